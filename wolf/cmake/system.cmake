@@ -196,13 +196,49 @@ endif()
 # include socket/websocket sources
 if (WOLF_SYSTEM_SOCKET AND NOT EMSCRIPTEN)    
     file(GLOB_RECURSE WOLF_SYSTEM_SOCKET_SRC
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_buffer.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_buffer.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_fd_passing.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_fd_passing.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_framing.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_framing.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_send_queue.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_send_queue.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_session_registry.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_session_registry.hpp"
         "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_socket_options.hpp"
         "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_tcp_client.cpp"
         "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_tcp_client.hpp"
         "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_tcp_server.cpp"
         "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_tcp_server.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_timing_wheel.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_timing_wheel.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_udp_batch.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_udp_batch.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_udp_client.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_udp_client.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_udp_server.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_udp_server.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_uds_client.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_uds_client.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_uds_server.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_uds_server.hpp"
     )
     list(APPEND SRCS ${WOLF_SYSTEM_SOCKET_SRC})
+
+    if (WOLF_SYSTEM_SOCKET_IO_URING)
+        if (NOT LINUX)
+            message(FATAL_ERROR "WOLF_SYSTEM_SOCKET_IO_URING is only supported on linux")
+        endif()
+        if (Boost_VERSION VERSION_LESS "1.78")
+            message(FATAL_ERROR "WOLF_SYSTEM_SOCKET_IO_URING requires boost asio 1.78 or later")
+        endif()
+        find_package(PkgConfig REQUIRED)
+        pkg_check_modules(LIBURING REQUIRED IMPORTED_TARGET liburing)
+        # all sockets, timers and descriptors of asio go through io_uring instead of epoll
+        add_definitions(-DBOOST_ASIO_HAS_IO_URING -DBOOST_ASIO_DISABLE_EPOLL)
+        list(APPEND LIBS PkgConfig::LIBURING)
+    endif()
 endif()
 
 if (WOLF_SYSTEM_HTTP_WS)
@@ -213,6 +249,8 @@ if (WOLF_SYSTEM_HTTP_WS)
         )
     else()
         file(GLOB_RECURSE WOLF_SYSTEM_HTTP_WS_SRC
+            "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_http_server.cpp"
+            "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_http_server.hpp"
             "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_ws_client.cpp"
             "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_ws_client.hpp"
             "${CMAKE_CURRENT_SOURCE_DIR}/system/socket/w_ws_server.cpp"
@@ -222,9 +260,40 @@ if (WOLF_SYSTEM_HTTP_WS)
     list(APPEND SRCS ${WOLF_SYSTEM_HTTP_WS_SRC})
 endif()
 
+# a shared-memory ring between the processes of one machine
+if (WOLF_SYSTEM_IPC)
+    if (NOT LINUX)
+        message(FATAL_ERROR "WOLF_SYSTEM_IPC is only supported on linux")
+    endif()
+    file(GLOB_RECURSE WOLF_SYSTEM_IPC_SRC
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/ipc/w_shm_channel.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/ipc/w_shm_channel.hpp"
+    )
+    list(APPEND SRCS ${WOLF_SYSTEM_IPC_SRC})
+endif()
+
 if (WOLF_SYSTEM_ZLIB)
     vcpkg_install(ZLIB zlib FALSE)
     list(APPEND LIBS ZLIB::ZLIB)
+
+    file(GLOB_RECURSE WOLF_SYSTEM_ZLIB_SRCS
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/compression/w_zlib.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/compression/w_zlib.hpp"
+    )
+    list(APPEND SRCS ${WOLF_SYSTEM_ZLIB_SRCS})
+endif()
+
+# the common interface of all compression codecs
+if (WOLF_SYSTEM_LZ4 OR WOLF_SYSTEM_LZMA OR WOLF_SYSTEM_ZLIB)
+    file(GLOB_RECURSE WOLF_SYSTEM_COMPRESSOR_SRCS
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/compression/w_checksum.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/compression/w_checksum.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/compression/w_compressor.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/compression/w_compressor.hpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/compression/w_entropy.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/system/compression/w_entropy.hpp"
+    )
+    list(APPEND SRCS ${WOLF_SYSTEM_COMPRESSOR_SRCS})
 endif()
 
 if (WOLF_SYSTEM_POSTGRESQL)
@@ -0,0 +1,235 @@
+#include "w_checksum.hpp"
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define W_CRC32C_X64
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && defined(__ARM_FEATURE_CRC32)
+#define W_CRC32C_ARM64
+#include <arm_acle.h>
+#endif
+
+using w_checksum = wolf::system::compression::w_checksum;
+using w_checksum_type = wolf::system::compression::w_checksum_type;
+
+// the reflected castagnoli polynomial
+constexpr auto CRC32C_POLY = uint32_t(0x82F63B78);
+
+// the tables of slicing-by-8 for the software fallback
+static const auto s_crc32c_tables = []() {
+  std::array<std::array<uint32_t, 256>, 8> _tables = {};
+  for (uint32_t i = 0; i < 256; ++i) {
+    auto _crc = i;
+    for (auto j = 0; j < 8; ++j) {
+      _crc = (_crc >> 1) ^ ((_crc & 1) ? CRC32C_POLY : 0);
+    }
+    _tables[0][i] = _crc;
+  }
+  for (uint32_t i = 0; i < 256; ++i) {
+    for (size_t t = 1; t < _tables.size(); ++t) {
+      _tables[t][i] = (_tables[t - 1][i] >> 8) ^ _tables[0][_tables[t - 1][i] & 0xFF];
+    }
+  }
+  return _tables;
+}();
+
+static uint64_t s_load_u64(_In_ const std::byte *p_src) noexcept {
+  uint64_t _value = 0;
+  std::memcpy(&_value, p_src, sizeof(_value));
+  return _value;
+}
+
+static uint32_t s_load_u32(_In_ const std::byte *p_src) noexcept {
+  uint32_t _value = 0;
+  std::memcpy(&_value, p_src, sizeof(_value));
+  return _value;
+}
+
+// the byte order of the loads above, the software paths assume little-endian
+static_assert(std::endian::native == std::endian::little,
+              "w_checksum only supports little-endian targets");
+
+static uint32_t s_crc32c_sw(_In_ const std::byte *p_src, _In_ size_t p_size,
+                            _In_ uint32_t p_crc) noexcept {
+  const auto &_t = s_crc32c_tables;
+  while (p_size >= sizeof(uint64_t)) {
+    const auto _value = s_load_u64(p_src) ^ p_crc;
+    p_crc = _t[7][_value & 0xFF] ^ _t[6][(_value >> 8) & 0xFF] ^ _t[5][(_value >> 16) & 0xFF] ^
+            _t[4][(_value >> 24) & 0xFF] ^ _t[3][(_value >> 32) & 0xFF] ^
+            _t[2][(_value >> 40) & 0xFF] ^ _t[1][(_value >> 48) & 0xFF] ^ _t[0][_value >> 56];
+    p_src += sizeof(uint64_t);
+    p_size -= sizeof(uint64_t);
+  }
+  while (p_size-- > 0) {
+    p_crc = (p_crc >> 8) ^ _t[0][(p_crc ^ std::to_integer<uint32_t>(*p_src++)) & 0xFF];
+  }
+  return p_crc;
+}
+
+#ifdef W_CRC32C_X64
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("sse4.2")))
+#endif
+static uint32_t
+s_crc32c_hw(_In_ const std::byte *p_src, _In_ size_t p_size, _In_ uint32_t p_crc) noexcept {
+  uint64_t _crc = p_crc;
+  while (p_size >= sizeof(uint64_t)) {
+    _crc = _mm_crc32_u64(_crc, s_load_u64(p_src));
+    p_src += sizeof(uint64_t);
+    p_size -= sizeof(uint64_t);
+  }
+  auto _crc_32 = gsl::narrow_cast<uint32_t>(_crc);
+  while (p_size-- > 0) {
+    _crc_32 = _mm_crc32_u8(_crc_32, std::to_integer<uint8_t>(*p_src++));
+  }
+  return _crc_32;
+}
+
+static bool s_detect_hw_crc32c() noexcept {
+#ifdef _MSC_VER
+  std::array<int, 4> _info = {};
+  __cpuid(_info.data(), 1);
+  // SSE4.2 is the bit 20 of ecx
+  return (_info[2] & (1 << 20)) != 0;
+#else
+  return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+#elif defined(W_CRC32C_ARM64)
+
+static uint32_t s_crc32c_hw(_In_ const std::byte *p_src, _In_ size_t p_size,
+                            _In_ uint32_t p_crc) noexcept {
+  while (p_size >= sizeof(uint64_t)) {
+    p_crc = __crc32cd(p_crc, s_load_u64(p_src));
+    p_src += sizeof(uint64_t);
+    p_size -= sizeof(uint64_t);
+  }
+  while (p_size-- > 0) {
+    p_crc = __crc32cb(p_crc, std::to_integer<uint8_t>(*p_src++));
+  }
+  return p_crc;
+}
+
+static bool s_detect_hw_crc32c() noexcept { return true; }
+
+#endif
+
+static const bool s_has_hw_crc32c = []() {
+#if defined(W_CRC32C_X64) || defined(W_CRC32C_ARM64)
+  return s_detect_hw_crc32c();
+#else
+  return false;
+#endif
+}();
+
+uint32_t w_checksum::crc32c(_In_ const gsl::span<const std::byte> p_src,
+                            _In_ uint32_t p_crc) noexcept {
+  const auto _crc = ~p_crc;
+#if defined(W_CRC32C_X64) || defined(W_CRC32C_ARM64)
+  if (s_has_hw_crc32c) {
+    return ~s_crc32c_hw(p_src.data(), p_src.size(), _crc);
+  }
+#endif
+  return ~s_crc32c_sw(p_src.data(), p_src.size(), _crc);
+}
+
+bool w_checksum::has_hardware_crc32c() noexcept { return s_has_hw_crc32c; }
+
+constexpr auto XXH_PRIME64_1 = uint64_t(0x9E3779B185EBCA87);
+constexpr auto XXH_PRIME64_2 = uint64_t(0xC2B2AE3D27D4EB4F);
+constexpr auto XXH_PRIME64_3 = uint64_t(0x165667B19E3779F9);
+constexpr auto XXH_PRIME64_4 = uint64_t(0x85EBCA77C2B2AE63);
+constexpr auto XXH_PRIME64_5 = uint64_t(0x27D4EB2F165667C5);
+
+static uint64_t s_xxh64_round(_In_ uint64_t p_acc, _In_ uint64_t p_input) noexcept {
+  p_acc += p_input * XXH_PRIME64_2;
+  p_acc = std::rotl(p_acc, 31);
+  return p_acc * XXH_PRIME64_1;
+}
+
+static uint64_t s_xxh64_merge(_In_ uint64_t p_acc, _In_ uint64_t p_value) noexcept {
+  p_acc ^= s_xxh64_round(0, p_value);
+  return p_acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+uint64_t w_checksum::xxh64(_In_ const gsl::span<const std::byte> p_src,
+                           _In_ uint64_t p_seed) noexcept {
+  const auto *_ptr = p_src.data();
+  const auto *const _end = _ptr + p_src.size();
+  uint64_t _hash = 0;
+
+  constexpr auto _stripe = size_t(32);
+  if (p_src.size() >= _stripe) {
+    auto _v1 = p_seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+    auto _v2 = p_seed + XXH_PRIME64_2;
+    auto _v3 = p_seed;
+    auto _v4 = p_seed - XXH_PRIME64_1;
+
+    const auto *const _limit = _end - _stripe;
+    do {
+      _v1 = s_xxh64_round(_v1, s_load_u64(_ptr));
+      _v2 = s_xxh64_round(_v2, s_load_u64(_ptr + 8));
+      _v3 = s_xxh64_round(_v3, s_load_u64(_ptr + 16));
+      _v4 = s_xxh64_round(_v4, s_load_u64(_ptr + 24));
+      _ptr += _stripe;
+    } while (_ptr <= _limit);
+
+    _hash = std::rotl(_v1, 1) + std::rotl(_v2, 7) + std::rotl(_v3, 12) + std::rotl(_v4, 18);
+    _hash = s_xxh64_merge(_hash, _v1);
+    _hash = s_xxh64_merge(_hash, _v2);
+    _hash = s_xxh64_merge(_hash, _v3);
+    _hash = s_xxh64_merge(_hash, _v4);
+  } else {
+    _hash = p_seed + XXH_PRIME64_5;
+  }
+
+  _hash += gsl::narrow_cast<uint64_t>(p_src.size());
+
+  while (_ptr + 8 <= _end) {
+    _hash ^= s_xxh64_round(0, s_load_u64(_ptr));
+    _hash = std::rotl(_hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    _ptr += 8;
+  }
+  if (_ptr + 4 <= _end) {
+    _hash ^= gsl::narrow_cast<uint64_t>(s_load_u32(_ptr)) * XXH_PRIME64_1;
+    _hash = std::rotl(_hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+    _ptr += 4;
+  }
+  while (_ptr < _end) {
+    _hash ^= std::to_integer<uint64_t>(*_ptr) * XXH_PRIME64_5;
+    _hash = std::rotl(_hash, 11) * XXH_PRIME64_1;
+    ++_ptr;
+  }
+
+  // avalanche
+  _hash ^= _hash >> 33;
+  _hash *= XXH_PRIME64_2;
+  _hash ^= _hash >> 29;
+  _hash *= XXH_PRIME64_3;
+  _hash ^= _hash >> 32;
+  return _hash;
+}
+
+uint32_t w_checksum::calculate(_In_ const gsl::span<const std::byte> p_src,
+                               _In_ w_checksum_type p_type) noexcept {
+  switch (p_type) {
+  default:
+    return 0;
+  case w_checksum_type::CRC32C:
+    return crc32c(p_src);
+  case w_checksum_type::XXH64:
+    return gsl::narrow_cast<uint32_t>(xxh64(p_src));
+  }
+}
+
+#endif // WOLF_SYSTEM_LZ4 || WOLF_SYSTEM_LZMA || WOLF_SYSTEM_ZLIB
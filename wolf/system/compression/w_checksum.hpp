@@ -0,0 +1,59 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+
+#include <wolf/wolf.hpp>
+
+namespace wolf::system::compression {
+
+// the checksum of each block of a checked container
+enum class w_checksum_type : uint8_t {
+  NONE = 0,
+  // crc32 with castagnoli polynomial, uses the crc32 instructions of SSE4.2 or ARMv8 if available
+  CRC32C,
+  // xxHash64, which is fast on any cpu
+  XXH64,
+};
+
+struct w_checksum {
+  /*
+   * calculate crc32c of a buffer
+   * @param p_src, the input source
+   * @param p_crc, the crc of previous buffers for continuing a calculation
+   * @returns the crc32c
+   */
+  W_API static uint32_t crc32c(_In_ const gsl::span<const std::byte> p_src,
+                               _In_ uint32_t p_crc = 0) noexcept;
+
+  /*
+   * calculate xxHash64 of a buffer
+   * @param p_src, the input source
+   * @param p_seed, the seed of hash
+   * @returns the hash
+   */
+  W_API static uint64_t xxh64(_In_ const gsl::span<const std::byte> p_src,
+                              _In_ uint64_t p_seed = 0) noexcept;
+
+  /*
+   * calculate the 32 bits checksum of a buffer, xxHash64 is truncated to its lower bits
+   * @param p_src, the input source
+   * @param p_type, the type of checksum
+   * @returns the checksum, zero for NONE
+   */
+  W_API static uint32_t calculate(_In_ const gsl::span<const std::byte> p_src,
+                                  _In_ w_checksum_type p_type) noexcept;
+
+  /*
+   * check whether crc32c is calculated via cpu instructions
+   * @returns true if hardware crc32c is available
+   */
+  W_API static bool has_hardware_crc32c() noexcept;
+};
+} // namespace wolf::system::compression
+
+#endif // WOLF_SYSTEM_LZ4 || WOLF_SYSTEM_LZMA || WOLF_SYSTEM_ZLIB
@@ -0,0 +1,764 @@
+#include "w_compressor.hpp"
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+
+#include "w_entropy.hpp"
+#include "w_lz4.hpp"
+#include "w_lzma.hpp"
+#include "w_zlib.hpp"
+
+#ifdef WOLF_SYSTEM_LZ4
+#include <DISABLE_ANALYSIS_BEGIN>
+#include <lz4.h>
+#include <DISABLE_ANALYSIS_END>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <optional>
+
+using w_compressor = wolf::system::compression::w_compressor;
+using w_checksum = wolf::system::compression::w_checksum;
+using w_checksum_type = wolf::system::compression::w_checksum_type;
+using w_compressor_codec = wolf::system::compression::w_compressor_codec;
+using w_compressor_container_options =
+    wolf::system::compression::w_compressor_container_options;
+using w_compressor_options = wolf::system::compression::w_compressor_options;
+using w_compressor_policy = wolf::system::compression::w_compressor_policy;
+using w_compressor_stats = wolf::system::compression::w_compressor_stats;
+using w_entropy = wolf::system::compression::w_entropy;
+
+/*
+ * the header of compressed stream:
+ * 2 bytes magic "WC", 1 byte version, 1 byte codec,
+ * 4 bytes level and 8 bytes original size, all in little-endian
+ */
+constexpr auto COMPRESSOR_MAGIC = uint16_t(0x4357);
+constexpr auto COMPRESSOR_VERSION = uint8_t(1);
+constexpr auto COMPRESSOR_HEADER_SIZE = size_t(16);
+// the number of places which a sample is taken from
+constexpr auto COMPRESSOR_SAMPLE_SLICES = size_t(4);
+// each candidate is repeated until this time is spent or the maximum repeat is reached
+constexpr auto COMPRESSOR_MEASURE_TIME = std::chrono::milliseconds(10);
+constexpr auto COMPRESSOR_MEASURE_MAX_REPEAT = 16;
+// lzma2 splits a source into blocks of at least 1MB, a smaller source is encoded by one thread
+constexpr auto COMPRESSOR_LZMA2_MT_MIN_SIZE = size_t(2 * 1024 * 1024);
+// the encoders which each thread keeps of a codec, the default candidates probe two of each
+constexpr auto COMPRESSOR_CACHED_ENCODERS = size_t(2);
+// the lzma2 encoders above this level take hundreds of MiB, so they are released after each use
+constexpr auto COMPRESSOR_LZMA2_MAX_CACHED_LEVEL = uint32_t(6);
+
+/*
+ * the header of checked container:
+ * 2 bytes magic "WB", 1 byte version, 1 byte codec, 4 bytes level, 8 bytes original size,
+ * 4 bytes block size, 1 byte checksum type, 3 reserved bytes and
+ * the crc32c of previous bytes, all in little-endian.
+ * Each block is 4 bytes compressed size, 4 bytes checksum of compressed bytes and the payload,
+ * the high bit of size marks a block which was stored without compression
+ */
+constexpr auto CONTAINER_MAGIC = uint16_t(0x4257);
+constexpr auto CONTAINER_VERSION = uint8_t(1);
+constexpr auto CONTAINER_HEADER_SIZE = size_t(28);
+constexpr auto CONTAINER_HEADER_CRC_OFFSET = size_t(24);
+constexpr auto CONTAINER_BLOCK_HEADER_SIZE = size_t(8);
+constexpr auto CONTAINER_STORED_FLAG = uint32_t(0x80000000);
+
+template <typename T>
+static void s_write_le(_Inout_ std::byte *p_dst, _In_ T p_value) noexcept {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    p_dst[i] = std::byte((static_cast<uint64_t>(p_value) >> (i * 8)) & 0xFF);
+  }
+}
+
+template <typename T> static T s_read_le(_In_ const std::byte *p_src) noexcept {
+  uint64_t _value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    _value |= std::to_integer<uint64_t>(p_src[i]) << (i * 8);
+  }
+  return static_cast<T>(_value);
+}
+
+/*
+ * an encoder which is kept with the options it was created for, so it is only created again
+ * when the options change
+ */
+template <typename T, typename K> struct w_compressor_cached_encoder {
+  T encoder;
+  std::optional<K> key;
+  // the order of last use, the least recently used encoder is replaced
+  uint64_t used = 0;
+};
+
+template <typename T, typename K>
+using w_compressor_cached_encoders =
+    std::array<w_compressor_cached_encoder<T, K>, COMPRESSOR_CACHED_ENCODERS>;
+
+template <typename T, typename K, typename F>
+static boost::leaf::result<T *> s_get_encoder(_Inout_ w_compressor_cached_encoders<T, K> &p_cache,
+                                              _In_ const K &p_key, _In_ F &&p_init) {
+  const auto _by_use = [](const auto &p_lhs, const auto &p_rhs) {
+    return p_lhs.used < p_rhs.used;
+  };
+  const auto _last_used = std::max_element(p_cache.begin(), p_cache.end(), _by_use)->used;
+
+  auto _cached = std::find_if(p_cache.begin(), p_cache.end(),
+                              [&](const auto &p_cached) { return p_cached.key == p_key; });
+  if (_cached == p_cache.end()) {
+    _cached = std::min_element(p_cache.begin(), p_cache.end(), _by_use);
+    // a failed init leaves nothing to reuse
+    _cached->key.reset();
+    _cached->used = 0;
+    BOOST_LEAF_CHECK(p_init(_cached->encoder));
+    _cached->key = p_key;
+  }
+  _cached->used = _last_used + 1;
+  return &_cached->encoder;
+}
+
+// free the cached encoder of a key
+template <typename T, typename K>
+static void s_release_encoder(_Inout_ w_compressor_cached_encoders<T, K> &p_cache,
+                              _In_ const K &p_key) noexcept {
+  for (auto &_cached : p_cache) {
+    if (_cached.key == p_key) {
+      _cached = {};
+    }
+  }
+}
+
+/*
+ * the encoders of each thread, which keep their tables and states between calls, so repeated
+ * calls and the probes of select do not allocate them again
+ */
+struct w_compressor_encoders {
+#ifdef WOLF_SYSTEM_LZ4
+  // the mode and the level
+  w_compressor_cached_encoders<wolf::system::compression::w_lz4_encoder, std::pair<int, int>> lz4;
+#endif
+#ifdef WOLF_SYSTEM_LZMA
+  // the level and the number of block threads
+  w_compressor_cached_encoders<wolf::system::compression::w_lzma_encoder,
+                               std::pair<uint32_t, int>>
+      lzma2;
+#endif
+#ifdef WOLF_SYSTEM_ZLIB
+  w_compressor_cached_encoders<wolf::system::compression::w_zlib_deflater, int> deflate;
+#endif
+};
+
+static w_compressor_encoders &s_get_encoders() {
+  static thread_local w_compressor_encoders s_encoders;
+  return s_encoders;
+}
+
+static boost::leaf::result<size_t> s_get_bound(_In_ w_compressor_codec p_codec,
+                                               _In_ size_t p_src_size) {
+  switch (p_codec) {
+  default:
+    return W_FAILURE(std::errc::invalid_argument, "unknown codec of w_compressor");
+  case w_compressor_codec::STORED:
+    return p_src_size;
+#ifdef WOLF_SYSTEM_LZ4
+  case w_compressor_codec::LZ4:
+  case w_compressor_codec::LZ4_HC:
+    if (p_src_size > LZ4_MAX_INPUT_SIZE) {
+      return W_FAILURE(std::errc::value_too_large, "the source is too large for lz4");
+    }
+    return gsl::narrow_cast<size_t>(
+        wolf::system::compression::w_lz4::get_compress_bound(gsl::narrow_cast<int>(p_src_size)));
+#endif
+#ifdef WOLF_SYSTEM_LZMA
+  case w_compressor_codec::LZMA2:
+    return wolf::system::compression::w_lzma_encoder::get_compress_bound(p_src_size);
+#endif
+#ifdef WOLF_SYSTEM_ZLIB
+  case w_compressor_codec::DEFLATE:
+    return wolf::system::compression::w_zlib::get_compress_bound(p_src_size);
+#endif
+  }
+}
+
+static boost::leaf::result<size_t> s_compress(_In_ const gsl::span<const std::byte> p_src,
+                                              _Inout_ gsl::span<std::byte> p_dst,
+                                              _In_ const w_compressor_options &p_options) {
+  switch (p_options.codec) {
+  default:
+    return W_FAILURE(std::errc::not_supported, "the codec of w_compressor is not available");
+  case w_compressor_codec::STORED:
+    std::copy(p_src.begin(), p_src.end(), p_dst.begin());
+    return p_src.size();
+#ifdef WOLF_SYSTEM_LZ4
+  case w_compressor_codec::LZ4:
+  case w_compressor_codec::LZ4_HC: {
+    using w_lz4_mode = wolf::system::compression::w_lz4_mode;
+    const auto _mode =
+        p_options.codec == w_compressor_codec::LZ4 ? w_lz4_mode::FAST : w_lz4_mode::HC;
+
+    BOOST_LEAF_AUTO(_encoder,
+                    s_get_encoder(s_get_encoders().lz4,
+                                  std::make_pair(static_cast<int>(_mode), p_options.level),
+                                  [&](auto &p_encoder) {
+                                    return p_encoder.init(_mode, p_options.level);
+                                  }));
+    return _encoder->compress(p_src, p_dst);
+  }
+#endif
+#ifdef WOLF_SYSTEM_LZMA
+  case w_compressor_codec::LZMA2: {
+    wolf::system::compression::w_lzma2_options _options = {};
+    _options.level = gsl::narrow_cast<uint32_t>(std::max(p_options.level, 0));
+    // a small source has one block, so the threads of other blocks would be idle
+    _options.block_threads = p_src.size() < COMPRESSOR_LZMA2_MT_MIN_SIZE ? 1 : 0;
+
+    const auto _key = std::make_pair(_options.level, _options.block_threads);
+    auto &_cache = s_get_encoders().lzma2;
+    BOOST_LEAF_AUTO(_encoder,
+                    s_get_encoder(_cache, _key,
+                                  [&](auto &p_encoder) { return p_encoder.init(_options); }));
+    auto _size = _encoder->compress(p_src, p_dst);
+    // the arenas of high levels and of the block threads are too large to keep per thread
+    if (_options.level > COMPRESSOR_LZMA2_MAX_CACHED_LEVEL || _options.block_threads != 1) {
+      s_release_encoder(_cache, _key);
+    }
+    return _size;
+  }
+#endif
+#ifdef WOLF_SYSTEM_ZLIB
+  case w_compressor_codec::DEFLATE: {
+    BOOST_LEAF_AUTO(_deflater,
+                    s_get_encoder(s_get_encoders().deflate, p_options.level, [&](auto &p_deflater) {
+                      return p_deflater.init(wolf::system::compression::w_zlib_format::RAW,
+                                             p_options.level);
+                    }));
+    return _deflater->compress(p_src, p_dst);
+  }
+#endif
+  }
+}
+
+static boost::leaf::result<size_t> s_decompress(_In_ const gsl::span<const std::byte> p_src,
+                                                _Inout_ gsl::span<std::byte> p_dst,
+                                                _In_ w_compressor_codec p_codec) {
+  switch (p_codec) {
+  default:
+    return W_FAILURE(std::errc::not_supported, "the codec of w_compressor is not available");
+  case w_compressor_codec::STORED:
+    if (p_src.size() != p_dst.size()) {
+      return W_FAILURE(std::errc::invalid_argument, "the stored stream is truncated");
+    }
+    std::copy(p_src.begin(), p_src.end(), p_dst.begin());
+    return p_src.size();
+#ifdef WOLF_SYSTEM_LZ4
+  case w_compressor_codec::LZ4:
+  case w_compressor_codec::LZ4_HC: {
+    if (p_src.size() > INT_MAX || p_dst.size() > INT_MAX) {
+      return W_FAILURE(std::errc::value_too_large, "the stream is too large for lz4");
+    }
+    const auto _size = LZ4_decompress_safe(
+        reinterpret_cast<const char *>(p_src.data()), reinterpret_cast<char *>(p_dst.data()),
+        gsl::narrow_cast<int>(p_src.size()), gsl::narrow_cast<int>(p_dst.size()));
+    if (_size < 0) {
+      return W_FAILURE(std::errc::invalid_argument, "the lz4 stream is corrupted");
+    }
+    return gsl::narrow_cast<size_t>(_size);
+  }
+#endif
+#ifdef WOLF_SYSTEM_LZMA
+  case w_compressor_codec::LZMA2: {
+    auto _decoder = wolf::system::compression::w_lzma_decoder();
+    BOOST_LEAF_CHECK(_decoder.init());
+    return _decoder.decompress(p_src, p_dst);
+  }
+#endif
+#ifdef WOLF_SYSTEM_ZLIB
+  case w_compressor_codec::DEFLATE: {
+    auto _inflater = wolf::system::compression::w_zlib_inflater();
+    BOOST_LEAF_CHECK(_inflater.init(wolf::system::compression::w_zlib_format::RAW));
+    return _inflater.decompress(p_src, p_dst);
+  }
+#endif
+  }
+}
+
+// allocate the destination of a size which was read from an untrusted header
+static boost::leaf::result<std::vector<std::byte>> s_allocate_dst(_In_ uint64_t p_size) noexcept {
+  std::vector<std::byte> _dst;
+  if (p_size > _dst.max_size()) {
+    return W_FAILURE(std::errc::not_enough_memory, "the size of header exceeds the memory");
+  }
+  try {
+    _dst.resize(gsl::narrow_cast<size_t>(p_size));
+  } catch (...) {
+    return W_FAILURE(std::errc::not_enough_memory, "could not allocate the destination");
+  }
+  return _dst;
+}
+
+/*
+ * walk through the blocks of a checked container and verify the checksum of each one
+ * before passing its payload to the function
+ */
+template <typename F>
+static boost::leaf::result<size_t>
+s_for_each_block(_In_ const gsl::span<const std::byte> p_src,
+                 _In_ const w_compressor_container_options &p_options, _In_ uint64_t p_size,
+                 _In_ F &&p_func) {
+  const auto _block_size = uint64_t(p_options.block_size);
+  // the count is rounded up without an add, which wraps for a forged size
+  const auto _blocks =
+      gsl::narrow_cast<size_t>(p_size / _block_size + (p_size % _block_size != 0 ? 1 : 0));
+
+  auto _offset = CONTAINER_HEADER_SIZE;
+  for (size_t i = 0; i < _blocks; ++i) {
+    if (p_src.size() - _offset < CONTAINER_BLOCK_HEADER_SIZE) {
+      return W_FAILURE(std::errc::invalid_argument,
+                       wolf::format("the header of block {} is truncated", i));
+    }
+    const auto _entry = s_read_le<uint32_t>(p_src.data() + _offset);
+    const auto _compressed_size = size_t(_entry & ~CONTAINER_STORED_FLAG);
+    const auto _stored = (_entry & CONTAINER_STORED_FLAG) != 0;
+    const auto _checksum = s_read_le<uint32_t>(p_src.data() + _offset + 4);
+    _offset += CONTAINER_BLOCK_HEADER_SIZE;
+
+    if (p_src.size() - _offset < _compressed_size) {
+      return W_FAILURE(std::errc::invalid_argument,
+                       wolf::format("the payload of block {} is truncated", i));
+    }
+    const auto _payload = p_src.subspan(_offset, _compressed_size);
+    _offset += _compressed_size;
+
+    if (w_checksum::calculate(_payload, p_options.checksum) != _checksum) {
+      return W_FAILURE(std::errc::illegal_byte_sequence,
+                       wolf::format("the checksum of block {} does not match", i));
+    }
+
+    const auto _position = i * _block_size;
+    const auto _raw_size = gsl::narrow_cast<size_t>(std::min(_block_size, p_size - _position));
+    BOOST_LEAF_CHECK(
+        p_func(_payload, gsl::narrow_cast<size_t>(_position), _raw_size, _stored));
+  }
+
+  if (_offset != p_src.size()) {
+    return W_FAILURE(std::errc::invalid_argument, "there are extra bytes after the last block");
+  }
+  return _blocks;
+}
+
+/*
+ * take the sample from a few evenly spaced places,
+ * so a header or a tail does not decide for the whole source
+ */
+static std::vector<std::byte> s_take_sample(_In_ const gsl::span<const std::byte> p_src,
+                                            _In_ size_t p_sample_size) {
+  if (p_sample_size == 0 || p_src.size() <= p_sample_size) {
+    return {p_src.begin(), p_src.end()};
+  }
+
+  const auto _slice_size = p_sample_size / COMPRESSOR_SAMPLE_SLICES;
+  const auto _stride = p_src.size() / COMPRESSOR_SAMPLE_SLICES;
+
+  std::vector<std::byte> _sample;
+  _sample.reserve(_slice_size * COMPRESSOR_SAMPLE_SLICES);
+  for (size_t i = 0; i < COMPRESSOR_SAMPLE_SLICES; ++i) {
+    const auto _slice = p_src.subspan(i * _stride, _slice_size);
+    _sample.insert(_sample.end(), _slice.begin(), _slice.end());
+  }
+  return _sample;
+}
+
+/*
+ * repeat a function for a short time and return the average time of each call in seconds
+ */
+template <typename F> static boost::leaf::result<double> s_measure_time(_In_ F &&p_func) {
+  using steady_clock = std::chrono::steady_clock;
+
+  auto _repeat = 0;
+  const auto _start = steady_clock::now();
+  auto _elapsed = steady_clock::duration::zero();
+  do {
+    BOOST_LEAF_CHECK(p_func());
+    ++_repeat;
+    _elapsed = steady_clock::now() - _start;
+  } while (_elapsed < COMPRESSOR_MEASURE_TIME && _repeat < COMPRESSOR_MEASURE_MAX_REPEAT);
+
+  return std::chrono::duration<double>(_elapsed).count() / _repeat;
+}
+
+bool w_compressor::is_available(_In_ w_compressor_codec p_codec) noexcept {
+  switch (p_codec) {
+  default:
+    return false;
+  case w_compressor_codec::STORED:
+    return true;
+#ifdef WOLF_SYSTEM_LZ4
+  case w_compressor_codec::LZ4:
+  case w_compressor_codec::LZ4_HC:
+    return true;
+#endif
+#ifdef WOLF_SYSTEM_LZMA
+  case w_compressor_codec::LZMA2:
+    return true;
+#endif
+#ifdef WOLF_SYSTEM_ZLIB
+  case w_compressor_codec::DEFLATE:
+    return true;
+#endif
+  }
+}
+
+void w_compressor::release_thread_cache() noexcept { s_get_encoders() = {}; }
+
+std::vector<w_compressor_options> w_compressor::get_default_candidates() {
+  const auto _candidates = std::vector<w_compressor_options>{
+      {w_compressor_codec::LZ4, 1},     {w_compressor_codec::LZ4_HC, 9},
+      {w_compressor_codec::DEFLATE, 1}, {w_compressor_codec::DEFLATE, 6},
+      {w_compressor_codec::LZMA2, 1},   {w_compressor_codec::LZMA2, 5},
+  };
+
+  std::vector<w_compressor_options> _available;
+  std::copy_if(_candidates.begin(), _candidates.end(), std::back_inserter(_available),
+               [](const auto &p_options) { return is_available(p_options.codec); });
+  return _available;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_compressor::compress(_In_ const gsl::span<const std::byte> p_src,
+                       _In_ const w_compressor_options &p_options) {
+  if (!is_available(p_options.codec)) {
+    return W_FAILURE(std::errc::not_supported,
+                     wolf::format("the codec {} of w_compressor is not available",
+                                  static_cast<int>(p_options.codec)));
+  }
+
+  // an empty source is always stored
+  auto _options = p_options;
+  if (p_src.empty()) {
+    _options = {w_compressor_codec::STORED, 0};
+  }
+
+  BOOST_LEAF_AUTO(_bound, s_get_bound(_options.codec, p_src.size()));
+
+  std::vector<std::byte> _dst;
+  _dst.resize(COMPRESSOR_HEADER_SIZE + _bound);
+
+  auto *_header = _dst.data();
+  s_write_le(_header, COMPRESSOR_MAGIC);
+  s_write_le(_header + 2, COMPRESSOR_VERSION);
+  s_write_le(_header + 3, static_cast<uint8_t>(_options.codec));
+  s_write_le(_header + 4, static_cast<uint32_t>(_options.level));
+  s_write_le(_header + 8, gsl::narrow_cast<uint64_t>(p_src.size()));
+
+  // compress right after the header, so there is no need for an extra copy
+  const auto _payload = gsl::span(_dst).subspan(COMPRESSOR_HEADER_SIZE);
+  BOOST_LEAF_AUTO(_size, s_compress(p_src, _payload, _options));
+
+  _dst.resize(COMPRESSOR_HEADER_SIZE + _size);
+  return _dst;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_compressor::compress(_In_ const gsl::span<const std::byte> p_src,
+                       _In_ const w_compressor_policy &p_policy) {
+  if (!w_entropy::is_compressible(p_src)) {
+    return compress(p_src, w_compressor_options{w_compressor_codec::STORED, 0});
+  }
+  BOOST_LEAF_AUTO(_stats, select(p_src, p_policy));
+  return compress(p_src, _stats.options);
+}
+
+boost::leaf::result<std::tuple<w_compressor_options, uint64_t>>
+w_compressor::get_header(_In_ const gsl::span<const std::byte> p_src) noexcept {
+  if (p_src.size() < COMPRESSOR_HEADER_SIZE) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid header size of w_compressor");
+  }
+
+  const auto *_header = p_src.data();
+  if (s_read_le<uint16_t>(_header) != COMPRESSOR_MAGIC) {
+    return W_FAILURE(std::errc::invalid_argument, "the stream was not made by w_compressor");
+  }
+  if (s_read_le<uint8_t>(_header + 2) != COMPRESSOR_VERSION) {
+    return W_FAILURE(std::errc::not_supported, "unsupported version of w_compressor stream");
+  }
+
+  w_compressor_options _options = {};
+  _options.codec = static_cast<w_compressor_codec>(s_read_le<uint8_t>(_header + 3));
+  _options.level = static_cast<int32_t>(s_read_le<uint32_t>(_header + 4));
+  if (!is_available(_options.codec)) {
+    return W_FAILURE(std::errc::not_supported, "the codec of w_compressor is not available");
+  }
+
+  return std::make_tuple(_options, s_read_le<uint64_t>(_header + 8));
+}
+
+boost::leaf::result<size_t> w_compressor::decompress(_In_ const gsl::span<const std::byte> p_src,
+                                                     _Inout_ gsl::span<std::byte> p_dst) {
+  BOOST_LEAF_AUTO(_header, get_header(p_src));
+  const auto &[_options, _size] = _header;
+
+  if (p_dst.size() < _size) {
+    return W_FAILURE(std::errc::no_buffer_space,
+                     wolf::format("the destination is {} bytes but {} bytes are required",
+                                  p_dst.size(), _size));
+  }
+
+  const auto _dst = p_dst.first(gsl::narrow_cast<size_t>(_size));
+  BOOST_LEAF_AUTO(_decompressed,
+                  s_decompress(p_src.subspan(COMPRESSOR_HEADER_SIZE), _dst, _options.codec));
+  if (_decompressed != _size) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     wolf::format("decompressed {} bytes but {} bytes were expected",
+                                  _decompressed, _size));
+  }
+  return _decompressed;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_compressor::decompress(_In_ const gsl::span<const std::byte> p_src) {
+  BOOST_LEAF_AUTO(_header, get_header(p_src));
+  BOOST_LEAF_AUTO(_dst, s_allocate_dst(std::get<1>(_header)));
+
+  BOOST_LEAF_CHECK(decompress(p_src, _dst));
+  return _dst;
+}
+
+boost::leaf::result<std::vector<w_compressor_stats>>
+w_compressor::measure(_In_ const gsl::span<const std::byte> p_src,
+                      _In_ const std::vector<w_compressor_options> &p_candidates) {
+  const auto _candidates = p_candidates.empty() ? get_default_candidates() : p_candidates;
+
+  constexpr auto _mb = 1024.0 * 1024.0;
+  const auto _src_mb = gsl::narrow_cast<double>(p_src.size()) / _mb;
+
+  std::vector<std::byte> _decompressed(p_src.size());
+  std::vector<w_compressor_stats> _stats;
+  _stats.reserve(_candidates.size());
+
+  for (const auto &_options : _candidates) {
+    if (!is_available(_options.codec)) {
+      continue;
+    }
+
+    std::vector<std::byte> _compressed;
+    BOOST_LEAF_AUTO(_compress_time, s_measure_time([&]() -> boost::leaf::result<int> {
+                      BOOST_LEAF_ASSIGN(_compressed, compress(p_src, _options));
+                      return 0;
+                    }));
+    BOOST_LEAF_AUTO(_decompress_time, s_measure_time([&]() -> boost::leaf::result<int> {
+                      BOOST_LEAF_CHECK(decompress(_compressed, _decompressed));
+                      return 0;
+                    }));
+
+    w_compressor_stats _stat = {};
+    _stat.options = _options;
+    _stat.src_size = p_src.size();
+    _stat.compressed_size = _compressed.size();
+    _stat.ratio = gsl::narrow_cast<double>(p_src.size()) /
+                  gsl::narrow_cast<double>(_compressed.size());
+    _stat.compress_mbps = _compress_time > 0.0 ? _src_mb / _compress_time : 0.0;
+    _stat.decompress_mbps = _decompress_time > 0.0 ? _src_mb / _decompress_time : 0.0;
+    _stats.push_back(_stat);
+  }
+  return _stats;
+}
+
+boost::leaf::result<w_compressor_stats>
+w_compressor::select(_In_ const gsl::span<const std::byte> p_src,
+                     _In_ const w_compressor_policy &p_policy) {
+  const auto _sample = s_take_sample(p_src, p_policy.sample_size);
+  BOOST_LEAF_AUTO(_stats, measure(_sample, p_policy.candidates));
+
+  // the candidates which are fast enough
+  std::vector<w_compressor_stats> _fast;
+  std::copy_if(_stats.begin(), _stats.end(), std::back_inserter(_fast), [&](const auto &p_stat) {
+    return p_stat.options.codec != w_compressor_codec::STORED &&
+           p_stat.compress_mbps >= p_policy.min_compress_mbps;
+  });
+
+  const auto _by_ratio = [](const auto &p_lhs, const auto &p_rhs) {
+    return p_lhs.ratio < p_rhs.ratio;
+  };
+  const auto _by_speed = [](const auto &p_lhs, const auto &p_rhs) {
+    return p_lhs.compress_mbps < p_rhs.compress_mbps;
+  };
+
+  auto _chosen = w_compressor_stats{};
+  _chosen.options = {w_compressor_codec::STORED, 0};
+  _chosen.ratio = 1.0;
+
+  if (!_fast.empty()) {
+    // the candidates which are also small enough
+    std::vector<w_compressor_stats> _good;
+    std::copy_if(_fast.begin(), _fast.end(), std::back_inserter(_good),
+                 [&](const auto &p_stat) { return p_stat.ratio >= p_policy.min_ratio; });
+
+    if (_good.empty()) {
+      _chosen = *std::max_element(_fast.begin(), _fast.end(), _by_ratio);
+    } else if (p_policy.min_compress_mbps > 0.0) {
+      _chosen = *std::max_element(_good.begin(), _good.end(), _by_ratio);
+    } else {
+      _chosen = *std::max_element(_good.begin(), _good.end(), _by_speed);
+    }
+  }
+
+  // there is no gain for incompressible data
+  if (_chosen.ratio <= 1.0) {
+    _chosen.options = {w_compressor_codec::STORED, 0};
+  }
+  return _chosen;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_compressor::compress_container(_In_ const gsl::span<const std::byte> p_src,
+                                 _In_ const w_compressor_container_options &p_options) {
+  const auto &_options = p_options.options;
+  if (!is_available(_options.codec)) {
+    return W_FAILURE(std::errc::not_supported,
+                     wolf::format("the codec {} of w_compressor is not available",
+                                  static_cast<int>(_options.codec)));
+  }
+  if (p_options.block_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the block size of container must be positive");
+  }
+  if (p_options.checksum > w_checksum_type::XXH64) {
+    return W_FAILURE(std::errc::invalid_argument, "unknown checksum of container");
+  }
+
+  const auto _block_size = size_t(p_options.block_size);
+  BOOST_LEAF_AUTO(_block_bound, s_get_bound(_options.codec, std::min(_block_size, p_src.size())));
+  if (_block_bound >= CONTAINER_STORED_FLAG) {
+    return W_FAILURE(std::errc::value_too_large, "the block size of container is too large");
+  }
+
+  const auto _blocks = (p_src.size() + _block_size - 1) / _block_size;
+
+  std::vector<std::byte> _dst;
+  _dst.resize(CONTAINER_HEADER_SIZE + _blocks * (CONTAINER_BLOCK_HEADER_SIZE + _block_bound));
+
+  auto *_header = _dst.data();
+  s_write_le(_header, CONTAINER_MAGIC);
+  s_write_le(_header + 2, CONTAINER_VERSION);
+  s_write_le(_header + 3, static_cast<uint8_t>(_options.codec));
+  s_write_le(_header + 4, static_cast<uint32_t>(_options.level));
+  s_write_le(_header + 8, gsl::narrow_cast<uint64_t>(p_src.size()));
+  s_write_le(_header + 16, p_options.block_size);
+  s_write_le(_header + 20, static_cast<uint8_t>(p_options.checksum));
+  s_write_le(_header + CONTAINER_HEADER_CRC_OFFSET,
+             w_checksum::crc32c(gsl::span(_dst).first(CONTAINER_HEADER_CRC_OFFSET)));
+
+  auto _offset = CONTAINER_HEADER_SIZE;
+  for (size_t i = 0; i < _blocks; ++i) {
+    const auto _position = i * _block_size;
+    const auto _block = p_src.subspan(_position, std::min(_block_size, p_src.size() - _position));
+    const auto _payload =
+        gsl::span(_dst).subspan(_offset + CONTAINER_BLOCK_HEADER_SIZE, _block_bound);
+
+    // the bound of every codec covers the block itself, so a stored block always fits
+    auto _size = _block.size();
+    auto _entry = gsl::narrow_cast<uint32_t>(_size) | CONTAINER_STORED_FLAG;
+    if (!p_options.skip_incompressible || w_entropy::is_compressible(_block)) {
+      BOOST_LEAF_AUTO(_compressed_size, s_compress(_block, _payload, _options));
+      if (_compressed_size < _block.size()) {
+        _size = _compressed_size;
+        _entry = gsl::narrow_cast<uint32_t>(_size);
+      }
+    }
+    if ((_entry & CONTAINER_STORED_FLAG) != 0) {
+      std::copy(_block.begin(), _block.end(), _payload.begin());
+    }
+
+    const auto _compressed = _payload.first(_size);
+    s_write_le(_dst.data() + _offset, _entry);
+    s_write_le(_dst.data() + _offset + 4, w_checksum::calculate(_compressed, p_options.checksum));
+    _offset += CONTAINER_BLOCK_HEADER_SIZE + _size;
+  }
+
+  _dst.resize(_offset);
+  return _dst;
+}
+
+boost::leaf::result<std::tuple<w_compressor_container_options, uint64_t>>
+w_compressor::get_container_header(_In_ const gsl::span<const std::byte> p_src) noexcept {
+  if (p_src.size() < CONTAINER_HEADER_SIZE) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid header size of container");
+  }
+
+  const auto *_header = p_src.data();
+  if (s_read_le<uint16_t>(_header) != CONTAINER_MAGIC) {
+    return W_FAILURE(std::errc::invalid_argument, "the stream is not a container of w_compressor");
+  }
+  if (s_read_le<uint32_t>(_header + CONTAINER_HEADER_CRC_OFFSET) !=
+      w_checksum::crc32c(p_src.first(CONTAINER_HEADER_CRC_OFFSET))) {
+    return W_FAILURE(std::errc::illegal_byte_sequence, "the header of container is corrupted");
+  }
+  if (s_read_le<uint8_t>(_header + 2) != CONTAINER_VERSION) {
+    return W_FAILURE(std::errc::not_supported, "unsupported version of container");
+  }
+
+  w_compressor_container_options _options = {};
+  _options.options.codec = static_cast<w_compressor_codec>(s_read_le<uint8_t>(_header + 3));
+  _options.options.level = static_cast<int32_t>(s_read_le<uint32_t>(_header + 4));
+  _options.block_size = s_read_le<uint32_t>(_header + 16);
+  _options.checksum = static_cast<w_checksum_type>(s_read_le<uint8_t>(_header + 20));
+  if (!is_available(_options.options.codec)) {
+    return W_FAILURE(std::errc::not_supported, "the codec of w_compressor is not available");
+  }
+  if (_options.block_size == 0 || _options.checksum > w_checksum_type::XXH64) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid options of container");
+  }
+
+  return std::make_tuple(_options, s_read_le<uint64_t>(_header + 8));
+}
+
+boost::leaf::result<size_t>
+w_compressor::decompress_container(_In_ const gsl::span<const std::byte> p_src,
+                                   _Inout_ gsl::span<std::byte> p_dst) {
+  BOOST_LEAF_AUTO(_header, get_container_header(p_src));
+  const auto &[_options, _size] = _header;
+
+  if (p_dst.size() < _size) {
+    return W_FAILURE(std::errc::no_buffer_space,
+                     wolf::format("the destination is {} bytes but {} bytes are required",
+                                  p_dst.size(), _size));
+  }
+
+  const auto _codec = _options.options.codec;
+  BOOST_LEAF_CHECK(s_for_each_block(
+      p_src, _options, _size,
+      [&](const auto &p_payload, size_t p_position, size_t p_raw_size,
+          bool p_stored) -> boost::leaf::result<int> {
+        BOOST_LEAF_AUTO(_decompressed,
+                        s_decompress(p_payload, p_dst.subspan(p_position, p_raw_size),
+                                     p_stored ? w_compressor_codec::STORED : _codec));
+        if (_decompressed != p_raw_size) {
+          return W_FAILURE(std::errc::operation_canceled,
+                           wolf::format("decompressed {} bytes but {} bytes were expected",
+                                        _decompressed, p_raw_size));
+        }
+        return 0;
+      }));
+  return gsl::narrow_cast<size_t>(_size);
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_compressor::decompress_container(_In_ const gsl::span<const std::byte> p_src) {
+  BOOST_LEAF_AUTO(_header, get_container_header(p_src));
+  BOOST_LEAF_AUTO(_dst, s_allocate_dst(std::get<1>(_header)));
+
+  BOOST_LEAF_CHECK(decompress_container(p_src, _dst));
+  return _dst;
+}
+
+boost::leaf::result<size_t>
+w_compressor::verify_container(_In_ const gsl::span<const std::byte> p_src) {
+  BOOST_LEAF_AUTO(_header, get_container_header(p_src));
+  const auto &[_options, _size] = _header;
+
+  return s_for_each_block(p_src, _options, _size,
+                          [](const auto &, size_t, size_t, bool) -> boost::leaf::result<int> {
+                            return 0;
+                          });
+}
+
+#endif // WOLF_SYSTEM_LZ4 || WOLF_SYSTEM_LZMA || WOLF_SYSTEM_ZLIB
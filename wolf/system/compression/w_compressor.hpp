@@ -0,0 +1,211 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+
+#include <wolf/wolf.hpp>
+
+#include "w_checksum.hpp"
+
+namespace wolf::system::compression {
+
+// the codec which is stored in the header of compressed stream
+enum class w_compressor_codec : uint8_t {
+  // the source is stored without compression
+  STORED = 0,
+  // lz4 fast mode, the level is the acceleration (1 - 65536)
+  LZ4,
+  // lz4 high compression mode, the level is between 3 - 12
+  LZ4_HC,
+  // lzma2, the level is between 0 - 9
+  LZMA2,
+  // raw deflate, the level is between 0 - 9
+  DEFLATE,
+};
+
+struct w_compressor_options {
+  w_compressor_codec codec = w_compressor_codec::STORED;
+  int level = 0;
+};
+
+// the measurement of a codec on a sample of data
+struct w_compressor_stats {
+  w_compressor_options options = {};
+  // the size of measured sample
+  size_t src_size = 0;
+  // the size of compressed sample including the header
+  size_t compressed_size = 0;
+  // the source size divided by the compressed size
+  double ratio = 0.0;
+  // the throughput of compression in MB/s of source
+  double compress_mbps = 0.0;
+  // the throughput of decompression in MB/s of source
+  double decompress_mbps = 0.0;
+};
+
+/*
+ * the policy of choosing a codec, the candidates are measured on a sample of source.
+ * When a throughput is requested, the best ratio which is fast enough wins,
+ * otherwise the fastest codec which reaches the ratio wins
+ */
+struct w_compressor_policy {
+  // the minimum throughput of compression in MB/s, zero means no limit
+  double min_compress_mbps = 0.0;
+  // the minimum ratio of compression, zero means no limit
+  double min_ratio = 0.0;
+  // the size of sample which is taken from a few places of source
+  size_t sample_size = 256 * 1024;
+  // the codecs to measure, empty means the default levels of all available codecs
+  std::vector<w_compressor_options> candidates = {};
+};
+
+/*
+ * the options of a checked container, the source is split into blocks and
+ * each compressed block is stored with its checksum, so a corruption is detected
+ * before the block is decoded
+ */
+struct w_compressor_container_options {
+  // the codec of each block
+  w_compressor_options options = {};
+  // the size of each uncompressed block
+  uint32_t block_size = 1024 * 1024;
+  // the checksum of each compressed block
+  w_checksum_type checksum = w_checksum_type::CRC32C;
+  // store the blocks which are estimated as incompressible without compressing them
+  bool skip_incompressible = true;
+};
+
+struct w_compressor {
+  /*
+   * check whether a codec was compiled in
+   * @param p_codec, the codec
+   * @returns true if the codec is available
+   */
+  W_API static bool is_available(_In_ w_compressor_codec p_codec) noexcept;
+
+  /*
+   * get the default candidates of all available codecs
+   * @returns the vector of candidates
+   */
+  W_API static std::vector<w_compressor_options> get_default_candidates();
+
+  /*
+   * release the encoders which the calling thread keeps between calls, the next call of the
+   * thread creates them again
+   */
+  W_API static void release_thread_cache() noexcept;
+
+  /*
+   * compress with a self-describing header which keeps the codec, level and original size
+   * @param p_src, the input source
+   * @param p_options, the codec and its level
+   * @returns the vector of compressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  compress(_In_ const gsl::span<const std::byte> p_src, _In_ const w_compressor_options &p_options);
+
+  /*
+   * choose a codec via the policy and compress with it,
+   * an incompressible source is stored without measuring the codecs
+   * @param p_src, the input source
+   * @param p_policy, the policy of choosing codec
+   * @returns the vector of compressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  compress(_In_ const gsl::span<const std::byte> p_src, _In_ const w_compressor_policy &p_policy);
+
+  /*
+   * get the codec, level and original size from the header of compressed stream
+   * @param p_src, the compressed stream
+   * @returns the options of codec and the decompressed size
+   */
+  W_API static boost::leaf::result<std::tuple<w_compressor_options, uint64_t>>
+  get_header(_In_ const gsl::span<const std::byte> p_src) noexcept;
+
+  /*
+   * decompress a stream of any codec, the codec is detected from the header
+   * @param p_src, the compressed stream
+   * @param p_dst, the destination which must have at least the decompressed size
+   * @returns number of decompressed bytes
+   */
+  W_API static boost::leaf::result<size_t> decompress(_In_ const gsl::span<const std::byte> p_src,
+                                                      _Inout_ gsl::span<std::byte> p_dst);
+
+  /*
+   * decompress a stream of any codec, the codec is detected from the header
+   * @param p_src, the compressed stream
+   * @returns the vector of decompressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  decompress(_In_ const gsl::span<const std::byte> p_src);
+
+  /*
+   * measure the ratio and throughput of candidates
+   * @param p_src, the data which is measured as a whole
+   * @param p_candidates, the candidates, empty means the default candidates
+   * @returns the stats of each candidate
+   */
+  W_API static boost::leaf::result<std::vector<w_compressor_stats>>
+  measure(_In_ const gsl::span<const std::byte> p_src,
+          _In_ const std::vector<w_compressor_options> &p_candidates = {});
+
+  /*
+   * choose a codec for the source via the policy
+   * @param p_src, the input source which is sampled
+   * @param p_policy, the policy of choosing codec
+   * @returns the stats of chosen codec
+   */
+  W_API static boost::leaf::result<w_compressor_stats>
+  select(_In_ const gsl::span<const std::byte> p_src, _In_ const w_compressor_policy &p_policy);
+
+  /*
+   * compress into a checked container of blocks
+   * @param p_src, the input source
+   * @param p_options, the codec, the block size and the checksum
+   * @returns the vector of container
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  compress_container(_In_ const gsl::span<const std::byte> p_src,
+                     _In_ const w_compressor_container_options &p_options);
+
+  /*
+   * get the options and original size from the header of a checked container
+   * @param p_src, the container
+   * @returns the options of container and the decompressed size
+   */
+  W_API static boost::leaf::result<std::tuple<w_compressor_container_options, uint64_t>>
+  get_container_header(_In_ const gsl::span<const std::byte> p_src) noexcept;
+
+  /*
+   * decompress a checked container, the checksum of each block is verified before decoding it
+   * @param p_src, the container
+   * @param p_dst, the destination which must have at least the decompressed size
+   * @returns number of decompressed bytes
+   */
+  W_API static boost::leaf::result<size_t>
+  decompress_container(_In_ const gsl::span<const std::byte> p_src,
+                       _Inout_ gsl::span<std::byte> p_dst);
+
+  /*
+   * decompress a checked container, the checksum of each block is verified before decoding it
+   * @param p_src, the container
+   * @returns the vector of decompressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  decompress_container(_In_ const gsl::span<const std::byte> p_src);
+
+  /*
+   * verify the header and the checksum of all blocks without decompressing them
+   * @param p_src, the container
+   * @returns the number of verified blocks
+   */
+  W_API static boost::leaf::result<size_t>
+  verify_container(_In_ const gsl::span<const std::byte> p_src);
+};
+} // namespace wolf::system::compression
+
+#endif // WOLF_SYSTEM_LZ4 || WOLF_SYSTEM_LZMA || WOLF_SYSTEM_ZLIB
@@ -0,0 +1,92 @@
+#include "w_entropy.hpp"
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+using w_entropy = wolf::system::compression::w_entropy;
+using w_entropy_estimate = wolf::system::compression::w_entropy_estimate;
+using w_entropy_options = wolf::system::compression::w_entropy_options;
+
+// the number of places which a sample is taken from
+constexpr auto ENTROPY_SAMPLE_SLICES = size_t(8);
+// the length of sequences which are looked up for matches, same as the minimum match of lz4
+constexpr auto ENTROPY_MATCH_LENGTH = sizeof(uint32_t);
+// the bits of hash table of sequences
+constexpr auto ENTROPY_HASH_LOG = 12;
+
+static uint32_t s_load_u32(_In_ const std::byte *p_src) noexcept {
+  uint32_t _value = 0;
+  std::memcpy(&_value, p_src, sizeof(_value));
+  return _value;
+}
+
+w_entropy_estimate w_entropy::estimate(_In_ const gsl::span<const std::byte> p_src,
+                                       _In_ size_t p_sample_size) noexcept {
+  w_entropy_estimate _estimate = {};
+  if (p_src.empty()) {
+    return _estimate;
+  }
+
+  // contiguous slices keep the nearby repeats which a codec would find
+  auto _slices = ENTROPY_SAMPLE_SLICES;
+  auto _slice_size = p_sample_size / ENTROPY_SAMPLE_SLICES;
+  if (p_sample_size == 0 || p_src.size() <= p_sample_size || _slice_size < ENTROPY_MATCH_LENGTH) {
+    _slices = 1;
+    _slice_size = p_src.size();
+  }
+  const auto _stride = p_src.size() / _slices;
+
+  std::array<uint32_t, 256> _histogram = {};
+  std::array<uint32_t, size_t(1) << ENTROPY_HASH_LOG> _table = {};
+  size_t _positions = 0;
+  size_t _matches = 0;
+
+  for (size_t s = 0; s < _slices; ++s) {
+    const auto _slice = p_src.subspan(s * _stride, _slice_size);
+    for (const auto _byte : _slice) {
+      ++_histogram[std::to_integer<uint8_t>(_byte)];
+    }
+
+    if (_slice.size() < ENTROPY_MATCH_LENGTH) {
+      continue;
+    }
+    const auto _last = _slice.size() - ENTROPY_MATCH_LENGTH;
+    for (size_t i = 0; i <= _last; ++i) {
+      const auto _value = s_load_u32(_slice.data() + i);
+      const auto _hash = (_value * 2654435761U) >> (32 - ENTROPY_HASH_LOG);
+      _matches += _table[_hash] == _value ? 1 : 0;
+      _table[_hash] = _value;
+    }
+    _positions += _last + 1;
+  }
+
+  const auto _total = gsl::narrow_cast<double>(std::min(p_src.size(), _slices * _slice_size));
+  for (const auto _count : _histogram) {
+    if (_count > 0) {
+      const auto _p = _count / _total;
+      _estimate.bits_per_byte -= _p * std::log2(_p);
+    }
+  }
+  if (_positions > 0) {
+    _estimate.match_ratio =
+        gsl::narrow_cast<double>(_matches) / gsl::narrow_cast<double>(_positions);
+  }
+  return _estimate;
+}
+
+bool w_entropy::is_compressible(_In_ const gsl::span<const std::byte> p_src,
+                                _In_ const w_entropy_options &p_options) noexcept {
+  // the estimate of a few bytes is not reliable, so let the codec decide
+  if (p_src.size() < p_options.min_size) {
+    return true;
+  }
+
+  const auto _estimate = estimate(p_src, p_options.sample_size);
+  return _estimate.bits_per_byte < p_options.max_bits_per_byte ||
+         _estimate.match_ratio >= p_options.min_match_ratio;
+}
+
+#endif // WOLF_SYSTEM_LZ4 || WOLF_SYSTEM_LZMA || WOLF_SYSTEM_ZLIB
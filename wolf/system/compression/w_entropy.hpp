@@ -0,0 +1,56 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+
+#include <wolf/wolf.hpp>
+
+namespace wolf::system::compression {
+
+// the compressibility of a source which is estimated from a sample
+struct w_entropy_estimate {
+  // the order-0 entropy of sampled bytes, between 0 - 8
+  double bits_per_byte = 0.0;
+  // the ratio of sampled positions which repeat an earlier 4 bytes sequence, between 0 - 1
+  double match_ratio = 0.0;
+};
+
+struct w_entropy_options {
+  // the number of sampled bytes, zero means the whole source
+  size_t sample_size = 16 * 1024;
+  // a source below this entropy is compressible
+  double max_bits_per_byte = 7.5;
+  // a source with this ratio of repeated sequences is compressible regardless of its entropy
+  double min_match_ratio = 0.05;
+  // a source smaller than this size is always handed to the codec
+  size_t min_size = 256;
+};
+
+struct w_entropy {
+  /*
+   * estimate the compressibility from a few evenly spaced slices of source,
+   * the cost does not depend on the size of source
+   * @param p_src, the input source
+   * @param p_sample_size, the number of sampled bytes, zero means the whole source
+   * @returns the estimate
+   */
+  W_API static w_entropy_estimate estimate(_In_ const gsl::span<const std::byte> p_src,
+                                           _In_ size_t p_sample_size = 16 * 1024) noexcept;
+
+  /*
+   * decide whether compressing the source is worth the cpu time,
+   * already encoded data such as video packets or archives is reported as incompressible
+   * @param p_src, the input source
+   * @param p_options, the options of estimation
+   * @returns false if the source should be stored without compression
+   */
+  W_API static bool is_compressible(_In_ const gsl::span<const std::byte> p_src,
+                                    _In_ const w_entropy_options &p_options = {}) noexcept;
+};
+} // namespace wolf::system::compression
+
+#endif // WOLF_SYSTEM_LZ4 || WOLF_SYSTEM_LZMA || WOLF_SYSTEM_ZLIB
@@ -2,11 +2,35 @@
 
 #ifdef WOLF_SYSTEM_LZ4
 
+#include "w_entropy.hpp"
+
 #include <DISABLE_ANALYSIS_BEGIN>
 #include <lz4.h>
+#include <lz4hc.h>
+#include <lz4frame.h>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <DISABLE_ANALYSIS_END>
 
+#include <atomic>
+#include <cstring>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+using w_entropy = wolf::system::compression::w_entropy;
 using w_lz4 = wolf::system::compression::w_lz4;
+using w_lz4_blocks = wolf::system::compression::w_lz4_blocks;
+using w_lz4_blocks_options = wolf::system::compression::w_lz4_blocks_options;
+using w_lz4_blocks_reader = wolf::system::compression::w_lz4_blocks_reader;
+using w_lz4_dict = wolf::system::compression::w_lz4_dict;
+using w_lz4_encoder = wolf::system::compression::w_lz4_encoder;
+using w_lz4_mode = wolf::system::compression::w_lz4_mode;
+using w_lz4_frame_compressor = wolf::system::compression::w_lz4_frame_compressor;
+using w_lz4_frame_decompressor = wolf::system::compression::w_lz4_frame_decompressor;
+using w_lz4_frame_options = wolf::system::compression::w_lz4_frame_options;
+using w_lz4_frame_progress = wolf::system::compression::w_lz4_frame_progress;
 
 static boost::leaf::result<int>
 s_check_input_len(_In_ const size_t p_src_size) noexcept {
@@ -85,6 +109,29 @@ w_lz4::compress_fast(_In_ const gsl::span<const std::byte> p_src,
   return W_FAILURE(std::errc::operation_canceled, "lz4 compress fast failed");
 }
 
+boost::leaf::result<std::vector<std::byte>>
+w_lz4::compress_hc(_In_ const gsl::span<const std::byte> p_src, _In_ const int p_level) noexcept {
+  const auto _src_size = p_src.size();
+  if (_src_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the source is empty");
+  }
+
+  BOOST_LEAF_CHECK(s_check_input_len(_src_size));
+
+  const auto _dst_capacity = LZ4_compressBound(gsl::narrow_cast<int>(_src_size));
+  std::vector<std::byte> _tmp;
+  _tmp.resize(_dst_capacity);
+
+  const auto _bytes = LZ4_compress_HC(
+      reinterpret_cast<const char *>(p_src.data()), reinterpret_cast<char *>(_tmp.data()),
+      gsl::narrow_cast<int>(_src_size), _dst_capacity, p_level);
+  if (_bytes > 0) {
+    return s_shrink_to_fit(_tmp, _bytes);
+  }
+
+  return W_FAILURE(std::errc::operation_canceled, "lz4 compress hc failed");
+}
+
 boost::leaf::result<std::vector<std::byte>>
 w_lz4::decompress(_In_ const gsl::span<const std::byte> p_src,
                   _In_ const size_t p_max_retry) noexcept {
@@ -123,4 +170,911 @@ w_lz4::decompress(_In_ const gsl::span<const std::byte> p_src,
                    "could not decompress lz4 stream after " + _max_retry_str);
 }
 
+constexpr auto LZ4_SIZED_HEADER_SIZE = sizeof(uint32_t);
+// the sizes never reach LZ4_MAX_INPUT_SIZE, so the high bit marks a stored block
+constexpr auto LZ4_STORED_FLAG = uint32_t(0x80000000);
+
+boost::leaf::result<std::vector<std::byte>>
+w_lz4::compress_sized(_In_ const gsl::span<const std::byte> p_src,
+                      _In_ const int p_acceleration) noexcept {
+  const auto _src_size = p_src.size();
+  if (_src_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the source is empty");
+  }
+
+  BOOST_LEAF_CHECK(s_check_input_len(_src_size));
+
+  // compress right after the header, so there is no need for an extra copy
+  const auto _dst_capacity = LZ4_compressBound(gsl::narrow_cast<int>(_src_size));
+  std::vector<std::byte> _dst;
+  _dst.resize(LZ4_SIZED_HEADER_SIZE + _dst_capacity);
+
+  const auto _write_header = [&](uint32_t p_header) {
+    for (size_t i = 0; i < LZ4_SIZED_HEADER_SIZE; ++i) {
+      gsl::at(_dst, i) = std::byte((p_header >> (i * 8)) & 0xFF);
+    }
+  };
+
+  auto _bytes = 0;
+  if (w_entropy::is_compressible(p_src)) {
+    _bytes = LZ4_compress_fast(reinterpret_cast<const char *>(p_src.data()),
+                               reinterpret_cast<char *>(_dst.data() + LZ4_SIZED_HEADER_SIZE),
+                               gsl::narrow_cast<int>(_src_size), _dst_capacity, p_acceleration);
+    if (_bytes <= 0) {
+      return W_FAILURE(std::errc::operation_canceled, "lz4 compress sized failed");
+    }
+  }
+
+  // there is no gain, so store the source as is
+  if (_bytes == 0 || gsl::narrow_cast<size_t>(_bytes) >= _src_size) {
+    _write_header(gsl::narrow_cast<uint32_t>(_src_size) | LZ4_STORED_FLAG);
+    std::copy(p_src.begin(), p_src.end(), _dst.begin() + LZ4_SIZED_HEADER_SIZE);
+    _dst.resize(LZ4_SIZED_HEADER_SIZE + _src_size);
+    return _dst;
+  }
+
+  _write_header(gsl::narrow_cast<uint32_t>(_src_size));
+  _dst.resize(LZ4_SIZED_HEADER_SIZE + _bytes);
+  return _dst;
+}
+
+boost::leaf::result<size_t>
+w_lz4::get_decompressed_size(_In_ const gsl::span<const std::byte> p_src) noexcept {
+  if (p_src.size() < LZ4_SIZED_HEADER_SIZE) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid lz4 sized header");
+  }
+
+  size_t _size = 0;
+  for (size_t i = 0; i < LZ4_SIZED_HEADER_SIZE; ++i) {
+    _size |= std::to_integer<size_t>(gsl::at(p_src, i)) << (i * 8);
+  }
+  _size &= ~size_t(LZ4_STORED_FLAG);
+
+  BOOST_LEAF_CHECK(s_check_input_len(_size));
+  return _size;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_lz4::decompress_sized(_In_ const gsl::span<const std::byte> p_src) noexcept {
+  BOOST_LEAF_AUTO(_size, get_decompressed_size(p_src));
+
+  std::vector<std::byte> _dst;
+  _dst.resize(_size);
+
+  BOOST_LEAF_CHECK(decompress_into(p_src, _dst));
+  return _dst;
+}
+
+boost::leaf::result<size_t>
+w_lz4::decompress_into(_In_ const gsl::span<const std::byte> p_src,
+                       _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  BOOST_LEAF_AUTO(_size, get_decompressed_size(p_src));
+  if (p_dst.size() < _size) {
+    return W_FAILURE(std::errc::no_buffer_space,
+                     "the destination is smaller than the lz4 decompressed size");
+  }
+  if (_size == 0) {
+    return 0;
+  }
+
+  const auto _payload = p_src.subspan(LZ4_SIZED_HEADER_SIZE);
+  // the flag is the high bit of the last byte of header
+  const auto _stored = (std::to_integer<uint32_t>(gsl::at(p_src, LZ4_SIZED_HEADER_SIZE - 1)) &
+                        (LZ4_STORED_FLAG >> 24)) != 0;
+  if (_stored) {
+    if (_payload.size() != _size) {
+      return W_FAILURE(std::errc::invalid_argument, "the stored lz4 sized block is truncated");
+    }
+    std::copy(_payload.begin(), _payload.end(), p_dst.begin());
+    return _size;
+  }
+
+  const auto _bytes = LZ4_decompress_safe(
+      reinterpret_cast<const char *>(_payload.data()), reinterpret_cast<char *>(p_dst.data()),
+      gsl::narrow_cast<int>(_payload.size()), gsl::narrow_cast<int>(_size));
+  if (_bytes >= 0 && gsl::narrow_cast<size_t>(_bytes) == _size) {
+    return _size;
+  }
+
+  return W_FAILURE(std::errc::operation_canceled, "lz4 decompress sized failed");
+}
+
+// footer of blocks: original size (8 bytes), block size (4 bytes), blocks count (4 bytes), magic
+constexpr auto LZ4_BLOCKS_MAGIC = uint32_t(0x34424C57); // "WLB4"
+constexpr auto LZ4_BLOCKS_FOOTER_SIZE = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+// each entry is the compressed size of a block, LZ4_STORED_FLAG marks a stored block
+constexpr auto LZ4_BLOCKS_INDEX_ENTRY_SIZE = sizeof(uint32_t);
+
+template <typename T>
+static void s_write_le(_Inout_ std::byte *p_dst, _In_ T p_value) noexcept {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    p_dst[i] = std::byte((p_value >> (i * 8)) & 0xFF);
+  }
+}
+
+template <typename T> static T s_read_le(_In_ const std::byte *p_src) noexcept {
+  T _value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    _value |= std::to_integer<T>(p_src[i]) << (i * 8);
+  }
+  return _value;
+}
+
+/*
+ * run p_func for each index in [0, p_count) over a thread pool,
+ * workers pull the next index from a shared counter, so uneven blocks are balanced
+ */
+template <typename F>
+static bool s_parallel_for(_In_ size_t p_count, _In_ size_t p_threads, _In_ F &&p_func) noexcept {
+  if (p_threads == 0) {
+    p_threads = std::max(size_t(1), gsl::narrow_cast<size_t>(std::thread::hardware_concurrency()));
+  }
+  p_threads = std::min(p_threads, p_count);
+
+  std::atomic<size_t> _next = 0;
+  std::atomic<bool> _succeeded = true;
+  const auto _worker = [&]() noexcept {
+    for (auto i = _next.fetch_add(1); i < p_count && _succeeded; i = _next.fetch_add(1)) {
+      if (!p_func(i)) {
+        _succeeded = false;
+      }
+    }
+  };
+
+  if (p_threads <= 1) {
+    _worker();
+    return _succeeded;
+  }
+
+  try {
+    // the calling thread is one of the workers
+    boost::asio::thread_pool _pool(p_threads - 1);
+    for (size_t i = 1; i < p_threads; ++i) {
+      boost::asio::post(_pool, _worker);
+    }
+    _worker();
+    _pool.join();
+  } catch (...) {
+    return false;
+  }
+  return _succeeded;
+}
+
+static boost::leaf::result<int> s_parse_blocks(_In_ const gsl::span<const std::byte> p_src,
+                                               _Out_ uint64_t &p_size, _Out_ size_t &p_block_size,
+                                               _Out_ std::vector<uint64_t> &p_offsets,
+                                               _Out_ std::vector<bool> &p_stored) noexcept {
+  const auto _src_size = p_src.size();
+  if (_src_size < LZ4_BLOCKS_FOOTER_SIZE) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid lz4 blocks footer");
+  }
+
+  const auto _footer = p_src.data() + _src_size - LZ4_BLOCKS_FOOTER_SIZE;
+  p_size = s_read_le<uint64_t>(_footer);
+  p_block_size = s_read_le<uint32_t>(_footer + sizeof(uint64_t));
+  const auto _count = s_read_le<uint32_t>(_footer + sizeof(uint64_t) + sizeof(uint32_t));
+  const auto _magic = s_read_le<uint32_t>(_footer + sizeof(uint64_t) + 2 * sizeof(uint32_t));
+
+  if (_magic != LZ4_BLOCKS_MAGIC || p_block_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid lz4 blocks footer");
+  }
+  // the count is computed without rounding up by an add, which wraps for a forged size
+  const auto _expected_count = p_size / p_block_size + (p_size % p_block_size != 0 ? 1 : 0);
+  if (_count != _expected_count || p_size > uint64_t(_count) * p_block_size) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid lz4 blocks footer");
+  }
+
+  const auto _index_size = uint64_t(_count) * LZ4_BLOCKS_INDEX_ENTRY_SIZE;
+  if (_index_size > _src_size - LZ4_BLOCKS_FOOTER_SIZE) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid lz4 blocks index");
+  }
+
+  // prefix sum of compressed sizes
+  const auto _index_pos = _src_size - LZ4_BLOCKS_FOOTER_SIZE - _index_size;
+  const auto _index = p_src.data() + _index_pos;
+  try {
+    p_offsets.resize(_count + 1);
+    p_stored.resize(_count);
+  } catch (...) {
+    return W_FAILURE(std::errc::not_enough_memory, "could not allocate lz4 blocks index");
+  }
+  p_offsets[0] = 0;
+  for (size_t i = 0; i < _count; ++i) {
+    const auto _entry = s_read_le<uint32_t>(_index + i * LZ4_BLOCKS_INDEX_ENTRY_SIZE);
+    p_offsets[i + 1] = p_offsets[i] + (_entry & ~LZ4_STORED_FLAG);
+    p_stored[i] = (_entry & LZ4_STORED_FLAG) != 0;
+  }
+  if (p_offsets[_count] != _index_pos) {
+    return W_FAILURE(std::errc::invalid_argument, "lz4 blocks index does not match the payload");
+  }
+  return 0;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_lz4_blocks::compress(_In_ const gsl::span<const std::byte> p_src,
+                       _In_ const w_lz4_blocks_options &p_options) noexcept {
+  const auto _src_size = p_src.size();
+  if (_src_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the source is empty");
+  }
+  if (p_options.block_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the block size is zero");
+  }
+  BOOST_LEAF_CHECK(s_check_input_len(p_options.block_size));
+
+  const auto _block_size = p_options.block_size;
+  const auto _count = (_src_size + _block_size - 1) / _block_size;
+  if (_count > std::numeric_limits<uint32_t>::max()) {
+    return W_FAILURE(std::errc::invalid_argument, "too many lz4 blocks, increase the block size");
+  }
+
+  // each block has its own slot, so workers never share the destination
+  const auto _bound = gsl::narrow_cast<size_t>(LZ4_compressBound(gsl::narrow_cast<int>(_block_size)));
+  std::vector<std::byte> _dst;
+  std::vector<uint32_t> _sizes;
+  try {
+    _dst.resize(_count * _bound + _count * LZ4_BLOCKS_INDEX_ENTRY_SIZE + LZ4_BLOCKS_FOOTER_SIZE);
+    _sizes.resize(_count);
+  } catch (...) {
+    return W_FAILURE(std::errc::not_enough_memory, "could not allocate lz4 blocks");
+  }
+
+  const auto _succeeded = s_parallel_for(_count, p_options.threads, [&](size_t p_index) {
+    const auto _offset = p_index * _block_size;
+    const auto _len = std::min(_block_size, _src_size - _offset);
+    const auto _block = p_src.subspan(_offset, _len);
+    auto *const _slot = _dst.data() + p_index * _bound;
+
+    auto _bytes = 0;
+    if (!p_options.skip_incompressible || w_entropy::is_compressible(_block)) {
+      _bytes = LZ4_compress_fast(reinterpret_cast<const char *>(_block.data()),
+                                 reinterpret_cast<char *>(_slot), gsl::narrow_cast<int>(_len),
+                                 gsl::narrow_cast<int>(_bound), p_options.acceleration);
+      if (_bytes <= 0) {
+        return false;
+      }
+    }
+
+    // there is no gain, so store the block as is
+    if (_bytes == 0 || gsl::narrow_cast<size_t>(_bytes) >= _len) {
+      std::copy(_block.begin(), _block.end(), _slot);
+      _sizes[p_index] = gsl::narrow_cast<uint32_t>(_len) | LZ4_STORED_FLAG;
+      return true;
+    }
+    _sizes[p_index] = gsl::narrow_cast<uint32_t>(_bytes);
+    return true;
+  });
+  if (!_succeeded) {
+    return W_FAILURE(std::errc::operation_canceled, "lz4 compress blocks failed");
+  }
+
+  // compact the slots in place, each block only moves toward the beginning
+  size_t _pos = 0;
+  for (size_t i = 0; i < _count; ++i) {
+    const auto _size = _sizes[i] & ~LZ4_STORED_FLAG;
+    std::memmove(_dst.data() + _pos, _dst.data() + i * _bound, _size);
+    _pos += _size;
+  }
+
+  // append the trailing index and footer
+  for (size_t i = 0; i < _count; ++i) {
+    s_write_le(_dst.data() + _pos, _sizes[i]);
+    _pos += LZ4_BLOCKS_INDEX_ENTRY_SIZE;
+  }
+  s_write_le(_dst.data() + _pos, gsl::narrow_cast<uint64_t>(_src_size));
+  _pos += sizeof(uint64_t);
+  s_write_le(_dst.data() + _pos, gsl::narrow_cast<uint32_t>(_block_size));
+  _pos += sizeof(uint32_t);
+  s_write_le(_dst.data() + _pos, gsl::narrow_cast<uint32_t>(_count));
+  _pos += sizeof(uint32_t);
+  s_write_le(_dst.data() + _pos, LZ4_BLOCKS_MAGIC);
+  _pos += sizeof(uint32_t);
+
+  _dst.resize(_pos);
+  return _dst;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_lz4_blocks::decompress(_In_ const gsl::span<const std::byte> p_src,
+                         _In_ size_t p_threads) noexcept {
+  uint64_t _size = 0;
+  size_t _block_size = 0;
+  std::vector<uint64_t> _offsets;
+  std::vector<bool> _stored;
+  BOOST_LEAF_CHECK(s_parse_blocks(p_src, _size, _block_size, _offsets, _stored));
+
+  std::vector<std::byte> _dst;
+  try {
+    _dst.resize(_size);
+  } catch (...) {
+    return W_FAILURE(std::errc::not_enough_memory, "could not allocate lz4 blocks destination");
+  }
+
+  const auto _count = _offsets.size() - 1;
+  const auto _succeeded = s_parallel_for(_count, p_threads, [&](size_t p_index) {
+    const auto _offset = p_index * _block_size;
+    const auto _len = gsl::narrow_cast<int>(std::min<uint64_t>(_block_size, _size - _offset));
+    const auto _block_src_size = gsl::narrow_cast<int>(_offsets[p_index + 1] - _offsets[p_index]);
+    if (_stored[p_index]) {
+      if (_block_src_size != _len) {
+        return false;
+      }
+      std::copy_n(p_src.begin() + gsl::narrow_cast<ptrdiff_t>(_offsets[p_index]), _len,
+                  _dst.begin() + gsl::narrow_cast<ptrdiff_t>(_offset));
+      return true;
+    }
+    const auto _bytes = LZ4_decompress_safe(
+        reinterpret_cast<const char *>(p_src.data() + _offsets[p_index]),
+        reinterpret_cast<char *>(_dst.data() + _offset), _block_src_size, _len);
+    return _bytes == _len;
+  });
+  if (!_succeeded) {
+    return W_FAILURE(std::errc::operation_canceled, "lz4 decompress blocks failed");
+  }
+  return _dst;
+}
+
+boost::leaf::result<int> w_lz4_blocks_reader::init(_In_ const gsl::span<const std::byte> p_src) noexcept {
+  BOOST_LEAF_CHECK(
+      s_parse_blocks(p_src, this->_size, this->_block_size, this->_offsets, this->_stored));
+  this->_src = p_src;
+  return 0;
+}
+
+boost::leaf::result<size_t> w_lz4_blocks_reader::read(_In_ uint64_t p_offset,
+                                                      _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_offsets.empty()) {
+    return W_FAILURE(std::errc::operation_not_permitted, "lz4 blocks reader was not initialized");
+  }
+  if (p_offset >= this->_size) {
+    return 0;
+  }
+
+  const auto _len = gsl::narrow_cast<size_t>(
+      std::min<uint64_t>(p_dst.size(), this->_size - p_offset));
+
+  size_t _written = 0;
+  while (_written < _len) {
+    const auto _pos = p_offset + _written;
+    const auto _index = gsl::narrow_cast<size_t>(_pos / this->_block_size);
+    const auto _in_block = gsl::narrow_cast<size_t>(_pos % this->_block_size);
+    const auto _block_len = gsl::narrow_cast<size_t>(
+        std::min<uint64_t>(this->_block_size, this->_size - uint64_t(_index) * this->_block_size));
+    const auto _bytes = std::min(_block_len - _in_block, _len - _written);
+
+    const auto _block_src = reinterpret_cast<const char *>(this->_src.data() + this->_offsets[_index]);
+    const auto _block_src_size =
+        gsl::narrow_cast<int>(this->_offsets[_index + 1] - this->_offsets[_index]);
+
+    if (this->_stored[_index]) {
+      // a stored block is copied as is
+      if (gsl::narrow_cast<size_t>(_block_src_size) != _block_len) {
+        return W_FAILURE(std::errc::operation_canceled, "lz4 blocks reader found a bad block");
+      }
+      const auto _range = this->_src.subspan(
+          gsl::narrow_cast<size_t>(this->_offsets[_index]) + _in_block, _bytes);
+      std::copy(_range.begin(), _range.end(), p_dst.begin() + _written);
+    } else if (_in_block == 0 && _bytes == _block_len) {
+      // the whole block was requested, decode it in place
+      const auto _res =
+          LZ4_decompress_safe(_block_src, reinterpret_cast<char *>(p_dst.data() + _written),
+                              _block_src_size, gsl::narrow_cast<int>(_block_len));
+      if (_res != gsl::narrow_cast<int>(_block_len)) {
+        return W_FAILURE(std::errc::operation_canceled, "lz4 blocks reader could not decode block");
+      }
+    } else {
+      // decode only the prefix of block which is needed
+      const auto _target = _in_block + _bytes;
+      try {
+        this->_scratch.resize(this->_block_size);
+      } catch (...) {
+        return W_FAILURE(std::errc::not_enough_memory, "could not allocate lz4 blocks scratch");
+      }
+      const auto _res = LZ4_decompress_safe_partial(
+          _block_src, reinterpret_cast<char *>(this->_scratch.data()), _block_src_size,
+          gsl::narrow_cast<int>(_target), gsl::narrow_cast<int>(this->_scratch.size()));
+      if (_res < 0 || gsl::narrow_cast<size_t>(_res) < _target) {
+        return W_FAILURE(std::errc::operation_canceled, "lz4 blocks reader could not decode block");
+      }
+      std::copy_n(this->_scratch.begin() + _in_block, _bytes, p_dst.begin() + _written);
+    }
+    _written += _bytes;
+  }
+  return _written;
+}
+
+uint64_t w_lz4_blocks_reader::get_size() const noexcept { return this->_size; }
+
+size_t w_lz4_blocks_reader::get_block_size() const noexcept { return this->_block_size; }
+
+size_t w_lz4_blocks_reader::get_blocks_count() const noexcept {
+  return this->_offsets.empty() ? 0 : this->_offsets.size() - 1;
+}
+
+boost::leaf::result<int> w_lz4_encoder::init(_In_ w_lz4_mode p_mode, _In_ int p_level) noexcept {
+  _release();
+
+  if (p_mode == w_lz4_mode::HC) {
+    this->_stream_hc = LZ4_createStreamHC();
+    if (this->_stream_hc == nullptr) {
+      return W_FAILURE(std::errc::not_enough_memory, "could not create lz4hc stream");
+    }
+  } else {
+    this->_stream = LZ4_createStream();
+    if (this->_stream == nullptr) {
+      return W_FAILURE(std::errc::not_enough_memory, "could not create lz4 stream");
+    }
+  }
+
+  this->_mode = p_mode;
+  this->_level = p_level;
+  return 0;
+}
+
+boost::leaf::result<size_t> w_lz4_encoder::compress(_In_ const gsl::span<const std::byte> p_src,
+                                                    _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  const auto _src_size = p_src.size();
+  if (_src_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the source is empty");
+  }
+
+  BOOST_LEAF_CHECK(s_check_input_len(_src_size));
+
+  const auto _src = reinterpret_cast<const char *>(p_src.data());
+  const auto _dst = reinterpret_cast<char *>(p_dst.data());
+  const auto _dst_capacity =
+      gsl::narrow_cast<int>(std::min(p_dst.size(), size_t(LZ4_MAX_INPUT_SIZE)));
+
+  /*
+   * the states were initialized once, so only a fast reset is needed for each call. a reset
+   * stream has no history, so its first block is a plain block. these functions are exported
+   * by shared builds of lz4, unlike the *_extState*_fastReset ones
+   */
+  auto _bytes = 0;
+  if (this->_stream_hc != nullptr) {
+    LZ4_resetStreamHC_fast(this->_stream_hc, this->_level);
+    _bytes = LZ4_compress_HC_continue(this->_stream_hc, _src, _dst,
+                                      gsl::narrow_cast<int>(_src_size), _dst_capacity);
+  } else if (this->_stream != nullptr) {
+    LZ4_resetStream_fast(this->_stream);
+    _bytes = LZ4_compress_fast_continue(this->_stream, _src, _dst,
+                                        gsl::narrow_cast<int>(_src_size), _dst_capacity,
+                                        this->_level);
+  } else {
+    return W_FAILURE(std::errc::operation_not_permitted, "lz4 encoder was not initialized");
+  }
+
+  if (_bytes > 0) {
+    return gsl::narrow_cast<size_t>(_bytes);
+  }
+  return W_FAILURE(std::errc::operation_canceled, "lz4 encoder failed");
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_lz4_encoder::compress(_In_ const gsl::span<const std::byte> p_src) noexcept {
+  const auto _src_size = p_src.size();
+  if (_src_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the source is empty");
+  }
+
+  BOOST_LEAF_CHECK(s_check_input_len(_src_size));
+
+  std::vector<std::byte> _dst;
+  _dst.resize(LZ4_compressBound(gsl::narrow_cast<int>(_src_size)));
+
+  BOOST_LEAF_AUTO(_bytes, compress(p_src, _dst));
+  _dst.resize(_bytes);
+  return _dst;
+}
+
+void w_lz4_encoder::_release() noexcept {
+  if (this->_stream != nullptr) {
+    LZ4_freeStream(this->_stream);
+    this->_stream = nullptr;
+  }
+  if (this->_stream_hc != nullptr) {
+    LZ4_freeStreamHC(this->_stream_hc);
+    this->_stream_hc = nullptr;
+  }
+}
+
+void w_lz4_encoder::_move(_Inout_ w_lz4_encoder &&p_other) noexcept {
+  if (this == &p_other) {
+    return;
+  }
+  _release();
+  this->_stream = std::exchange(p_other._stream, nullptr);
+  this->_stream_hc = std::exchange(p_other._stream_hc, nullptr);
+  this->_mode = p_other._mode;
+  this->_level = p_other._level;
+}
+
+constexpr auto LZ4_DICT_MAX_SIZE = size_t(64 * 1024);
+constexpr auto LZ4_DICT_DMER_SIZE = sizeof(uint64_t);
+constexpr auto LZ4_DICT_SEGMENT_SIZE = size_t(64);
+
+static uint64_t s_load_dmer(_In_ const std::byte *p_src) noexcept {
+  uint64_t _dmer = 0;
+  std::memcpy(&_dmer, p_src, sizeof(_dmer));
+  return _dmer;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_lz4_dict::train(_In_ const std::vector<gsl::span<const std::byte>> &p_samples,
+                  _In_ size_t p_capacity) noexcept {
+  if (p_samples.empty() || p_capacity == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the samples or capacity is empty");
+  }
+  p_capacity = std::min(p_capacity, LZ4_DICT_MAX_SIZE);
+
+  struct segment {
+    uint64_t score;
+    size_t sample;
+    size_t pos;
+    size_t len;
+    bool operator<(const segment &p_other) const noexcept { return score < p_other.score; }
+  };
+
+  try {
+    // count in how many samples each d-mer appears
+    std::unordered_map<uint64_t, uint32_t> _freqs;
+    std::unordered_set<uint64_t> _seen;
+    for (const auto &_sample : p_samples) {
+      _seen.clear();
+      for (size_t i = 0; i + LZ4_DICT_DMER_SIZE <= _sample.size(); ++i) {
+        const auto _dmer = s_load_dmer(_sample.data() + i);
+        if (_seen.insert(_dmer).second) {
+          _freqs[_dmer]++;
+        }
+      }
+    }
+
+    // a d-mer which was seen in a single sample does not help the others
+    std::unordered_set<uint64_t> _covered;
+    const auto _score = [&](const segment &p_seg) {
+      uint64_t _sum = 0;
+      const auto _data = p_samples[p_seg.sample].data() + p_seg.pos;
+      for (size_t i = 0; i + LZ4_DICT_DMER_SIZE <= p_seg.len; ++i) {
+        const auto _dmer = s_load_dmer(_data + i);
+        if (_covered.contains(_dmer)) {
+          continue;
+        }
+        const auto _it = _freqs.find(_dmer);
+        if (_it != _freqs.end() && _it->second > 1) {
+          _sum += _it->second - 1;
+        }
+      }
+      return _sum;
+    };
+
+    // half-overlapped segments of each sample are the candidates
+    std::priority_queue<segment> _candidates;
+    for (size_t s = 0; s < p_samples.size(); ++s) {
+      const auto _size = p_samples[s].size();
+      if (_size < LZ4_DICT_DMER_SIZE) {
+        continue;
+      }
+      for (size_t _pos = 0; _pos < _size; _pos += LZ4_DICT_SEGMENT_SIZE / 2) {
+        auto _seg = segment{0, s, _pos, std::min(LZ4_DICT_SEGMENT_SIZE, _size - _pos)};
+        _seg.score = _score(_seg);
+        if (_seg.score > 0) {
+          _candidates.push(_seg);
+        }
+        if (_pos + LZ4_DICT_SEGMENT_SIZE >= _size) {
+          break;
+        }
+      }
+    }
+
+    // lazy greedy, a segment is re-scored against covered d-mers before selection
+    std::vector<segment> _selected;
+    size_t _dict_size = 0;
+    while (!_candidates.empty() && _dict_size < p_capacity) {
+      auto _seg = _candidates.top();
+      _candidates.pop();
+
+      _seg.score = _score(_seg);
+      if (_seg.score == 0) {
+        continue;
+      }
+      if (!_candidates.empty() && _seg.score < _candidates.top().score) {
+        _candidates.push(_seg);
+        continue;
+      }
+
+      _seg.len = std::min(_seg.len, p_capacity - _dict_size);
+      const auto _data = p_samples[_seg.sample].data() + _seg.pos;
+      for (size_t i = 0; i + LZ4_DICT_DMER_SIZE <= _seg.len; ++i) {
+        _covered.insert(s_load_dmer(_data + i));
+      }
+      _dict_size += _seg.len;
+      _selected.push_back(_seg);
+    }
+
+    if (_selected.empty()) {
+      return W_FAILURE(std::errc::invalid_argument,
+                       "could not find any common content between samples");
+    }
+
+    // lz4 finds the closest matches cheaper, so the best segment goes to the end
+    std::vector<std::byte> _dict;
+    _dict.reserve(_dict_size);
+    for (auto _it = _selected.crbegin(); _it != _selected.crend(); ++_it) {
+      const auto _data = p_samples[_it->sample].data() + _it->pos;
+      _dict.insert(_dict.end(), _data, _data + _it->len);
+    }
+    return _dict;
+  } catch (...) {
+    return W_FAILURE(std::errc::not_enough_memory, "could not train lz4 dictionary");
+  }
+}
+
+boost::leaf::result<int> w_lz4_dict::init(_In_ const gsl::span<const std::byte> p_dict,
+                                          _In_ int p_acceleration) noexcept {
+  _release();
+
+  // lz4 only uses the last 64KB of dictionary
+  const auto _dict = p_dict.last(std::min(p_dict.size(), LZ4_DICT_MAX_SIZE));
+  try {
+    this->_dict.assign(_dict.begin(), _dict.end());
+  } catch (...) {
+    return W_FAILURE(std::errc::not_enough_memory, "could not allocate lz4 dictionary");
+  }
+
+  this->_dict_stream = LZ4_createStream();
+  this->_stream = LZ4_createStream();
+  if (this->_dict_stream == nullptr || this->_stream == nullptr) {
+    _release();
+    return W_FAILURE(std::errc::not_enough_memory, "could not create lz4 streams");
+  }
+
+  LZ4_loadDict(this->_dict_stream, reinterpret_cast<const char *>(this->_dict.data()),
+               gsl::narrow_cast<int>(this->_dict.size()));
+  this->_acceleration = p_acceleration;
+  return 0;
+}
+
+boost::leaf::result<size_t> w_lz4_dict::compress(_In_ const gsl::span<const std::byte> p_src,
+                                                 _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_stream == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "lz4 dictionary was not initialized");
+  }
+  const auto _src_size = p_src.size();
+  if (_src_size == 0) {
+    return W_FAILURE(std::errc::invalid_argument, "the source is empty");
+  }
+  BOOST_LEAF_CHECK(s_check_input_len(_src_size));
+
+  // copy the hashed dictionary into the working stream instead of loading it again, which
+  // needs no static-only api of lz4 like LZ4_attach_dictionary
+  std::memcpy(this->_stream, this->_dict_stream, sizeof(LZ4_stream_t));
+
+  const auto _bytes = LZ4_compress_fast_continue(
+      this->_stream, reinterpret_cast<const char *>(p_src.data()),
+      reinterpret_cast<char *>(p_dst.data()), gsl::narrow_cast<int>(_src_size),
+      gsl::narrow_cast<int>(std::min(p_dst.size(), size_t(LZ4_MAX_INPUT_SIZE))),
+      this->_acceleration);
+  if (_bytes > 0) {
+    return gsl::narrow_cast<size_t>(_bytes);
+  }
+
+  return W_FAILURE(std::errc::operation_canceled, "lz4 compress with dictionary failed");
+}
+
+boost::leaf::result<size_t>
+w_lz4_dict::decompress(_In_ const gsl::span<const std::byte> p_src,
+                       _Inout_ gsl::span<std::byte> p_dst) const noexcept {
+  if (p_src.empty()) {
+    return W_FAILURE(std::errc::invalid_argument, "the source is empty");
+  }
+
+  const auto _bytes = LZ4_decompress_safe_usingDict(
+      reinterpret_cast<const char *>(p_src.data()), reinterpret_cast<char *>(p_dst.data()),
+      gsl::narrow_cast<int>(p_src.size()),
+      gsl::narrow_cast<int>(std::min(p_dst.size(), size_t(LZ4_MAX_INPUT_SIZE))),
+      reinterpret_cast<const char *>(this->_dict.data()), gsl::narrow_cast<int>(this->_dict.size()));
+  if (_bytes >= 0) {
+    return gsl::narrow_cast<size_t>(_bytes);
+  }
+
+  return W_FAILURE(std::errc::operation_canceled, "lz4 decompress with dictionary failed");
+}
+
+gsl::span<const std::byte> w_lz4_dict::get_dict() const noexcept { return this->_dict; }
+
+void w_lz4_dict::_release() noexcept {
+  if (this->_stream != nullptr) {
+    LZ4_freeStream(this->_stream);
+    this->_stream = nullptr;
+  }
+  if (this->_dict_stream != nullptr) {
+    LZ4_freeStream(this->_dict_stream);
+    this->_dict_stream = nullptr;
+  }
+}
+
+void w_lz4_dict::_move(_Inout_ w_lz4_dict &&p_other) noexcept {
+  if (this == &p_other) {
+    return;
+  }
+  _release();
+  // the dictionary stream references the buffer of _dict, which is kept by the move
+  this->_dict = std::move(p_other._dict);
+  this->_dict_stream = std::exchange(p_other._dict_stream, nullptr);
+  this->_stream = std::exchange(p_other._stream, nullptr);
+  this->_acceleration = p_other._acceleration;
+}
+
+static boost::leaf::result<size_t> s_check_lz4f_code(_In_ const size_t p_code,
+                                                     _In_ const char *p_msg) noexcept {
+  if (LZ4F_isError(p_code) == 0) {
+    return p_code;
+  }
+  return W_FAILURE(std::errc::operation_canceled,
+                   std::string(p_msg) + " because: " + LZ4F_getErrorName(p_code));
+}
+
+static LZ4F_preferences_t s_lz4f_preferences(_In_ const w_lz4_frame_options &p_options) noexcept {
+  constexpr auto _64_kb = 64 * 1024;
+  constexpr auto _256_kb = 256 * 1024;
+  constexpr auto _1_mb = 1024 * 1024;
+
+  LZ4F_preferences_t _prefs = LZ4F_INIT_PREFERENCES;
+  if (p_options.block_size <= _64_kb) {
+    _prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+  } else if (p_options.block_size <= _256_kb) {
+    _prefs.frameInfo.blockSizeID = LZ4F_max256KB;
+  } else if (p_options.block_size <= _1_mb) {
+    _prefs.frameInfo.blockSizeID = LZ4F_max1MB;
+  } else {
+    _prefs.frameInfo.blockSizeID = LZ4F_max4MB;
+  }
+  _prefs.frameInfo.blockMode =
+      p_options.block_independent ? LZ4F_blockIndependent : LZ4F_blockLinked;
+  _prefs.frameInfo.contentChecksumFlag =
+      p_options.content_checksum ? LZ4F_contentChecksumEnabled : LZ4F_noContentChecksum;
+  _prefs.frameInfo.contentSize = p_options.content_size;
+  _prefs.compressionLevel = p_options.compression_level;
+
+  return _prefs;
+}
+
+boost::leaf::result<int>
+w_lz4_frame_compressor::init(_In_ const w_lz4_frame_options &p_options) noexcept {
+  _release();
+
+  LZ4F_cctx *_ctx = nullptr;
+  BOOST_LEAF_CHECK(s_check_lz4f_code(LZ4F_createCompressionContext(&_ctx, LZ4F_VERSION),
+                                     "could not create lz4 frame compression context"));
+  this->_ctx = _ctx;
+  this->_options = p_options;
+  return 0;
+}
+
+size_t w_lz4_frame_compressor::get_compress_bound(_In_ size_t p_src_size) const noexcept {
+  const auto _prefs = s_lz4f_preferences(this->_options);
+  return LZ4F_compressBound(p_src_size, &_prefs);
+}
+
+boost::leaf::result<size_t>
+w_lz4_frame_compressor::begin(_Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted,
+                     "lz4 frame compressor was not initialized");
+  }
+  if (p_dst.size() < LZ4F_HEADER_SIZE_MAX) {
+    return W_FAILURE(std::errc::no_buffer_space,
+                     "the destination is too small for lz4 frame header");
+  }
+
+  const auto _prefs = s_lz4f_preferences(this->_options);
+  return s_check_lz4f_code(LZ4F_compressBegin(this->_ctx, p_dst.data(), p_dst.size(), &_prefs),
+                           "could not begin lz4 frame");
+}
+
+boost::leaf::result<size_t>
+w_lz4_frame_compressor::update(_In_ const gsl::span<const std::byte> p_src,
+                               _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted,
+                     "lz4 frame compressor was not initialized");
+  }
+  if (p_src.empty()) {
+    return 0;
+  }
+  if (p_dst.size() < get_compress_bound(p_src.size())) {
+    return W_FAILURE(std::errc::no_buffer_space,
+                     "the destination is smaller than lz4 frame compress bound");
+  }
+
+  return s_check_lz4f_code(LZ4F_compressUpdate(this->_ctx, p_dst.data(), p_dst.size(),
+                                               p_src.data(), p_src.size(), nullptr),
+                           "could not compress lz4 frame chunk");
+}
+
+boost::leaf::result<size_t>
+w_lz4_frame_compressor::flush(_Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted,
+                     "lz4 frame compressor was not initialized");
+  }
+  return s_check_lz4f_code(LZ4F_flush(this->_ctx, p_dst.data(), p_dst.size(), nullptr),
+                           "could not flush lz4 frame");
+}
+
+boost::leaf::result<size_t>
+w_lz4_frame_compressor::end(_Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted,
+                     "lz4 frame compressor was not initialized");
+  }
+  return s_check_lz4f_code(LZ4F_compressEnd(this->_ctx, p_dst.data(), p_dst.size(), nullptr),
+                           "could not end lz4 frame");
+}
+
+void w_lz4_frame_compressor::_release() noexcept {
+  if (this->_ctx != nullptr) {
+    LZ4F_freeCompressionContext(this->_ctx);
+    this->_ctx = nullptr;
+  }
+}
+
+void w_lz4_frame_compressor::_move(_Inout_ w_lz4_frame_compressor &&p_other) noexcept {
+  if (this == &p_other) {
+    return;
+  }
+  _release();
+  this->_ctx = std::exchange(p_other._ctx, nullptr);
+  this->_options = p_other._options;
+}
+
+boost::leaf::result<int> w_lz4_frame_decompressor::init() noexcept {
+  _release();
+
+  LZ4F_dctx *_ctx = nullptr;
+  BOOST_LEAF_CHECK(s_check_lz4f_code(LZ4F_createDecompressionContext(&_ctx, LZ4F_VERSION),
+                                     "could not create lz4 frame decompression context"));
+  this->_ctx = _ctx;
+  return 0;
+}
+
+boost::leaf::result<w_lz4_frame_progress>
+w_lz4_frame_decompressor::update(_In_ const gsl::span<const std::byte> p_src,
+                                 _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted,
+                     "lz4 frame decompressor was not initialized");
+  }
+
+  // on input these are the capacities, on output they are the processed sizes
+  auto _src_size = p_src.size();
+  auto _dst_size = p_dst.size();
+
+  BOOST_LEAF_AUTO(_hint, s_check_lz4f_code(LZ4F_decompress(this->_ctx, p_dst.data(), &_dst_size,
+                                                           p_src.data(), &_src_size, nullptr),
+                                           "could not decompress lz4 frame chunk"));
+  return w_lz4_frame_progress{_src_size, _dst_size, _hint};
+}
+
+void w_lz4_frame_decompressor::reset() noexcept {
+  if (this->_ctx != nullptr) {
+    LZ4F_resetDecompressionContext(this->_ctx);
+  }
+}
+
+void w_lz4_frame_decompressor::_release() noexcept {
+  if (this->_ctx != nullptr) {
+    LZ4F_freeDecompressionContext(this->_ctx);
+    this->_ctx = nullptr;
+  }
+}
+
+void w_lz4_frame_decompressor::_move(_Inout_ w_lz4_frame_decompressor &&p_other) noexcept {
+  if (this == &p_other) {
+    return;
+  }
+  _release();
+  this->_ctx = std::exchange(p_other._ctx, nullptr);
+}
+
 #endif // WOLF_SYSTEM_LZ4
@@ -9,6 +9,11 @@
 
 #include <wolf/wolf.hpp>
 
+union LZ4_stream_u;
+union LZ4_streamHC_u;
+struct LZ4F_cctx_s;
+struct LZ4F_dctx_s;
+
 namespace wolf::system::compression {
 
 struct w_lz4 {
@@ -39,6 +44,16 @@ struct w_lz4 {
   compress_fast(_In_ const gsl::span<const std::byte> p_src,
                 _In_ const int p_acceleration) noexcept;
 
+  /*
+   * compress using the high compression mode of lz4 (lz4hc),
+   * the output could be decompressed via the same decompress functions
+   * @param p_src, the input source
+   * @param p_level, a value between 3 - 12, higher is smaller but slower
+   * @returns the vector of compressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  compress_hc(_In_ const gsl::span<const std::byte> p_src, _In_ const int p_level) noexcept;
+
   /*
    * decompress the compressed stream
    * @param p_src, the input source
@@ -47,6 +62,449 @@ struct w_lz4 {
   W_API static boost::leaf::result<std::vector<std::byte>>
   decompress(_In_ const gsl::span<const std::byte> p_src,
              _In_ const size_t p_max_retry) noexcept;
+
+  /*
+   * compress into a self-describing block, the original size is stored
+   * as a 4 bytes little-endian header in front of the compressed stream.
+   * An incompressible source is stored as is and the high bit of header marks it,
+   * so the decoders pass it through
+   * @param p_src, the input source
+   * @param p_acceleration, a value between 1 - 65536
+   * @returns the vector of sized block
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  compress_sized(_In_ const gsl::span<const std::byte> p_src,
+                 _In_ const int p_acceleration = 1) noexcept;
+
+  /*
+   * get the original size of a sized block from its header
+   * @param p_src, the sized block
+   * @returns the size of decompressed stream
+   */
+  W_API static boost::leaf::result<size_t>
+  get_decompressed_size(_In_ const gsl::span<const std::byte> p_src) noexcept;
+
+  /*
+   * decompress a sized block with only one pass over the input
+   * @param p_src, the sized block
+   * @returns the vector of decompressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  decompress_sized(_In_ const gsl::span<const std::byte> p_src) noexcept;
+
+  /*
+   * decompress a sized block into the caller's buffer with only one pass over the input
+   * @param p_src, the sized block
+   * @param p_dst, the destination which must have at least get_decompressed_size bytes
+   * @returns number of decompressed bytes
+   */
+  W_API static boost::leaf::result<size_t>
+  decompress_into(_In_ const gsl::span<const std::byte> p_src,
+                  _Inout_ gsl::span<std::byte> p_dst) noexcept;
+};
+
+struct w_lz4_blocks_options {
+  // the size of each independent block in bytes
+  size_t block_size = 256 * 1024;
+  // the acceleration of compress_fast, a value between 1 - 65536
+  int acceleration = 1;
+  // number of worker threads, zero means the number of hardware threads
+  size_t threads = 0;
+  // store the blocks which are estimated as incompressible without compressing them
+  bool skip_incompressible = true;
+};
+
+struct w_lz4_blocks {
+  /*
+   * split the source into fixed-size independent blocks and compress them in parallel,
+   * the blocks are followed by a trailing index which allows random access
+   * @param p_src, the input source
+   * @param p_options, the options of blocks
+   * @returns the vector of blocks container
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  compress(_In_ const gsl::span<const std::byte> p_src,
+           _In_ const w_lz4_blocks_options &p_options = {}) noexcept;
+
+  /*
+   * decompress the whole blocks container in parallel
+   * @param p_src, the blocks container
+   * @param p_threads, number of worker threads, zero means the number of hardware threads
+   * @returns the vector of decompressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  decompress(_In_ const gsl::span<const std::byte> p_src, _In_ size_t p_threads = 0) noexcept;
+};
+
+/*
+ * a reader which decompresses any byte range of a blocks container
+ * without touching the blocks outside of that range
+ */
+class w_lz4_blocks_reader {
+ public:
+  // default constructor
+  W_API w_lz4_blocks_reader() noexcept = default;
+
+  // move constructor.
+  W_API w_lz4_blocks_reader(w_lz4_blocks_reader &&p_other) noexcept = default;
+  // move assignment operator.
+  W_API w_lz4_blocks_reader &operator=(w_lz4_blocks_reader &&p_other) noexcept = default;
+
+  // destructor
+  W_API virtual ~w_lz4_blocks_reader() noexcept = default;
+
+  /*
+   * parse the trailing index of a blocks container,
+   * the container must outlive the reader
+   * @param p_src, the blocks container
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init(_In_ const gsl::span<const std::byte> p_src) noexcept;
+
+  /*
+   * decompress a byte range of the original stream
+   * @param p_offset, the offset in the original stream
+   * @param p_dst, the destination, its size is the length of range
+   * @returns number of bytes which were written into the destination
+   */
+  W_API boost::leaf::result<size_t> read(_In_ uint64_t p_offset,
+                                         _Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  // get the size of the original stream
+  [[nodiscard]] W_API uint64_t get_size() const noexcept;
+
+  // get the size of each block
+  [[nodiscard]] W_API size_t get_block_size() const noexcept;
+
+  // get number of blocks
+  [[nodiscard]] W_API size_t get_blocks_count() const noexcept;
+
+ private:
+  // copy constructor.
+  w_lz4_blocks_reader(const w_lz4_blocks_reader &) = delete;
+  // copy assignment operator.
+  w_lz4_blocks_reader &operator=(const w_lz4_blocks_reader &) = delete;
+
+  gsl::span<const std::byte> _src = {};
+  // the offset of each block in the container, plus the end of last block
+  std::vector<uint64_t> _offsets = {};
+  // whether each block was stored without compression
+  std::vector<bool> _stored = {};
+  // a scratch for blocks which were partially requested
+  std::vector<std::byte> _scratch = {};
+  uint64_t _size = 0;
+  size_t _block_size = 0;
+};
+
+enum class w_lz4_mode {
+  // the default and fast modes of lz4, tuned via acceleration
+  FAST = 0,
+  // the high compression mode of lz4, tuned via level
+  HC
+};
+
+/*
+ * a stateful encoder which keeps the lz4 state alive across calls,
+ * so the state does not need to be allocated and fully initialized per call
+ */
+class w_lz4_encoder {
+ public:
+  // default constructor
+  W_API w_lz4_encoder() noexcept = default;
+
+  // move constructor.
+  W_API w_lz4_encoder(w_lz4_encoder &&p_other) noexcept {
+    _move(std::forward<w_lz4_encoder &&>(p_other));
+  }
+  // move assignment operator.
+  W_API w_lz4_encoder &operator=(w_lz4_encoder &&p_other) noexcept {
+    _move(std::forward<w_lz4_encoder &&>(p_other));
+    return *this;
+  }
+
+  // destructor
+  W_API virtual ~w_lz4_encoder() noexcept { _release(); }
+
+  /*
+   * allocate the state of encoder
+   * @param p_mode, the mode of compression
+   * @param p_level, the acceleration (1 - 65536) for FAST or the level (3 - 12) for HC
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init(_In_ w_lz4_mode p_mode = w_lz4_mode::FAST,
+                                      _In_ int p_level = 1) noexcept;
+
+  /*
+   * compress into the caller's buffer
+   * @param p_src, the input source
+   * @param p_dst, the destination, see w_lz4::get_compress_bound
+   * @returns number of compressed bytes
+   */
+  W_API boost::leaf::result<size_t> compress(_In_ const gsl::span<const std::byte> p_src,
+                                             _Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * compress into a new vector
+   * @param p_src, the input source
+   * @returns the vector of compressed stream
+   */
+  W_API boost::leaf::result<std::vector<std::byte>>
+  compress(_In_ const gsl::span<const std::byte> p_src) noexcept;
+
+ private:
+  // copy constructor.
+  w_lz4_encoder(const w_lz4_encoder &) = delete;
+  // copy assignment operator.
+  w_lz4_encoder &operator=(const w_lz4_encoder &) = delete;
+  // release the resources
+  void _release() noexcept;
+  // move the resources
+  void _move(_Inout_ w_lz4_encoder &&p_other) noexcept;
+
+  gsl::owner<LZ4_stream_u *> _stream = nullptr;
+  gsl::owner<LZ4_streamHC_u *> _stream_hc = nullptr;
+  w_lz4_mode _mode = w_lz4_mode::FAST;
+  int _level = 1;
+};
+
+/*
+ * compress small messages against a shared dictionary,
+ * the dictionary is hashed only once and copied into a reusable stream per call
+ */
+class w_lz4_dict {
+ public:
+  // default constructor
+  W_API w_lz4_dict() noexcept = default;
+
+  // move constructor.
+  W_API w_lz4_dict(w_lz4_dict &&p_other) noexcept {
+    _move(std::forward<w_lz4_dict &&>(p_other));
+  }
+  // move assignment operator.
+  W_API w_lz4_dict &operator=(w_lz4_dict &&p_other) noexcept {
+    _move(std::forward<w_lz4_dict &&>(p_other));
+    return *this;
+  }
+
+  // destructor
+  W_API virtual ~w_lz4_dict() noexcept { _release(); }
+
+  /*
+   * train a dictionary from captured samples, the most frequent segments
+   * across samples are selected and the most valuable ones placed at the end
+   * @param p_samples, the captured samples
+   * @param p_capacity, the maximum size of dictionary, lz4 uses up to 64KB
+   * @returns the dictionary
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  train(_In_ const std::vector<gsl::span<const std::byte>> &p_samples,
+        _In_ size_t p_capacity = 64 * 1024) noexcept;
+
+  /*
+   * load the dictionary and create the stream states
+   * @param p_dict, the dictionary which will be copied
+   * @param p_acceleration, a value between 1 - 65536
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init(_In_ const gsl::span<const std::byte> p_dict,
+                                      _In_ int p_acceleration = 1) noexcept;
+
+  /*
+   * compress a message with the dictionary
+   * @param p_src, the message
+   * @param p_dst, the destination, see w_lz4::get_compress_bound
+   * @returns number of compressed bytes
+   */
+  W_API boost::leaf::result<size_t> compress(_In_ const gsl::span<const std::byte> p_src,
+                                             _Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * decompress a message which was compressed with the same dictionary
+   * @param p_src, the compressed message
+   * @param p_dst, the destination
+   * @returns number of decompressed bytes
+   */
+  W_API boost::leaf::result<size_t> decompress(_In_ const gsl::span<const std::byte> p_src,
+                                               _Inout_ gsl::span<std::byte> p_dst) const noexcept;
+
+  // get the loaded dictionary
+  [[nodiscard]] W_API gsl::span<const std::byte> get_dict() const noexcept;
+
+ private:
+  // copy constructor.
+  w_lz4_dict(const w_lz4_dict &) = delete;
+  // copy assignment operator.
+  w_lz4_dict &operator=(const w_lz4_dict &) = delete;
+  // release the resources
+  void _release() noexcept;
+  // move the resources
+  void _move(_Inout_ w_lz4_dict &&p_other) noexcept;
+
+  std::vector<std::byte> _dict = {};
+  // the stream which holds the hashed dictionary
+  gsl::owner<LZ4_stream_u *> _dict_stream = nullptr;
+  // the working stream which will be reused for each message
+  gsl::owner<LZ4_stream_u *> _stream = nullptr;
+  int _acceleration = 1;
+};
+
+struct w_lz4_frame_options {
+  // the maximum size of each block in bytes, one of 64KB, 256KB, 1MB or 4MB
+  size_t block_size = 64 * 1024;
+  // each block could be decompressed without referencing the previous one
+  bool block_independent = false;
+  // append a checksum of the whole content at the end of frame
+  bool content_checksum = false;
+  // the compression level, zero means default (fast mode)
+  int compression_level = 0;
+  // the size of content, zero means unknown
+  uint64_t content_size = 0;
+};
+
+struct w_lz4_frame_progress {
+  // number of bytes which were read from the source
+  size_t src_consumed = 0;
+  // number of bytes which were written into the destination
+  size_t dst_written = 0;
+  // a hint of the source size for next call, zero means the frame is fully decoded
+  size_t src_size_hint = 0;
+};
+
+/*
+ * an incremental compressor which generates lz4 frames (compatible with lz4 cli),
+ * the compressed stream will be written into the caller's buffer
+ */
+class w_lz4_frame_compressor {
+ public:
+  // default constructor
+  W_API w_lz4_frame_compressor() noexcept = default;
+
+  // move constructor.
+  W_API w_lz4_frame_compressor(w_lz4_frame_compressor &&p_other) noexcept {
+    _move(std::forward<w_lz4_frame_compressor &&>(p_other));
+  }
+  // move assignment operator.
+  W_API w_lz4_frame_compressor &operator=(w_lz4_frame_compressor &&p_other) noexcept {
+    _move(std::forward<w_lz4_frame_compressor &&>(p_other));
+    return *this;
+  }
+
+  // destructor
+  W_API virtual ~w_lz4_frame_compressor() noexcept { _release(); }
+
+  /*
+   * initialize the compression context
+   * @param p_options, the frame options
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init(_In_ const w_lz4_frame_options &p_options = {}) noexcept;
+
+  /*
+   * get the worst case size of destination for compressing a chunk via update
+   * @param p_src_size, the size of source chunk
+   * @returns the size of bound
+   */
+  W_API size_t get_compress_bound(_In_ size_t p_src_size) const noexcept;
+
+  /*
+   * write the frame header, must be called before the first update
+   * @param p_dst, the destination buffer which should be at least 19 bytes
+   * @returns number of written bytes
+   */
+  W_API boost::leaf::result<size_t> begin(_Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * compress a chunk of source
+   * @param p_src, the input chunk
+   * @param p_dst, the destination buffer, see get_compress_bound
+   * @returns number of written bytes, might be zero because of buffering
+   */
+  W_API boost::leaf::result<size_t> update(_In_ const gsl::span<const std::byte> p_src,
+                                           _Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * flush all buffered data into the destination
+   * @param p_dst, the destination buffer
+   * @returns number of written bytes
+   */
+  W_API boost::leaf::result<size_t> flush(_Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * flush the buffered data and write the end mark of frame,
+   * the compressor could be used for a new frame by calling begin again
+   * @param p_dst, the destination buffer
+   * @returns number of written bytes
+   */
+  W_API boost::leaf::result<size_t> end(_Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+ private:
+  // copy constructor.
+  w_lz4_frame_compressor(const w_lz4_frame_compressor &) = delete;
+  // copy assignment operator.
+  w_lz4_frame_compressor &operator=(const w_lz4_frame_compressor &) = delete;
+  // release the resources
+  void _release() noexcept;
+  // move the resources
+  void _move(_Inout_ w_lz4_frame_compressor &&p_other) noexcept;
+
+  gsl::owner<LZ4F_cctx_s *> _ctx = nullptr;
+  w_lz4_frame_options _options = {};
+};
+
+/*
+ * an incremental decompressor of lz4 frames,
+ * the decompressed stream will be written into the caller's buffer
+ */
+class w_lz4_frame_decompressor {
+ public:
+  // default constructor
+  W_API w_lz4_frame_decompressor() noexcept = default;
+
+  // move constructor.
+  W_API w_lz4_frame_decompressor(w_lz4_frame_decompressor &&p_other) noexcept {
+    _move(std::forward<w_lz4_frame_decompressor &&>(p_other));
+  }
+  // move assignment operator.
+  W_API w_lz4_frame_decompressor &operator=(w_lz4_frame_decompressor &&p_other) noexcept {
+    _move(std::forward<w_lz4_frame_decompressor &&>(p_other));
+    return *this;
+  }
+
+  // destructor
+  W_API virtual ~w_lz4_frame_decompressor() noexcept { _release(); }
+
+  /*
+   * initialize the decompression context
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init() noexcept;
+
+  /*
+   * decompress a chunk of frame, call it again with the rest of the source
+   * until src_size_hint of progress becomes zero
+   * @param p_src, the input chunk
+   * @param p_dst, the destination buffer
+   * @returns the progress of decompression
+   */
+  W_API boost::leaf::result<w_lz4_frame_progress>
+  update(_In_ const gsl::span<const std::byte> p_src, _Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * reset the state for decoding a new frame
+   */
+  W_API void reset() noexcept;
+
+ private:
+  // copy constructor.
+  w_lz4_frame_decompressor(const w_lz4_frame_decompressor &) = delete;
+  // copy assignment operator.
+  w_lz4_frame_decompressor &operator=(const w_lz4_frame_decompressor &) = delete;
+  // release the resources
+  void _release() noexcept;
+  // move the resources
+  void _move(_Inout_ w_lz4_frame_decompressor &&p_other) noexcept;
+
+  gsl::owner<LZ4F_dctx_s *> _ctx = nullptr;
 };
 } // namespace wolf::system::compression
 
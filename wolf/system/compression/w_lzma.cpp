@@ -2,6 +2,8 @@
 
 #ifdef WOLF_SYSTEM_LZMA
 
+#include "w_entropy.hpp"
+
 #include <DISABLE_ANALYSIS_BEGIN>
 #include <Lzma2Enc.h>
 #include <Lzma2Dec.h>
@@ -9,10 +11,22 @@
 #include <LzmaEnc.h>
 #include <DISABLE_ANALYSIS_END>
 
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using w_entropy = wolf::system::compression::w_entropy;
 using w_lzma = wolf::system::compression::w_lzma;
+using w_lzma2_options = wolf::system::compression::w_lzma2_options;
+using w_lzma_source = wolf::system::compression::w_lzma_source;
+using w_lzma_sink = wolf::system::compression::w_lzma_sink;
+using w_lzma_encoder = wolf::system::compression::w_lzma_encoder;
+using w_lzma_decoder = wolf::system::compression::w_lzma_decoder;
 
 constexpr auto LZMA_HEADER_SRC_SIZE = 8;
 constexpr auto MAX_HEADER_SIZE = 256 * 1024 * 1024;
+// a property which is invalid for both lzma1 and lzma2 marks a stream which was stored as is
+constexpr auto LZMA_STORED_PROPERTY = std::byte(0xFF);
 
 static void *s_lzma_alloc(ISzAllocPtr p_ptr, size_t p_size) noexcept {
   std::ignore = p_ptr;
@@ -26,7 +40,7 @@ static void s_lzma_free(ISzAllocPtr p_ptr, void *p_addr) noexcept {
 constexpr ISzAlloc s_alloc_funcs = {s_lzma_alloc, s_lzma_free};
 
 static void s_lzma_prop(_Inout_ CLzmaEncProps *p_prop, _In_ uint32_t p_level,
-                        _In_ int p_src_size) noexcept {
+                        _In_ uint64_t p_src_size) noexcept {
   // set up properties
   LzmaEncProps_Init(p_prop);
 
@@ -52,6 +66,69 @@ static void s_lzma_prop(_Inout_ CLzmaEncProps *p_prop, _In_ uint32_t p_level,
   p_prop->level = p_level;
 }
 
+static uint64_t s_read_src_size(_In_ const gsl::span<const std::byte> p_src,
+                                _In_ size_t p_offset) noexcept {
+  // the uncompressed size is stored in little-endian after the properties
+  uint64_t _size = 0;
+  for (size_t i = 0; i < LZMA_HEADER_SRC_SIZE; i++) {
+    _size |= std::to_integer<uint64_t>(gsl::at(p_src, p_offset + i)) << (i * 8);
+  }
+  return _size;
+}
+
+/*
+ * store the source as is behind a header with the same layout of compressed streams,
+ * the properties are replaced with LZMA_STORED_PROPERTY and zeros
+ */
+static void s_write_stored(_Inout_ gsl::span<std::byte> p_dst, _In_ size_t p_props_size,
+                           _In_ const gsl::span<const std::byte> p_src) noexcept {
+  const auto _src_size = gsl::narrow_cast<uint64_t>(p_src.size());
+  std::fill_n(p_dst.begin(), p_props_size, std::byte(0));
+  gsl::at(p_dst, 0) = LZMA_STORED_PROPERTY;
+  for (size_t i = 0; i < LZMA_HEADER_SRC_SIZE; i++) {
+    gsl::at(p_dst, p_props_size + i) = std::byte((_src_size >> (i * 8)) & 0xFF);
+  }
+  std::copy(p_src.begin(), p_src.end(), p_dst.begin() + p_props_size + LZMA_HEADER_SRC_SIZE);
+}
+
+static std::vector<std::byte> s_make_stored(_In_ size_t p_props_size,
+                                            _In_ const gsl::span<const std::byte> p_src) {
+  std::vector<std::byte> _dst;
+  _dst.resize(p_props_size + LZMA_HEADER_SRC_SIZE + p_src.size());
+  s_write_stored(_dst, p_props_size, p_src);
+  return _dst;
+}
+
+static bool s_is_stored(_In_ const gsl::span<const std::byte> p_src) noexcept {
+  return !p_src.empty() && p_src[0] == LZMA_STORED_PROPERTY;
+}
+
+/*
+ * copy the payload of a stored stream, the size of payload must match the header
+ */
+static boost::leaf::result<size_t> s_read_stored(_In_ const gsl::span<const std::byte> p_payload,
+                                                 _Inout_ gsl::span<std::byte> p_dst) {
+  if (p_payload.size() != p_dst.size()) {
+    return W_FAILURE(std::errc::operation_canceled, "the stored lzma stream is truncated");
+  }
+  std::copy(p_payload.begin(), p_payload.end(), p_dst.begin());
+  return p_dst.size();
+}
+
+/*
+ * the decode function of streaming decoders for a stored stream, it only copies the input
+ */
+static SRes s_decode_stored(Byte *p_dst, SizeT *p_dst_len, const Byte *p_src, SizeT *p_src_len,
+                            ELzmaFinishMode p_finish, ELzmaStatus *p_status) noexcept {
+  std::ignore = p_finish;
+  const auto _len = std::min(*p_dst_len, *p_src_len);
+  std::copy_n(p_src, _len, p_dst);
+  *p_dst_len = _len;
+  *p_src_len = _len;
+  *p_status = LZMA_STATUS_NOT_FINISHED;
+  return SZ_OK;
+}
+
 boost::leaf::result<std::vector<std::byte>>
 w_lzma::compress_lzma1(_In_ const gsl::span<const std::byte> p_src,
                        _In_ uint32_t p_level) {
@@ -59,6 +136,9 @@ w_lzma::compress_lzma1(_In_ const gsl::span<const std::byte> p_src,
   if (_src_size == 0) {
     return W_FAILURE(std::errc::invalid_argument, "the source is empty");
   }
+  if (!w_entropy::is_compressible(p_src)) {
+    return s_make_stored(LZMA_PROPS_SIZE, p_src);
+  }
 
   // set up properties
   CLzmaEncProps _props = {};
@@ -87,6 +167,11 @@ w_lzma::compress_lzma1(_In_ const gsl::span<const std::byte> p_src,
   const auto _compressed_size =
       _output_size_64 + LZMA_HEADER_SRC_SIZE + LZMA_PROPS_SIZE;
 
+  // there is no gain, so store the source as is
+  if (_lzma_status == SZ_OK && _output_size_64 >= p_src.size()) {
+    return s_make_stored(LZMA_PROPS_SIZE, p_src);
+  }
+
   if (_lzma_status == SZ_OK) {
     std::vector<std::byte> _dst;
     _dst.reserve(_compressed_size);
@@ -112,69 +197,99 @@ w_lzma::compress_lzma1(_In_ const gsl::span<const std::byte> p_src,
 boost::leaf::result<std::vector<std::byte>>
 w_lzma::compress_lzma2(_In_ const gsl::span<const std::byte> p_src,
                        _In_ uint32_t p_level) {
-  const auto _src_size = gsl::narrow_cast<int>(p_src.size());
+  // a single block thread keeps the previous solid encoding
+  w_lzma2_options _options = {};
+  _options.level = p_level;
+  _options.block_threads = 1;
+  return compress_lzma2(p_src, _options);
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_lzma::compress_lzma2(_In_ const gsl::span<const std::byte> p_src,
+                       _In_ const w_lzma2_options &p_options) {
+  const auto _src_size = gsl::narrow_cast<uint64_t>(p_src.size());
   if (_src_size == 0) {
     return W_FAILURE(std::errc::invalid_argument, "the source is empty");
   }
+  if (p_options.skip_incompressible && !w_entropy::is_compressible(p_src)) {
+    return s_make_stored(sizeof(Byte), p_src);
+  }
 
-  auto _enc_handler = Lzma2Enc_Create(&s_alloc_funcs, &s_alloc_funcs);
-  if (!_enc_handler) {
-    return W_FAILURE(std::errc::operation_canceled,
-                     "failed on creating lzma2 encoder");
+  auto _block_threads = p_options.block_threads;
+  if (_block_threads <= 0) {
+    _block_threads = std::max(1, gsl::narrow_cast<int>(std::thread::hardware_concurrency()));
+  }
+
+  // split the input between block threads, otherwise there is only one block
+  constexpr auto _min_block_size = uint64_t(1) << 20;
+  auto _block_size = p_options.block_size;
+  if (_block_size == 0) {
+    _block_size = std::max(_min_block_size, (_src_size + _block_threads - 1) / _block_threads);
   }
 
   // set up properties
   CLzmaEncProps _props_1{};
-  s_lzma_prop(&_props_1, p_level, _src_size);
+  s_lzma_prop(&_props_1, p_options.level, _src_size);
+
+  // the dictionary never grows beyond a block
+  constexpr auto _min_dic_size = uint64_t(1) << 12;
+  if (_props_1.dictSize > _block_size) {
+    _props_1.dictSize = gsl::narrow_cast<uint32_t>(std::max(_block_size, _min_dic_size));
+  }
 
   CLzma2EncProps _props_2{};
   Lzma2EncProps_Init(&_props_2);
   _props_2.lzmaProps = _props_1;
+  _props_2.blockSize = _block_size;
+  _props_2.numBlockThreads_Max = _block_threads;
+  _props_2.numTotalThreads =
+      p_options.total_threads > 0 ? p_options.total_threads : _block_threads;
+
+  auto _enc_handler = Lzma2Enc_Create(&s_alloc_funcs, &s_alloc_funcs);
+  if (!_enc_handler) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     "failed on creating lzma2 encoder");
+  }
+  DEFER { Lzma2Enc_Destroy(_enc_handler); });
 
   const auto _props_status = Lzma2Enc_SetProps(_enc_handler, &_props_2);
   if (_props_status != SZ_OK) {
     return W_FAILURE(std::errc::operation_canceled,
                      "failed on setting lzma2 encoder properties");
   }
+  Lzma2Enc_SetDataSize(_enc_handler, _src_size);
 
   // prepare space for the encoded properties
   const auto properties = Lzma2Enc_WriteProperties(_enc_handler);
-  // allocate some space for the compression output
-  // this is way more than necessary in most cases.
-  auto _output_size_64 = gsl::narrow_cast<size_t>(_src_size) * 2;
-  if (_output_size_64 < 1024) {
-    _output_size_64 = 1024;
-  }
 
-  std::vector<std::byte> _tmp;
-  _tmp.resize(_output_size_64);
+  // compress right after the header, so there is no need for an extra copy
+  constexpr auto _header_size = LZMA_HEADER_SRC_SIZE + sizeof(properties);
+  auto _output_size_64 = w_lzma_encoder::get_compress_bound(_src_size) - _header_size;
+  std::vector<std::byte> _dst;
+  _dst.resize(_header_size + _output_size_64);
+
+  /*
+      tricky: we have to generate the LZMA header
+      1 byte properties + 8 bytes uncompressed size
+  */
+  _dst[0] = std::byte(properties);
+  for (int i = 0; i < LZMA_HEADER_SRC_SIZE; i++) {
+    _dst[sizeof(properties) + i] = std::byte((_src_size >> (i * 8)) & 0xFF);
+  }
 
   const auto _encode_status = Lzma2Enc_Encode2(
-      _enc_handler, nullptr, reinterpret_cast<Byte *>(_tmp.data()),
+      _enc_handler, nullptr, reinterpret_cast<Byte *>(_dst.data() + _header_size),
       &_output_size_64, nullptr, reinterpret_cast<const Byte *>(p_src.data()),
-      _src_size, nullptr);
-  Lzma2Enc_Destroy(_enc_handler);
-
-  const auto _compressed_size =
-      _output_size_64 + LZMA_HEADER_SRC_SIZE + sizeof(properties);
+      p_src.size(), nullptr);
 
   if (_encode_status == SZ_OK) {
-    std::vector<std::byte> _dst;
-    _dst.reserve(_compressed_size);
-
-    /*
-        tricky: we have to generate the LZMA header
-        1 byte properties + 8 bytes uncompressed size
-    */
-    _dst.push_back(std::byte(properties));
-    for (int i = 0; i < LZMA_HEADER_SRC_SIZE; i++) {
-      _dst.push_back(std::byte((_src_size >> (i * 8)) & 0xFF));
+    // there is no gain, so store the source as is
+    if (_output_size_64 >= _src_size) {
+      _dst.resize(_header_size + p_src.size());
+      s_write_stored(_dst, sizeof(properties), p_src);
+      return _dst;
     }
-
-    // copy the compressed size
-    std::copy(_tmp.begin(), _tmp.begin() + _output_size_64,
-              std::back_inserter(_dst));
-
+    _dst.resize(_header_size + _output_size_64);
     return _dst;
   }
   return W_FAILURE(std::errc::operation_canceled, "lzma2 compress failed");
@@ -189,24 +304,22 @@ w_lzma::decompress_lzma1(_In_ const gsl::span<const std::byte> p_src) {
   }
 
   // extract the size from the header
-  uint64_t _size_from_header = 0;
-  for (uint64_t i = 0; i < LZMA_HEADER_SRC_SIZE; i++) {
-    const auto _h1 = gsl::at(p_src, LZMA_PROPS_SIZE + i);
-    const auto _h2 = i * 8;
-    const auto _h3 = gsl::narrow_cast<uint64_t>(_h1 << _h2);
-    if (_h3 < std::numeric_limits<uint64_t>::max()) {
-      _size_from_header |= _h3;
-    }
-  }
+  const auto _size_from_header = s_read_src_size(p_src, LZMA_PROPS_SIZE);
 
   std::vector<std::byte> _dst;
   if (_size_from_header <= MAX_HEADER_SIZE) {
     // allocate memory
     _dst.resize(_size_from_header);
 
+    if (s_is_stored(p_src)) {
+      BOOST_LEAF_CHECK(
+          s_read_stored(p_src.subspan(LZMA_HEADER_SRC_SIZE + LZMA_PROPS_SIZE), _dst));
+      return _dst;
+    }
+
     ELzmaStatus _lzma_status{};
     size_t _proc_out_size = _size_from_header,
-           _proc_in_size = _src_size - LZMA_HEADER_SRC_SIZE + LZMA_PROPS_SIZE;
+           _proc_in_size = _src_size - LZMA_HEADER_SRC_SIZE - LZMA_PROPS_SIZE;
     // decode via lzma
     const auto _status = LzmaDecode(
         reinterpret_cast<Byte *>(_dst.data()), &_proc_out_size,
@@ -231,69 +344,619 @@ w_lzma::decompress_lzma2(_In_ gsl::span<const std::byte> p_src) {
   }
 
   // extract the size from the header
-  uint64_t _size_from_header = 0;
-  for (uint64_t i = 0; i < LZMA_HEADER_SRC_SIZE; i++) {
-    const auto _h1 = gsl::at(p_src, sizeof(Byte) + i);
-    const auto _h2 = i * 8;
-    const auto _h3 = gsl::narrow_cast<uint64_t>(_h1 << _h2);
-    if (_h3 < std::numeric_limits<uint64_t>::max()) {
-      _size_from_header |= _h3;
+  const auto _size_from_header = s_read_src_size(p_src, sizeof(Byte));
+  if (_size_from_header > MAX_HEADER_SIZE) {
+    return W_FAILURE(std::errc::value_too_large,
+                     "lzma2 decompressed size is too large, use the streaming decoder");
+  }
+
+  std::vector<std::byte> _dst;
+  _dst.resize(_size_from_header);
+
+  if (s_is_stored(p_src)) {
+    BOOST_LEAF_CHECK(s_read_stored(p_src.subspan(LZMA_HEADER_SRC_SIZE + sizeof(Byte)), _dst));
+    return _dst;
+  }
+
+  CLzma2Dec _dec{};
+  Lzma2Dec_Construct(&_dec);
+
+  // the dictionary must be allocated from the stored property
+  const auto _properties = std::to_integer<Byte>(gsl::at(p_src, 0));
+  const auto _res = Lzma2Dec_Allocate(&_dec, _properties, &s_alloc_funcs);
+  if (_res != SZ_OK) {
+    return W_FAILURE(std::errc::invalid_argument,
+                     "could not allocate memory for lzma2 decoder");
+  }
+  DEFER { Lzma2Dec_Free(&_dec, &s_alloc_funcs); });
+
+  Lzma2Dec_Init(&_dec);
+
+  // the whole output is already allocated, so decode it in one call
+  constexpr auto _header_size = LZMA_HEADER_SRC_SIZE + sizeof(Byte);
+  auto _dst_len = gsl::narrow_cast<SizeT>(_size_from_header);
+  auto _src_len = gsl::narrow_cast<SizeT>(_src_size - _header_size);
+  ELzmaStatus _status = LZMA_STATUS_NOT_SPECIFIED;
+
+  const auto _decode_status = Lzma2Dec_DecodeToBuf(
+      &_dec, reinterpret_cast<Byte *>(_dst.data()), &_dst_len,
+      reinterpret_cast<const Byte *>(p_src.data() + _header_size), &_src_len, LZMA_FINISH_END,
+      &_status);
+  if (_decode_status == SZ_OK && _dst_len == _size_from_header) {
+    return _dst;
+  }
+
+  return W_FAILURE(std::errc::operation_canceled, "lzma2 decompress failed");
+}
+
+/*
+ * pull the header from the source into the beginning of the input buffer
+ * @returns number of bytes which were read into the buffer
+ */
+static boost::leaf::result<size_t> s_pull_header(_In_ const w_lzma_source &p_source,
+                                                 _Inout_ std::vector<std::byte> &p_in,
+                                                 _In_ size_t p_header_size) {
+  size_t _len = 0;
+  while (_len < p_header_size) {
+    BOOST_LEAF_AUTO(_read, p_source(gsl::span(p_in.data() + _len, p_in.size() - _len)));
+    if (_read == 0) {
+      return W_FAILURE(std::errc::invalid_argument, "the lzma stream header is truncated");
     }
+    _len += _read;
   }
+  return _len;
+}
 
-  const auto _pre_out_size = _size_from_header * 2;
-  if (_size_from_header <= MAX_HEADER_SIZE) {
-    std::vector<std::byte> _dst;
-    _dst.resize(_size_from_header);
+/*
+ * the shared loop of streaming decoders, the input is pulled chunk by chunk
+ * and every decoded chunk is pushed into the sink, so the memory usage does not
+ * depend on the size of stream
+ */
+template <typename F>
+static boost::leaf::result<uint64_t>
+s_decode_stream(_In_ const w_lzma_source &p_source, _In_ const w_lzma_sink &p_sink,
+                _Inout_ std::vector<std::byte> &p_in, _In_ size_t p_in_len,
+                _In_ size_t p_in_pos, _In_ uint64_t p_size_from_header,
+                _In_ size_t p_chunk_size, _In_ F &&p_decode) {
+  std::vector<std::byte> _out;
+  _out.resize(p_chunk_size);
+
+  uint64_t _total = 0;
+  auto _eof = false;
+
+  while (_total < p_size_from_header) {
+    // refill the input buffer once it is consumed
+    if (p_in_pos == p_in_len && !_eof) {
+      BOOST_LEAF_AUTO(_read, p_source(gsl::span(p_in.data(), p_in.size())));
+      p_in_pos = 0;
+      p_in_len = _read;
+      _eof = _read == 0;
+    }
 
-    CLzma2Dec _dec{};
-    Lzma2Dec_Construct(&_dec);
+    // never decode beyond the size which was stored in the header
+    const auto _remained = p_size_from_header - _total;
+    auto _out_len = gsl::narrow_cast<SizeT>(
+        std::min(gsl::narrow_cast<uint64_t>(_out.size()), _remained));
+    auto _in_len = gsl::narrow_cast<SizeT>(p_in_len - p_in_pos);
+    const auto _finish = _out_len == _remained ? LZMA_FINISH_END : LZMA_FINISH_ANY;
 
-    auto _res = Lzma2Dec_Allocate(&_dec, 0, &s_alloc_funcs);
+    ELzmaStatus _status = LZMA_STATUS_NOT_SPECIFIED;
+    const auto _res = p_decode(reinterpret_cast<Byte *>(_out.data()), &_out_len,
+                               reinterpret_cast<const Byte *>(p_in.data() + p_in_pos), &_in_len,
+                               _finish, &_status);
     if (_res != SZ_OK) {
-      return W_FAILURE(std::errc::invalid_argument,
-                       "could not allocate memory for lzma2 decoder");
+      return W_FAILURE(std::errc::operation_canceled,
+                       wolf::format("lzma stream decode failed with error code {}", _res));
     }
 
-    Lzma2Dec_Init(&_dec);
-    const auto properties = gsl::at(p_src, 0);
-    unsigned _out_pos = 0, _in_pos = LZMA_HEADER_SRC_SIZE + sizeof(properties);
+    p_in_pos += _in_len;
+    _total += _out_len;
 
-    ELzmaStatus _status = LZMA_STATUS_NOT_SPECIFIED;
-    constexpr uint32_t BUF_SIZE = 10240;
-
-    while (_out_pos < _pre_out_size) {
-      auto _dest_len = std::min(gsl::narrow_cast<uint64_t>(BUF_SIZE),
-                                _pre_out_size - _out_pos);
-      auto _src_len = std::min(gsl::narrow_cast<size_t>(BUF_SIZE),
-                               _src_size - gsl::narrow_cast<size_t>(_in_pos));
-
-      _res = Lzma2Dec_DecodeToBuf(
-          &_dec, reinterpret_cast<Byte *>(&gsl::at(_dst, _out_pos)), &_dest_len,
-          reinterpret_cast<const Byte *>(&gsl::at(p_src, _in_pos)), &_src_len,
-          (_out_pos + _dest_len == _size_from_header) ? LZMA_FINISH_END
-                                                      : LZMA_FINISH_ANY,
-          &_status);
-      if (_res != SZ_OK) {
-        return W_FAILURE(std::errc::invalid_argument,
-                         "Lzma2Dec_DecodeToBuf failed");
-      }
+    if (_out_len > 0) {
+      BOOST_LEAF_CHECK(p_sink(gsl::span<const std::byte>(_out.data(), _out_len)));
+    }
+
+    if (_status == LZMA_STATUS_FINISHED_WITH_MARK) {
+      break;
+    }
+    if (_eof && _in_len == 0 && _out_len == 0) {
+      return W_FAILURE(std::errc::operation_canceled, "the lzma stream is truncated");
+    }
+  }
+
+  if (_total != p_size_from_header) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     wolf::format("lzma stream decoded {} bytes but {} bytes were expected",
+                                  _total, p_size_from_header));
+  }
+  return _total;
+}
+
+boost::leaf::result<uint64_t> w_lzma::decompress_lzma1(_In_ const w_lzma_source &p_source,
+                                                       _In_ const w_lzma_sink &p_sink,
+                                                       _In_ size_t p_chunk_size) {
+  constexpr auto _header_size = LZMA_PROPS_SIZE + LZMA_HEADER_SRC_SIZE;
+  if (p_chunk_size < _header_size) {
+    return W_FAILURE(std::errc::invalid_argument, "the chunk size is too small");
+  }
+
+  std::vector<std::byte> _in;
+  _in.resize(p_chunk_size);
+
+  BOOST_LEAF_AUTO(_in_len, s_pull_header(p_source, _in, _header_size));
+  const auto _size_from_header = s_read_src_size(_in, LZMA_PROPS_SIZE);
+
+  if (s_is_stored(_in)) {
+    return s_decode_stream(p_source, p_sink, _in, _in_len, _header_size, _size_from_header,
+                           p_chunk_size, s_decode_stored);
+  }
+
+  CLzmaDec _dec{};
+  LzmaDec_Construct(&_dec);
+
+  const auto _res = LzmaDec_Allocate(&_dec, reinterpret_cast<const Byte *>(_in.data()),
+                                     LZMA_PROPS_SIZE, &s_alloc_funcs);
+  if (_res != SZ_OK) {
+    return W_FAILURE(std::errc::invalid_argument,
+                     "could not allocate memory for lzma1 decoder");
+  }
+  DEFER { LzmaDec_Free(&_dec, &s_alloc_funcs); });
+
+  LzmaDec_Init(&_dec);
+
+  return s_decode_stream(
+      p_source, p_sink, _in, _in_len, _header_size, _size_from_header, p_chunk_size,
+      [&](Byte *p_dst, SizeT *p_dst_len, const Byte *p_src, SizeT *p_src_len,
+          ELzmaFinishMode p_finish, ELzmaStatus *p_status) {
+        return LzmaDec_DecodeToBuf(&_dec, p_dst, p_dst_len, p_src, p_src_len, p_finish,
+                                   p_status);
+      });
+}
+
+boost::leaf::result<uint64_t> w_lzma::decompress_lzma2(_In_ const w_lzma_source &p_source,
+                                                       _In_ const w_lzma_sink &p_sink,
+                                                       _In_ size_t p_chunk_size) {
+  constexpr auto _header_size = sizeof(Byte) + LZMA_HEADER_SRC_SIZE;
+  if (p_chunk_size < _header_size) {
+    return W_FAILURE(std::errc::invalid_argument, "the chunk size is too small");
+  }
+
+  std::vector<std::byte> _in;
+  _in.resize(p_chunk_size);
 
-      _in_pos += gsl::narrow_cast<uint32_t>(_src_len);
-      _out_pos += gsl::narrow_cast<uint32_t>(_dest_len);
-      if (_status == LZMA_STATUS_FINISHED_WITH_MARK) {
-        break;
+  BOOST_LEAF_AUTO(_in_len, s_pull_header(p_source, _in, _header_size));
+  const auto _size_from_header = s_read_src_size(_in, sizeof(Byte));
+
+  if (s_is_stored(_in)) {
+    return s_decode_stream(p_source, p_sink, _in, _in_len, _header_size, _size_from_header,
+                           p_chunk_size, s_decode_stored);
+  }
+
+  CLzma2Dec _dec{};
+  Lzma2Dec_Construct(&_dec);
+
+  const auto _res =
+      Lzma2Dec_Allocate(&_dec, std::to_integer<Byte>(_in[0]), &s_alloc_funcs);
+  if (_res != SZ_OK) {
+    return W_FAILURE(std::errc::invalid_argument,
+                     "could not allocate memory for lzma2 decoder");
+  }
+  DEFER { Lzma2Dec_Free(&_dec, &s_alloc_funcs); });
+
+  Lzma2Dec_Init(&_dec);
+
+  return s_decode_stream(
+      p_source, p_sink, _in, _in_len, _header_size, _size_from_header, p_chunk_size,
+      [&](Byte *p_dst, SizeT *p_dst_len, const Byte *p_src, SizeT *p_src_len,
+          ELzmaFinishMode p_finish, ELzmaStatus *p_status) {
+        return Lzma2Dec_DecodeToBuf(&_dec, p_dst, p_dst_len, p_src, p_src_len, p_finish,
+                                    p_status);
+      });
+}
+
+/*
+ * decompress a file to another file via one of the streaming decoders
+ */
+template <typename F>
+static boost::leaf::result<uint64_t>
+s_decompress_file(_In_ const std::filesystem::path &p_src_path,
+                  _In_ const std::filesystem::path &p_dst_path, _In_ F &&p_decompress) {
+  std::ifstream _src(p_src_path, std::ios::binary);
+  if (!_src.is_open()) {
+    return W_FAILURE(std::errc::no_such_file_or_directory,
+                     "could not open lzma source file " + p_src_path.string());
+  }
+  std::ofstream _dst(p_dst_path, std::ios::binary | std::ios::trunc);
+  if (!_dst.is_open()) {
+    return W_FAILURE(std::errc::io_error,
+                     "could not open lzma destination file " + p_dst_path.string());
+  }
+
+  const w_lzma_source _source =
+      [&](_Inout_ gsl::span<std::byte> p_buffer) -> boost::leaf::result<size_t> {
+    _src.read(reinterpret_cast<char *>(p_buffer.data()),
+              gsl::narrow_cast<std::streamsize>(p_buffer.size()));
+    if (_src.bad()) {
+      return W_FAILURE(std::errc::io_error, "could not read from lzma source file");
+    }
+    return gsl::narrow_cast<size_t>(_src.gcount());
+  };
+
+  const w_lzma_sink _sink =
+      [&](_In_ gsl::span<const std::byte> p_chunk) -> boost::leaf::result<int> {
+    _dst.write(reinterpret_cast<const char *>(p_chunk.data()),
+               gsl::narrow_cast<std::streamsize>(p_chunk.size()));
+    if (!_dst.good()) {
+      return W_FAILURE(std::errc::io_error, "could not write to lzma destination file");
+    }
+    return 0;
+  };
+
+  return p_decompress(_source, _sink);
+}
+
+boost::leaf::result<uint64_t>
+w_lzma::decompress_lzma1_file(_In_ const std::filesystem::path &p_src_path,
+                              _In_ const std::filesystem::path &p_dst_path) {
+  return s_decompress_file(p_src_path, p_dst_path,
+                           [](const w_lzma_source &p_source, const w_lzma_sink &p_sink) {
+                             return decompress_lzma1(p_source, p_sink);
+                           });
+}
+
+boost::leaf::result<uint64_t>
+w_lzma::decompress_lzma2_file(_In_ const std::filesystem::path &p_src_path,
+                              _In_ const std::filesystem::path &p_dst_path) {
+  return s_decompress_file(p_src_path, p_dst_path,
+                           [](const w_lzma_source &p_source, const w_lzma_sink &p_sink) {
+                             return decompress_lzma2(p_source, p_sink);
+                           });
+}
+
+namespace wolf::system::compression {
+/*
+ * a pool for the allocations of lzma sdk, the freed blocks are kept and handed out again
+ * for the next allocation with a close size, so after the first call a long-lived
+ * encoder or decoder does not touch the heap anymore
+ */
+struct w_lzma_arena {
+  // the allocator which is passed to lzma sdk, it must be the first member
+  struct alloc_t {
+    ISzAlloc vt;
+    w_lzma_arena *arena;
+  } alloc = {};
+
+  std::mutex lock;
+  std::vector<std::pair<size_t, void *>> blocks;
+
+  w_lzma_arena() noexcept;
+  ~w_lzma_arena() noexcept;
+
+  w_lzma_arena(const w_lzma_arena &) = delete;
+  w_lzma_arena &operator=(const w_lzma_arena &) = delete;
+
+  ISzAllocPtr get() const noexcept { return &this->alloc.vt; }
+};
+
+struct w_lzma_encoder_ctx {
+  w_lzma_arena arena;
+  CLzma2EncHandle handle = nullptr;
+  bool skip_incompressible = true;
+};
+
+struct w_lzma_decoder_ctx {
+  w_lzma_arena arena;
+  CLzma2Dec dec{};
+};
+} // namespace wolf::system::compression
+
+using w_lzma_arena = wolf::system::compression::w_lzma_arena;
+
+// every block keeps its capacity in front of the address which is returned to lzma sdk
+constexpr auto LZMA_ARENA_BLOCK_HEADER = alignof(std::max_align_t);
+// number of free blocks which are reserved up front
+constexpr auto LZMA_ARENA_RESERVED_BLOCKS = 32;
+
+static void *s_lzma_arena_alloc(ISzAllocPtr p_ptr, size_t p_size) noexcept {
+  auto *_arena = reinterpret_cast<const w_lzma_arena::alloc_t *>(p_ptr)->arena;
+  {
+    std::scoped_lock _lock(_arena->lock);
+
+    // find the smallest free block which fits, but do not waste more than half of it
+    auto _best = _arena->blocks.end();
+    for (auto _iter = _arena->blocks.begin(); _iter != _arena->blocks.end(); ++_iter) {
+      if (_iter->first >= p_size && _iter->first / 2 <= p_size &&
+          (_best == _arena->blocks.end() || _iter->first < _best->first)) {
+        _best = _iter;
       }
     }
+    if (_best != _arena->blocks.end()) {
+      auto *_addr = _best->second;
+      *_best = _arena->blocks.back();
+      _arena->blocks.pop_back();
+      return _addr;
+    }
+  }
 
-    Lzma2Dec_Free(&_dec, &s_alloc_funcs);
+  auto *_block = static_cast<std::byte *>(malloc(LZMA_ARENA_BLOCK_HEADER + p_size));
+  if (_block == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(_block, &p_size, sizeof(p_size));
+  return _block + LZMA_ARENA_BLOCK_HEADER;
+}
 
-    if (_out_pos == _size_from_header) {
-      return _dst;
+static void s_lzma_arena_free(ISzAllocPtr p_ptr, void *p_addr) noexcept {
+  if (p_addr == nullptr) {
+    return;
+  }
+  auto *_arena = reinterpret_cast<const w_lzma_arena::alloc_t *>(p_ptr)->arena;
+
+  size_t _size = 0;
+  std::memcpy(&_size, static_cast<std::byte *>(p_addr) - LZMA_ARENA_BLOCK_HEADER,
+              sizeof(_size));
+
+  std::scoped_lock _lock(_arena->lock);
+  try {
+    _arena->blocks.emplace_back(_size, p_addr);
+  } catch (...) {
+    free(static_cast<std::byte *>(p_addr) - LZMA_ARENA_BLOCK_HEADER);
+  }
+}
+
+w_lzma_arena::w_lzma_arena() noexcept {
+  this->alloc.vt = {s_lzma_arena_alloc, s_lzma_arena_free};
+  this->alloc.arena = this;
+  try {
+    this->blocks.reserve(LZMA_ARENA_RESERVED_BLOCKS);
+  } catch (...) {
+    // the pool grows on demand
+  }
+}
+
+w_lzma_arena::~w_lzma_arena() noexcept {
+  for (const auto &_block : this->blocks) {
+    free(static_cast<std::byte *>(_block.second) - LZMA_ARENA_BLOCK_HEADER);
+  }
+  this->blocks.clear();
+}
+
+size_t w_lzma_encoder::get_compress_bound(_In_ uint64_t p_src_size) noexcept {
+  // lzma2 stores incompressible chunks with 3 bytes of header per 64KB,
+  // so there is no need for twice of the source size
+  constexpr auto _header_size = LZMA_HEADER_SRC_SIZE + sizeof(Byte);
+  return gsl::narrow_cast<size_t>(_header_size + p_src_size + p_src_size / 512 + 4096);
+}
+
+boost::leaf::result<int> w_lzma_encoder::init(_In_ const w_lzma2_options &p_options) {
+  _release();
+
+  this->_ctx = new (std::nothrow) w_lzma_encoder_ctx();
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "could not allocate memory for lzma2 encoder");
+  }
+
+  const auto _alloc = this->_ctx->arena.get();
+  this->_ctx->handle = Lzma2Enc_Create(_alloc, _alloc);
+  if (this->_ctx->handle == nullptr) {
+    // a failed encoder reads as not initialized
+    _release();
+    return W_FAILURE(std::errc::operation_canceled, "failed on creating lzma2 encoder");
+  }
+
+  // the size of source is unknown, so the dictionary comes from the level
+  // and lzma2 shrinks its tables for each call via the expected data size
+  constexpr auto _max_level = 9U;
+  constexpr auto _fb = 40;
+  constexpr auto _min_dic_size = uint64_t(1) << 12;
+
+  CLzmaEncProps _props_1{};
+  LzmaEncProps_Init(&_props_1);
+  _props_1.level = gsl::narrow_cast<int>(std::min(p_options.level, _max_level));
+  _props_1.fb = _fb;
+  LzmaEncProps_Normalize(&_props_1);
+
+  // the dictionary never grows beyond a block
+  if (p_options.block_size > 0 && _props_1.dictSize > p_options.block_size) {
+    _props_1.dictSize =
+        gsl::narrow_cast<uint32_t>(std::max(p_options.block_size, _min_dic_size));
+  }
+
+  auto _block_threads = p_options.block_threads;
+  if (_block_threads <= 0) {
+    _block_threads = std::max(1, gsl::narrow_cast<int>(std::thread::hardware_concurrency()));
+  }
+
+  CLzma2EncProps _props_2{};
+  Lzma2EncProps_Init(&_props_2);
+  _props_2.lzmaProps = _props_1;
+  _props_2.blockSize = p_options.block_size;
+  _props_2.numBlockThreads_Max = _block_threads;
+  _props_2.numTotalThreads =
+      p_options.total_threads > 0 ? p_options.total_threads : _block_threads;
+
+  if (Lzma2Enc_SetProps(this->_ctx->handle, &_props_2) != SZ_OK) {
+    _release();
+    return W_FAILURE(std::errc::operation_canceled,
+                     "failed on setting lzma2 encoder properties");
+  }
+  this->_ctx->skip_incompressible = p_options.skip_incompressible;
+  return 0;
+}
+
+boost::leaf::result<size_t> w_lzma_encoder::compress(_In_ const gsl::span<const std::byte> p_src,
+                                                     _Inout_ gsl::span<std::byte> p_dst) {
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "lzma2 encoder is not initialized");
+  }
+  if (p_src.empty()) {
+    return W_FAILURE(std::errc::invalid_argument, "the source is empty");
+  }
+
+  constexpr auto _header_size = LZMA_HEADER_SRC_SIZE + sizeof(Byte);
+  if (p_dst.size() <= _header_size) {
+    return W_FAILURE(std::errc::no_buffer_space, "the destination is too small");
+  }
+
+  // a stored stream fits whenever the destination could keep the source itself
+  const auto _can_store = p_dst.size() >= _header_size + p_src.size();
+  if (_can_store && this->_ctx->skip_incompressible && !w_entropy::is_compressible(p_src)) {
+    s_write_stored(p_dst, sizeof(Byte), p_src);
+    return _header_size + p_src.size();
+  }
+
+  const auto _src_size = gsl::narrow_cast<uint64_t>(p_src.size());
+  Lzma2Enc_SetDataSize(this->_ctx->handle, _src_size);
+
+  // 1 byte properties + 8 bytes uncompressed size
+  gsl::at(p_dst, 0) = std::byte(Lzma2Enc_WriteProperties(this->_ctx->handle));
+  for (size_t i = 0; i < LZMA_HEADER_SRC_SIZE; i++) {
+    gsl::at(p_dst, sizeof(Byte) + i) = std::byte((_src_size >> (i * 8)) & 0xFF);
+  }
+
+  auto _output_size = p_dst.size() - _header_size;
+  const auto _encode_status = Lzma2Enc_Encode2(
+      this->_ctx->handle, nullptr, reinterpret_cast<Byte *>(p_dst.data() + _header_size),
+      &_output_size, nullptr, reinterpret_cast<const Byte *>(p_src.data()), p_src.size(),
+      nullptr);
+
+  // there is no gain, so store the source as is
+  if (_can_store && (_encode_status == SZ_ERROR_OUTPUT_EOF ||
+                     (_encode_status == SZ_OK && _output_size >= p_src.size()))) {
+    s_write_stored(p_dst, sizeof(Byte), p_src);
+    return _header_size + p_src.size();
+  }
+  if (_encode_status == SZ_ERROR_OUTPUT_EOF) {
+    return W_FAILURE(std::errc::no_buffer_space,
+                     "the destination is too small, see w_lzma_encoder::get_compress_bound");
+  }
+  if (_encode_status != SZ_OK) {
+    return W_FAILURE(std::errc::operation_canceled, "lzma2 compress failed");
+  }
+  return _header_size + _output_size;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_lzma_encoder::compress(_In_ const gsl::span<const std::byte> p_src) {
+  std::vector<std::byte> _dst;
+  _dst.resize(get_compress_bound(p_src.size()));
+
+  BOOST_LEAF_AUTO(_size, compress(p_src, _dst));
+  _dst.resize(_size);
+  return _dst;
+}
+
+void w_lzma_encoder::_release() noexcept {
+  if (this->_ctx != nullptr) {
+    // the encoder must return its blocks before the arena goes away
+    if (this->_ctx->handle != nullptr) {
+      Lzma2Enc_Destroy(this->_ctx->handle);
     }
+    delete this->_ctx;
+    this->_ctx = nullptr;
   }
+}
 
-  return W_FAILURE(std::errc::operation_canceled, "lzma2 decompress failed");
+void w_lzma_encoder::_move(_Inout_ w_lzma_encoder &&p_other) noexcept {
+  if (this == &p_other) {
+    return;
+  }
+  _release();
+  this->_ctx = std::exchange(p_other._ctx, nullptr);
+}
+
+boost::leaf::result<int> w_lzma_decoder::init() {
+  _release();
+
+  this->_ctx = new (std::nothrow) w_lzma_decoder_ctx();
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "could not allocate memory for lzma2 decoder");
+  }
+  Lzma2Dec_Construct(&this->_ctx->dec);
+  return 0;
+}
+
+boost::leaf::result<uint64_t>
+w_lzma_decoder::get_decompressed_size(_In_ const gsl::span<const std::byte> p_src) {
+  if (p_src.size() < LZMA_HEADER_SRC_SIZE + sizeof(Byte)) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid lzma2 header size");
+  }
+  return s_read_src_size(p_src, sizeof(Byte));
+}
+
+boost::leaf::result<size_t> w_lzma_decoder::decompress(_In_ const gsl::span<const std::byte> p_src,
+                                                       _Inout_ gsl::span<std::byte> p_dst) {
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "lzma2 decoder is not initialized");
+  }
+
+  BOOST_LEAF_AUTO(_size_from_header, get_decompressed_size(p_src));
+  if (p_dst.size() < _size_from_header) {
+    return W_FAILURE(std::errc::no_buffer_space,
+                     wolf::format("the destination is {} bytes but {} bytes are required",
+                                  p_dst.size(), _size_from_header));
+  }
+
+  constexpr auto _header_size = LZMA_HEADER_SRC_SIZE + sizeof(Byte);
+  if (s_is_stored(p_src)) {
+    return s_read_stored(p_src.subspan(_header_size),
+                         p_dst.first(gsl::narrow_cast<size_t>(_size_from_header)));
+  }
+
+  // the dictionary and the probabilities are only reallocated when the property changes
+  const auto _properties = std::to_integer<Byte>(gsl::at(p_src, 0));
+  if (Lzma2Dec_Allocate(&this->_ctx->dec, _properties, this->_ctx->arena.get()) != SZ_OK) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "could not allocate memory for lzma2 decoder");
+  }
+  Lzma2Dec_Init(&this->_ctx->dec);
+
+  auto _dst_len = gsl::narrow_cast<SizeT>(_size_from_header);
+  auto _src_len = gsl::narrow_cast<SizeT>(p_src.size() - _header_size);
+  ELzmaStatus _status = LZMA_STATUS_NOT_SPECIFIED;
+
+  const auto _decode_status = Lzma2Dec_DecodeToBuf(
+      &this->_ctx->dec, reinterpret_cast<Byte *>(p_dst.data()), &_dst_len,
+      reinterpret_cast<const Byte *>(p_src.data() + _header_size), &_src_len, LZMA_FINISH_END,
+      &_status);
+  if (_decode_status != SZ_OK || _dst_len != _size_from_header) {
+    return W_FAILURE(std::errc::operation_canceled, "lzma2 decompress failed");
+  }
+  return gsl::narrow_cast<size_t>(_dst_len);
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_lzma_decoder::decompress(_In_ const gsl::span<const std::byte> p_src) {
+  BOOST_LEAF_AUTO(_size_from_header, get_decompressed_size(p_src));
+  if (_size_from_header > MAX_HEADER_SIZE) {
+    return W_FAILURE(std::errc::value_too_large,
+                     "lzma2 decompressed size is too large, use the streaming decoder");
+  }
+
+  std::vector<std::byte> _dst;
+  _dst.resize(_size_from_header);
+
+  BOOST_LEAF_CHECK(decompress(p_src, _dst));
+  return _dst;
+}
+
+void w_lzma_decoder::_release() noexcept {
+  if (this->_ctx != nullptr) {
+    // the decoder must return its blocks before the arena goes away
+    Lzma2Dec_Free(&this->_ctx->dec, this->_ctx->arena.get());
+    delete this->_ctx;
+    this->_ctx = nullptr;
+  }
+}
+
+void w_lzma_decoder::_move(_Inout_ w_lzma_decoder &&p_other) noexcept {
+  if (this == &p_other) {
+    return;
+  }
+  _release();
+  this->_ctx = std::exchange(p_other._ctx, nullptr);
 }
 
 #endif // WOLF_SYSTEM_LZMA
\ No newline at end of file
@@ -9,12 +9,50 @@
 
 #include <wolf/wolf.hpp>
 
+#include <filesystem>
+#include <functional>
+
 namespace wolf::system::compression {
 
+// the internal state of reusable encoder and decoder, defined in w_lzma.cpp
+struct w_lzma_encoder_ctx;
+struct w_lzma_decoder_ctx;
+
+/*
+ * pull the next chunk of compressed stream into the buffer
+ * @param p_buffer, the buffer which should be filled
+ * @returns number of bytes which were read, zero means the end of stream
+ */
+typedef std::function<boost::leaf::result<size_t>(_Inout_ gsl::span<std::byte> p_buffer)>
+    w_lzma_source;
+
+/*
+ * consume a chunk of decompressed stream, the chunk is only valid during the call
+ * @param p_chunk, the decompressed chunk
+ * @returns zero on success
+ */
+typedef std::function<boost::leaf::result<int>(_In_ gsl::span<const std::byte> p_chunk)>
+    w_lzma_sink;
+
+struct w_lzma2_options {
+  // the level of compression, a value between 0 - 9
+  uint32_t level = 5;
+  // the size of each independent block in bytes, zero means auto
+  // (input size divided between block threads, at least 1MB)
+  uint64_t block_size = 0;
+  // number of blocks which are encoded in parallel, zero means the number of hardware threads
+  int block_threads = 0;
+  // number of all threads, zero means one thread per block
+  int total_threads = 0;
+  // store the source which is estimated as incompressible without compressing it
+  bool skip_incompressible = true;
+};
+
 struct w_lzma {
 
   /*
-   * compress a stream via lzma1 algorithm
+   * compress a stream via lzma1 algorithm, an incompressible source is stored as is
+   * with a marker in its header, so the decoders pass it through
    * @param p_src, the input source
    * @param p_level, the level of compression
    * @returns a vector of compressed stream
@@ -33,6 +71,18 @@ struct w_lzma {
   compress_lzma2(_In_ const gsl::span<const std::byte> p_src,
                  _In_ uint32_t p_level);
 
+  /*
+   * compress a stream via lzma2 algorithm, the input is split into
+   * independent blocks which are encoded in parallel. The output
+   * could be decompressed via decompress_lzma2
+   * @param p_src, the input source
+   * @param p_options, the options of lzma2 encoder
+   * @returns a vector of compressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  compress_lzma2(_In_ const gsl::span<const std::byte> p_src,
+                 _In_ const w_lzma2_options &p_options);
+
   /*
    * decompress a stream via lzma1 algorithm
    * @param p_src, the input source
@@ -48,7 +98,185 @@ struct w_lzma {
    */
   W_API static boost::leaf::result<std::vector<std::byte>>
   decompress_lzma2(_In_ gsl::span<const std::byte> p_src);
+
+  /*
+   * decompress a stream via lzma1 algorithm in constant memory,
+   * the input is pulled from the source and the output is pushed into the sink
+   * @param p_source, the source of compressed stream
+   * @param p_sink, the sink of decompressed chunks
+   * @param p_chunk_size, the size of input and output buffers
+   * @returns number of decompressed bytes
+   */
+  W_API static boost::leaf::result<uint64_t>
+  decompress_lzma1(_In_ const w_lzma_source &p_source, _In_ const w_lzma_sink &p_sink,
+                   _In_ size_t p_chunk_size = 1024 * 1024);
+
+  /*
+   * decompress a stream via lzma2 algorithm in constant memory,
+   * the input is pulled from the source and the output is pushed into the sink
+   * @param p_source, the source of compressed stream
+   * @param p_sink, the sink of decompressed chunks
+   * @param p_chunk_size, the size of input and output buffers
+   * @returns number of decompressed bytes
+   */
+  W_API static boost::leaf::result<uint64_t>
+  decompress_lzma2(_In_ const w_lzma_source &p_source, _In_ const w_lzma_sink &p_sink,
+                   _In_ size_t p_chunk_size = 1024 * 1024);
+
+  /*
+   * decompress a file via lzma1 algorithm in constant memory
+   * @param p_src_path, the path of compressed file
+   * @param p_dst_path, the path of decompressed file
+   * @returns number of decompressed bytes
+   */
+  W_API static boost::leaf::result<uint64_t>
+  decompress_lzma1_file(_In_ const std::filesystem::path &p_src_path,
+                        _In_ const std::filesystem::path &p_dst_path);
+
+  /*
+   * decompress a file via lzma2 algorithm in constant memory
+   * @param p_src_path, the path of compressed file
+   * @param p_dst_path, the path of decompressed file
+   * @returns number of decompressed bytes
+   */
+  W_API static boost::leaf::result<uint64_t>
+  decompress_lzma2_file(_In_ const std::filesystem::path &p_src_path,
+                        _In_ const std::filesystem::path &p_dst_path);
+};
+
+/*
+ * a long-lived lzma2 encoder, the encoder and its match finder tables are created once
+ * and all internal allocations are served from a pool owned by the encoder,
+ * so compressing many blobs with the same options does not touch the heap after warm up
+ */
+class w_lzma_encoder {
+ public:
+  // default constructor
+  W_API w_lzma_encoder() noexcept = default;
+
+  // move constructor.
+  W_API w_lzma_encoder(w_lzma_encoder &&p_other) noexcept {
+    _move(std::forward<w_lzma_encoder &&>(p_other));
+  }
+  // move assignment operator.
+  W_API w_lzma_encoder &operator=(w_lzma_encoder &&p_other) noexcept {
+    _move(std::forward<w_lzma_encoder &&>(p_other));
+    return *this;
+  }
+
+  // destructor
+  W_API virtual ~w_lzma_encoder() noexcept { _release(); }
+
+  /*
+   * create the encoder, when the block size is zero, the block size is chosen by lzma2
+   * @param p_options, the options of lzma2 encoder
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init(_In_ const w_lzma2_options &p_options = {});
+
+  /*
+   * get the maximum size of the compressed stream
+   * @param p_src_size, the size of input source
+   * @returns the size which the destination buffer should have
+   */
+  W_API static size_t get_compress_bound(_In_ uint64_t p_src_size) noexcept;
+
+  /*
+   * compress into the caller's buffer, the output is the same stream of w_lzma::compress_lzma2
+   * @param p_src, the input source
+   * @param p_dst, the destination, see get_compress_bound
+   * @returns number of compressed bytes
+   */
+  W_API boost::leaf::result<size_t> compress(_In_ const gsl::span<const std::byte> p_src,
+                                             _Inout_ gsl::span<std::byte> p_dst);
+
+  /*
+   * compress into a new vector
+   * @param p_src, the input source
+   * @returns the vector of compressed stream
+   */
+  W_API boost::leaf::result<std::vector<std::byte>>
+  compress(_In_ const gsl::span<const std::byte> p_src);
+
+ private:
+  // copy constructor.
+  w_lzma_encoder(const w_lzma_encoder &) = delete;
+  // copy assignment operator.
+  w_lzma_encoder &operator=(const w_lzma_encoder &) = delete;
+  // release the resources
+  void _release() noexcept;
+  // move the resources
+  void _move(_Inout_ w_lzma_encoder &&p_other) noexcept;
+
+  gsl::owner<w_lzma_encoder_ctx *> _ctx = nullptr;
+};
+
+/*
+ * a long-lived lzma2 decoder, the dictionary is kept between calls
+ * and all internal allocations are served from a pool owned by the decoder
+ */
+class w_lzma_decoder {
+ public:
+  // default constructor
+  W_API w_lzma_decoder() noexcept = default;
+
+  // move constructor.
+  W_API w_lzma_decoder(w_lzma_decoder &&p_other) noexcept {
+    _move(std::forward<w_lzma_decoder &&>(p_other));
+  }
+  // move assignment operator.
+  W_API w_lzma_decoder &operator=(w_lzma_decoder &&p_other) noexcept {
+    _move(std::forward<w_lzma_decoder &&>(p_other));
+    return *this;
+  }
+
+  // destructor
+  W_API virtual ~w_lzma_decoder() noexcept { _release(); }
+
+  /*
+   * create the decoder
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init();
+
+  /*
+   * get the decompressed size which was stored in the header of lzma2 stream
+   * @param p_src, the compressed stream
+   * @returns the decompressed size
+   */
+  W_API static boost::leaf::result<uint64_t>
+  get_decompressed_size(_In_ const gsl::span<const std::byte> p_src);
+
+  /*
+   * decompress a lzma2 stream into the caller's buffer
+   * @param p_src, the compressed stream
+   * @param p_dst, the destination, see get_decompressed_size
+   * @returns number of decompressed bytes
+   */
+  W_API boost::leaf::result<size_t> decompress(_In_ const gsl::span<const std::byte> p_src,
+                                               _Inout_ gsl::span<std::byte> p_dst);
+
+  /*
+   * decompress a lzma2 stream into a new vector
+   * @param p_src, the compressed stream
+   * @returns the vector of decompressed stream
+   */
+  W_API boost::leaf::result<std::vector<std::byte>>
+  decompress(_In_ const gsl::span<const std::byte> p_src);
+
+ private:
+  // copy constructor.
+  w_lzma_decoder(const w_lzma_decoder &) = delete;
+  // copy assignment operator.
+  w_lzma_decoder &operator=(const w_lzma_decoder &) = delete;
+  // release the resources
+  void _release() noexcept;
+  // move the resources
+  void _move(_Inout_ w_lzma_decoder &&p_other) noexcept;
+
+  gsl::owner<w_lzma_decoder_ctx *> _ctx = nullptr;
 };
+
 } // namespace wolf::system::compression
 
 #endif // WOLF_SYSTEM_LZMA
\ No newline at end of file
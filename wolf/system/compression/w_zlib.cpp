@@ -0,0 +1,364 @@
+#include "w_zlib.hpp"
+
+#ifdef WOLF_SYSTEM_ZLIB
+
+#include <DISABLE_ANALYSIS_BEGIN>
+#include <zlib.h>
+#include <DISABLE_ANALYSIS_END>
+
+#include <climits>
+
+using w_zlib = wolf::system::compression::w_zlib;
+using w_zlib_deflater = wolf::system::compression::w_zlib_deflater;
+using w_zlib_format = wolf::system::compression::w_zlib_format;
+using w_zlib_inflater = wolf::system::compression::w_zlib_inflater;
+using w_zlib_progress = wolf::system::compression::w_zlib_progress;
+
+// the size of gzip trailer which keeps crc32 and the size of input modulo 2^32
+constexpr auto ZLIB_GZIP_TRAILER_SIZE = 8;
+// the minimum size of destination when the decompressed size is unknown
+constexpr auto ZLIB_MIN_INFLATE_SIZE = size_t(4096);
+
+static int s_window_bits(_In_ w_zlib_format p_format) noexcept {
+  // negative bits means raw deflate, 16 more bits means gzip framing
+  constexpr auto _max_wbits = MAX_WBITS;
+  switch (p_format) {
+  case w_zlib_format::RAW:
+    return -_max_wbits;
+  case w_zlib_format::ZLIB:
+    return _max_wbits;
+  default:
+    return _max_wbits + 16;
+  }
+}
+
+static std::string s_zlib_error(_In_ const z_stream *p_stream, _In_ int p_ret) {
+  if (p_stream != nullptr && p_stream->msg != nullptr) {
+    return wolf::format("{} ({})", p_stream->msg, p_ret);
+  }
+  return wolf::format("{} ({})", zError(p_ret), p_ret);
+}
+
+/*
+ * run deflate or inflate over the whole source and destination,
+ * zlib counts with 32 bits, so bigger buffers are fed in pieces
+ */
+template <typename F>
+static int s_run(_Inout_ z_stream *p_stream, _In_ const gsl::span<const std::byte> p_src,
+                 _Inout_ gsl::span<std::byte> p_dst, _In_ int p_flush,
+                 _Inout_ w_zlib_progress &p_progress, _In_ F &&p_func) noexcept {
+  constexpr auto _max_chunk = size_t(UINT_MAX);
+
+  p_progress = {};
+  for (;;) {
+    const auto _in_chunk = std::min(p_src.size() - p_progress.src_consumed, _max_chunk);
+    const auto _out_chunk = std::min(p_dst.size() - p_progress.dst_written, _max_chunk);
+    const auto _last = p_progress.src_consumed + _in_chunk == p_src.size();
+
+    // zlib does not write into its input
+    p_stream->next_in =
+        reinterpret_cast<Bytef *>(const_cast<std::byte *>(p_src.data() + p_progress.src_consumed));
+    p_stream->avail_in = gsl::narrow_cast<uInt>(_in_chunk);
+    p_stream->next_out = reinterpret_cast<Bytef *>(p_dst.data() + p_progress.dst_written);
+    p_stream->avail_out = gsl::narrow_cast<uInt>(_out_chunk);
+
+    const auto _ret = p_func(p_stream, _last ? p_flush : Z_NO_FLUSH);
+
+    p_progress.src_consumed += _in_chunk - p_stream->avail_in;
+    p_progress.dst_written += _out_chunk - p_stream->avail_out;
+
+    if (_ret != Z_OK && _ret != Z_BUF_ERROR) {
+      return _ret;
+    }
+    // continue only when one of the pieces was exhausted and there is more
+    const auto _more_in = p_stream->avail_in == 0 && p_progress.src_consumed < p_src.size();
+    const auto _more_out = p_stream->avail_out == 0 && p_progress.dst_written < p_dst.size();
+    if (!_more_in && !_more_out) {
+      return _ret;
+    }
+  }
+}
+
+static int s_deflate(_Inout_ z_stream *p_stream, _In_ int p_flush) noexcept {
+  return deflate(p_stream, p_flush);
+}
+
+static int s_inflate(_Inout_ z_stream *p_stream, _In_ int p_flush) noexcept {
+  return inflate(p_stream, p_flush);
+}
+
+size_t w_zlib::get_compress_bound(_In_ size_t p_src_size) noexcept {
+  // the bound of compressBound plus the difference between zlib and gzip headers
+  constexpr auto _header_size = size_t(13 + 12);
+  return p_src_size + (p_src_size >> 12) + (p_src_size >> 14) + (p_src_size >> 25) +
+         _header_size;
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_zlib::compress(_In_ const gsl::span<const std::byte> p_src, _In_ w_zlib_format p_format,
+                 _In_ int p_level) {
+  w_zlib_deflater _deflater;
+  BOOST_LEAF_CHECK(_deflater.init(p_format, p_level));
+  return _deflater.compress(p_src);
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_zlib::decompress(_In_ const gsl::span<const std::byte> p_src, _In_ w_zlib_format p_format) {
+  w_zlib_inflater _inflater;
+  BOOST_LEAF_CHECK(_inflater.init(p_format));
+  return _inflater.decompress(p_src);
+}
+
+boost::leaf::result<int> w_zlib_deflater::init(_In_ w_zlib_format p_format, _In_ int p_level,
+                                               _In_ int p_mem_level) noexcept {
+  _release();
+
+  if (p_level < Z_NO_COMPRESSION || p_level > Z_BEST_COMPRESSION) {
+    return W_FAILURE(std::errc::invalid_argument, "zlib level must be between 0 - 9");
+  }
+  if (p_mem_level < 1 || p_mem_level > MAX_MEM_LEVEL) {
+    return W_FAILURE(std::errc::invalid_argument, "zlib memory level must be between 1 - 9");
+  }
+
+  auto *_stream = new (std::nothrow) z_stream();
+  if (_stream == nullptr) {
+    return W_FAILURE(std::errc::not_enough_memory, "could not allocate memory for z_stream");
+  }
+
+  const auto _ret = deflateInit2(_stream, p_level, Z_DEFLATED, s_window_bits(p_format),
+                                 p_mem_level, Z_DEFAULT_STRATEGY);
+  if (_ret != Z_OK) {
+    delete _stream;
+    return W_FAILURE(std::errc::operation_canceled,
+                     "deflateInit2 failed because " + s_zlib_error(nullptr, _ret));
+  }
+
+  this->_stream = _stream;
+  return 0;
+}
+
+size_t w_zlib_deflater::get_compress_bound(_In_ size_t p_src_size) const noexcept {
+  if (this->_stream != nullptr && p_src_size <= size_t(ULONG_MAX)) {
+    const auto _src_size = gsl::narrow_cast<uLong>(p_src_size);
+    return gsl::narrow_cast<size_t>(deflateBound(this->_stream, _src_size));
+  }
+  return w_zlib::get_compress_bound(p_src_size);
+}
+
+boost::leaf::result<size_t>
+w_zlib_deflater::compress(_In_ const gsl::span<const std::byte> p_src,
+                          _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_stream == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "w_zlib_deflater is not initialized");
+  }
+
+  // drop any unfinished stream
+  deflateReset(this->_stream);
+
+  w_zlib_progress _progress = {};
+  const auto _ret = s_run(this->_stream, p_src, p_dst, Z_FINISH, _progress, s_deflate);
+  deflateReset(this->_stream);
+
+  if (_ret == Z_STREAM_END) {
+    return _progress.dst_written;
+  }
+  if (_ret == Z_OK || _ret == Z_BUF_ERROR) {
+    return W_FAILURE(std::errc::no_buffer_space,
+                     "the destination is too small, see w_zlib_deflater::get_compress_bound");
+  }
+  return W_FAILURE(std::errc::operation_canceled,
+                   "deflate failed because " + s_zlib_error(this->_stream, _ret));
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_zlib_deflater::compress(_In_ const gsl::span<const std::byte> p_src) {
+  std::vector<std::byte> _dst;
+  _dst.resize(get_compress_bound(p_src.size()));
+
+  BOOST_LEAF_AUTO(_size, compress(p_src, _dst));
+  _dst.resize(_size);
+  return _dst;
+}
+
+boost::leaf::result<w_zlib_progress>
+w_zlib_deflater::update(_In_ const gsl::span<const std::byte> p_src,
+                        _Inout_ gsl::span<std::byte> p_dst, _In_ bool p_flush) noexcept {
+  if (this->_stream == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "w_zlib_deflater is not initialized");
+  }
+
+  w_zlib_progress _progress = {};
+  const auto _ret = s_run(this->_stream, p_src, p_dst, p_flush ? Z_SYNC_FLUSH : Z_NO_FLUSH,
+                          _progress, s_deflate);
+  if (_ret != Z_OK && _ret != Z_BUF_ERROR) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     "deflate failed because " + s_zlib_error(this->_stream, _ret));
+  }
+  return _progress;
+}
+
+boost::leaf::result<w_zlib_progress>
+w_zlib_deflater::end(_Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_stream == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "w_zlib_deflater is not initialized");
+  }
+
+  w_zlib_progress _progress = {};
+  const auto _ret = s_run(this->_stream, {}, p_dst, Z_FINISH, _progress, s_deflate);
+  if (_ret == Z_STREAM_END) {
+    _progress.finished = true;
+    deflateReset(this->_stream);
+    return _progress;
+  }
+  if (_ret != Z_OK && _ret != Z_BUF_ERROR) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     "deflate failed because " + s_zlib_error(this->_stream, _ret));
+  }
+  return _progress;
+}
+
+void w_zlib_deflater::_release() noexcept {
+  if (this->_stream != nullptr) {
+    deflateEnd(this->_stream);
+    delete this->_stream;
+    this->_stream = nullptr;
+  }
+}
+
+void w_zlib_deflater::_move(_Inout_ w_zlib_deflater &&p_other) noexcept {
+  if (this == &p_other) {
+    return;
+  }
+  _release();
+  this->_stream = std::exchange(p_other._stream, nullptr);
+}
+
+boost::leaf::result<int> w_zlib_inflater::init(_In_ w_zlib_format p_format) noexcept {
+  _release();
+
+  auto *_stream = new (std::nothrow) z_stream();
+  if (_stream == nullptr) {
+    return W_FAILURE(std::errc::not_enough_memory, "could not allocate memory for z_stream");
+  }
+
+  const auto _ret = inflateInit2(_stream, s_window_bits(p_format));
+  if (_ret != Z_OK) {
+    delete _stream;
+    return W_FAILURE(std::errc::operation_canceled,
+                     "inflateInit2 failed because " + s_zlib_error(nullptr, _ret));
+  }
+
+  this->_stream = _stream;
+  this->_format = p_format;
+  return 0;
+}
+
+boost::leaf::result<size_t>
+w_zlib_inflater::decompress(_In_ const gsl::span<const std::byte> p_src,
+                            _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  BOOST_LEAF_CHECK(reset());
+
+  BOOST_LEAF_AUTO(_progress, update(p_src, p_dst));
+  if (_progress.finished) {
+    return _progress.dst_written;
+  }
+
+  // drop the unfinished stream, so the next call starts from the beginning
+  inflateReset(this->_stream);
+  if (_progress.dst_written == p_dst.size()) {
+    return W_FAILURE(std::errc::no_buffer_space, "the destination is too small");
+  }
+  return W_FAILURE(std::errc::invalid_argument, "the deflate stream is truncated");
+}
+
+boost::leaf::result<std::vector<std::byte>>
+w_zlib_inflater::decompress(_In_ const gsl::span<const std::byte> p_src) {
+  BOOST_LEAF_CHECK(reset());
+
+  // gzip keeps the size of input modulo 2^32 at the end, which is a good guess
+  auto _size = std::max(ZLIB_MIN_INFLATE_SIZE, p_src.size() * 4);
+  if (this->_format == w_zlib_format::GZIP && p_src.size() >= ZLIB_GZIP_TRAILER_SIZE) {
+    uint32_t _isize = 0;
+    for (size_t i = 0; i < sizeof(_isize); ++i) {
+      _isize |= std::to_integer<uint32_t>(gsl::at(p_src, p_src.size() - sizeof(_isize) + i))
+                << (i * 8);
+    }
+    _size = std::max(_size, gsl::narrow_cast<size_t>(_isize));
+  }
+
+  std::vector<std::byte> _dst;
+  _dst.resize(_size);
+
+  size_t _in_pos = 0;
+  size_t _out_pos = 0;
+  for (;;) {
+    BOOST_LEAF_AUTO(_progress, update(p_src.subspan(_in_pos),
+                                      gsl::span(_dst.data() + _out_pos, _dst.size() - _out_pos)));
+    _in_pos += _progress.src_consumed;
+    _out_pos += _progress.dst_written;
+
+    if (_progress.finished) {
+      break;
+    }
+    if (_out_pos == _dst.size()) {
+      _dst.resize(_dst.size() * 2);
+      continue;
+    }
+    if (_in_pos == p_src.size()) {
+      inflateReset(this->_stream);
+      return W_FAILURE(std::errc::invalid_argument, "the deflate stream is truncated");
+    }
+  }
+
+  _dst.resize(_out_pos);
+  return _dst;
+}
+
+boost::leaf::result<w_zlib_progress>
+w_zlib_inflater::update(_In_ const gsl::span<const std::byte> p_src,
+                        _Inout_ gsl::span<std::byte> p_dst) noexcept {
+  if (this->_stream == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "w_zlib_inflater is not initialized");
+  }
+
+  w_zlib_progress _progress = {};
+  const auto _ret = s_run(this->_stream, p_src, p_dst, Z_NO_FLUSH, _progress, s_inflate);
+  if (_ret == Z_STREAM_END) {
+    _progress.finished = true;
+    inflateReset(this->_stream);
+    return _progress;
+  }
+  if (_ret != Z_OK && _ret != Z_BUF_ERROR) {
+    const auto _msg = s_zlib_error(this->_stream, _ret);
+    inflateReset(this->_stream);
+    return W_FAILURE(std::errc::invalid_argument, "inflate failed because " + _msg);
+  }
+  return _progress;
+}
+
+boost::leaf::result<int> w_zlib_inflater::reset() noexcept {
+  if (this->_stream == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "w_zlib_inflater is not initialized");
+  }
+  inflateReset(this->_stream);
+  return 0;
+}
+
+void w_zlib_inflater::_release() noexcept {
+  if (this->_stream != nullptr) {
+    inflateEnd(this->_stream);
+    delete this->_stream;
+    this->_stream = nullptr;
+  }
+}
+
+void w_zlib_inflater::_move(_Inout_ w_zlib_inflater &&p_other) noexcept {
+  if (this == &p_other) {
+    return;
+  }
+  _release();
+  this->_stream = std::exchange(p_other._stream, nullptr);
+  this->_format = p_other._format;
+}
+
+#endif // WOLF_SYSTEM_ZLIB
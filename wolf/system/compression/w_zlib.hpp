@@ -0,0 +1,233 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_ZLIB
+
+#include <wolf/wolf.hpp>
+
+struct z_stream_s;
+
+namespace wolf::system::compression {
+
+// the framing of deflate stream
+enum class w_zlib_format {
+  // raw deflate without header and checksum, e.g. for zip entries
+  RAW = 0,
+  // zlib header and adler32 checksum, e.g. for "Content-Encoding: deflate"
+  ZLIB,
+  // gzip header and crc32 checksum, e.g. for "Content-Encoding: gzip"
+  GZIP,
+};
+
+struct w_zlib_progress {
+  // number of bytes which were consumed from the source
+  size_t src_consumed = 0;
+  // number of bytes which were written into the destination
+  size_t dst_written = 0;
+  // the end of stream was reached
+  bool finished = false;
+};
+
+struct w_zlib {
+  /*
+   * get the worst case size of compressed stream for any of formats
+   * @param p_src_size, the size of input source
+   * @returns the size of bound
+   */
+  W_API static size_t get_compress_bound(_In_ size_t p_src_size) noexcept;
+
+  /*
+   * compress a stream via deflate
+   * @param p_src, the input source
+   * @param p_format, the framing of output
+   * @param p_level, the level of compression, a value between 0 - 9
+   * @returns a vector of compressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  compress(_In_ const gsl::span<const std::byte> p_src,
+           _In_ w_zlib_format p_format = w_zlib_format::GZIP, _In_ int p_level = 6);
+
+  /*
+   * decompress a deflate stream
+   * @param p_src, the compressed stream
+   * @param p_format, the framing of compressed stream
+   * @returns a vector of decompressed stream
+   */
+  W_API static boost::leaf::result<std::vector<std::byte>>
+  decompress(_In_ const gsl::span<const std::byte> p_src,
+             _In_ w_zlib_format p_format = w_zlib_format::GZIP);
+};
+
+/*
+ * a reusable deflate stream, the internal state is allocated once
+ * and reset between streams, so it could be kept per connection or per thread
+ */
+class w_zlib_deflater {
+ public:
+  // default constructor
+  W_API w_zlib_deflater() noexcept = default;
+
+  // move constructor.
+  W_API w_zlib_deflater(w_zlib_deflater &&p_other) noexcept {
+    _move(std::forward<w_zlib_deflater &&>(p_other));
+  }
+  // move assignment operator.
+  W_API w_zlib_deflater &operator=(w_zlib_deflater &&p_other) noexcept {
+    _move(std::forward<w_zlib_deflater &&>(p_other));
+    return *this;
+  }
+
+  // destructor
+  W_API virtual ~w_zlib_deflater() noexcept { _release(); }
+
+  /*
+   * allocate the state of deflate stream
+   * @param p_format, the framing of output
+   * @param p_level, the level of compression, a value between 0 - 9
+   * @param p_mem_level, the memory level of deflate, a value between 1 - 9
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init(_In_ w_zlib_format p_format = w_zlib_format::GZIP,
+                                      _In_ int p_level = 6, _In_ int p_mem_level = 8) noexcept;
+
+  /*
+   * get the worst case size of destination for compressing the whole source
+   * @param p_src_size, the size of input source
+   * @returns the size of bound
+   */
+  W_API size_t get_compress_bound(_In_ size_t p_src_size) const noexcept;
+
+  /*
+   * compress the whole source as a new stream into the caller's buffer
+   * @param p_src, the input source
+   * @param p_dst, the destination, see get_compress_bound
+   * @returns number of compressed bytes
+   */
+  W_API boost::leaf::result<size_t> compress(_In_ const gsl::span<const std::byte> p_src,
+                                             _Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * compress the whole source as a new stream into a new vector
+   * @param p_src, the input source
+   * @returns the vector of compressed stream
+   */
+  W_API boost::leaf::result<std::vector<std::byte>>
+  compress(_In_ const gsl::span<const std::byte> p_src);
+
+  /*
+   * compress a chunk of the current stream, call it again with the rest of source
+   * while src_consumed is less than the size of source or the destination was filled up
+   * @param p_src, the input chunk
+   * @param p_dst, the destination buffer
+   * @param p_flush, flush all pending output on a byte boundary, e.g. before sending a chunk
+   * @returns the progress of compression
+   */
+  W_API boost::leaf::result<w_zlib_progress> update(_In_ const gsl::span<const std::byte> p_src,
+                                                    _Inout_ gsl::span<std::byte> p_dst,
+                                                    _In_ bool p_flush = false) noexcept;
+
+  /*
+   * write the pending output and the trailer of the current stream, call it again
+   * with a new destination until finished is set, then the deflater is ready for a new stream
+   * @param p_dst, the destination buffer
+   * @returns the progress of compression
+   */
+  W_API boost::leaf::result<w_zlib_progress> end(_Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+ private:
+  // copy constructor.
+  w_zlib_deflater(const w_zlib_deflater &) = delete;
+  // copy assignment operator.
+  w_zlib_deflater &operator=(const w_zlib_deflater &) = delete;
+  // release the resources
+  void _release() noexcept;
+  // move the resources
+  void _move(_Inout_ w_zlib_deflater &&p_other) noexcept;
+
+  gsl::owner<z_stream_s *> _stream = nullptr;
+};
+
+/*
+ * a reusable inflate stream, the internal state and its window are allocated once
+ * and reset between streams
+ */
+class w_zlib_inflater {
+ public:
+  // default constructor
+  W_API w_zlib_inflater() noexcept = default;
+
+  // move constructor.
+  W_API w_zlib_inflater(w_zlib_inflater &&p_other) noexcept {
+    _move(std::forward<w_zlib_inflater &&>(p_other));
+  }
+  // move assignment operator.
+  W_API w_zlib_inflater &operator=(w_zlib_inflater &&p_other) noexcept {
+    _move(std::forward<w_zlib_inflater &&>(p_other));
+    return *this;
+  }
+
+  // destructor
+  W_API virtual ~w_zlib_inflater() noexcept { _release(); }
+
+  /*
+   * allocate the state of inflate stream
+   * @param p_format, the framing of compressed stream
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int>
+  init(_In_ w_zlib_format p_format = w_zlib_format::GZIP) noexcept;
+
+  /*
+   * decompress a whole stream into the caller's buffer
+   * @param p_src, the compressed stream
+   * @param p_dst, the destination buffer
+   * @returns number of decompressed bytes
+   */
+  W_API boost::leaf::result<size_t> decompress(_In_ const gsl::span<const std::byte> p_src,
+                                               _Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * decompress a whole stream into a new vector
+   * @param p_src, the compressed stream
+   * @returns the vector of decompressed stream
+   */
+  W_API boost::leaf::result<std::vector<std::byte>>
+  decompress(_In_ const gsl::span<const std::byte> p_src);
+
+  /*
+   * decompress a chunk of the current stream, call it again with the rest of source
+   * or a new destination until finished is set, then the inflater is ready for a new stream
+   * @param p_src, the input chunk
+   * @param p_dst, the destination buffer
+   * @returns the progress of decompression
+   */
+  W_API boost::leaf::result<w_zlib_progress> update(_In_ const gsl::span<const std::byte> p_src,
+                                                    _Inout_ gsl::span<std::byte> p_dst) noexcept;
+
+  /*
+   * drop the current stream and get ready for a new one
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> reset() noexcept;
+
+ private:
+  // copy constructor.
+  w_zlib_inflater(const w_zlib_inflater &) = delete;
+  // copy assignment operator.
+  w_zlib_inflater &operator=(const w_zlib_inflater &) = delete;
+  // release the resources
+  void _release() noexcept;
+  // move the resources
+  void _move(_Inout_ w_zlib_inflater &&p_other) noexcept;
+
+  gsl::owner<z_stream_s *> _stream = nullptr;
+  w_zlib_format _format = w_zlib_format::GZIP;
+};
+
+} // namespace wolf::system::compression
+
+#endif // WOLF_SYSTEM_ZLIB
@@ -0,0 +1,676 @@
+#ifdef WOLF_SYSTEM_IPC
+
+#include "w_shm_channel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using w_shm_channel = wolf::system::ipc::w_shm_channel;
+using w_shm_channel_options = wolf::system::ipc::w_shm_channel_options;
+using w_shm_channel_reader = wolf::system::ipc::w_shm_channel_reader;
+using steady_clock = std::chrono::steady_clock;
+
+// "WOLFSHM1", which marks an initialized segment
+constexpr auto SHM_CHANNEL_MAGIC = uint64_t(0x574f4c4653484d31);
+constexpr auto SHM_CHANNEL_VERSION = uint32_t(2);
+// the smallest ring, which is a page
+constexpr auto SHM_CHANNEL_MIN_CAPACITY = size_t(4096);
+// the largest ring, whose records and paddings fit the 32-bit size of a record header
+constexpr auto SHM_CHANNEL_MAX_CAPACITY = size_t(1) << 32;
+// the most readers, so their slots fit before the ring
+constexpr auto SHM_CHANNEL_MAX_READERS = size_t(1024);
+// the header of each record, and the alignment of records and their payloads
+constexpr auto SHM_CHANNEL_RECORD_HEADER_SIZE = size_t(8);
+// a record which fills the end of the ring, because the next one did not fit there
+constexpr auto SHM_CHANNEL_PADDING = uint32_t(1);
+// a waiting producer looks for the readers of dead processes this often
+constexpr auto SHM_CHANNEL_EVICT_INTERVAL = std::chrono::milliseconds(100);
+// a timeout longer than this waits forever, so the deadline does not overflow
+constexpr auto SHM_CHANNEL_MAX_TIMEOUT = std::chrono::hours(24 * 365);
+
+namespace wolf::system::ipc {
+// the header of segment, the waiting sides sleep on the sequences
+struct w_shm_channel_header {
+  std::atomic<uint64_t> magic;
+  uint32_t version;
+  uint32_t spin;
+  uint64_t capacity;
+  uint64_t max_readers;
+  uint64_t ring_offset;
+  // the inode of the pid namespace of creator, the pids of slots are only known in it
+  uint64_t pid_namespace;
+
+  // the end of the published records
+  alignas(64) std::atomic<uint64_t> write_position;
+
+  alignas(64) std::atomic<uint32_t> data_sequence;
+  std::atomic<uint32_t> data_waiters;
+
+  alignas(64) std::atomic<uint32_t> space_sequence;
+  std::atomic<uint32_t> space_waiters;
+};
+
+// the cursor of a reader, each one is on its own cache line
+struct alignas(64) w_shm_channel_slot {
+  // the end of the records which the reader released
+  std::atomic<uint64_t> position;
+  std::atomic<uint32_t> state;
+  std::atomic<int32_t> pid;
+  // the start time of the process of reader, which tells it apart from a reuse of its pid
+  std::atomic<uint64_t> start_time;
+  // counts the claims, so a reader finds out that its slot was evicted and taken again
+  std::atomic<uint32_t> generation;
+};
+} // namespace wolf::system::ipc
+
+using w_shm_channel_header = wolf::system::ipc::w_shm_channel_header;
+using w_shm_channel_slot = wolf::system::ipc::w_shm_channel_slot;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "the atomics of a shared segment must be lock free");
+
+enum w_shm_channel_slot_state : uint32_t {
+  SLOT_FREE = 0,
+  // a reader took the slot and is setting its position, or the slot is being freed
+  SLOT_CLAIMED,
+  SLOT_ATTACHED,
+};
+
+struct w_shm_channel_record {
+  uint32_t size;
+  uint32_t flags;
+};
+static_assert(sizeof(w_shm_channel_record) == SHM_CHANNEL_RECORD_HEADER_SIZE);
+
+static size_t s_align(_In_ size_t p_size, _In_ size_t p_alignment) noexcept {
+  return (p_size + p_alignment - 1) & ~(p_alignment - 1);
+}
+
+static size_t s_get_record_size(_In_ size_t p_payload) noexcept {
+  return s_align(SHM_CHANNEL_RECORD_HEADER_SIZE + p_payload, SHM_CHANNEL_RECORD_HEADER_SIZE);
+}
+
+static void s_cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+// the futexes are shared, because the segment is mapped by several processes
+static void s_futex_wait(_In_ std::atomic<uint32_t> &p_word, _In_ uint32_t p_expected,
+                         _In_ steady_clock::duration p_timeout) noexcept {
+  const auto _ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::max(p_timeout, steady_clock::duration::zero()))
+                       .count();
+  timespec _timeout = {};
+  _timeout.tv_sec = gsl::narrow_cast<time_t>(_ns / 1000000000);
+  _timeout.tv_nsec = gsl::narrow_cast<long>(_ns % 1000000000);
+  std::ignore = ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&p_word), FUTEX_WAIT,
+                          p_expected, &_timeout, nullptr, 0);
+}
+
+static void s_futex_wake(_In_ std::atomic<uint32_t> &p_word) noexcept {
+  std::ignore = ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&p_word), FUTEX_WAKE, INT_MAX,
+                          nullptr, nullptr, 0);
+}
+
+// wake the sleepers of a sequence, the caller published its change before
+static void s_notify(_In_ std::atomic<uint32_t> &p_sequence,
+                     _In_ const std::atomic<uint32_t> &p_waiters) noexcept {
+  if (p_waiters.load(std::memory_order_seq_cst) != 0) {
+    p_sequence.fetch_add(1, std::memory_order_seq_cst);
+    s_futex_wake(p_sequence);
+  }
+}
+
+// free an attached slot, the claim keeps a new reader from taking it before its pid is cleared
+static bool s_free_slot(_Inout_ w_shm_channel_slot &p_slot) noexcept {
+  auto _state = uint32_t(SLOT_ATTACHED);
+  if (!p_slot.state.compare_exchange_strong(_state, SLOT_CLAIMED)) {
+    return false;
+  }
+  p_slot.pid.store(0, std::memory_order_release);
+  p_slot.start_time.store(0, std::memory_order_release);
+  p_slot.state.store(SLOT_FREE, std::memory_order_seq_cst);
+  return true;
+}
+
+// the inode of the pid namespace of this process, or zero without procfs
+static uint64_t s_get_pid_namespace() noexcept {
+  struct stat _stat = {};
+  return ::stat("/proc/self/ns/pid", &_stat) == 0 ? uint64_t(_stat.st_ino) : 0;
+}
+
+// the start time of a process in clock ticks since boot, or zero when it is unknown
+static uint64_t s_get_start_time(_In_ int32_t p_pid) noexcept {
+  char _path[32] = {};
+  std::ignore = std::snprintf(_path, sizeof(_path), "/proc/%d/stat", p_pid);
+  const auto _fd = ::open(_path, O_RDONLY | O_CLOEXEC);
+  if (_fd == -1) {
+    return 0;
+  }
+  char _stat[1024] = {};
+  const auto _size = ::read(_fd, _stat, sizeof(_stat) - 1);
+  std::ignore = ::close(_fd);
+  if (_size <= 0) {
+    return 0;
+  }
+
+  // the command may hold spaces, so the fields are counted from its closing parenthesis. the
+  // state is the first field after it and the start time is the twentieth
+  const char *_field = std::strrchr(_stat, ')');
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (size_t i = 0; i < 20 && _field != nullptr; ++i) {
+    _field = std::strchr(_field + 1, ' ');
+  }
+  return _field == nullptr ? 0 : std::strtoull(_field + 1, nullptr, 10);
+}
+
+static steady_clock::time_point s_get_deadline(_In_ steady_clock::duration p_timeout) noexcept {
+  const auto _timeout = std::min(p_timeout, steady_clock::duration(SHM_CHANNEL_MAX_TIMEOUT));
+  return steady_clock::now() + std::max(_timeout, steady_clock::duration::zero());
+}
+
+w_shm_channel::w_shm_channel(w_shm_channel &&p_other) noexcept { *this = std::move(p_other); }
+
+w_shm_channel &w_shm_channel::operator=(w_shm_channel &&p_other) noexcept {
+  if (this != &p_other) {
+    _release();
+    this->_fd = std::exchange(p_other._fd, -1);
+    this->_segment = std::exchange(p_other._segment, nullptr);
+    this->_segment_size = std::exchange(p_other._segment_size, 0);
+    this->_header = std::exchange(p_other._header, nullptr);
+    this->_slots = std::exchange(p_other._slots, nullptr);
+    this->_ring = std::exchange(p_other._ring, nullptr);
+    this->_slowest = std::exchange(p_other._slowest, 0);
+    this->_reserved_end = std::exchange(p_other._reserved_end, 0);
+    this->_reserved = std::exchange(p_other._reserved, false);
+  }
+  return *this;
+}
+
+w_shm_channel::~w_shm_channel() noexcept { _release(); }
+
+void w_shm_channel::_release() noexcept {
+  if (this->_segment != nullptr) {
+    std::ignore = ::munmap(this->_segment, this->_segment_size);
+    this->_segment = nullptr;
+  }
+  if (this->_fd != -1) {
+    std::ignore = ::close(this->_fd);
+    this->_fd = -1;
+  }
+  this->_header = nullptr;
+  this->_slots = nullptr;
+  this->_ring = nullptr;
+}
+
+boost::leaf::result<w_shm_channel> w_shm_channel::_map(_In_ int p_fd) noexcept {
+  // the channel owns the descriptor from now on, so it is closed on failure
+  w_shm_channel _channel = {};
+  _channel._fd = p_fd;
+
+  struct stat _stat = {};
+  if (::fstat(p_fd, &_stat) != 0 || _stat.st_size < off_t(sizeof(w_shm_channel_header))) {
+    return W_FAILURE(std::errc::invalid_argument, "could not get the size of shm segment");
+  }
+  _channel._segment_size = gsl::narrow_cast<size_t>(_stat.st_size);
+  _channel._segment =
+      ::mmap(nullptr, _channel._segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, p_fd, 0);
+  if (_channel._segment == MAP_FAILED) {
+    _channel._segment = nullptr;
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "could not map shm segment because: " + std::string(std::strerror(errno)));
+  }
+  _channel._header = static_cast<w_shm_channel_header *>(_channel._segment);
+  _channel._slots = reinterpret_cast<w_shm_channel_slot *>(
+      static_cast<std::byte *>(_channel._segment) + sizeof(w_shm_channel_header));
+  return _channel;
+}
+
+boost::leaf::result<w_shm_channel>
+w_shm_channel::create(_In_ std::string_view p_name, _In_ const w_shm_channel_options &p_options,
+                      _In_ bool p_named) noexcept {
+  if (p_options.max_readers == 0 || p_options.max_readers > SHM_CHANNEL_MAX_READERS ||
+      p_options.capacity > SHM_CHANNEL_MAX_CAPACITY) {
+    return W_FAILURE(std::errc::invalid_argument, "invalid options of shm channel");
+  }
+
+  const auto _capacity = std::bit_ceil(std::max(p_options.capacity, SHM_CHANNEL_MIN_CAPACITY));
+  const auto _page = gsl::narrow_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  const auto _ring_offset = s_align(sizeof(w_shm_channel_header) +
+                                        sizeof(w_shm_channel_slot) * p_options.max_readers,
+                                    _page);
+
+  const auto _name = std::string(p_name);
+  const auto _fd = p_named ? ::shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600)
+                           : ::memfd_create(_name.c_str(), MFD_CLOEXEC);
+  if (_fd == -1) {
+    return W_FAILURE(std::errc::io_error, "could not create shm segment " + _name +
+                                              " because: " + std::string(std::strerror(errno)));
+  }
+  if (::ftruncate(_fd, off_t(_ring_offset + _capacity)) != 0) {
+    std::ignore = ::close(_fd);
+    if (p_named) {
+      std::ignore = ::shm_unlink(_name.c_str());
+    }
+    return W_FAILURE(std::errc::not_enough_memory, "could not size shm segment " + _name);
+  }
+
+  BOOST_LEAF_AUTO(_channel, _map(_fd));
+
+  // the segment is zeroed, the magic is written last, so an opener sees a whole header
+  auto *_header = new (_channel._segment) w_shm_channel_header{};
+  _header->version = SHM_CHANNEL_VERSION;
+  // polling on a single cpu only delays the other side
+  _header->spin = std::thread::hardware_concurrency() > 1 ? p_options.spin : 0;
+  _header->capacity = _capacity;
+  _header->max_readers = p_options.max_readers;
+  _header->ring_offset = _ring_offset;
+  _header->pid_namespace = s_get_pid_namespace();
+  for (size_t i = 0; i < p_options.max_readers; ++i) {
+    new (&_channel._slots[i]) w_shm_channel_slot{};
+  }
+  _channel._ring = static_cast<std::byte *>(_channel._segment) + _ring_offset;
+  _header->magic.store(SHM_CHANNEL_MAGIC, std::memory_order_release);
+
+  return std::move(_channel);
+}
+
+boost::leaf::result<w_shm_channel> w_shm_channel::open(_In_ int p_fd) noexcept {
+  const auto _fd = ::fcntl(p_fd, F_DUPFD_CLOEXEC, 0);
+  if (_fd == -1) {
+    return W_FAILURE(std::errc::bad_file_descriptor, "could not duplicate shm descriptor");
+  }
+  BOOST_LEAF_AUTO(_channel, _map(_fd));
+
+  // the sizes are read from the segment, so they are checked without overflowing
+  const auto *_header = _channel._header;
+  if (_header->magic.load(std::memory_order_acquire) != SHM_CHANNEL_MAGIC ||
+      _header->version != SHM_CHANNEL_VERSION || !std::has_single_bit(_header->capacity) ||
+      _header->capacity > SHM_CHANNEL_MAX_CAPACITY ||
+      _header->ring_offset < sizeof(w_shm_channel_header) ||
+      _header->ring_offset > _channel._segment_size ||
+      _header->max_readers >
+          (_header->ring_offset - sizeof(w_shm_channel_header)) / sizeof(w_shm_channel_slot) ||
+      _header->capacity != _channel._segment_size - _header->ring_offset) {
+    return W_FAILURE(std::errc::invalid_argument, "the segment is not a shm channel");
+  }
+  _channel._ring = static_cast<std::byte *>(_channel._segment) + _header->ring_offset;
+  return std::move(_channel);
+}
+
+boost::leaf::result<w_shm_channel> w_shm_channel::open(_In_ std::string_view p_name) noexcept {
+  const auto _name = std::string(p_name);
+  const auto _fd = ::shm_open(_name.c_str(), O_RDWR | O_CLOEXEC, 0);
+  if (_fd == -1) {
+    return W_FAILURE(std::errc::no_such_file_or_directory,
+                     "could not open shm segment " + _name);
+  }
+  // open duplicates it
+  DEFER { std::ignore = ::close(_fd); });
+  return open(_fd);
+}
+
+boost::leaf::result<int> w_shm_channel::unlink(_In_ std::string_view p_name) noexcept {
+  if (::shm_unlink(std::string(p_name).c_str()) != 0) {
+    return W_FAILURE(std::errc::no_such_file_or_directory,
+                     "could not unlink shm segment " + std::string(p_name));
+  }
+  return 0;
+}
+
+size_t w_shm_channel::get_capacity() const noexcept {
+  return this->_header == nullptr ? 0 : gsl::narrow_cast<size_t>(this->_header->capacity);
+}
+
+size_t w_shm_channel::get_max_record_size() const noexcept {
+  // a record of half of the ring always fits after the padding of the end
+  return this->_header == nullptr
+             ? 0
+             : get_capacity() / 2 - SHM_CHANNEL_RECORD_HEADER_SIZE;
+}
+
+size_t w_shm_channel::get_reader_count() const noexcept {
+  if (this->_header == nullptr) {
+    return 0;
+  }
+  size_t _count = 0;
+  for (size_t i = 0; i < this->_header->max_readers; ++i) {
+    if (this->_slots[i].state.load(std::memory_order_acquire) == SLOT_ATTACHED) {
+      ++_count;
+    }
+  }
+  return _count;
+}
+
+uint64_t w_shm_channel::_get_slowest_position(_In_ uint64_t p_write_position) const noexcept {
+  // without readers the whole ring is free
+  auto _slowest = p_write_position;
+  for (size_t i = 0; i < this->_header->max_readers; ++i) {
+    const auto &_slot = this->_slots[i];
+    if (_slot.state.load(std::memory_order_seq_cst) == SLOT_ATTACHED) {
+      _slowest = std::min(_slowest, _slot.position.load(std::memory_order_seq_cst));
+    }
+  }
+  return _slowest;
+}
+
+void w_shm_channel::_evict_dead_readers() noexcept {
+  // the pids of slots mean other processes in another pid namespace
+  if (s_get_pid_namespace() != this->_header->pid_namespace) {
+    return;
+  }
+  for (size_t i = 0; i < this->_header->max_readers; ++i) {
+    // a claimed slot has no position yet, and may still hold the pid of its last reader
+    auto &_slot = this->_slots[i];
+    if (_slot.state.load(std::memory_order_acquire) != SLOT_ATTACHED) {
+      continue;
+    }
+    const auto _pid = _slot.pid.load(std::memory_order_acquire);
+    if (_pid <= 0) {
+      continue;
+    }
+    // a live pid may have been reused by another process, which started later than the reader
+    if (::kill(_pid, 0) == 0 || errno != ESRCH) {
+      const auto _start_time = s_get_start_time(_pid);
+      if (_start_time == 0 || _start_time == _slot.start_time.load(std::memory_order_acquire)) {
+        continue;
+      }
+    }
+    std::ignore = s_free_slot(_slot);
+  }
+}
+
+bool w_shm_channel::_wait_for_space(_In_ uint64_t p_size,
+                                    _In_ steady_clock::duration p_timeout) noexcept {
+  const auto _capacity = this->_header->capacity;
+  const auto _write = this->_header->write_position.load(std::memory_order_relaxed);
+  // the cached position of the slowest reader is only refreshed when the ring looks full
+  if (_write + p_size - this->_slowest <= _capacity) {
+    return true;
+  }
+
+  const auto _deadline = s_get_deadline(p_timeout);
+  auto _next_eviction = steady_clock::now() + SHM_CHANNEL_EVICT_INTERVAL;
+  uint32_t _spins = 0;
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (;;) {
+    this->_slowest = _get_slowest_position(_write);
+    if (_write + p_size - this->_slowest <= _capacity) {
+      return true;
+    }
+    if (_spins < this->_header->spin) {
+      ++_spins;
+      s_cpu_relax();
+      continue;
+    }
+
+    const auto _sequence = this->_header->space_sequence.load(std::memory_order_acquire);
+    this->_header->space_waiters.fetch_add(1, std::memory_order_seq_cst);
+    this->_slowest = _get_slowest_position(_write);
+    const auto _now = steady_clock::now();
+    if (_write + p_size - this->_slowest > _capacity && _now < _deadline) {
+      s_futex_wait(this->_header->space_sequence, _sequence,
+                   std::min(_deadline, _next_eviction) - _now);
+    }
+    this->_header->space_waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+    if (steady_clock::now() >= _next_eviction || steady_clock::now() >= _deadline) {
+      _evict_dead_readers();
+      _next_eviction = steady_clock::now() + SHM_CHANNEL_EVICT_INTERVAL;
+      if (steady_clock::now() >= _deadline) {
+        this->_slowest = _get_slowest_position(_write);
+        return _write + p_size - this->_slowest <= _capacity;
+      }
+    }
+  }
+}
+
+boost::leaf::result<std::optional<gsl::span<std::byte>>>
+w_shm_channel::reserve(_In_ size_t p_size, _In_ steady_clock::duration p_timeout) noexcept {
+  if (this->_header == nullptr) {
+    return W_FAILURE(std::errc::bad_file_descriptor, "the shm channel is not mapped");
+  }
+  if (this->_reserved) {
+    return W_FAILURE(std::errc::operation_in_progress, "the reserved record was not committed");
+  }
+  if (p_size > get_max_record_size()) {
+    return W_FAILURE(std::errc::message_size,
+                     "the record of " + std::to_string(p_size) + " bytes does not fit the ring");
+  }
+
+  const auto _capacity = this->_header->capacity;
+  const auto _write = this->_header->write_position.load(std::memory_order_relaxed);
+  const auto _size = s_get_record_size(p_size);
+  auto _offset = gsl::narrow_cast<size_t>(_write & (_capacity - 1));
+  const auto _tail = gsl::narrow_cast<size_t>(_capacity) - _offset;
+  // a record is never split, the end of ring is skipped instead
+  const auto _padding = _tail < _size ? _tail : size_t(0);
+
+  if (!_wait_for_space(_padding + _size, p_timeout)) {
+    return std::optional<gsl::span<std::byte>>();
+  }
+
+  if (_padding != 0) {
+    const auto _record = w_shm_channel_record{
+        gsl::narrow_cast<uint32_t>(_padding - SHM_CHANNEL_RECORD_HEADER_SIZE),
+        SHM_CHANNEL_PADDING};
+    std::memcpy(this->_ring + _offset, &_record, sizeof(_record));
+    _offset = 0;
+  }
+  const auto _record = w_shm_channel_record{gsl::narrow_cast<uint32_t>(p_size), 0};
+  std::memcpy(this->_ring + _offset, &_record, sizeof(_record));
+
+  this->_reserved_end = _write + _padding + _size;
+  this->_reserved = true;
+  return std::optional<gsl::span<std::byte>>(
+      gsl::span<std::byte>(this->_ring + _offset + SHM_CHANNEL_RECORD_HEADER_SIZE, p_size));
+}
+
+boost::leaf::result<int> w_shm_channel::commit() noexcept {
+  if (!this->_reserved) {
+    return W_FAILURE(std::errc::invalid_argument, "no record was reserved");
+  }
+  this->_reserved = false;
+  this->_header->write_position.store(this->_reserved_end, std::memory_order_seq_cst);
+  s_notify(this->_header->data_sequence, this->_header->data_waiters);
+  return 0;
+}
+
+boost::leaf::result<bool> w_shm_channel::write(_In_ gsl::span<const std::byte> p_record,
+                                               _In_ steady_clock::duration p_timeout) noexcept {
+  BOOST_LEAF_AUTO(_room, reserve(p_record.size(), p_timeout));
+  if (!_room.has_value()) {
+    return false;
+  }
+  std::memcpy(_room->data(), p_record.data(), p_record.size());
+  BOOST_LEAF_CHECK(commit());
+  return true;
+}
+
+w_shm_channel_reader::w_shm_channel_reader(_In_ w_shm_channel &p_channel) noexcept
+    : _channel(&p_channel) {}
+
+w_shm_channel_reader::w_shm_channel_reader(w_shm_channel_reader &&p_other) noexcept
+    : _channel(p_other._channel), _slot(std::exchange(p_other._slot, nullptr)),
+      _generation(p_other._generation), _position(p_other._position),
+      _pending(std::exchange(p_other._pending, 0)) {}
+
+w_shm_channel_reader::~w_shm_channel_reader() noexcept { detach(); }
+
+boost::leaf::result<int> w_shm_channel_reader::attach() noexcept {
+  auto *_header = this->_channel->_header;
+  if (_header == nullptr) {
+    return W_FAILURE(std::errc::bad_file_descriptor, "the shm channel is not mapped");
+  }
+  if (this->_slot != nullptr) {
+    return 0;
+  }
+  // the producer evicts the readers of dead processes by their pids, which only mean the same
+  // process in the pid namespace of creator
+  if (s_get_pid_namespace() != _header->pid_namespace) {
+    return W_FAILURE(std::errc::operation_not_supported,
+                     "the reader is not in the pid namespace of the shm channel");
+  }
+  const auto _pid = ::getpid();
+  const auto _start_time = s_get_start_time(gsl::narrow_cast<int32_t>(_pid));
+
+  for (size_t i = 0; i < _header->max_readers; ++i) {
+    auto &_slot = this->_channel->_slots[i];
+    auto _state = uint32_t(SLOT_FREE);
+    if (!_slot.state.compare_exchange_strong(_state, SLOT_CLAIMED)) {
+      continue;
+    }
+    const auto _generation = _slot.generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+    _slot.pid.store(gsl::narrow_cast<int32_t>(_pid), std::memory_order_release);
+    _slot.start_time.store(_start_time, std::memory_order_release);
+    _slot.position.store(_header->write_position.load(std::memory_order_seq_cst));
+    _state = SLOT_CLAIMED;
+    if (!_slot.state.compare_exchange_strong(_state, SLOT_ATTACHED)) {
+      return W_FAILURE(std::errc::resource_unavailable_try_again,
+                       "the slot of reader was taken while it was attached");
+    }
+    // the producer may have passed the first position before it saw the slot, so the reader
+    // starts from a position which it counts
+    this->_position = _header->write_position.load(std::memory_order_seq_cst);
+    _slot.position.store(this->_position, std::memory_order_seq_cst);
+
+    this->_slot = &_slot;
+    this->_generation = _generation;
+    this->_pending = 0;
+    return 0;
+  }
+  return W_FAILURE(std::errc::too_many_files_open, "all slots of readers are taken");
+}
+
+bool w_shm_channel_reader::_get_is_evicted() const noexcept {
+  return this->_slot->state.load(std::memory_order_seq_cst) != SLOT_ATTACHED ||
+         this->_slot->generation.load(std::memory_order_acquire) != this->_generation;
+}
+
+void w_shm_channel_reader::detach() noexcept {
+  if (this->_slot == nullptr) {
+    return;
+  }
+  // an evicted slot may belong to another reader now
+  if (!_get_is_evicted()) {
+    std::ignore = s_free_slot(*this->_slot);
+  }
+  this->_slot = nullptr;
+  this->_pending = 0;
+  // the producer may wait for this reader
+  auto *_header = this->_channel->_header;
+  s_notify(_header->space_sequence, _header->space_waiters);
+}
+
+void w_shm_channel_reader::consume() noexcept {
+  if (this->_slot == nullptr || this->_pending == 0 || _get_is_evicted()) {
+    return;
+  }
+  this->_position = std::exchange(this->_pending, 0);
+  this->_slot->position.store(this->_position, std::memory_order_seq_cst);
+  auto *_header = this->_channel->_header;
+  s_notify(_header->space_sequence, _header->space_waiters);
+}
+
+boost::leaf::result<std::optional<gsl::span<const std::byte>>>
+w_shm_channel_reader::read(_In_ steady_clock::duration p_timeout) noexcept {
+  if (this->_slot == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "the reader is not attached");
+  }
+  if (_get_is_evicted()) {
+    // the producer took this reader for dead, so its records may be overwritten
+    this->_slot = nullptr;
+    this->_pending = 0;
+    return W_FAILURE(std::errc::connection_aborted, "the reader was evicted from the channel");
+  }
+  consume();
+
+  auto *_header = this->_channel->_header;
+  const auto *_ring = this->_channel->_ring;
+  const auto _capacity = _header->capacity;
+  const auto _mask = _capacity - 1;
+  const auto _max_record_size = this->_channel->get_max_record_size();
+  std::optional<steady_clock::time_point> _deadline = std::nullopt;
+  uint32_t _spins = 0;
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (;;) {
+    const auto _write = _header->write_position.load(std::memory_order_acquire);
+    while (this->_position != _write) {
+      const auto _offset = this->_position & _mask;
+      const auto *_data = _ring + _offset;
+      w_shm_channel_record _record = {};
+      std::memcpy(&_record, _data, sizeof(_record));
+      const auto _size = s_get_record_size(_record.size);
+
+      // the segment is shared with other processes, so its records are not trusted
+      const auto _is_padding = (_record.flags & SHM_CHANNEL_PADDING) != 0;
+      const auto _is_corrupted =
+          _write - this->_position < _size ||
+          (_is_padding ? _offset + _size != _capacity
+                       : _record.size > _max_record_size || _offset + _size > _capacity);
+      if (_is_corrupted) {
+        return W_FAILURE(std::errc::bad_message,
+                         "the record at " + std::to_string(this->_position) + " is corrupted");
+      }
+      if (_is_padding) {
+        this->_position += _size;
+        continue;
+      }
+      this->_pending = this->_position + _size;
+      return std::optional<gsl::span<const std::byte>>(
+          gsl::span<const std::byte>(_data + SHM_CHANNEL_RECORD_HEADER_SIZE, _record.size));
+    }
+
+    if (_spins < _header->spin) {
+      ++_spins;
+      s_cpu_relax();
+      continue;
+    }
+
+    if (!_deadline.has_value()) {
+      _deadline = s_get_deadline(p_timeout);
+    }
+    const auto _now = steady_clock::now();
+    if (_now >= _deadline.value()) {
+      return std::optional<gsl::span<const std::byte>>();
+    }
+
+    const auto _sequence = _header->data_sequence.load(std::memory_order_acquire);
+    _header->data_waiters.fetch_add(1, std::memory_order_seq_cst);
+    if (_header->write_position.load(std::memory_order_seq_cst) == this->_position) {
+      s_futex_wait(_header->data_sequence, _sequence, _deadline.value() - _now);
+    }
+    _header->data_waiters.fetch_sub(1, std::memory_order_seq_cst);
+  }
+}
+
+#endif // WOLF_SYSTEM_IPC
@@ -0,0 +1,213 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_IPC
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <wolf/wolf.hpp>
+
+namespace wolf::system::ipc {
+
+struct w_shm_channel_header;
+struct w_shm_channel_slot;
+
+struct w_shm_channel_options {
+  // the bytes of the ring, which are rounded up to a power of two, up to 4 GiB. a record fits
+  // in half of it
+  size_t capacity = 64 * 1024 * 1024;
+  // the number of readers which may be attached at once, up to 1024
+  size_t max_readers = 8;
+  // the number of polls before a waiting side sleeps on its futex, which trades cpu for latency
+  uint32_t spin = 4096;
+};
+
+/*
+ * a channel between the processes of one machine over a shared-memory ring of variable-size
+ * records. the segment is a memfd, whose descriptor is inherited or passed with SCM_RIGHTS, or a
+ * named segment of shm_open. there is one producer, which writes each record once into the ring,
+ * and every attached reader gets all records after it was attached. the producer waits for the
+ * slowest reader instead of overwriting its records, the readers of dead processes are evicted.
+ * a reader is known by its pid and the start time of its process, so the readers must be in the
+ * pid namespace of the creator of segment. the positions are atomics in the segment and a side
+ * only sleeps on a futex after it polled in vain, so a busy channel makes no system calls
+ */
+class w_shm_channel {
+public:
+  // default constructor
+  W_API w_shm_channel() noexcept = default;
+
+  // move constructor.
+  W_API w_shm_channel(w_shm_channel &&p_other) noexcept;
+  // move assignment operator.
+  W_API w_shm_channel &operator=(w_shm_channel &&p_other) noexcept;
+
+  // destructor, which unmaps the segment and closes its descriptor
+  W_API virtual ~w_shm_channel() noexcept;
+
+  /*
+   * create a segment and its ring
+   * @param p_name, the name of memfd, or the name of shm_open which starts with '/'
+   * @param p_options, the options of ring
+   * @param p_named, create a named segment with shm_open instead of a memfd
+   * @returns the channel
+   */
+  W_API static boost::leaf::result<w_shm_channel>
+  create(_In_ std::string_view p_name, _In_ const w_shm_channel_options &p_options,
+         _In_ bool p_named = false) noexcept;
+
+  /*
+   * map the segment of a descriptor, e.g. one which was passed by the producer
+   * @param p_fd, the descriptor which is duplicated, so the caller keeps it
+   * @returns the channel
+   */
+  W_API static boost::leaf::result<w_shm_channel> open(_In_ int p_fd) noexcept;
+
+  /*
+   * map a named segment
+   * @param p_name, the name of shm_open which starts with '/'
+   * @returns the channel
+   */
+  W_API static boost::leaf::result<w_shm_channel> open(_In_ std::string_view p_name) noexcept;
+
+  /*
+   * remove the name of a named segment, the mapped channels stay valid
+   * @param p_name, the name of shm_open
+   * @returns zero on success
+   */
+  W_API static boost::leaf::result<int> unlink(_In_ std::string_view p_name) noexcept;
+
+  /*
+   * reserve the room of the next record, so the producer fills it in place, e.g. with the
+   * planes of a decoded frame. the record is published by commit
+   * @param p_size, the size of record
+   * @param p_timeout, the time which the producer waits for the slowest reader
+   * @returns the room, or nothing when the ring stayed full
+   */
+  W_API boost::leaf::result<std::optional<gsl::span<std::byte>>>
+  reserve(_In_ size_t p_size, _In_ std::chrono::steady_clock::duration p_timeout) noexcept;
+
+  /*
+   * publish the reserved record and wake the sleeping readers
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> commit() noexcept;
+
+  /*
+   * copy a record into the ring and publish it
+   * @param p_record, the record
+   * @param p_timeout, the time which the producer waits for the slowest reader
+   * @returns true if the record was written, or false when the ring stayed full
+   */
+  W_API boost::leaf::result<bool>
+  write(_In_ gsl::span<const std::byte> p_record,
+        _In_ std::chrono::steady_clock::duration p_timeout) noexcept;
+
+  // get the descriptor of segment
+  W_API int get_fd() const noexcept { return this->_fd; }
+
+  // get the bytes of ring
+  W_API size_t get_capacity() const noexcept;
+
+  // get the largest record
+  W_API size_t get_max_record_size() const noexcept;
+
+  // get the number of attached readers
+  W_API size_t get_reader_count() const noexcept;
+
+private:
+  friend class w_shm_channel_reader;
+
+  // copy constructor
+  w_shm_channel(const w_shm_channel &) = delete;
+  // copy operator
+  w_shm_channel &operator=(const w_shm_channel &) = delete;
+
+  static boost::leaf::result<w_shm_channel> _map(_In_ int p_fd) noexcept;
+  bool _wait_for_space(_In_ uint64_t p_size,
+                       _In_ std::chrono::steady_clock::duration p_timeout) noexcept;
+  uint64_t _get_slowest_position(_In_ uint64_t p_write_position) const noexcept;
+  void _evict_dead_readers() noexcept;
+  void _release() noexcept;
+
+  int _fd = -1;
+  void *_segment = nullptr;
+  size_t _segment_size = 0;
+  w_shm_channel_header *_header = nullptr;
+  w_shm_channel_slot *_slots = nullptr;
+  std::byte *_ring = nullptr;
+
+  // the state of producer, which is local to its process
+  uint64_t _slowest = 0;
+  uint64_t _reserved_end = 0;
+  bool _reserved = false;
+};
+
+/*
+ * a reader of a channel, which takes a slot of the segment while it is attached. the records
+ * are views into the ring, so they are never copied, and a record stays valid until the next
+ * read or consume
+ */
+class w_shm_channel_reader {
+public:
+  /*
+   * constructor
+   * @param p_channel, the channel which outlives the reader
+   */
+  W_API explicit w_shm_channel_reader(_In_ w_shm_channel &p_channel) noexcept;
+
+  // move constructor.
+  W_API w_shm_channel_reader(w_shm_channel_reader &&p_other) noexcept;
+
+  // destructor, which detaches the reader
+  W_API virtual ~w_shm_channel_reader() noexcept;
+
+  /*
+   * attach to the channel, the reader gets the records which are written from now on
+   * @returns zero on success. fails when the process is not in the pid namespace of the creator
+   * of segment, or all slots are taken
+   */
+  W_API boost::leaf::result<int> attach() noexcept;
+
+  // detach from the channel, so the producer does not wait for this reader anymore
+  W_API void detach() noexcept;
+
+  /*
+   * release the previous record and wait for the next one
+   * @param p_timeout, the time which the reader waits for a record
+   * @returns the view of record, or nothing when no record was written in time. fails when
+   * the reader was evicted, or a record of the segment is corrupted
+   */
+  W_API boost::leaf::result<std::optional<gsl::span<const std::byte>>>
+  read(_In_ std::chrono::steady_clock::duration p_timeout) noexcept;
+
+  // release the previous record, so the producer may reuse its room
+  W_API void consume() noexcept;
+
+private:
+  // copy constructor
+  w_shm_channel_reader(const w_shm_channel_reader &) = delete;
+  // copy operator
+  w_shm_channel_reader &operator=(const w_shm_channel_reader &) = delete;
+  // move operator, the reader stays bound to its channel
+  w_shm_channel_reader &operator=(w_shm_channel_reader &&) = delete;
+
+  // whether the producer freed the slot of this reader
+  bool _get_is_evicted() const noexcept;
+
+  w_shm_channel *_channel = nullptr;
+  w_shm_channel_slot *_slot = nullptr;
+  uint32_t _generation = 0;
+  // the position of the next record, and the end of the record which was returned
+  uint64_t _position = 0;
+  uint64_t _pending = 0;
+};
+} // namespace wolf::system::ipc
+
+#endif // WOLF_SYSTEM_IPC
@@ -0,0 +1,349 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <tuple>
+
+using w_buffer = wolf::system::socket::w_buffer;
+using w_buffer_block = wolf::system::socket::w_buffer_block;
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+using w_buffer_pool_ctx = wolf::system::socket::w_buffer_pool_ctx;
+using w_buffer_pool_stats = wolf::system::socket::w_buffer_pool_stats;
+using w_buffer_sequence = wolf::system::socket::w_buffer_sequence;
+
+// the size class of blocks which are larger than the largest class and never cached
+constexpr auto BUFFER_NO_SIZE_CLASS = std::numeric_limits<uint32_t>::max();
+
+namespace wolf::system::socket {
+
+// the header of a block, the bytes of block follow it
+struct w_buffer_block {
+  std::atomic<uint32_t> refs = 0;
+  uint32_t size_class = BUFFER_NO_SIZE_CLASS;
+  size_t capacity = 0;
+  // keeps the pool alive while the block is in use
+  std::shared_ptr<w_buffer_pool_ctx> pool;
+
+  std::byte *data() noexcept { return reinterpret_cast<std::byte *>(this + 1); }
+};
+
+struct w_buffer_pool_ctx {
+  struct free_list {
+    std::mutex lock;
+    std::vector<w_buffer_block *> blocks;
+  };
+
+  std::vector<size_t> size_classes;
+  std::vector<free_list> free_lists;
+  size_t max_cached_blocks = 0;
+  std::atomic<size_t> hits = 0;
+  std::atomic<size_t> misses = 0;
+
+  ~w_buffer_pool_ctx() noexcept;
+};
+} // namespace wolf::system::socket
+
+// the bytes of a block start right after its header, so keep them aligned
+static_assert(sizeof(w_buffer_block) % alignof(std::max_align_t) == 0,
+              "the header of w_buffer_block breaks the alignment of its bytes");
+
+static w_buffer_block *s_allocate_block(_In_ size_t p_capacity,
+                                        _In_ uint32_t p_size_class) noexcept {
+  auto *_memory = ::operator new(sizeof(w_buffer_block) + p_capacity, std::nothrow);
+  if (_memory == nullptr) {
+    return nullptr;
+  }
+  auto *_block = new (_memory) w_buffer_block();
+  _block->size_class = p_size_class;
+  _block->capacity = p_capacity;
+  return _block;
+}
+
+static void s_free_block(_In_ w_buffer_block *p_block) noexcept {
+  p_block->~w_buffer_block();
+  ::operator delete(p_block);
+}
+
+static void s_recycle_block(_In_ w_buffer_block *p_block) noexcept {
+  // the pool must outlive the lock of its free list
+  const auto _ctx = std::move(p_block->pool);
+  if (_ctx != nullptr && p_block->size_class < _ctx->free_lists.size()) {
+    auto &_list = _ctx->free_lists[p_block->size_class];
+    std::scoped_lock _lock(_list.lock);
+    // the free lists were reserved, so pushing does not allocate
+    if (_list.blocks.size() < _ctx->max_cached_blocks) {
+      _list.blocks.push_back(p_block);
+      return;
+    }
+  }
+  s_free_block(p_block);
+}
+
+w_buffer_pool_ctx::~w_buffer_pool_ctx() noexcept {
+  for (auto &_list : this->free_lists) {
+    for (auto *_block : _list.blocks) {
+      s_free_block(_block);
+    }
+  }
+}
+
+w_buffer::w_buffer(_In_ w_buffer_block *p_block, _In_ size_t p_size) noexcept
+    : _block(p_block), _data(p_block->data()), _size(p_size), _capacity(p_block->capacity) {}
+
+w_buffer::w_buffer(_In_ std::string_view p_str) {
+  if (!from_string(p_str)) {
+    throw std::bad_alloc();
+  }
+}
+
+w_buffer::w_buffer(const w_buffer &p_other) noexcept
+    : _block(p_other._block), _data(p_other._data), _size(p_other._size),
+      _capacity(p_other._capacity) {
+  if (this->_block != nullptr) {
+    this->_block->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+w_buffer &w_buffer::operator=(const w_buffer &p_other) noexcept {
+  if (this != &p_other) {
+    auto _copy = p_other;
+    *this = std::move(_copy);
+  }
+  return *this;
+}
+
+w_buffer::w_buffer(w_buffer &&p_other) noexcept
+    : _block(std::exchange(p_other._block, nullptr)),
+      _data(std::exchange(p_other._data, nullptr)), _size(std::exchange(p_other._size, 0)),
+      _capacity(std::exchange(p_other._capacity, 0)) {}
+
+w_buffer &w_buffer::operator=(w_buffer &&p_other) noexcept {
+  if (this != &p_other) {
+    _release();
+    this->_block = std::exchange(p_other._block, nullptr);
+    this->_data = std::exchange(p_other._data, nullptr);
+    this->_size = std::exchange(p_other._size, 0);
+    this->_capacity = std::exchange(p_other._capacity, 0);
+  }
+  return *this;
+}
+
+w_buffer::~w_buffer() noexcept { _release(); }
+
+void w_buffer::_release() noexcept {
+  if (this->_block != nullptr &&
+      this->_block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    s_recycle_block(this->_block);
+  }
+  this->_block = nullptr;
+  this->_data = nullptr;
+  this->_size = 0;
+  this->_capacity = 0;
+}
+
+uint32_t w_buffer::use_count() const noexcept {
+  return this->_block != nullptr ? this->_block->refs.load(std::memory_order_relaxed) : 0;
+}
+
+boost::leaf::result<int> w_buffer::resize(_In_ size_t p_size) noexcept {
+  if (p_size > this->_capacity) {
+    return W_FAILURE(std::errc::invalid_argument,
+                     wolf::format("the size {} exceeds the capacity {} of buffer", p_size,
+                                  this->_capacity));
+  }
+  this->_size = p_size;
+  return 0;
+}
+
+w_buffer w_buffer::slice(_In_ size_t p_offset, _In_ size_t p_size) const noexcept {
+  const auto _offset = std::min(p_offset, this->_size);
+
+  auto _view = *this;
+  _view._data += _offset;
+  _view._size = std::min(p_size, this->_size - _offset);
+  _view._capacity -= _offset;
+  return _view;
+}
+
+boost::leaf::result<int> w_buffer::from_string(_In_ std::string_view p_str) noexcept {
+  // never write into a block which is visible from other buffers
+  if (this->_block == nullptr || use_count() > 1 || this->_capacity < p_str.size()) {
+    BOOST_LEAF_AUTO(_buffer, w_buffer_pool::get_default().acquire(p_str.size()));
+    *this = std::move(_buffer);
+  }
+  this->_size = p_str.size();
+  if (!p_str.empty()) {
+    std::memcpy(this->_data, p_str.data(), p_str.size());
+  }
+  return 0;
+}
+
+std::string w_buffer::to_string() const {
+  if (this->_size == 0) {
+    return std::string();
+  }
+  return std::string(reinterpret_cast<const char *>(this->_data), this->_size);
+}
+
+boost::leaf::result<int> w_buffer_pool::init(_In_ std::vector<size_t> p_size_classes,
+                                             _In_ size_t p_max_cached_blocks) noexcept {
+  if (p_size_classes.empty()) {
+    p_size_classes = {256, 1024, 4 * 1024, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024};
+  }
+  if (std::find(p_size_classes.cbegin(), p_size_classes.cend(), 0) != p_size_classes.cend() ||
+      !std::is_sorted(p_size_classes.cbegin(), p_size_classes.cend())) {
+    return W_FAILURE(std::errc::invalid_argument,
+                     "the size classes of buffer pool must be ascending and non-zero");
+  }
+
+  try {
+    auto _ctx = std::make_shared<w_buffer_pool_ctx>();
+    _ctx->free_lists = std::vector<w_buffer_pool_ctx::free_list>(p_size_classes.size());
+    for (auto &_list : _ctx->free_lists) {
+      _list.blocks.reserve(p_max_cached_blocks);
+    }
+    _ctx->size_classes = std::move(p_size_classes);
+    _ctx->max_cached_blocks = p_max_cached_blocks;
+    this->_ctx = std::move(_ctx);
+    return 0;
+  } catch (const std::exception &p_ex) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "could not initialize buffer pool because " + std::string(p_ex.what()));
+  }
+}
+
+boost::leaf::result<w_buffer> w_buffer_pool::acquire(_In_ size_t p_size) noexcept {
+  if (this->_ctx == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "the buffer pool was not initialized");
+  }
+
+  const auto &_classes = this->_ctx->size_classes;
+  const auto _iter = std::lower_bound(_classes.cbegin(), _classes.cend(), p_size);
+
+  w_buffer_block *_block = nullptr;
+  auto _size_class = BUFFER_NO_SIZE_CLASS;
+  auto _capacity = p_size;
+  if (_iter != _classes.cend()) {
+    _size_class = gsl::narrow_cast<uint32_t>(std::distance(_classes.cbegin(), _iter));
+    _capacity = *_iter;
+
+    auto &_list = this->_ctx->free_lists[_size_class];
+    std::scoped_lock _lock(_list.lock);
+    if (!_list.blocks.empty()) {
+      _block = _list.blocks.back();
+      _list.blocks.pop_back();
+    }
+  }
+
+  if (_block != nullptr) {
+    this->_ctx->hits.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    this->_ctx->misses.fetch_add(1, std::memory_order_relaxed);
+    _block = s_allocate_block(_capacity, _size_class);
+    if (_block == nullptr) {
+      return W_FAILURE(std::errc::not_enough_memory,
+                       wolf::format("could not allocate a buffer of {} bytes", _capacity));
+    }
+  }
+
+  _block->refs.store(1, std::memory_order_relaxed);
+  _block->pool = this->_ctx;
+  return w_buffer(_block, p_size);
+}
+
+void w_buffer_pool::trim() noexcept {
+  if (this->_ctx == nullptr) {
+    return;
+  }
+  for (auto &_list : this->_ctx->free_lists) {
+    std::scoped_lock _lock(_list.lock);
+    for (auto *_block : _list.blocks) {
+      s_free_block(_block);
+    }
+    _list.blocks.clear();
+  }
+}
+
+w_buffer_pool_stats w_buffer_pool::get_stats() const noexcept {
+  w_buffer_pool_stats _stats = {};
+  if (this->_ctx == nullptr) {
+    return _stats;
+  }
+
+  _stats.hits = this->_ctx->hits.load(std::memory_order_relaxed);
+  _stats.misses = this->_ctx->misses.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < this->_ctx->free_lists.size(); ++i) {
+    auto &_list = this->_ctx->free_lists[i];
+    std::scoped_lock _lock(_list.lock);
+    _stats.cached_blocks += _list.blocks.size();
+    _stats.cached_bytes += _list.blocks.size() * this->_ctx->size_classes[i];
+  }
+  return _stats;
+}
+
+w_buffer_pool &w_buffer_pool::get_default() noexcept {
+  // an uninitialized pool reports the failure on each acquire
+  static auto s_pool = []() noexcept {
+    w_buffer_pool _pool = {};
+    std::ignore = _pool.init();
+    return _pool;
+  }();
+  return s_pool;
+}
+
+void w_buffer_sequence::push_back(_In_ w_buffer p_buffer) {
+  if (p_buffer.empty()) {
+    return;
+  }
+  this->_buffers.reserve(this->_buffers.size() + 1);
+  this->_views.reserve(this->_views.size() + 1);
+
+  this->_size += p_buffer.size();
+  this->_views.push_back(p_buffer.get_const_buffer());
+  this->_buffers.push_back(std::move(p_buffer));
+}
+
+void w_buffer_sequence::consume(_In_ size_t p_size) noexcept {
+  auto _remaining = std::min(p_size, this->_size);
+  this->_size -= _remaining;
+
+  // drop the buffers which were consumed completely
+  size_t _count = 0;
+  while (_remaining > 0 && _remaining >= this->_buffers[_count].size()) {
+    _remaining -= this->_buffers[_count].size();
+    ++_count;
+  }
+  const auto _drop = gsl::narrow_cast<std::ptrdiff_t>(_count);
+  this->_buffers.erase(this->_buffers.begin(), this->_buffers.begin() + _drop);
+  this->_views.erase(this->_views.begin(), this->_views.begin() + _drop);
+
+  if (_remaining > 0) {
+    auto &_front = this->_buffers.front();
+    _front = _front.slice(_remaining, _front.size());
+    this->_views.front() = _front.get_const_buffer();
+  }
+}
+
+void w_buffer_sequence::clear() noexcept {
+  this->_buffers.clear();
+  this->_views.clear();
+  this->_size = 0;
+}
+
+boost::leaf::result<w_buffer> w_buffer_sequence::flatten() const noexcept {
+  BOOST_LEAF_AUTO(_buffer, w_buffer_pool::get_default().acquire(this->_size));
+
+  auto *_dst = _buffer.data();
+  for (const auto &_view : this->_views) {
+    std::memcpy(_dst, _view.data(), _view.size());
+    _dst += _view.size();
+  }
+  return _buffer;
+}
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -0,0 +1,238 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include <atomic>
+#include <vector>
+#include <wolf/wolf.hpp>
+
+#include "DISABLE_ANALYSIS_BEGIN"
+#include <boost/asio/buffer.hpp>
+#include "DISABLE_ANALYSIS_END"
+
+namespace wolf::system::socket {
+
+struct w_buffer_block;
+struct w_buffer_pool_ctx;
+class w_buffer_pool;
+
+/*
+ * a refcounted view of a pooled block of memory, copies share the same block
+ * and the block goes back to its pool once the last copy is released
+ */
+class w_buffer {
+public:
+  // default constructor, an empty buffer which does not own any block
+  W_API w_buffer() noexcept = default;
+
+  // allocate a buffer from the default pool and copy the string into it
+  W_API explicit w_buffer(_In_ std::string_view p_str);
+
+  // copy constructor, shares the block
+  W_API w_buffer(const w_buffer &p_other) noexcept;
+  // copy assignment operator, shares the block
+  W_API w_buffer &operator=(const w_buffer &p_other) noexcept;
+
+  // move constructor.
+  W_API w_buffer(w_buffer &&p_other) noexcept;
+  // move assignment operator.
+  W_API w_buffer &operator=(w_buffer &&p_other) noexcept;
+
+  // destructor
+  W_API ~w_buffer() noexcept;
+
+  // get the pointer to the first byte of view
+  std::byte *data() const noexcept { return this->_data; }
+  // get the number of used bytes
+  size_t size() const noexcept { return this->_size; }
+  // get the number of bytes which are available from the start of view to the end of block
+  size_t capacity() const noexcept { return this->_capacity; }
+  // get whether the buffer has no used bytes
+  bool empty() const noexcept { return this->_size == 0; }
+
+  // get the used bytes as a span
+  gsl::span<std::byte> span() const noexcept { return {this->_data, this->_size}; }
+
+  // get the used bytes as a mutable asio buffer
+  boost::asio::mutable_buffer get_buffer() const noexcept {
+    return {this->_data, this->_size};
+  }
+
+  // get the used bytes as a const asio buffer
+  boost::asio::const_buffer get_const_buffer() const noexcept {
+    return {this->_data, this->_size};
+  }
+
+  /*
+   * get the number of buffers which share the block
+   * @returns the number of references, zero for an empty buffer
+   */
+  W_API uint32_t use_count() const noexcept;
+
+  /*
+   * change the number of used bytes without touching the content
+   * @param p_size, the new size which must not exceed the capacity
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> resize(_In_ size_t p_size) noexcept;
+
+  /*
+   * make a view of a part of this buffer without copying, the view shares the block
+   * @param p_offset, the offset from the start of this view
+   * @param p_size, the number of bytes, clamped to the end of this view
+   * @returns the sliced view
+   */
+  W_API w_buffer slice(_In_ size_t p_offset, _In_ size_t p_size) const noexcept;
+
+  /*
+   * copy a string into the buffer, the block is replaced by a block of the default pool
+   * if it is shared or small
+   * @param p_str, the source string
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> from_string(_In_ std::string_view p_str) noexcept;
+
+  /*
+   * copy the used bytes into a string
+   * @returns the string
+   */
+  W_API std::string to_string() const;
+
+private:
+  friend class w_buffer_pool;
+
+  // adopt a block which has already been referenced
+  w_buffer(_In_ w_buffer_block *p_block, _In_ size_t p_size) noexcept;
+
+  void _release() noexcept;
+
+  w_buffer_block *_block = nullptr;
+  std::byte *_data = nullptr;
+  size_t _size = 0;
+  size_t _capacity = 0;
+};
+
+struct w_buffer_pool_stats {
+  // the number of acquires which reused a cached block
+  size_t hits = 0;
+  // the number of acquires which allocated a new block
+  size_t misses = 0;
+  // the number of blocks which are waiting for reuse
+  size_t cached_blocks = 0;
+  // the total capacity of cached blocks
+  size_t cached_bytes = 0;
+};
+
+/*
+ * a thread safe pool of blocks which are grouped by size classes, a request is served
+ * by the smallest class which fits it and requests above the largest class are
+ * allocated directly and freed on release
+ */
+class w_buffer_pool {
+public:
+  // default constructor
+  W_API w_buffer_pool() noexcept = default;
+
+  // move constructor.
+  W_API w_buffer_pool(w_buffer_pool &&p_other) noexcept = default;
+  // move assignment operator.
+  W_API w_buffer_pool &operator=(w_buffer_pool &&p_other) noexcept = default;
+
+  // destructor, the cached blocks are freed once all buffers of this pool are released
+  W_API virtual ~w_buffer_pool() noexcept = default;
+
+  /*
+   * initialize the pool
+   * @param p_size_classes, the capacities of size classes, empty means 256 bytes to 1 MiB
+   * @param p_max_cached_blocks, the maximum number of cached blocks of each class
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init(_In_ std::vector<size_t> p_size_classes = {},
+                                      _In_ size_t p_max_cached_blocks = 64) noexcept;
+
+  /*
+   * acquire a buffer, its capacity is the capacity of the chosen size class
+   * @param p_size, the number of used bytes of the buffer
+   * @returns the buffer
+   */
+  W_API boost::leaf::result<w_buffer> acquire(_In_ size_t p_size) noexcept;
+
+  /*
+   * free the cached blocks
+   */
+  W_API void trim() noexcept;
+
+  /*
+   * get the statistics of the pool
+   * @returns the statistics
+   */
+  W_API w_buffer_pool_stats get_stats() const noexcept;
+
+  /*
+   * get the shared pool of the process which is used by sockets
+   * @returns the default pool
+   */
+  W_API static w_buffer_pool &get_default() noexcept;
+
+private:
+  // copy constructor
+  w_buffer_pool(const w_buffer_pool &) = delete;
+  // copy operator
+  w_buffer_pool &operator=(const w_buffer_pool &) = delete;
+
+  std::shared_ptr<w_buffer_pool_ctx> _ctx;
+};
+
+/*
+ * a sequence of buffers which are gathered by a single write of asio,
+ * it satisfies the ConstBufferSequence requirements
+ */
+class w_buffer_sequence {
+public:
+  using value_type = boost::asio::const_buffer;
+  using const_iterator = std::vector<boost::asio::const_buffer>::const_iterator;
+
+  /*
+   * append a buffer without copying its bytes
+   * @param p_buffer, the buffer
+   */
+  W_API void push_back(_In_ w_buffer p_buffer);
+
+  /*
+   * remove bytes from the front, e.g. after a partial write
+   * @param p_size, the number of bytes
+   */
+  W_API void consume(_In_ size_t p_size) noexcept;
+
+  // remove all buffers
+  W_API void clear() noexcept;
+
+  /*
+   * copy all bytes into one buffer of the default pool
+   * @returns the flattened buffer
+   */
+  W_API boost::leaf::result<w_buffer> flatten() const noexcept;
+
+  // get the total number of bytes
+  size_t size() const noexcept { return this->_size; }
+  // get the number of buffers
+  size_t count() const noexcept { return this->_views.size(); }
+  // get whether there is no byte
+  bool empty() const noexcept { return this->_size == 0; }
+
+  const_iterator begin() const noexcept { return this->_views.cbegin(); }
+  const_iterator end() const noexcept { return this->_views.cend(); }
+
+private:
+  std::vector<w_buffer> _buffers;
+  std::vector<boost::asio::const_buffer> _views;
+  size_t _size = 0;
+};
+} // namespace wolf::system::socket
+
+#endif // WOLF_SYSTEM_SOCKET
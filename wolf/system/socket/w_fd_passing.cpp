@@ -0,0 +1,150 @@
+#if defined(WOLF_SYSTEM_SOCKET) && !defined(WIN32)
+
+#include "w_fd_passing.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+using w_stream_socket = wolf::system::socket::w_stream_socket;
+
+// the largest number of descriptors which are passed with one send
+constexpr auto FD_PASSING_MAX_FDS = size_t(64);
+// the control buffer of the largest message, which is aligned for its header
+constexpr auto FD_PASSING_CONTROL_SIZE = size_t(CMSG_SPACE(sizeof(int) * FD_PASSING_MAX_FDS));
+
+#ifdef MSG_NOSIGNAL
+constexpr auto FD_PASSING_SEND_FLAGS = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+constexpr auto FD_PASSING_SEND_FLAGS = MSG_DONTWAIT;
+#endif
+
+#ifdef MSG_CMSG_CLOEXEC
+// the received descriptors are not inherited by child processes
+constexpr auto FD_PASSING_RECEIVE_FLAGS = MSG_DONTWAIT | MSG_CMSG_CLOEXEC;
+#else
+constexpr auto FD_PASSING_RECEIVE_FLAGS = MSG_DONTWAIT;
+#endif
+
+static boost::system::system_error s_errno_error() {
+  return boost::system::system_error(
+      boost::system::error_code(errno, boost::asio::error::get_system_category()));
+}
+
+// the control buffer lives on the stack of a plain function, a coroutine frame may not align it
+static ssize_t s_send(_In_ int p_socket, _In_ boost::asio::const_buffer p_buffer,
+                      _In_ gsl::span<const int> p_fds) noexcept {
+  alignas(cmsghdr) std::array<char, FD_PASSING_CONTROL_SIZE> _control = {};
+  iovec _iov = {const_cast<void *>(p_buffer.data()), p_buffer.size()};
+  msghdr _msg = {};
+  _msg.msg_iov = &_iov;
+  _msg.msg_iovlen = 1;
+  if (!p_fds.empty()) {
+    _msg.msg_control = _control.data();
+    _msg.msg_controllen = CMSG_SPACE(p_fds.size_bytes());
+
+    auto *_header = CMSG_FIRSTHDR(&_msg);
+    _header->cmsg_level = SOL_SOCKET;
+    _header->cmsg_type = SCM_RIGHTS;
+    _header->cmsg_len = CMSG_LEN(p_fds.size_bytes());
+    std::memcpy(CMSG_DATA(_header), p_fds.data(), p_fds.size_bytes());
+  }
+  return ::sendmsg(p_socket, &_msg, FD_PASSING_SEND_FLAGS);
+}
+
+static ssize_t s_receive(_In_ int p_socket, _In_ boost::asio::mutable_buffer p_buffer,
+                         _Inout_ std::vector<int> &p_mut_fds) {
+  alignas(cmsghdr) std::array<char, FD_PASSING_CONTROL_SIZE> _control = {};
+  iovec _iov = {p_buffer.data(), p_buffer.size()};
+  msghdr _msg = {};
+  _msg.msg_iov = &_iov;
+  _msg.msg_iovlen = 1;
+  _msg.msg_control = _control.data();
+  _msg.msg_controllen = _control.size();
+
+  const auto _received = ::recvmsg(p_socket, &_msg, FD_PASSING_RECEIVE_FLAGS);
+  if (_received < 0) {
+    return _received;
+  }
+
+  for (auto *_header = CMSG_FIRSTHDR(&_msg); _header != nullptr;
+       _header = CMSG_NXTHDR(&_msg, _header)) {
+    if (_header->cmsg_level != SOL_SOCKET || _header->cmsg_type != SCM_RIGHTS) {
+      continue;
+    }
+    const auto _count = (_header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    const auto *_data = CMSG_DATA(_header);
+    for (size_t i = 0; i < _count; ++i) {
+      int _fd = -1;
+      std::memcpy(&_fd, _data + i * sizeof(int), sizeof(int));
+      p_mut_fds.push_back(_fd);
+    }
+  }
+  return _received;
+}
+
+boost::asio::awaitable<size_t>
+wolf::system::socket::async_send_with_fds(_Inout_ w_stream_socket &p_socket,
+                                          _In_ boost::asio::const_buffer p_buffer,
+                                          _In_ gsl::span<const int> p_fds) {
+  if (p_buffer.size() == 0 || p_fds.size() > FD_PASSING_MAX_FDS) {
+    throw boost::system::system_error(
+        make_error_code(boost::system::errc::invalid_argument));
+  }
+
+  ssize_t _sent = 0;
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (;;) {
+    _sent = s_send(p_socket.native_handle(), p_buffer, p_fds);
+    if (_sent >= 0) {
+      break;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      co_await p_socket.async_wait(w_stream_socket::wait_write, boost::asio::use_awaitable);
+    } else if (errno != EINTR) {
+      throw s_errno_error();
+    }
+  }
+
+  // the descriptors went with the first byte, the rest is a plain write
+  const auto _bytes = gsl::narrow_cast<size_t>(_sent);
+  if (_bytes < p_buffer.size()) {
+    co_await boost::asio::async_write(p_socket, p_buffer + _bytes, boost::asio::use_awaitable);
+  }
+  co_return p_buffer.size();
+}
+
+boost::asio::awaitable<size_t>
+wolf::system::socket::async_receive_with_fds(_Inout_ w_stream_socket &p_socket,
+                                             _In_ boost::asio::mutable_buffer p_buffer,
+                                             _Inout_ std::vector<int> &p_mut_fds) {
+  ssize_t _received = 0;
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (;;) {
+    _received = s_receive(p_socket.native_handle(), p_buffer, p_mut_fds);
+    if (_received >= 0) {
+      break;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      co_await p_socket.async_wait(w_stream_socket::wait_read, boost::asio::use_awaitable);
+    } else if (errno != EINTR) {
+      throw s_errno_error();
+    }
+  }
+
+  // like a receive of asio, the end of stream is an error
+  if (_received == 0 && p_buffer.size() != 0) {
+    throw boost::system::system_error(boost::asio::error::eof);
+  }
+  co_return gsl::narrow_cast<size_t>(_received);
+}
+
+#endif // defined(WOLF_SYSTEM_SOCKET) && !defined(WIN32)
@@ -0,0 +1,47 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#if defined(WOLF_SYSTEM_SOCKET) && !defined(WIN32)
+
+#include "w_socket_options.hpp"
+#include <vector>
+#include <wolf/wolf.hpp>
+
+#include "DISABLE_ANALYSIS_BEGIN"
+#include <boost/asio.hpp>
+#include "DISABLE_ANALYSIS_END"
+
+namespace wolf::system::socket {
+
+/*
+ * send bytes over a unix domain socket and pass file descriptors with them by SCM_RIGHTS. the
+ * descriptors are duplicated into the peer and stay open on this side
+ * @param p_socket, the connected socket
+ * @param p_buffer, the bytes which carry the descriptors, which must not be empty
+ * @param p_fds, the file descriptors, up to 64 of them
+ * @returns number of the written bytes
+ */
+W_API boost::asio::awaitable<size_t> async_send_with_fds(_Inout_ w_stream_socket &p_socket,
+                                                         _In_ boost::asio::const_buffer p_buffer,
+                                                         _In_ gsl::span<const int> p_fds);
+
+/*
+ * receive bytes from a unix domain socket together with the file descriptors which were passed
+ * with them. a read never crosses the bytes of two sends which passed descriptors
+ * @param p_socket, the connected socket
+ * @param p_buffer, the destination of bytes
+ * @param p_mut_fds, the received descriptors are appended and owned by the caller, the ones
+ * which do not fit in 64 are closed by the kernel
+ * @returns number of the received bytes
+ */
+W_API boost::asio::awaitable<size_t>
+async_receive_with_fds(_Inout_ w_stream_socket &p_socket,
+                       _In_ boost::asio::mutable_buffer p_buffer,
+                       _Inout_ std::vector<int> &p_mut_fds);
+} // namespace wolf::system::socket
+
+#endif // defined(WOLF_SYSTEM_SOCKET) && !defined(WIN32)
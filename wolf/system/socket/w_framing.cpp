@@ -0,0 +1,140 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_framing.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+using w_buffer = wolf::system::socket::w_buffer;
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+using w_frame_decoder = wolf::system::socket::w_frame_decoder;
+using w_frame_encoder = wolf::system::socket::w_frame_encoder;
+using w_framing_options = wolf::system::socket::w_framing_options;
+
+constexpr auto FRAME_HEADER_SIZE = wolf::system::socket::W_FRAME_HEADER_SIZE;
+// the size of the block which is shared by the prefixes of queued messages
+constexpr auto FRAME_HEADERS_BLOCK_SIZE = size_t(4 * 1024);
+
+static uint32_t s_load_header(_In_ const std::byte *p_src) noexcept {
+  return std::to_integer<uint32_t>(p_src[0]) | (std::to_integer<uint32_t>(p_src[1]) << 8) |
+         (std::to_integer<uint32_t>(p_src[2]) << 16) |
+         (std::to_integer<uint32_t>(p_src[3]) << 24);
+}
+
+static void s_store_header(_Inout_ std::byte *p_dst, _In_ uint32_t p_size) noexcept {
+  p_dst[0] = std::byte(p_size & 0xFF);
+  p_dst[1] = std::byte((p_size >> 8) & 0xFF);
+  p_dst[2] = std::byte((p_size >> 16) & 0xFF);
+  p_dst[3] = std::byte((p_size >> 24) & 0xFF);
+}
+
+w_frame_decoder::w_frame_decoder(_In_ const w_framing_options &p_options) noexcept
+    : _options(p_options) {}
+
+size_t w_frame_decoder::get_pending_size() const noexcept {
+  return this->_buffer.size() - this->_parsed;
+}
+
+boost::leaf::result<boost::asio::mutable_buffer>
+w_frame_decoder::prepare(_In_ size_t p_size_hint) noexcept {
+  const auto _pending = get_pending_size();
+
+  // the bytes which are missing from the current message
+  auto _missing = FRAME_HEADER_SIZE - std::min(_pending, FRAME_HEADER_SIZE);
+  if (_pending >= FRAME_HEADER_SIZE) {
+    const auto _message_size = s_load_header(this->_buffer.data() + this->_parsed);
+    const auto _frame_size = FRAME_HEADER_SIZE + size_t(_message_size);
+    _missing = _frame_size > _pending ? _frame_size - _pending : 0;
+  }
+  const auto _size = std::max({_missing, p_size_hint, this->_options.min_read_size});
+
+  // nobody refers to the parsed messages, so the block is read again from its start
+  if (_pending == 0 && this->_buffer.use_count() == 1) {
+    std::ignore = this->_buffer.resize(0);
+    this->_parsed = 0;
+  }
+
+  if (this->_buffer.capacity() - this->_buffer.size() < _size) {
+    // move the incomplete message to a new block, the old block may still be referenced
+    BOOST_LEAF_AUTO(_buffer, w_buffer_pool::get_default().acquire(_pending + _size));
+    if (_pending != 0) {
+      std::memcpy(_buffer.data(), this->_buffer.data() + this->_parsed, _pending);
+    }
+    std::ignore = _buffer.resize(_pending);
+    this->_buffer = std::move(_buffer);
+    this->_parsed = 0;
+  }
+
+  return boost::asio::mutable_buffer(this->_buffer.data() + this->_buffer.size(),
+                                     this->_buffer.capacity() - this->_buffer.size());
+}
+
+void w_frame_decoder::commit(_In_ size_t p_size) noexcept {
+  const auto _size = std::min(this->_buffer.size() + p_size, this->_buffer.capacity());
+  std::ignore = this->_buffer.resize(_size);
+}
+
+boost::leaf::result<std::optional<w_buffer>> w_frame_decoder::next() noexcept {
+  const auto _pending = get_pending_size();
+  if (_pending < FRAME_HEADER_SIZE) {
+    return std::optional<w_buffer>();
+  }
+
+  const auto _message_size = s_load_header(this->_buffer.data() + this->_parsed);
+  if (_message_size > this->_options.max_message_size) {
+    return W_FAILURE(std::errc::message_size,
+                     wolf::format("the message of {} bytes exceeds the limit of {} bytes",
+                                  _message_size, this->_options.max_message_size));
+  }
+  if (_pending - FRAME_HEADER_SIZE < _message_size) {
+    return std::optional<w_buffer>();
+  }
+
+  auto _message = this->_buffer.slice(this->_parsed + FRAME_HEADER_SIZE, _message_size);
+  this->_parsed += FRAME_HEADER_SIZE + _message_size;
+  return std::optional<w_buffer>(std::move(_message));
+}
+
+w_frame_encoder::w_frame_encoder(_In_ const w_framing_options &p_options) noexcept
+    : _options(p_options) {}
+
+boost::leaf::result<int> w_frame_encoder::push(_In_ w_buffer p_message) noexcept {
+  if (p_message.size() > this->_options.max_message_size) {
+    return W_FAILURE(std::errc::message_size,
+                     wolf::format("the message of {} bytes exceeds the limit of {} bytes",
+                                  p_message.size(), this->_options.max_message_size));
+  }
+
+  if (this->_headers.capacity() - this->_headers.size() < FRAME_HEADER_SIZE) {
+    BOOST_LEAF_AUTO(_headers, w_buffer_pool::get_default().acquire(FRAME_HEADERS_BLOCK_SIZE));
+    std::ignore = _headers.resize(0);
+    this->_headers = std::move(_headers);
+  }
+
+  const auto _offset = this->_headers.size();
+  std::ignore = this->_headers.resize(_offset + FRAME_HEADER_SIZE);
+  s_store_header(this->_headers.data() + _offset, gsl::narrow_cast<uint32_t>(p_message.size()));
+
+  try {
+    this->_buffers.push_back(this->_headers.slice(_offset, FRAME_HEADER_SIZE));
+    this->_buffers.push_back(std::move(p_message));
+  } catch (const std::exception &p_ex) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "could not queue the message because " + std::string(p_ex.what()));
+  }
+  ++this->_count;
+  return 0;
+}
+
+void w_frame_encoder::clear() noexcept {
+  this->_buffers.clear();
+  this->_count = 0;
+
+  // the prefixes were written, so their block is reused if nobody else holds it
+  if (this->_headers.use_count() == 1) {
+    std::ignore = this->_headers.resize(0);
+  }
+}
+
+#endif // WOLF_SYSTEM_SOCKET
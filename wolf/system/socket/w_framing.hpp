@@ -0,0 +1,141 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_buffer.hpp"
+#include <optional>
+#include <wolf/wolf.hpp>
+
+namespace wolf::system::socket {
+
+// each message is preceded by its size as a little-endian 32 bits integer
+constexpr auto W_FRAME_HEADER_SIZE = sizeof(uint32_t);
+
+struct w_framing_options {
+  // the largest accepted message, a larger prefix is treated as a protocol error
+  uint32_t max_message_size = 16 * 1024 * 1024;
+  // the smallest room which is prepared for a read
+  size_t min_read_size = 4 * 1024;
+};
+
+/*
+ * splits a stream of bytes into length-prefixed messages, many messages are parsed from
+ * one read and each message is a view of the received bytes without copying
+ */
+class w_frame_decoder {
+public:
+  // default constructor
+  W_API w_frame_decoder() noexcept = default;
+
+  // constructor with options
+  W_API explicit w_frame_decoder(_In_ const w_framing_options &p_options) noexcept;
+
+  // move constructor.
+  W_API w_frame_decoder(w_frame_decoder &&p_other) noexcept = default;
+  // move assignment operator.
+  W_API w_frame_decoder &operator=(w_frame_decoder &&p_other) noexcept = default;
+
+  // destructor
+  W_API virtual ~w_frame_decoder() noexcept = default;
+
+  /*
+   * get the room which the next read should fill, it always fits the rest of the current
+   * message. the bytes of parsed messages are never overwritten, so the views which were
+   * returned by next remain valid
+   * @param p_size_hint, the number of bytes which are expected, e.g. the pending bytes of socket
+   * @returns the room for reading
+   */
+  W_API boost::leaf::result<boost::asio::mutable_buffer>
+  prepare(_In_ size_t p_size_hint = 0) noexcept;
+
+  /*
+   * make the read bytes available for parsing
+   * @param p_size, the number of bytes which were written into the prepared room
+   */
+  W_API void commit(_In_ size_t p_size) noexcept;
+
+  /*
+   * parse the next complete message
+   * @returns the message, or nothing if more bytes are needed
+   */
+  W_API boost::leaf::result<std::optional<w_buffer>> next() noexcept;
+
+  /*
+   * get the number of received bytes which were not parsed yet
+   * @returns the number of bytes
+   */
+  W_API size_t get_pending_size() const noexcept;
+
+private:
+  // copy constructor
+  w_frame_decoder(const w_frame_decoder &) = delete;
+  // copy operator
+  w_frame_decoder &operator=(const w_frame_decoder &) = delete;
+
+  w_framing_options _options = {};
+  // the block which receives bytes, its size is the number of received bytes
+  w_buffer _buffer = {};
+  // the number of bytes of parsed messages at the start of buffer
+  size_t _parsed = 0;
+};
+
+/*
+ * queues length-prefixed messages, so all of them are written with one gathered write
+ */
+class w_frame_encoder {
+public:
+  // default constructor
+  W_API w_frame_encoder() noexcept = default;
+
+  // constructor with options
+  W_API explicit w_frame_encoder(_In_ const w_framing_options &p_options) noexcept;
+
+  // move constructor.
+  W_API w_frame_encoder(w_frame_encoder &&p_other) noexcept = default;
+  // move assignment operator.
+  W_API w_frame_encoder &operator=(w_frame_encoder &&p_other) noexcept = default;
+
+  // destructor
+  W_API virtual ~w_frame_encoder() noexcept = default;
+
+  /*
+   * queue a message and its prefix without copying the message
+   * @param p_message, the message
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> push(_In_ w_buffer p_message) noexcept;
+
+  // get the queued prefixes and messages as one buffer sequence
+  const w_buffer_sequence &get_buffers() const noexcept { return this->_buffers; }
+
+  // get the number of queued messages
+  size_t count() const noexcept { return this->_count; }
+
+  // get whether no message was queued
+  bool empty() const noexcept { return this->_count == 0; }
+
+  /*
+   * remove the queued messages, e.g. after they were written
+   */
+  W_API void clear() noexcept;
+
+private:
+  // copy constructor
+  w_frame_encoder(const w_frame_encoder &) = delete;
+  // copy operator
+  w_frame_encoder &operator=(const w_frame_encoder &) = delete;
+
+  w_framing_options _options = {};
+  w_buffer_sequence _buffers = {};
+  // the prefixes of many messages share one block
+  w_buffer _headers = {};
+  size_t _count = 0;
+};
+} // namespace wolf::system::socket
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -0,0 +1,316 @@
+#if defined(WOLF_SYSTEM_HTTP_WS) && defined(WOLF_SYSTEM_SOCKET)
+
+#include "w_http_server.hpp"
+#include <algorithm>
+
+using w_http_handler = wolf::system::socket::w_http_handler;
+using w_http_options = wolf::system::socket::w_http_options;
+using w_http_request = wolf::system::socket::w_http_request;
+using w_http_response = wolf::system::socket::w_http_response;
+using w_http_routes = wolf::system::socket::w_http_routes;
+using w_http_server = wolf::system::socket::w_http_server;
+using w_session_on_error_callback = wolf::system::socket::w_session_on_error_callback;
+using w_socket_options = wolf::system::socket::w_socket_options;
+using w_tcp_server = wolf::system::socket::w_tcp_server;
+using w_tcp_server_reactors = wolf::system::socket::w_tcp_server_reactors;
+using w_tcp_session_handler = wolf::system::socket::w_tcp_session_handler;
+using w_timing_wheel = wolf::system::socket::w_timing_wheel;
+using w_timing_wheel_entry = wolf::system::socket::w_timing_wheel_entry;
+using io_context = boost::asio::io_context;
+using steady_clock = std::chrono::steady_clock;
+using tcp = boost::asio::ip::tcp;
+namespace http = boost::beast::http;
+using namespace boost::asio::experimental::awaitable_operators;
+
+// the smallest room which is prepared for a read of requests
+constexpr auto HTTP_MIN_READ_SIZE = size_t(4096);
+
+boost::leaf::result<int> w_http_routes::add(_In_ http::verb p_method,
+                                            _In_ std::string_view p_path,
+                                            _In_ w_http_handler p_handler) noexcept {
+  if (p_path.empty() || p_handler == nullptr) {
+    return W_FAILURE(std::errc::invalid_argument, "missing path or handler of http route");
+  }
+
+  try {
+    w_http_methods *_methods = nullptr;
+    if (p_path.back() == '*') {
+      const auto _prefix = p_path.substr(0, p_path.size() - 1);
+      auto _iter = std::find_if(this->_prefixes.begin(), this->_prefixes.end(),
+                                [&](const auto &p_route) { return p_route.first == _prefix; });
+      if (_iter == this->_prefixes.end()) {
+        // keep the longest prefixes first
+        _iter = std::find_if(
+            this->_prefixes.begin(), this->_prefixes.end(),
+            [&](const auto &p_route) { return p_route.first.size() < _prefix.size(); });
+        _iter = this->_prefixes.emplace(_iter, std::string(_prefix), w_http_methods{});
+      }
+      _methods = &_iter->second;
+    } else {
+      _methods = &this->_paths[std::string(p_path)];
+    }
+
+    for (const auto &_route : *_methods) {
+      if (_route.first == p_method) {
+        const auto _method = http::to_string(p_method);
+        return W_FAILURE(std::errc::file_exists,
+                         wolf::format("the route {} {} was already added",
+                                      std::string_view(_method.data(), _method.size()), p_path));
+      }
+    }
+    _methods->emplace_back(p_method, std::move(p_handler));
+  } catch (const std::exception &p_ex) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "could not add the http route because " + std::string(p_ex.what()));
+  }
+  return 0;
+}
+
+const w_http_handler *w_http_routes::find(_In_ http::verb p_method,
+                                          _In_ std::string_view p_target,
+                                          _Out_ http::status &p_status) const noexcept {
+  const auto _path = p_target.substr(0, p_target.find('?'));
+
+  const w_http_methods *_methods = nullptr;
+  if (const auto _iter = this->_paths.find(_path); _iter != this->_paths.end()) {
+    _methods = &_iter->second;
+  } else {
+    for (const auto &_route : this->_prefixes) {
+      if (_path.starts_with(_route.first)) {
+        _methods = &_route.second;
+        break;
+      }
+    }
+  }
+
+  if (_methods == nullptr) {
+    p_status = http::status::not_found;
+    return nullptr;
+  }
+  for (const auto &_route : *_methods) {
+    if (_route.first == p_method) {
+      p_status = http::status::ok;
+      return &_route.second;
+    }
+  }
+  p_status = http::status::method_not_allowed;
+  return nullptr;
+}
+
+static void s_respond(_In_ const w_http_routes &p_routes, _In_ const std::string &p_conn_id,
+                      _In_ const w_http_request &p_request, _Inout_ w_http_response &p_response) {
+  p_response.version(p_request.version());
+  p_response.keep_alive(p_request.keep_alive());
+
+  auto _status = http::status::ok;
+  const auto _target = p_request.target();
+  const auto *_handler = p_routes.find(p_request.method(),
+                                       std::string_view(_target.data(), _target.size()), _status);
+  p_response.result(_status);
+  if (_handler != nullptr) {
+    try {
+      (*_handler)(p_conn_id, p_request, p_response);
+    } catch (const std::exception &p_ex) {
+      p_response.result(http::status::internal_server_error);
+      p_response.body() = p_ex.what();
+    }
+  }
+  p_response.set(http::field::server, std::string(BOOST_BEAST_VERSION_STRING) + "wolf-http-server");
+  p_response.prepare_payload();
+}
+
+static http::status s_get_error_status(_In_ const boost::system::error_code &p_error) noexcept {
+  if (p_error == http::error::body_limit) {
+    return http::status::payload_too_large;
+  }
+  if (p_error == http::error::header_limit) {
+    return http::status::request_header_fields_too_large;
+  }
+  return http::status::bad_request;
+}
+
+static boost::asio::awaitable<void>
+on_handle_http_session(_In_ const io_context &p_io_context, _Inout_ tcp::socket &p_socket,
+                       _In_ const std::string &p_conn_id, _Inout_ w_timing_wheel_entry &p_idle,
+                       _In_ steady_clock::duration p_timeout,
+                       _In_ const w_http_options &p_http_options,
+                       _In_ const w_http_routes &p_routes,
+                       _In_ const w_session_on_error_callback &p_on_error_callback) noexcept {
+  // the bytes of pipelined requests stay in the input until they are parsed
+  boost::beast::flat_buffer _input;
+  // the responses of pipelined requests which are written together
+  boost::beast::flat_buffer _output;
+  size_t _pending = 0;
+  size_t _requests = 0;
+
+  const auto _flush = [&]() -> boost::asio::awaitable<void> {
+    if (_pending != 0) {
+      co_await boost::asio::async_write(p_socket, _output.data(), boost::asio::use_awaitable);
+      _output.consume(_output.size());
+      _pending = 0;
+    }
+  };
+
+  try {
+#ifdef __clang__
+#pragma unroll
+#endif
+    while (!p_io_context.stopped()) {
+      http::request_parser<http::string_body> _parser;
+      _parser.eager(true);
+      _parser.body_limit(p_http_options.body_limit);
+      _parser.header_limit(p_http_options.header_limit);
+
+      // parse a request from the buffered bytes, the socket is read only when they run out
+      boost::system::error_code _error = {};
+      for (;;) {
+        if (_input.size() != 0) {
+          const auto _used = _parser.put(_input.data(), _error);
+          _input.consume(_used);
+          if (_error == http::error::need_more) {
+            _error = {};
+          }
+          if (_error || _parser.is_done()) {
+            break;
+          }
+          if (_used != 0 && _input.size() != 0) {
+            continue;
+          }
+        }
+
+        // the socket is needed, so the responses of previous requests are written first
+        co_await _flush();
+
+        const auto _size = std::max(p_socket.available(), HTTP_MIN_READ_SIZE);
+        const auto _bytes = co_await p_socket.async_read_some(
+            _input.prepare(_size),
+            boost::asio::redirect_error(boost::asio::use_awaitable, _error));
+        if (_error == boost::asio::error::eof) {
+          // a connection which is closed between requests is not an error
+          if (_parser.got_some()) {
+            p_on_error_callback(p_conn_id, boost::system::system_error(_error));
+          }
+          co_return;
+        }
+        if (_error) {
+          throw boost::system::system_error(_error);
+        }
+        _input.commit(_bytes);
+        p_idle.set_deadline(steady_clock::now() + p_timeout);
+      }
+
+      w_http_response _response = {};
+      if (_error) {
+        // answer a malformed or too large request and close the connection
+        _response.version(11);
+        _response.result(s_get_error_status(_error));
+        _response.keep_alive(false);
+        _response.set(http::field::server,
+                      std::string(BOOST_BEAST_VERSION_STRING) + "wolf-http-server");
+        _response.prepare_payload();
+      } else {
+        const auto _request = _parser.release();
+        s_respond(p_routes, p_conn_id, _request, _response);
+        ++_requests;
+        if (p_http_options.max_keep_alive_requests != 0 &&
+            _requests >= p_http_options.max_keep_alive_requests) {
+          _response.keep_alive(false);
+        }
+      }
+
+      const auto _keep_alive = _response.keep_alive();
+      if (_pending == 0 && (_input.size() == 0 || !_keep_alive)) {
+        // a single response is written from its body without copying
+        co_await http::async_write(p_socket, _response, boost::asio::use_awaitable);
+      } else {
+        boost::beast::ostream(_output) << _response;
+        ++_pending;
+        if (!_keep_alive || _pending >= p_http_options.max_pipelined_responses) {
+          co_await _flush();
+        }
+      }
+
+      if (!_keep_alive) {
+        boost::system::error_code _ignored;
+        p_socket.shutdown(tcp::socket::shutdown_send, _ignored);
+        co_return;
+      }
+    }
+  } catch (const boost::system::system_error &p_ex) {
+    p_on_error_callback(p_conn_id, p_ex);
+  }
+}
+
+static boost::asio::awaitable<void>
+s_session(_In_ const io_context &p_io_context, _In_ tcp::socket p_socket,
+          _In_ std::shared_ptr<w_timing_wheel> p_wheel, _In_ steady_clock::duration p_timeout,
+          _In_ std::shared_ptr<const w_http_options> p_http_options,
+          _In_ std::shared_ptr<const w_http_routes> p_routes,
+          _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+  const auto _conn_id = wolf::system::socket::make_connection_id();
+
+  // the wheel watches the idle deadline, which the reader refreshes
+  w_timing_wheel_entry _idle = {};
+  _idle.set_deadline(steady_clock::now() + p_timeout);
+
+  const auto _ret = co_await (on_handle_http_session(p_io_context, p_socket, _conn_id, _idle,
+                                                     p_timeout, *p_http_options, *p_routes,
+                                                     p_on_error_callback) ||
+                              p_wheel->async_wait(_idle));
+  if (_ret.index() == 1 && std::get<1>(_ret) == std::errc::timed_out) {
+    const auto _error =
+        boost::system::system_error(make_error_code(boost::system::errc::timed_out));
+    p_on_error_callback(_conn_id, _error);
+  }
+}
+
+static w_tcp_session_handler
+s_make_session_handler(_In_ steady_clock::duration p_timeout,
+                       _In_ w_http_options &&p_http_options, _In_ w_http_routes &&p_routes,
+                       _In_ w_session_on_error_callback p_on_error_callback) {
+  auto _http_options = std::make_shared<const w_http_options>(std::move(p_http_options));
+  auto _routes = std::make_shared<const w_http_routes>(std::move(p_routes));
+
+  return [=](_In_ const io_context &p_io_context, _In_ tcp::socket &&p_socket,
+             _In_ std::shared_ptr<w_timing_wheel> p_wheel) {
+    return s_session(p_io_context, std::move(p_socket), std::move(p_wheel), p_timeout,
+                     _http_options, _routes, p_on_error_callback);
+  };
+}
+
+boost::leaf::result<int>
+w_http_server::run(_In_ io_context &p_io_context, _In_ tcp::endpoint &&p_endpoint,
+                   _In_ steady_clock::duration &&p_timeout,
+                   _In_ w_socket_options &&p_socket_options, _In_ w_http_options &&p_http_options,
+                   _In_ w_http_routes &&p_routes,
+                   _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+  try {
+    auto _handler = s_make_session_handler(p_timeout, std::move(p_http_options),
+                                           std::move(p_routes), std::move(p_on_error_callback));
+    return w_tcp_server::run(p_io_context, std::move(p_endpoint), std::move(p_timeout),
+                             std::move(p_socket_options), std::move(_handler));
+  } catch (const std::exception &p_ex) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     "http server caught an exception : " + std::string(p_ex.what()));
+  }
+}
+
+boost::leaf::result<int>
+w_http_server::run(_In_ const w_tcp_server_reactors &p_reactors, _In_ std::stop_token p_stop_token,
+                   _In_ tcp::endpoint &&p_endpoint, _In_ steady_clock::duration &&p_timeout,
+                   _In_ w_socket_options &&p_socket_options, _In_ w_http_options &&p_http_options,
+                   _In_ w_http_routes &&p_routes,
+                   _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+  try {
+    auto _handler = s_make_session_handler(p_timeout, std::move(p_http_options),
+                                           std::move(p_routes), std::move(p_on_error_callback));
+    return w_tcp_server::run(p_reactors, std::move(p_stop_token), std::move(p_endpoint),
+                             std::move(p_timeout), std::move(p_socket_options),
+                             std::move(_handler));
+  } catch (const std::exception &p_ex) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     "http server caught an exception : " + std::string(p_ex.what()));
+  }
+}
+
+#endif // defined(WOLF_SYSTEM_HTTP_WS) && defined(WOLF_SYSTEM_SOCKET)
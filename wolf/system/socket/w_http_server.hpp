@@ -0,0 +1,143 @@
+#if defined(WOLF_SYSTEM_HTTP_WS) && defined(WOLF_SYSTEM_SOCKET)
+
+#pragma once
+
+#include "w_tcp_server.hpp"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <wolf/wolf.hpp>
+
+namespace wolf::system::socket {
+
+using w_http_request = boost::beast::http::request<boost::beast::http::string_body>;
+using w_http_response = boost::beast::http::response<boost::beast::http::string_body>;
+
+/*
+ * the handler of a route, the response has the status of ok and the version and keep-alive of
+ * the request, the handler sets its body and fields
+ */
+typedef std::function<void(_In_ const std::string &p_conn_id,
+                           _In_ const w_http_request &p_request,
+                           _Inout_ w_http_response &p_response)>
+    w_http_handler;
+
+struct w_http_options {
+  // the largest body of a request, a larger one is answered with 413 and closes the connection
+  uint64_t body_limit = 1024 * 1024;
+  // the largest header of a request, a larger one is answered with 431 and closes the connection
+  uint32_t header_limit = 8 * 1024;
+  // the number of responses of pipelined requests which are written together
+  size_t max_pipelined_responses = 16;
+  // the number of requests of a connection before it is closed, zero means no limit
+  size_t max_keep_alive_requests = 0;
+};
+
+/*
+ * the route table of an http server. a route is a whole path, or a prefix if it ends with '*'
+ * where the longest prefix wins. the query string of a target is not matched
+ */
+class w_http_routes {
+public:
+  // default constructor
+  W_API w_http_routes() noexcept = default;
+
+  // move constructor.
+  W_API w_http_routes(w_http_routes &&p_other) noexcept = default;
+  // move assignment operator.
+  W_API w_http_routes &operator=(w_http_routes &&p_other) noexcept = default;
+
+  // destructor
+  W_API virtual ~w_http_routes() noexcept = default;
+
+  /*
+   * add a route
+   * @param p_method, the method of requests
+   * @param p_path, the path or the prefix of route
+   * @param p_handler, the handler
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> add(_In_ boost::beast::http::verb p_method,
+                                     _In_ std::string_view p_path,
+                                     _In_ w_http_handler p_handler) noexcept;
+
+  /*
+   * find the handler of a request
+   * @param p_method, the method of request
+   * @param p_target, the target of request
+   * @param p_status, the status which should be answered when there is no handler, which is
+   * not found or method not allowed
+   * @returns the handler or null
+   */
+  W_API const w_http_handler *find(_In_ boost::beast::http::verb p_method,
+                                   _In_ std::string_view p_target,
+                                   _Out_ boost::beast::http::status &p_status) const noexcept;
+
+private:
+  // copy constructor
+  w_http_routes(const w_http_routes &) = delete;
+  // copy operator
+  w_http_routes &operator=(const w_http_routes &) = delete;
+
+  struct w_http_path_hash {
+    using is_transparent = void;
+    size_t operator()(_In_ std::string_view p_path) const noexcept {
+      return std::hash<std::string_view>{}(p_path);
+    }
+  };
+
+  using w_http_methods = std::vector<std::pair<boost::beast::http::verb, w_http_handler>>;
+
+  std::unordered_map<std::string, w_http_methods, w_http_path_hash, std::equal_to<>> _paths;
+  // sorted from the longest prefix
+  std::vector<std::pair<std::string, w_http_methods>> _prefixes;
+};
+
+/*
+ * an http/1.1 server on the accept loop of w_tcp_server. the connections are kept alive, the
+ * pipelined requests are parsed from the buffered bytes and their responses are written together
+ */
+class w_http_server {
+public:
+  /*
+   * @param p_io_context, the boost io context
+   * @param p_endpoint, the endpoint of the server
+   * @param p_timeout, the idle timeout of connections
+   * @param p_socket_options, the socket options
+   * @param p_http_options, the http options
+   * @param p_routes, the route table
+   * @param p_on_error_callback, on error callback for session
+   * @returns zero on success
+   */
+  W_API static boost::leaf::result<int>
+  run(_In_ boost::asio::io_context &p_io_context, _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
+      _In_ std::chrono::steady_clock::duration &&p_timeout,
+      _In_ w_socket_options &&p_socket_options, _In_ w_http_options &&p_http_options,
+      _In_ w_http_routes &&p_routes,
+      _In_ w_session_on_error_callback p_on_error_callback) noexcept;
+
+  /*
+   * run the server on several io contexts and block until a stop is requested, the handlers
+   * of routes are called from all threads
+   * @param p_reactors, the options of io contexts
+   * @param p_stop_token, the token which stops the server
+   * @param p_endpoint, the endpoint of the server
+   * @param p_timeout, the idle timeout of connections
+   * @param p_socket_options, the socket options
+   * @param p_http_options, the http options
+   * @param p_routes, the route table
+   * @param p_on_error_callback, on error callback for session
+   * @returns zero after all io contexts were stopped
+   */
+  W_API static boost::leaf::result<int>
+  run(_In_ const w_tcp_server_reactors &p_reactors, _In_ std::stop_token p_stop_token,
+      _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
+      _In_ std::chrono::steady_clock::duration &&p_timeout,
+      _In_ w_socket_options &&p_socket_options, _In_ w_http_options &&p_http_options,
+      _In_ w_http_routes &&p_routes,
+      _In_ w_session_on_error_callback p_on_error_callback) noexcept;
+};
+} // namespace wolf::system::socket
+
+#endif // defined(WOLF_SYSTEM_HTTP_WS) && defined(WOLF_SYSTEM_SOCKET)
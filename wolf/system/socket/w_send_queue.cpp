@@ -0,0 +1,175 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_send_queue.hpp"
+
+#include <algorithm>
+
+using w_buffer = wolf::system::socket::w_buffer;
+using w_send_queue = wolf::system::socket::w_send_queue;
+using w_send_queue_message = wolf::system::socket::w_send_queue_message;
+using w_send_queue_options = wolf::system::socket::w_send_queue_options;
+using w_send_queue_policy = wolf::system::socket::w_send_queue_policy;
+using w_send_queue_stats = wolf::system::socket::w_send_queue_stats;
+using w_send_queue_status = wolf::system::socket::w_send_queue_status;
+using steady_clock = std::chrono::steady_clock;
+using steady_timer = boost::asio::steady_timer;
+
+w_send_queue::w_send_queue(_In_ const w_send_queue_options &p_options) noexcept
+    : _options(p_options) {
+  this->_options.low_watermark =
+      std::min(this->_options.low_watermark, this->_options.high_watermark);
+}
+
+w_send_queue::~w_send_queue() noexcept { close(); }
+
+void w_send_queue::_notify(_Inout_ std::vector<std::shared_ptr<steady_timer>> &p_waiters) noexcept {
+  for (auto &_waiter : p_waiters) {
+    // an expired timer wakes up a pending wait, or completes the next wait at once
+    boost::asio::post(_waiter->get_executor(), [_waiter]() {
+      std::ignore = _waiter->expires_at(steady_clock::time_point::min());
+    });
+  }
+  p_waiters.clear();
+}
+
+w_send_queue_status w_send_queue::push(_In_ w_buffer p_message,
+                                       _In_ bool p_is_binary) noexcept {
+  std::scoped_lock _lock(this->_mutex);
+
+  if (this->_closed) {
+    return w_send_queue_status::CLOSED;
+  }
+  // a message is always accepted by an empty queue, even if it exceeds the high watermark
+  if (this->_bytes != 0 && this->_bytes + p_message.size() > this->_options.high_watermark) {
+    this->_full = true;
+  }
+
+  if (this->_full) {
+    switch (this->_options.policy) {
+    case w_send_queue_policy::DROP:
+      ++this->_dropped;
+      return w_send_queue_status::DROPPED;
+    case w_send_queue_policy::DISCONNECT:
+      this->_overflowed = true;
+      this->_closed = true;
+      this->_messages.clear();
+      _notify(this->_pop_waiters);
+      _notify(this->_writable_waiters);
+      return w_send_queue_status::CLOSED;
+    case w_send_queue_policy::SLOW_DOWN:
+      return w_send_queue_status::FULL;
+    }
+  }
+
+  const auto _size = p_message.size();
+  try {
+    this->_messages.push_back({std::move(p_message), p_is_binary});
+  } catch (...) {
+    ++this->_dropped;
+    return w_send_queue_status::DROPPED;
+  }
+  this->_bytes += _size;
+  _notify(this->_pop_waiters);
+
+  return w_send_queue_status::QUEUED;
+}
+
+boost::asio::awaitable<w_send_queue_status>
+w_send_queue::async_push(_In_ w_buffer p_message, _In_ bool p_is_binary) {
+  for (;;) {
+    // the copy shares the block, so the message can be pushed again
+    const auto _status = push(p_message, p_is_binary);
+    if (_status != w_send_queue_status::FULL) {
+      co_return _status;
+    }
+    if (!co_await async_wait_writable()) {
+      co_return w_send_queue_status::CLOSED;
+    }
+  }
+}
+
+boost::asio::awaitable<bool> w_send_queue::async_wait_writable() {
+  auto _executor = co_await boost::asio::this_coro::executor;
+
+  for (;;) {
+    auto _waiter = std::make_shared<steady_timer>(_executor, steady_clock::time_point::max());
+    {
+      std::scoped_lock _lock(this->_mutex);
+      if (this->_closed || !this->_full) {
+        break;
+      }
+      this->_writable_waiters.push_back(_waiter);
+    }
+
+    boost::system::error_code _error = {};
+    co_await _waiter->async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, _error));
+  }
+
+  std::scoped_lock _lock(this->_mutex);
+  co_return !this->_closed;
+}
+
+boost::asio::awaitable<size_t>
+w_send_queue::async_pop(_Inout_ std::vector<w_send_queue_message> &p_messages) {
+  auto _executor = co_await boost::asio::this_coro::executor;
+  p_messages.clear();
+
+  for (;;) {
+    auto _waiter = std::make_shared<steady_timer>(_executor, steady_clock::time_point::max());
+    {
+      std::scoped_lock _lock(this->_mutex);
+      if (this->_closed) {
+        break;
+      }
+      if (!this->_messages.empty()) {
+        // the storage of vectors is reused by both sides
+        std::swap(this->_messages, p_messages);
+        break;
+      }
+      this->_pop_waiters.push_back(_waiter);
+    }
+
+    boost::system::error_code _error = {};
+    co_await _waiter->async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, _error));
+  }
+
+  co_return p_messages.size();
+}
+
+void w_send_queue::consume(_In_ size_t p_size) noexcept {
+  std::scoped_lock _lock(this->_mutex);
+
+  this->_bytes -= std::min(p_size, this->_bytes);
+  if (this->_full && this->_bytes <= this->_options.low_watermark) {
+    this->_full = false;
+    _notify(this->_writable_waiters);
+  }
+}
+
+void w_send_queue::close() noexcept {
+  std::scoped_lock _lock(this->_mutex);
+
+  this->_closed = true;
+  this->_messages.clear();
+  _notify(this->_pop_waiters);
+  _notify(this->_writable_waiters);
+}
+
+bool w_send_queue::is_overflowed() const noexcept {
+  std::scoped_lock _lock(this->_mutex);
+  return this->_overflowed;
+}
+
+w_send_queue_stats w_send_queue::get_stats() const noexcept {
+  std::scoped_lock _lock(this->_mutex);
+
+  w_send_queue_stats _stats = {};
+  _stats.bytes = this->_bytes;
+  _stats.messages = this->_messages.size();
+  _stats.dropped_messages = this->_dropped;
+  _stats.full = this->_full;
+  _stats.closed = this->_closed;
+  return _stats;
+}
+
+#endif // WOLF_SYSTEM_SOCKET
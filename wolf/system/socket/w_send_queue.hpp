@@ -0,0 +1,168 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_buffer.hpp"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <wolf/wolf.hpp>
+
+#include "DISABLE_ANALYSIS_BEGIN"
+#include <boost/asio.hpp>
+#include "DISABLE_ANALYSIS_END"
+
+namespace wolf::system::socket {
+
+class w_send_queue;
+
+// what happens to the messages which are pushed while the queue is full
+enum class w_send_queue_policy : uint8_t {
+  // drop the message, the session stays open
+  DROP = 0,
+  // close the session, e.g. for a consumer which must not miss any message
+  DISCONNECT,
+  // refuse the message, the producer waits until the queue is writable and pushes it again
+  SLOW_DOWN,
+};
+
+// the result of pushing a message
+enum class w_send_queue_status : uint8_t {
+  // the message was queued
+  QUEUED = 0,
+  // the queue is full and the message was dropped
+  DROPPED,
+  // the queue is full, wait until it is writable and push the message again
+  FULL,
+  // the session was closed and the message was not queued
+  CLOSED,
+};
+
+struct w_send_queue_options {
+  // the queue becomes full once the queued and in-flight bytes would exceed this size
+  size_t high_watermark = 1024 * 1024;
+  // a full queue becomes writable again once its bytes fall to this size
+  size_t low_watermark = 256 * 1024;
+  w_send_queue_policy policy = w_send_queue_policy::SLOW_DOWN;
+  // called when a session is opened, the queue may be kept for pushing messages to the
+  // session from anywhere, e.g. for fan-out
+  std::function<void(_In_ const std::string &p_conn_id,
+                     _In_ std::shared_ptr<w_send_queue> p_queue)>
+      on_open = nullptr;
+};
+
+struct w_send_queue_message {
+  w_buffer buffer = {};
+  // the type of websocket message, it is ignored by tcp
+  bool is_binary = true;
+};
+
+struct w_send_queue_stats {
+  // the bytes which were queued or are being written
+  size_t bytes = 0;
+  // the number of messages which wait for the writer
+  size_t messages = 0;
+  // the number of messages which were dropped because the queue was full
+  size_t dropped_messages = 0;
+  bool full = false;
+  bool closed = false;
+};
+
+/*
+ * a bounded queue of outgoing messages of a session. producers push from any thread without
+ * blocking and the writer of session drains all queued messages with one write, so a slow
+ * consumer only fills its own queue and the policy decides what happens then
+ */
+class w_send_queue {
+public:
+  // constructor with options
+  W_API explicit w_send_queue(_In_ const w_send_queue_options &p_options) noexcept;
+
+  // destructor, wakes up all waiters
+  W_API virtual ~w_send_queue() noexcept;
+
+  /*
+   * queue a message without copying it, it never blocks
+   * @param p_message, the message
+   * @param p_is_binary, the type of websocket message
+   * @returns the status of message
+   */
+  W_API w_send_queue_status push(_In_ w_buffer p_message, _In_ bool p_is_binary = true) noexcept;
+
+  /*
+   * queue a message, and wait until the queue is writable while it is full
+   * @param p_message, the message
+   * @param p_is_binary, the type of websocket message
+   * @returns the status of message, which is never FULL
+   */
+  W_API boost::asio::awaitable<w_send_queue_status> async_push(_In_ w_buffer p_message,
+                                                               _In_ bool p_is_binary = true);
+
+  /*
+   * wait until the queue is not full
+   * @returns false if the queue was closed
+   */
+  W_API boost::asio::awaitable<bool> async_wait_writable();
+
+  /*
+   * wait for queued messages and take all of them, it is called by the writer of session
+   * @param p_messages, the taken messages, its storage is swapped with the queue
+   * @returns the number of messages, zero once the queue is closed
+   */
+  W_API boost::asio::awaitable<size_t>
+  async_pop(_Inout_ std::vector<w_send_queue_message> &p_messages);
+
+  /*
+   * release the bytes of popped messages after they were written
+   * @param p_size, the number of written bytes
+   */
+  W_API void consume(_In_ size_t p_size) noexcept;
+
+  /*
+   * close the queue, the queued messages are dropped and the waiters are woken up
+   */
+  W_API void close() noexcept;
+
+  // get whether the queue was closed because it was full with the disconnect policy
+  W_API bool is_overflowed() const noexcept;
+
+  /*
+   * get the statistics of the queue
+   * @returns the statistics
+   */
+  W_API w_send_queue_stats get_stats() const noexcept;
+
+private:
+  // copy constructor
+  w_send_queue(const w_send_queue &) = delete;
+  // copy operator
+  w_send_queue &operator=(const w_send_queue &) = delete;
+  // move constructor, waiters refer to the queue
+  w_send_queue(w_send_queue &&) = delete;
+  // move operator
+  w_send_queue &operator=(w_send_queue &&) = delete;
+
+  // wake up and forget the waiters, the lock must be held
+  static void _notify(
+      _Inout_ std::vector<std::shared_ptr<boost::asio::steady_timer>> &p_waiters) noexcept;
+
+  w_send_queue_options _options = {};
+  mutable std::mutex _mutex;
+  std::vector<w_send_queue_message> _messages;
+  size_t _bytes = 0;
+  size_t _dropped = 0;
+  bool _full = false;
+  bool _closed = false;
+  bool _overflowed = false;
+  // the writer and the producers which wait, each one wakes up once its timer is expired
+  std::vector<std::shared_ptr<boost::asio::steady_timer>> _pop_waiters;
+  std::vector<std::shared_ptr<boost::asio::steady_timer>> _writable_waiters;
+};
+} // namespace wolf::system::socket
+
+#endif // WOLF_SYSTEM_SOCKET
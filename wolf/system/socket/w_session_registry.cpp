@@ -0,0 +1,190 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_session_registry.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+using w_broadcast_stats = wolf::system::socket::w_broadcast_stats;
+using w_buffer = wolf::system::socket::w_buffer;
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+using w_send_queue = wolf::system::socket::w_send_queue;
+using w_send_queue_status = wolf::system::socket::w_send_queue_status;
+using w_session_id = wolf::system::socket::w_session_id;
+using w_session_registry = wolf::system::socket::w_session_registry;
+using w_session_registry_shard = wolf::system::socket::w_session_registry_shard;
+
+namespace wolf::system::socket {
+
+// each shard has its own cache line, so the shards are locked without false sharing
+struct alignas(64) w_session_registry_shard {
+  mutable std::mutex lock;
+  std::unordered_map<w_session_id, std::shared_ptr<w_send_queue>> sessions;
+};
+} // namespace wolf::system::socket
+
+// push a message and count how it was delivered, returns false if the session was closed
+static bool s_push(_Inout_ w_send_queue &p_queue, _In_ const w_buffer &p_message,
+                   _In_ bool p_is_binary, _Inout_ w_broadcast_stats &p_stats) noexcept {
+  switch (p_queue.push(p_message, p_is_binary)) {
+  case w_send_queue_status::QUEUED:
+    ++p_stats.queued;
+    return true;
+  case w_send_queue_status::CLOSED:
+    ++p_stats.closed;
+    return false;
+  default:
+    ++p_stats.dropped;
+    return true;
+  }
+}
+
+w_session_registry::w_session_registry(_In_ size_t p_shards)
+    : _shards(std::make_unique<w_session_registry_shard[]>(std::bit_ceil(
+          std::max(p_shards, size_t(1))))),
+      _mask(std::bit_ceil(std::max(p_shards, size_t(1))) - 1) {}
+
+// the shard is only complete here, so the moves and destructor of its array are defined here
+w_session_registry::w_session_registry(w_session_registry &&p_other) noexcept
+    : _shards(std::move(p_other._shards)), _mask(std::exchange(p_other._mask, 0)) {}
+
+w_session_registry &w_session_registry::operator=(w_session_registry &&p_other) noexcept {
+  if (this != &p_other) {
+    this->_shards = std::move(p_other._shards);
+    this->_mask = std::exchange(p_other._mask, 0);
+  }
+  return *this;
+}
+
+w_session_registry::~w_session_registry() noexcept = default;
+
+w_session_registry_shard &w_session_registry::_get_shard(_In_ w_session_id p_id) const noexcept {
+  // the ids are sequential, so they are spread evenly by the low bits
+  return this->_shards[p_id & this->_mask];
+}
+
+boost::leaf::result<int>
+w_session_registry::add(_In_ w_session_id p_id,
+                        _In_ std::shared_ptr<w_send_queue> p_queue) noexcept {
+  if (p_id == 0 || p_queue == nullptr) {
+    return W_FAILURE(std::errc::invalid_argument, "missing id or send queue of session");
+  }
+  if (this->_shards == nullptr) {
+    return W_FAILURE(std::errc::operation_not_permitted, "the session registry was moved");
+  }
+
+  auto &_shard = _get_shard(p_id);
+  std::scoped_lock _lock(_shard.lock);
+  try {
+    if (!_shard.sessions.emplace(p_id, std::move(p_queue)).second) {
+      return W_FAILURE(std::errc::file_exists,
+                       wolf::format("the session {} was already added", p_id));
+    }
+  } catch (const std::exception &p_ex) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "could not add the session because " + std::string(p_ex.what()));
+  }
+  return 0;
+}
+
+void w_session_registry::remove(_In_ w_session_id p_id) noexcept {
+  if (this->_shards == nullptr) {
+    return;
+  }
+  auto &_shard = _get_shard(p_id);
+  std::scoped_lock _lock(_shard.lock);
+  _shard.sessions.erase(p_id);
+}
+
+std::shared_ptr<w_send_queue> w_session_registry::find(_In_ w_session_id p_id) const noexcept {
+  if (this->_shards == nullptr) {
+    return nullptr;
+  }
+  auto &_shard = _get_shard(p_id);
+  std::scoped_lock _lock(_shard.lock);
+  const auto _iter = _shard.sessions.find(p_id);
+  return _iter == _shard.sessions.end() ? nullptr : _iter->second;
+}
+
+size_t w_session_registry::size() const noexcept {
+  size_t _size = 0;
+  for (size_t i = 0; this->_shards != nullptr && i <= this->_mask; ++i) {
+    std::scoped_lock _lock(this->_shards[i].lock);
+    _size += this->_shards[i].sessions.size();
+  }
+  return _size;
+}
+
+w_broadcast_stats w_session_registry::broadcast(_In_ const w_buffer &p_message,
+                                                _In_ bool p_is_binary) noexcept {
+  w_broadcast_stats _stats = {};
+
+  // a push never blocks, so a shard is only locked for copying the references of message
+  for (size_t i = 0; this->_shards != nullptr && i <= this->_mask; ++i) {
+    auto &_shard = this->_shards[i];
+    std::scoped_lock _lock(_shard.lock);
+
+    for (auto _iter = _shard.sessions.begin(); _iter != _shard.sessions.end();) {
+      if (s_push(*_iter->second, p_message, p_is_binary, _stats)) {
+        ++_iter;
+      } else {
+        _iter = _shard.sessions.erase(_iter);
+      }
+    }
+  }
+  return _stats;
+}
+
+w_broadcast_stats w_session_registry::multicast(_In_ gsl::span<const w_session_id> p_ids,
+                                                _In_ const w_buffer &p_message,
+                                                _In_ bool p_is_binary) noexcept {
+  w_broadcast_stats _stats = {};
+  if (this->_shards == nullptr) {
+    return _stats;
+  }
+
+  for (const auto _id : p_ids) {
+    auto &_shard = _get_shard(_id);
+    std::scoped_lock _lock(_shard.lock);
+
+    const auto _iter = _shard.sessions.find(_id);
+    if (_iter != _shard.sessions.end() &&
+        !s_push(*_iter->second, p_message, p_is_binary, _stats)) {
+      _shard.sessions.erase(_iter);
+    }
+  }
+  return _stats;
+}
+
+boost::leaf::result<w_buffer>
+w_session_registry::make_message(_In_ gsl::span<const std::byte> p_payload) noexcept {
+  BOOST_LEAF_AUTO(_message, w_buffer_pool::get_default().acquire(p_payload.size()));
+  if (!p_payload.empty()) {
+    std::memcpy(_message.data(), p_payload.data(), p_payload.size());
+  }
+  return _message;
+}
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+boost::leaf::result<w_buffer> w_session_registry::make_message(
+    _In_ gsl::span<const std::byte> p_payload,
+    _In_ const wolf::system::compression::w_compressor_options &p_options) noexcept {
+  using w_compressor = wolf::system::compression::w_compressor;
+
+  BOOST_LEAF_AUTO(_compressed, w_compressor::compress(p_payload, p_options));
+  return make_message(gsl::span<const std::byte>(_compressed.data(), _compressed.size()));
+}
+#endif
+
+w_session_id w_session_registry::get_id(_In_ std::string_view p_conn_id) noexcept {
+  w_session_id _id = 0;
+  const auto *_end = p_conn_id.data() + p_conn_id.size();
+  const auto [_ptr, _error] = std::from_chars(p_conn_id.data(), _end, _id);
+  return _error == std::errc() && _ptr == _end ? _id : 0;
+}
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -0,0 +1,156 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_buffer.hpp"
+#include "w_send_queue.hpp"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <wolf/wolf.hpp>
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+#include <system/compression/w_compressor.hpp>
+#endif
+
+namespace wolf::system::socket {
+
+// the id of a session, which is unique in the process and never zero
+using w_session_id = uint64_t;
+
+/*
+ * make the id of a new session
+ * @returns the id
+ */
+inline w_session_id make_session_id() noexcept {
+  static std::atomic<w_session_id> s_last_id = 0;
+  return s_last_id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+struct w_session_registry_shard;
+
+struct w_broadcast_stats {
+  // the number of sessions which queued the message
+  size_t queued = 0;
+  // the number of sessions which dropped the message, or were full and slowed down
+  size_t dropped = 0;
+  // the number of closed sessions which were removed
+  size_t closed = 0;
+};
+
+/*
+ * the sessions of servers by their ids, the sessions are split into shards which are locked
+ * independently. a broadcast shares one refcounted buffer between the send queues of all
+ * sessions, so a message is serialized once for any number of sessions
+ */
+class w_session_registry {
+public:
+  /*
+   * constructor
+   * @param p_shards, the number of shards, which is rounded up to a power of two
+   */
+  W_API explicit w_session_registry(_In_ size_t p_shards = 16);
+
+  // move constructor, the moved registry has no shards and no sessions.
+  W_API w_session_registry(w_session_registry &&p_other) noexcept;
+  // move assignment operator.
+  W_API w_session_registry &operator=(w_session_registry &&p_other) noexcept;
+
+  // destructor
+  W_API virtual ~w_session_registry() noexcept;
+
+  /*
+   * add a session
+   * @param p_id, the id of session
+   * @param p_queue, the send queue of session
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> add(_In_ w_session_id p_id,
+                                     _In_ std::shared_ptr<w_send_queue> p_queue) noexcept;
+
+  /*
+   * remove a session
+   * @param p_id, the id of session
+   */
+  W_API void remove(_In_ w_session_id p_id) noexcept;
+
+  /*
+   * find the send queue of a session
+   * @param p_id, the id of session
+   * @returns the queue, or null if the session was not found
+   */
+  W_API std::shared_ptr<w_send_queue> find(_In_ w_session_id p_id) const noexcept;
+
+  /*
+   * get the number of sessions
+   * @returns the number of sessions
+   */
+  W_API size_t size() const noexcept;
+
+  /*
+   * queue a message for all sessions without copying it, the closed sessions are removed
+   * @param p_message, the message which is shared by all sessions
+   * @param p_is_binary, the type of websocket message
+   * @returns the statistics of delivery
+   */
+  W_API w_broadcast_stats broadcast(_In_ const w_buffer &p_message,
+                                    _In_ bool p_is_binary = true) noexcept;
+
+  /*
+   * queue a message for some sessions without copying it, the closed sessions are removed
+   * @param p_ids, the ids of sessions, the missing ones are ignored
+   * @param p_message, the message which is shared by the sessions
+   * @param p_is_binary, the type of websocket message
+   * @returns the statistics of delivery
+   */
+  W_API w_broadcast_stats multicast(_In_ gsl::span<const w_session_id> p_ids,
+                                    _In_ const w_buffer &p_message,
+                                    _In_ bool p_is_binary = true) noexcept;
+
+  /*
+   * copy a serialized payload once into a pooled buffer, which can be broadcast
+   * @param p_payload, the payload
+   * @returns the message
+   */
+  W_API static boost::leaf::result<w_buffer>
+  make_message(_In_ gsl::span<const std::byte> p_payload) noexcept;
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+  /*
+   * compress a serialized payload once into a pooled buffer, which can be broadcast.
+   * the receivers decompress it with w_compressor::decompress
+   * @param p_payload, the payload
+   * @param p_options, the codec and its level
+   * @returns the message
+   */
+  W_API static boost::leaf::result<w_buffer>
+  make_message(_In_ gsl::span<const std::byte> p_payload,
+               _In_ const wolf::system::compression::w_compressor_options &p_options) noexcept;
+#endif
+
+  /*
+   * get the session id of a connection id which was given to the callbacks of servers
+   * @param p_conn_id, the connection id
+   * @returns the session id, or zero if it is not a session id
+   */
+  W_API static w_session_id get_id(_In_ std::string_view p_conn_id) noexcept;
+
+private:
+  // copy constructor
+  w_session_registry(const w_session_registry &) = delete;
+  // copy operator
+  w_session_registry &operator=(const w_session_registry &) = delete;
+
+  w_session_registry_shard &_get_shard(_In_ w_session_id p_id) const noexcept;
+
+  std::unique_ptr<w_session_registry_shard[]> _shards;
+  size_t _mask = 0;
+};
+} // namespace wolf::system::socket
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -7,8 +7,14 @@
 
 #ifdef WOLF_SYSTEM_SOCKET
 
+#include "w_buffer.hpp"
+#include "w_framing.hpp"
+#include "w_send_queue.hpp"
+#include "w_session_registry.hpp"
 #include <functional>
-#include <random>
+#include <memory>
+#include <optional>
+#include <vector>
 #include <wolf/wolf.hpp>
 
 #include "DISABLE_ANALYSIS_BEGIN"
@@ -17,27 +23,106 @@
 #ifdef WOLF_SYSTEM_HTTP_WS
 #include <boost/asio/experimental/awaitable_operators.hpp>
 #include <boost/beast.hpp>
+#include <boost/version.hpp>
 #endif
 #include "DISABLE_ANALYSIS_END"
 
 namespace wolf::system::socket {
 
-inline std::string make_connection_id() {
-  constexpr auto _max = 999;
-  constexpr auto _min = 100;
-
-  std::default_random_engine _rand_engine{};
-  std::uniform_int_distribution<int> _rand_gen(_min, _max);
+/*
+ * make the id of a new connection, which is the decimal of its session id
+ * @returns the id
+ */
+inline std::string make_connection_id() { return std::to_string(make_session_id()); }
 
-  const auto _now = std::chrono::system_clock::now();
-  return wolf::format("{}_{}", _now, _rand_gen(_rand_engine));
+/*
+ * get the name of the backend which runs the asynchronous operations of asio,
+ * WOLF_SYSTEM_SOCKET_IO_URING switches linux from epoll to io_uring
+ * @returns the name of backend
+ */
+inline std::string_view get_io_backend() noexcept {
+#if defined(BOOST_ASIO_HAS_IO_URING_AS_DEFAULT)
+  return "io_uring";
+#elif defined(BOOST_ASIO_HAS_IOCP)
+  return "iocp";
+#elif defined(BOOST_ASIO_HAS_EPOLL)
+  return "epoll";
+#elif defined(BOOST_ASIO_HAS_KQUEUE)
+  return "kqueue";
+#elif defined(BOOST_ASIO_HAS_DEV_POLL)
+  return "/dev/poll";
+#else
+  return "select";
+#endif
 }
 
+#ifdef WOLF_SYSTEM_HTTP_WS
+// the options of permessage-deflate, both sides must enable it for messages to be compressed
+struct w_ws_deflate_options {
+  // the base two logarithm of the window size of the server and the client, between 9 - 15
+  int server_max_window_bits = 15;
+  int client_max_window_bits = 15;
+  // reset the compression context after each message of the server or the client, which
+  // saves the memory of each session but compresses similar messages worse
+  bool server_no_context_takeover = false;
+  bool client_no_context_takeover = false;
+  // the level of deflate, between 0 - 9
+  int compression_level = 6;
+  // the memory level of deflate, between 1 - 9
+  int memory_level = 4;
+  // messages smaller than this size are sent without compression, requires boost 1.80
+  size_t min_size = 256;
+
+  template <typename T>
+  void set_to_stream(_Inout_ boost::beast::websocket::stream<T, true> &p_ws) const {
+    boost::beast::websocket::permessage_deflate _deflate = {};
+    _deflate.server_enable = true;
+    _deflate.client_enable = true;
+    _deflate.server_max_window_bits = this->server_max_window_bits;
+    _deflate.client_max_window_bits = this->client_max_window_bits;
+    _deflate.server_no_context_takeover = this->server_no_context_takeover;
+    _deflate.client_no_context_takeover = this->client_no_context_takeover;
+    _deflate.compLevel = this->compression_level;
+    _deflate.memLevel = this->memory_level;
+#if BOOST_VERSION >= 108000
+    _deflate.msg_size_threshold = this->min_size;
+#endif
+    p_ws.set_option(_deflate);
+  }
+};
+#endif
+
+// the socket of a stream session, which is a tcp or a unix domain socket
+using w_stream_socket = boost::asio::generic::stream_protocol::socket;
+
+// the file descriptors are owned by the callback, which should close them
+typedef std::function<void(_In_ const std::string &p_conn_id, _In_ std::vector<int> &&p_fds)>
+    w_session_on_fds_callback;
+
 struct w_socket_options {
   bool keep_alive = true;
   bool no_delay = true;
   bool reuse_address = true;
+  // let several acceptors bind the same endpoint, so the kernel balances connections between
+  // them. it is only supported on platforms which define SO_REUSEPORT
+  bool reuse_port = false;
   int max_connections = boost::asio::socket_base::max_listen_connections;
+  // split the stream of a tcp session into length-prefixed messages, so the data callback is
+  // called once per message and the replies of one read are written together
+  std::optional<w_framing_options> framing = std::nullopt;
+  // queue the replies and the pushed messages of each session, so a slow consumer is bounded by
+  // watermarks instead of stalling its session
+  std::optional<w_send_queue_options> send_queue = std::nullopt;
+  // register the send queue of each session by its id, so messages are broadcast to sessions.
+  // the sessions get a send queue with default options if send_queue is not set
+  std::shared_ptr<w_session_registry> registry = nullptr;
+  // receive the file descriptors which the peers of unix domain sockets pass with SCM_RIGHTS,
+  // the sessions receive with recvmsg instead of recv while it is set
+  w_session_on_fds_callback on_fds = nullptr;
+#ifdef WOLF_SYSTEM_HTTP_WS
+  // compress the messages of websockets with permessage-deflate
+  std::optional<w_ws_deflate_options> ws_deflate = std::nullopt;
+#endif
 
   void set_to_socket(_Inout_ boost::asio::ip::tcp::socket &p_socket) {
     // set acceptor's options
@@ -64,6 +149,14 @@ struct w_socket_options {
     const auto _reuse_address_option =
         boost::asio::socket_base::reuse_address(this->reuse_address);
     p_acceptor.set_option(_reuse_address_option);
+
+#ifdef SO_REUSEPORT
+    if (this->reuse_port) {
+      using reuse_port_option =
+          boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+      p_acceptor.set_option(reuse_port_option(true));
+    }
+#endif
   }
 };
 
@@ -77,6 +170,18 @@ typedef std::function<boost::beast::websocket::close_code(
     _In_ const std::string &p_conn_id, _Inout_ w_buffer &p_mut_data,
     _Inout_ bool &p_is_binary)>
     w_session_ws_on_data_callback;
+
+// the message is a read-only view of the received bytes, which is only valid until the
+// callback returns. a non-empty reply is sent back to the session
+typedef std::function<boost::beast::websocket::close_code(
+    _In_ const std::string &p_conn_id, _In_ gsl::span<const std::byte> p_message,
+    _Inout_ bool &p_is_binary, _Inout_ w_buffer &p_mut_reply)>
+    w_session_ws_on_message_callback;
+
+// the message is a read-only view of the received bytes, which is only valid until the
+// callback returns
+typedef std::function<void(_In_ gsl::span<const std::byte> p_message, _In_ bool p_is_binary)>
+    w_ws_on_message_callback;
 #endif
 
 typedef std::function<boost::system::errc::errc_t(
@@ -2,19 +2,31 @@
 
 #include "w_tcp_client.hpp"
 #include <chrono>
+#include <tuple>
 
 #include "DISABLE_ANALYSIS_BEGIN"
 #include <boost/asio/experimental/awaitable_operators.hpp>
 #include "DISABLE_ANALYSIS_END"
 
 using namespace boost::asio::experimental::awaitable_operators;
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+using w_framing_options = wolf::system::socket::w_framing_options;
 using w_tcp_client = wolf::system::socket::w_tcp_client;
 using tcp = boost::asio::ip::tcp;
 
+// the smallest buffer which is acquired for a receive, when the socket reports nothing pending
+constexpr auto TCP_MIN_RECEIVE_SIZE = size_t(256);
+
 w_tcp_client::w_tcp_client(boost::asio::io_context &p_io_context) noexcept
     : _resolver(std::make_unique<tcp::resolver>(p_io_context)),
       _socket(std::make_unique<tcp::socket>(p_io_context)) {}
 
+w_tcp_client::w_tcp_client(boost::asio::io_context &p_io_context,
+                           _In_ const w_framing_options &p_framing) noexcept
+    : _resolver(std::make_unique<tcp::resolver>(p_io_context)),
+      _socket(std::make_unique<tcp::socket>(p_io_context)), _decoder(p_framing),
+      _encoder(p_framing) {}
+
 w_tcp_client::~w_tcp_client() noexcept {
   try {
     const auto _resolver_nn =
@@ -73,17 +85,86 @@ boost::asio::awaitable<size_t>
 w_tcp_client::async_write(_In_ const w_buffer &p_buffer) {
   const gsl::not_null<tcp::socket *> _socket_nn(this->_socket.get());
 
-  return _socket_nn->async_send(
-      boost::asio::buffer(p_buffer.buf, p_buffer.used_bytes),
-      boost::asio::use_awaitable);
+  return boost::asio::async_write(*_socket_nn, p_buffer.get_const_buffer(),
+                                  boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<size_t>
+w_tcp_client::async_write(_In_ const w_buffer_sequence &p_buffers) {
+  const gsl::not_null<tcp::socket *> _socket_nn(this->_socket.get());
+
+  return boost::asio::async_write(*_socket_nn, p_buffers, boost::asio::use_awaitable);
 }
 
 boost::asio::awaitable<size_t>
 w_tcp_client::async_read(_Inout_ w_buffer &p_mut_buffer) {
   const gsl::not_null<tcp::socket *> _socket_nn(this->_socket.get());
 
-  return _socket_nn->async_receive(boost::asio::buffer(p_mut_buffer.buf),
-                                   boost::asio::use_awaitable);
+  co_await _socket_nn->async_wait(tcp::socket::wait_read, boost::asio::use_awaitable);
+
+  const auto _available = std::max(_socket_nn->available(), TCP_MIN_RECEIVE_SIZE);
+  auto _buffer_res = w_buffer_pool::get_default().acquire(_available);
+  if (!_buffer_res) {
+    throw boost::system::system_error(
+        make_error_code(boost::system::errc::not_enough_memory));
+  }
+  auto _buffer = std::move(_buffer_res.value());
+
+  const auto _bytes = co_await _socket_nn->async_receive(
+      boost::asio::mutable_buffer(_buffer.data(), _buffer.capacity()),
+      boost::asio::use_awaitable);
+  std::ignore = _buffer.resize(_bytes);
+
+  p_mut_buffer = std::move(_buffer);
+  co_return _bytes;
+}
+
+boost::leaf::result<int> w_tcp_client::queue_message(_In_ w_buffer p_message) noexcept {
+  return this->_encoder.push(std::move(p_message));
+}
+
+boost::asio::awaitable<size_t> w_tcp_client::async_flush() {
+  const gsl::not_null<tcp::socket *> _socket_nn(this->_socket.get());
+
+  if (this->_encoder.empty()) {
+    co_return 0;
+  }
+  // clear the queue even if the write fails, the stream is broken anyway
+  DEFER { this->_encoder.clear(); });
+  co_return co_await boost::asio::async_write(*_socket_nn, this->_encoder.get_buffers(),
+                                              boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<size_t> w_tcp_client::async_write_message(_In_ w_buffer p_message) {
+  if (!queue_message(std::move(p_message))) {
+    throw boost::system::system_error(make_error_code(boost::system::errc::message_size));
+  }
+  co_return co_await async_flush();
+}
+
+boost::asio::awaitable<size_t>
+w_tcp_client::async_read_message(_Inout_ w_buffer &p_mut_message) {
+  const gsl::not_null<tcp::socket *> _socket_nn(this->_socket.get());
+
+  for (;;) {
+    auto _message = this->_decoder.next();
+    if (!_message) {
+      throw boost::system::system_error(make_error_code(boost::system::errc::message_size));
+    }
+    if (_message.value().has_value()) {
+      p_mut_message = std::move(_message.value().value());
+      co_return p_mut_message.size();
+    }
+
+    auto _room = this->_decoder.prepare();
+    if (!_room) {
+      throw boost::system::system_error(
+          make_error_code(boost::system::errc::not_enough_memory));
+    }
+    const auto _bytes =
+        co_await _socket_nn->async_receive(_room.value(), boost::asio::use_awaitable);
+    this->_decoder.commit(_bytes);
+  }
 }
 
 bool w_tcp_client::get_is_open() const {
@@ -21,6 +21,10 @@ public:
   // default constructor
   W_API explicit w_tcp_client(boost::asio::io_context &p_io_context) noexcept;
 
+  // constructor with the framing options of messages
+  W_API w_tcp_client(boost::asio::io_context &p_io_context,
+                     _In_ const w_framing_options &p_framing) noexcept;
+
   // move constructor.
   W_API w_tcp_client(w_tcp_client &&p_other) = default;
   // move assignment operator.
@@ -70,13 +74,54 @@ public:
   boost::asio::awaitable<size_t> async_write(_In_ const w_buffer &p_buffer);
 
   /*
-   * read from the socket into the buffer
-   * @param p_mut_buffer, the destination buffer which will contain bytes
+   * gather a sequence of buffers and write them into the socket with a single call
+   * @param p_buffers, the source buffers which should be written
+   * @returns number of the written bytes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_write(_In_ const w_buffer_sequence &p_buffers);
+
+  /*
+   * read from the socket into a buffer of the default pool, which is sized by the
+   * pending bytes of socket, so a message is never truncated to a fixed size
+   * @param p_mut_buffer, the destination buffer which will be replaced by the read bytes
    * @returns number of read bytes
    */
   W_API
   boost::asio::awaitable<size_t> async_read(_Inout_ w_buffer &p_mut_buffer);
 
+  /*
+   * queue a length-prefixed message, the queued messages are sent by the next flush
+   * @param p_message, the message which is not copied
+   * @returns zero on success
+   */
+  W_API
+  boost::leaf::result<int> queue_message(_In_ w_buffer p_message) noexcept;
+
+  /*
+   * write all queued messages with a single gathered write
+   * @returns number of the written bytes, including the prefixes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_flush();
+
+  /*
+   * write a length-prefixed message together with the queued messages
+   * @param p_message, the message which is not copied
+   * @returns number of the written bytes, including the prefixes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_write_message(_In_ w_buffer p_message);
+
+  /*
+   * read the next length-prefixed message, the messages which arrived with one read are
+   * returned without reading the socket again
+   * @param p_mut_message, the destination which will be a view of the received bytes
+   * @returns the size of message
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_read_message(_Inout_ w_buffer &p_mut_message);
+
   /*
    * get whether socket is open
    * @returns true if socket was open
@@ -92,6 +137,8 @@ private:
 
   std::unique_ptr<boost::asio::ip::tcp::socket> _socket;
   std::unique_ptr<boost::asio::ip::tcp::resolver> _resolver;
+  w_frame_decoder _decoder;
+  w_frame_encoder _encoder;
 };
 } // namespace wolf::system::socket
 
@@ -1,7 +1,16 @@
 #ifdef WOLF_SYSTEM_SOCKET
 
 #include "w_tcp_server.hpp"
+#include "w_fd_passing.hpp"
+#include <mutex>
 #include <random>
+#include <thread>
+#include <tuple>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include "DISABLE_ANALYSIS_BEGIN"
 #ifdef WOLF_SYSTEM_SSL
@@ -10,59 +19,248 @@
 #include <boost/asio/experimental/awaitable_operators.hpp>
 #include "DISABLE_ANALYSIS_END"
 
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+using w_frame_decoder = wolf::system::socket::w_frame_decoder;
+using w_frame_encoder = wolf::system::socket::w_frame_encoder;
+using w_framing_options = wolf::system::socket::w_framing_options;
+using w_buffer_sequence = wolf::system::socket::w_buffer_sequence;
+using w_send_queue = wolf::system::socket::w_send_queue;
+using w_send_queue_message = wolf::system::socket::w_send_queue_message;
+using w_send_queue_options = wolf::system::socket::w_send_queue_options;
+using w_send_queue_status = wolf::system::socket::w_send_queue_status;
+using w_session_registry = wolf::system::socket::w_session_registry;
 using w_tcp_server = wolf::system::socket::w_tcp_server;
+using w_timing_wheel = wolf::system::socket::w_timing_wheel;
+using w_timing_wheel_entry = wolf::system::socket::w_timing_wheel_entry;
+using w_tcp_server_reactors = wolf::system::socket::w_tcp_server_reactors;
+using w_tcp_session_handler = wolf::system::socket::w_tcp_session_handler;
 using w_session_on_data_callback = wolf::system::socket::w_session_on_data_callback;
 using w_session_on_error_callback = wolf::system::socket::w_session_on_error_callback;
+using w_session_on_fds_callback = wolf::system::socket::w_session_on_fds_callback;
 using w_socket_options = wolf::system::socket::w_socket_options;
+using w_stream_socket = wolf::system::socket::w_stream_socket;
 using steady_clock = std::chrono::steady_clock;
-using steady_timer = boost::asio::steady_timer;
 using io_context = boost::asio::io_context;
 using tcp = boost::asio::ip::tcp;
-using time_point = std::chrono::steady_clock::time_point;
 using namespace boost::asio::experimental::awaitable_operators;
 
-static boost::asio::awaitable<std::errc>
-watchdog(_Inout_ const time_point &p_deadline) noexcept {
-  steady_timer _timer(co_await boost::asio::this_coro::executor);
-  auto _now = steady_clock::now();
+// the smallest buffer which is acquired for a receive, when the socket reports nothing pending
+constexpr auto TCP_MIN_RECEIVE_SIZE = size_t(256);
 
-#ifdef __clang__
-#pragma unroll
-#endif
-  while (p_deadline > _now) {
-    _timer.expires_at(p_deadline);
-    co_await _timer.async_wait(boost::asio::use_awaitable);
-    _now = steady_clock::now();
+// receive with recvmsg and hand the passed file descriptors of a unix domain socket to the callback
+static boost::asio::awaitable<size_t>
+s_receive_with_fds(_Inout_ w_stream_socket &p_socket, _In_ boost::asio::mutable_buffer p_buffer,
+                   _In_ const std::string &p_conn_id,
+                   _In_ const w_session_on_fds_callback &p_on_fds_callback) {
+#ifdef WIN32
+  co_return co_await p_socket.async_receive(p_buffer, boost::asio::use_awaitable);
+#else
+  std::vector<int> _fds;
+  const auto _bytes =
+      co_await wolf::system::socket::async_receive_with_fds(p_socket, p_buffer, _fds);
+  if (!_fds.empty()) {
+    p_on_fds_callback(p_conn_id, std::move(_fds));
   }
-  co_return std::errc::timed_out;
+  co_return _bytes;
+#endif
 }
 
 static boost::asio::awaitable<void> on_handle_session(
-    const boost::asio::io_context &p_io_context, tcp::socket &p_socket,
-    const std::string &p_conn_id, time_point &p_deadline,
-    steady_clock::duration p_timeout,
+    const boost::asio::io_context &p_io_context, w_stream_socket &p_socket,
+    const std::string &p_conn_id, w_timing_wheel_entry &p_idle,
+    steady_clock::duration p_timeout, std::shared_ptr<w_send_queue> p_queue,
+    const w_session_on_fds_callback p_on_fds_callback,
     const w_session_on_data_callback p_on_data_callback,
     const w_session_on_error_callback p_on_error_callback) noexcept {
-  w_buffer _buffer = {};
+  auto &_pool = w_buffer_pool::get_default();
 
 #ifdef __clang__
 #pragma unroll
 #endif
   while (!p_io_context.stopped()) {
-    p_deadline = steady_clock::now() + p_timeout;
+    p_idle.set_deadline(steady_clock::now() + p_timeout);
 
     try {
-      _buffer.used_bytes = co_await p_socket.async_receive(
-          boost::asio::buffer(_buffer.buf), boost::asio::use_awaitable);
+      // wait for incoming bytes, so the buffer is sized by what actually arrived
+      co_await p_socket.async_wait(w_stream_socket::wait_read, boost::asio::use_awaitable);
+
+      const auto _available = std::max(p_socket.available(), TCP_MIN_RECEIVE_SIZE);
+      auto _buffer_res = _pool.acquire(_available);
+      if (!_buffer_res) {
+        const auto _error = boost::system::system_error(
+            make_error_code(boost::system::errc::not_enough_memory));
+        p_on_error_callback(p_conn_id, _error);
+        break;
+      }
+      auto _buffer = std::move(_buffer_res.value());
+
+      // receive up to the capacity of the size class, the bytes are never copied
+      const auto _room = boost::asio::mutable_buffer(_buffer.data(), _buffer.capacity());
+      const auto _bytes =
+          p_on_fds_callback == nullptr
+              ? co_await p_socket.async_receive(_room, boost::asio::use_awaitable)
+              : co_await s_receive_with_fds(p_socket, _room, p_conn_id, p_on_fds_callback);
+      std::ignore = _buffer.resize(_bytes);
 
       // call callback
       const auto _res = p_on_data_callback(p_conn_id, _buffer);
       if (_res == boost::system::errc::connection_aborted) {
         break;
       }
-      co_await p_socket.async_send(
-          boost::asio::buffer(_buffer.buf, _buffer.used_bytes),
-          boost::asio::use_awaitable);
+      if (p_queue == nullptr) {
+        co_await boost::asio::async_write(p_socket, _buffer.get_const_buffer(),
+                                          boost::asio::use_awaitable);
+      } else if (!_buffer.empty()) {
+        // the writer sends it, reading stops while a slowed down queue is full
+        const auto _status = co_await p_queue->async_push(std::move(_buffer));
+        if (_status == w_send_queue_status::CLOSED) {
+          break;
+        }
+      }
+    } catch (const boost::system::system_error &p_ex) {
+      p_on_error_callback(p_conn_id, p_ex);
+      break;
+    }
+  }
+}
+
+static void s_on_session_error(_In_ const w_session_on_error_callback &p_on_error_callback,
+                               _In_ const std::string &p_conn_id,
+                               _In_ boost::system::errc::errc_t p_error) {
+  const auto _error = boost::system::system_error(make_error_code(p_error));
+  p_on_error_callback(p_conn_id, _error);
+}
+
+static boost::asio::awaitable<void> on_handle_framed_session(
+    const boost::asio::io_context &p_io_context, w_stream_socket &p_socket,
+    const std::string &p_conn_id, w_timing_wheel_entry &p_idle, steady_clock::duration p_timeout,
+    const w_framing_options p_framing, std::shared_ptr<w_send_queue> p_queue,
+    const w_session_on_fds_callback p_on_fds_callback,
+    const w_session_on_data_callback p_on_data_callback,
+    const w_session_on_error_callback p_on_error_callback) noexcept {
+  w_frame_decoder _decoder(p_framing);
+  w_frame_encoder _encoder(p_framing);
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  while (!p_io_context.stopped()) {
+    p_idle.set_deadline(steady_clock::now() + p_timeout);
+
+    try {
+      co_await p_socket.async_wait(w_stream_socket::wait_read, boost::asio::use_awaitable);
+
+      auto _room = _decoder.prepare(p_socket.available());
+      if (!_room) {
+        s_on_session_error(p_on_error_callback, p_conn_id,
+                           boost::system::errc::not_enough_memory);
+        break;
+      }
+      const auto _bytes =
+          p_on_fds_callback == nullptr
+              ? co_await p_socket.async_receive(_room.value(), boost::asio::use_awaitable)
+              : co_await s_receive_with_fds(p_socket, _room.value(), p_conn_id,
+                                            p_on_fds_callback);
+      _decoder.commit(_bytes);
+
+      // handle every complete message of this read, then write all replies at once
+      auto _close = false;
+      for (;;) {
+        auto _message = _decoder.next();
+        if (!_message) {
+          s_on_session_error(p_on_error_callback, p_conn_id,
+                             boost::system::errc::message_size);
+          _close = true;
+          break;
+        }
+        if (!_message.value().has_value()) {
+          break;
+        }
+
+        auto &_data = _message.value().value();
+        const auto _res = p_on_data_callback(p_conn_id, _data);
+        if (_res == boost::system::errc::connection_aborted) {
+          _close = true;
+          break;
+        }
+        if (p_queue != nullptr) {
+          // the writer prefixes the queued messages
+          const auto _status = co_await p_queue->async_push(std::move(_data));
+          if (_status == w_send_queue_status::CLOSED) {
+            _close = true;
+            break;
+          }
+          continue;
+        }
+        if (!_encoder.push(std::move(_data))) {
+          s_on_session_error(p_on_error_callback, p_conn_id,
+                             boost::system::errc::not_enough_memory);
+          _close = true;
+          break;
+        }
+      }
+
+      if (!_encoder.empty()) {
+        co_await boost::asio::async_write(p_socket, _encoder.get_buffers(),
+                                          boost::asio::use_awaitable);
+        _encoder.clear();
+      }
+      if (_close) {
+        break;
+      }
+    } catch (const boost::system::system_error &p_ex) {
+      p_on_error_callback(p_conn_id, p_ex);
+      break;
+    }
+  }
+}
+
+static boost::asio::awaitable<void> on_write_session(
+    w_stream_socket &p_socket, const std::string &p_conn_id,
+    const std::optional<w_framing_options> p_framing, w_send_queue &p_queue,
+    const w_session_on_error_callback p_on_error_callback) noexcept {
+  std::vector<w_send_queue_message> _messages;
+  w_buffer_sequence _buffers = {};
+  w_frame_encoder _encoder(p_framing.value_or(w_framing_options{}));
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (;;) {
+    try {
+      // take every queued message, so all of them are written at once
+      if (co_await p_queue.async_pop(_messages) == 0) {
+        if (p_queue.is_overflowed()) {
+          s_on_session_error(p_on_error_callback, p_conn_id,
+                             boost::system::errc::no_buffer_space);
+        }
+        break;
+      }
+
+      size_t _size = 0;
+      for (auto &_message : _messages) {
+        _size += _message.buffer.size();
+        if (p_framing.has_value()) {
+          if (!_encoder.push(std::move(_message.buffer))) {
+            s_on_session_error(p_on_error_callback, p_conn_id,
+                               boost::system::errc::message_size);
+            co_return;
+          }
+        } else {
+          _buffers.push_back(std::move(_message.buffer));
+        }
+      }
+      _messages.clear();
+
+      if (p_framing.has_value()) {
+        co_await boost::asio::async_write(p_socket, _encoder.get_buffers(),
+                                          boost::asio::use_awaitable);
+        _encoder.clear();
+      } else {
+        co_await boost::asio::async_write(p_socket, _buffers, boost::asio::use_awaitable);
+        _buffers.clear();
+      }
+      p_queue.consume(_size);
     } catch (const boost::system::system_error &p_ex) {
       p_on_error_callback(p_conn_id, p_ex);
       break;
@@ -71,19 +269,79 @@ static boost::asio::awaitable<void> on_handle_session(
 }
 
 static boost::asio::awaitable<void>
-s_session(const boost::asio::io_context &p_io_context, tcp::socket p_socket,
-          steady_clock::duration p_timeout,
-          w_session_on_data_callback p_on_data_callback,
-          w_session_on_error_callback p_on_error_callback) noexcept {
-
-  const auto _conn_id = wolf::system::socket::make_connection_id();
-
-  time_point _deadline = {};
-  const auto _ret = co_await (
-      on_handle_session(p_io_context, p_socket, _conn_id, _deadline, p_timeout,
-                        p_on_data_callback, p_on_error_callback) ||
-      watchdog(_deadline));
-  if (std::get<1>(_ret) == std::errc::timed_out) {
+s_with_send_queue(boost::asio::awaitable<void> p_handler, w_stream_socket &p_socket,
+                  const std::string &p_conn_id, std::optional<w_framing_options> p_framing,
+                  std::shared_ptr<w_send_queue> p_queue,
+                  w_session_on_error_callback p_on_error_callback) noexcept {
+  // the session ends once its reader or its writer ends
+  co_await (std::move(p_handler) ||
+            on_write_session(p_socket, p_conn_id, p_framing, *p_queue, p_on_error_callback));
+}
+
+boost::asio::awaitable<void> w_tcp_server::async_run_session(
+    _In_ const boost::asio::io_context &p_io_context, _In_ w_stream_socket p_socket,
+    _In_ std::chrono::steady_clock::duration p_timeout, _In_ w_socket_options p_socket_options,
+    _In_ std::shared_ptr<w_timing_wheel> p_wheel,
+    _In_ w_session_on_data_callback p_on_data_callback,
+    _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+  const auto &_framing = p_socket_options.framing;
+  auto &_send_queue = p_socket_options.send_queue;
+  const auto &_registry = p_socket_options.registry;
+
+  const auto _id = wolf::system::socket::make_session_id();
+  const auto _conn_id = std::to_string(_id);
+
+  // the registered sessions need a queue for the broadcast messages
+  if (!_send_queue.has_value() && _registry != nullptr) {
+    _send_queue = w_send_queue_options{};
+  }
+
+  std::shared_ptr<w_send_queue> _queue = nullptr;
+  if (_send_queue.has_value()) {
+    try {
+      _queue = std::make_shared<w_send_queue>(_send_queue.value());
+      if (_send_queue->on_open) {
+        _send_queue->on_open(_conn_id, _queue);
+      }
+    } catch (...) {
+      // on_open may have kept the queue, so its producers see the session as closed
+      if (_queue != nullptr) {
+        _queue->close();
+      }
+      s_on_session_error(p_on_error_callback, _conn_id, boost::system::errc::not_enough_memory);
+      co_return;
+    }
+    if (_registry != nullptr && _registry->add(_id, _queue).has_error()) {
+      _queue->close();
+      s_on_session_error(p_on_error_callback, _conn_id, boost::system::errc::not_enough_memory);
+      co_return;
+    }
+  }
+
+  // the wheel watches the idle deadline, which the reader refreshes
+  w_timing_wheel_entry _idle = {};
+  _idle.set_deadline(steady_clock::now() + p_timeout);
+  auto _reader = _framing.has_value()
+                     ? on_handle_framed_session(p_io_context, p_socket, _conn_id, _idle,
+                                                p_timeout, _framing.value(), _queue,
+                                                p_socket_options.on_fds, p_on_data_callback,
+                                                p_on_error_callback)
+                     : on_handle_session(p_io_context, p_socket, _conn_id, _idle,
+                                         p_timeout, _queue, p_socket_options.on_fds,
+                                         p_on_data_callback, p_on_error_callback);
+  auto _handler = _queue == nullptr
+                      ? std::move(_reader)
+                      : s_with_send_queue(std::move(_reader), p_socket, _conn_id, _framing,
+                                          _queue, p_on_error_callback);
+  const auto _ret = co_await (std::move(_handler) || p_wheel->async_wait(_idle));
+  // the producers which keep the queue see the session as closed
+  if (_queue != nullptr) {
+    _queue->close();
+  }
+  if (_registry != nullptr) {
+    _registry->remove(_id);
+  }
+  if (_ret.index() == 1 && std::get<1>(_ret) == std::errc::timed_out) {
     const auto _error = boost::system::system_error(
         make_error_code(boost::system::errc::timed_out));
     p_on_error_callback(_conn_id, _error);
@@ -93,43 +351,106 @@ s_session(const boost::asio::io_context &p_io_context, tcp::socket p_socket,
 }
 
 static boost::asio::awaitable<void> s_listen(
-    _In_ const boost::asio::io_context &p_io_context, _In_ tcp::endpoint &p_endpoint,
-    _In_ const steady_clock::duration &p_timeout, _In_ w_socket_options &p_socket_options,
-    _In_ w_session_on_data_callback p_on_data_callback,
-    _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+    _In_ const boost::asio::io_context &p_io_context, _In_ tcp::endpoint p_endpoint,
+    _In_ steady_clock::duration p_timeout, _In_ w_socket_options p_socket_options,
+    _In_ w_tcp_session_handler p_session_handler,
+    _In_ std::vector<boost::asio::any_io_executor> p_session_executors = {}) noexcept {
   // create acceptor from this coroutine
   auto _executor = co_await boost::asio::this_coro::executor;
-  tcp::acceptor _acceptor(_executor, p_endpoint);
+  tcp::acceptor _acceptor(_executor);
+  _acceptor.open(p_endpoint.protocol());
 
-  // set acceptor's options
+  // set acceptor's options, which must be done before binding
   p_socket_options.set_to_acceptor(_acceptor);
+  _acceptor.bind(p_endpoint);
 
   // start listening for connections
   _acceptor.listen(p_socket_options.max_connections);
 
+  if (p_session_executors.empty()) {
+    p_session_executors.push_back(_executor);
+  }
+
+  // one timing wheel per io context watches the idle timeouts of its sessions
+  std::vector<std::shared_ptr<w_timing_wheel>> _wheels;
+  for (const auto &_session_executor : p_session_executors) {
+    _wheels.push_back(w_timing_wheel::make_for_timeout(p_timeout));
+    _wheels.back()->run(_session_executor);
+  }
+
+  size_t _next_executor = 0;
+
 #ifdef __clang__
 #pragma unroll
 #endif
   while (!p_io_context.stopped()) {
-    tcp::socket _socket = co_await _acceptor.async_accept(boost::asio::use_awaitable);
+    // hand the sessions to the other io contexts in turn, if the kernel does not do it
+    const auto _index = _next_executor++ % p_session_executors.size();
+    const auto &_session_executor = p_session_executors[_index];
+
+    tcp::socket _socket =
+        co_await _acceptor.async_accept(_session_executor, boost::asio::use_awaitable);
     p_socket_options.set_to_socket(_socket);
 
     //auto _ssl_session = boost::asio::ssl::stream<tcp::socket>(std::move(_socket), _ssl_context);
 
     // spawn a coroutinue for handling session
-    co_spawn(_executor,
-             s_session(p_io_context, std::move(_socket), p_timeout, p_on_data_callback,
-                       p_on_error_callback),
+    co_spawn(_session_executor,
+             p_session_handler(p_io_context, std::move(_socket), _wheels[_index]),
              boost::asio::detached);
   }
 }
 
+static void s_pin_thread(_In_ std::thread &p_thread, _In_ size_t p_cpu) noexcept {
+#if defined(__linux__)
+  cpu_set_t _cpu_set;
+  CPU_ZERO(&_cpu_set);
+  CPU_SET(p_cpu, &_cpu_set);
+  std::ignore = pthread_setaffinity_np(p_thread.native_handle(), sizeof(_cpu_set), &_cpu_set);
+#elif defined(WIN32)
+  std::ignore = SetThreadAffinityMask(p_thread.native_handle(), DWORD_PTR(1) << p_cpu);
+#else
+  std::ignore = p_thread;
+  std::ignore = p_cpu;
+#endif
+}
+
+static w_tcp_session_handler
+s_make_session_handler(_In_ steady_clock::duration p_timeout,
+                       _In_ const w_socket_options &p_socket_options,
+                       _In_ w_session_on_data_callback p_on_data_callback,
+                       _In_ w_session_on_error_callback p_on_error_callback) {
+  return [=](_In_ const io_context &p_io_context, _In_ tcp::socket &&p_socket,
+             _In_ std::shared_ptr<w_timing_wheel> p_wheel) {
+    return w_tcp_server::async_run_session(p_io_context, w_stream_socket(std::move(p_socket)),
+                                           p_timeout, p_socket_options, std::move(p_wheel),
+                                           p_on_data_callback, p_on_error_callback);
+  };
+}
+
 boost::leaf::result<int> w_tcp_server::run(
     _In_ boost::asio::io_context &p_io_context, _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
     _In_ std::chrono::steady_clock::duration &&p_timeout, _In_ w_socket_options &&p_socket_options,
     _In_ w_session_on_data_callback p_on_data_callback,
     _In_ w_session_on_error_callback p_on_error_callback) noexcept {
   try {
+    // the handler copies the options and the callbacks
+    auto _handler = s_make_session_handler(p_timeout, p_socket_options, p_on_data_callback,
+                                           p_on_error_callback);
+    return run(p_io_context, std::move(p_endpoint), std::move(p_timeout),
+               std::move(p_socket_options), std::move(_handler));
+  } catch (_In_ const std::exception &p_ex) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "tcp server could not make its session handler : " +
+                         std::string(p_ex.what()));
+  }
+}
+
+boost::leaf::result<int> w_tcp_server::run(
+    _In_ boost::asio::io_context &p_io_context, _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
+    _In_ std::chrono::steady_clock::duration &&p_timeout, _In_ w_socket_options &&p_socket_options,
+    _In_ w_tcp_session_handler p_session_handler) noexcept {
+  try {
 #ifdef WOLF_SYSTEM_SSL
     // try create ssl context
     // auto _ssl = boost::asio::ssl::context(p_socket_options.tls_version);
@@ -141,7 +462,7 @@ boost::leaf::result<int> w_tcp_server::run(
     // server with coroutines
     boost::asio::co_spawn(p_io_context,
                           s_listen(p_io_context, p_endpoint, p_timeout, p_socket_options,
-                                   p_on_data_callback, p_on_error_callback),
+                                   std::move(p_session_handler)),
                           boost::asio::detached);
     return 0;
 
@@ -151,4 +472,110 @@ boost::leaf::result<int> w_tcp_server::run(
   }
 }
 
+boost::leaf::result<int> w_tcp_server::run(
+    _In_ const w_tcp_server_reactors &p_reactors, _In_ std::stop_token p_stop_token,
+    _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
+    _In_ std::chrono::steady_clock::duration &&p_timeout, _In_ w_socket_options &&p_socket_options,
+    _In_ w_session_on_data_callback p_on_data_callback,
+    _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+  try {
+    // the handler copies the options and the callbacks
+    auto _handler = s_make_session_handler(p_timeout, p_socket_options, p_on_data_callback,
+                                           p_on_error_callback);
+    return run(p_reactors, std::move(p_stop_token), std::move(p_endpoint),
+               std::move(p_timeout), std::move(p_socket_options), std::move(_handler));
+  } catch (_In_ const std::exception &p_ex) {
+    return W_FAILURE(std::errc::not_enough_memory,
+                     "tcp server could not make its session handler : " +
+                         std::string(p_ex.what()));
+  }
+}
+
+boost::leaf::result<int> w_tcp_server::run(
+    _In_ const w_tcp_server_reactors &p_reactors, _In_ std::stop_token p_stop_token,
+    _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
+    _In_ std::chrono::steady_clock::duration &&p_timeout, _In_ w_socket_options &&p_socket_options,
+    _In_ w_tcp_session_handler p_session_handler) noexcept {
+  const auto _cores = std::max(std::thread::hardware_concurrency(), 1U);
+  const auto _count = p_reactors.count != 0 ? p_reactors.count : size_t(_cores);
+
+#ifdef SO_REUSEPORT
+  // every io context accepts on its own socket of the same port
+  constexpr auto _sharded = true;
+  p_socket_options.reuse_port = true;
+#else
+  constexpr auto _sharded = false;
+#endif
+
+  try {
+    std::vector<std::unique_ptr<io_context>> _io_contexts;
+    std::vector<boost::asio::executor_work_guard<io_context::executor_type>> _work_guards;
+    std::vector<boost::asio::any_io_executor> _session_executors;
+    for (size_t i = 0; i < _count; ++i) {
+      // each io context is only run by one thread, so its internal locking is skipped
+      auto &_io = _io_contexts.emplace_back(
+          std::make_unique<io_context>(BOOST_ASIO_CONCURRENCY_HINT_UNSAFE_IO));
+      _work_guards.emplace_back(_io->get_executor());
+      if (!_sharded) {
+        _session_executors.emplace_back(_io->get_executor());
+      }
+    }
+
+    for (size_t i = 0; i < _count; ++i) {
+      if (!_sharded && i != 0) {
+        break;
+      }
+      boost::asio::co_spawn(*_io_contexts[i],
+                            s_listen(*_io_contexts[i], p_endpoint, p_timeout, p_socket_options,
+                                     p_session_handler, _session_executors),
+                            boost::asio::detached);
+    }
+
+    const auto _stop_callback = std::stop_callback(p_stop_token, [&]() noexcept {
+      for (auto &_io : _io_contexts) {
+        _io->stop();
+      }
+    });
+
+    std::mutex _error_mutex;
+    std::string _error;
+    {
+      std::vector<std::thread> _threads;
+      _threads.reserve(_count);
+      DEFER {
+        for (auto &_thread : _threads) {
+          _thread.join();
+        }
+      });
+
+      for (size_t i = 0; i < _count; ++i) {
+        _threads.emplace_back([&, i]() {
+          try {
+            _io_contexts[i]->run();
+          } catch (const std::exception &p_ex) {
+            const auto _lock = std::scoped_lock(_error_mutex);
+            _error = p_ex.what();
+            // a failed reactor takes the others down, so the caller does not wait forever
+            for (auto &_io : _io_contexts) {
+              _io->stop();
+            }
+          }
+        });
+        if (p_reactors.pin_threads) {
+          s_pin_thread(_threads.back(), i % _cores);
+        }
+      }
+    }
+
+    if (!_error.empty()) {
+      return W_FAILURE(std::errc::operation_canceled,
+                       "tcp server reactor caught an exception : " + _error);
+    }
+    return 0;
+  } catch (_In_ const std::exception &p_ex) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     "tcp server caught an exception : " + std::string(p_ex.what()));
+  }
+}
+
 #endif // WOLF_SYSTEM_SOCKET
@@ -7,9 +7,29 @@
 #pragma once
 
 #include "w_socket_options.hpp"
+#include "w_timing_wheel.hpp"
+#include <stop_token>
 #include <wolf/wolf.hpp>
 
 namespace wolf::system::socket {
+
+struct w_tcp_server_reactors {
+  // the number of io contexts, each one runs on its own thread, zero means the number of cores
+  size_t count = 0;
+  // pin the thread of each io context to a cpu core
+  bool pin_threads = true;
+};
+
+/*
+ * the handler of an accepted connection, the protocols which run on tcp share the accept loop
+ * and the options of w_tcp_server and bring their own sessions. the session should watch its
+ * idle timeout with the timing wheel of its io context
+ */
+typedef std::function<boost::asio::awaitable<void>(
+    _In_ const boost::asio::io_context &p_io_context, _In_ boost::asio::ip::tcp::socket &&p_socket,
+    _In_ std::shared_ptr<w_timing_wheel> p_wheel)>
+    w_tcp_session_handler;
+
 class w_tcp_server {
  public:
   /*
@@ -26,6 +46,78 @@ class w_tcp_server {
       _In_ std::chrono::steady_clock::duration &&p_timeout,
       _In_ w_socket_options &&p_socket_options, _In_ w_session_on_data_callback p_on_data_callback,
       _In_ w_session_on_error_callback p_on_error_callback) noexcept;
+
+  /*
+   * @param p_io_context, the boost io context
+   * @param p_endpoint, the endpoint of the server
+   * @param p_timeout, the timeout for connection, which sets the resolution of timing wheels
+   * @param p_socket_options, the socket options
+   * @param p_session_handler, the handler of accepted connections
+   * @returns void
+   */
+  W_API static boost::leaf::result<int> run(
+      _In_ boost::asio::io_context &p_io_context, _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
+      _In_ std::chrono::steady_clock::duration &&p_timeout,
+      _In_ w_socket_options &&p_socket_options,
+      _In_ w_tcp_session_handler p_session_handler) noexcept;
+
+  /*
+   * run the server on several io contexts and block until a stop is requested. each io
+   * context has its own SO_REUSEPORT acceptor and the kernel spreads the connections between
+   * them; where SO_REUSEPORT is not available, the first io context accepts and hands the
+   * sessions to the io contexts in turn. the callbacks are called from all threads.
+   * @param p_reactors, the options of io contexts
+   * @param p_stop_token, the token which stops the server
+   * @param p_endpoint, the endpoint of the server
+   * @param p_timeout, the timeout for connection
+   * @param p_socket_options, the socket options
+   * @param p_on_data_callback, on data callback for session
+   * @param p_on_error_callback, on error callback for session
+   * @returns zero after all io contexts were stopped
+   */
+  W_API static boost::leaf::result<int> run(
+      _In_ const w_tcp_server_reactors &p_reactors, _In_ std::stop_token p_stop_token,
+      _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
+      _In_ std::chrono::steady_clock::duration &&p_timeout,
+      _In_ w_socket_options &&p_socket_options, _In_ w_session_on_data_callback p_on_data_callback,
+      _In_ w_session_on_error_callback p_on_error_callback) noexcept;
+
+  /*
+   * run the server with a custom session on several io contexts and block until a stop is
+   * requested, the handler is called from all threads
+   * @param p_reactors, the options of io contexts
+   * @param p_stop_token, the token which stops the server
+   * @param p_endpoint, the endpoint of the server
+   * @param p_timeout, the timeout for connection, which sets the resolution of timing wheels
+   * @param p_socket_options, the socket options
+   * @param p_session_handler, the handler of accepted connections
+   * @returns zero after all io contexts were stopped
+   */
+  W_API static boost::leaf::result<int> run(
+      _In_ const w_tcp_server_reactors &p_reactors, _In_ std::stop_token p_stop_token,
+      _In_ boost::asio::ip::tcp::endpoint &&p_endpoint,
+      _In_ std::chrono::steady_clock::duration &&p_timeout,
+      _In_ w_socket_options &&p_socket_options,
+      _In_ w_tcp_session_handler p_session_handler) noexcept;
+
+  /*
+   * run the session of this server on a connected stream socket, so the servers of other
+   * stream sockets share the framing, send queues, registry and idle timeouts of tcp sessions
+   * @param p_io_context, the boost io context
+   * @param p_socket, the connected socket
+   * @param p_timeout, the idle timeout of session
+   * @param p_socket_options, the socket options
+   * @param p_wheel, the timing wheel of the io context of session
+   * @param p_on_data_callback, on data callback for session
+   * @param p_on_error_callback, on error callback for session
+   * @returns a coroutine which ends with the session
+   */
+  W_API static boost::asio::awaitable<void> async_run_session(
+      _In_ const boost::asio::io_context &p_io_context, _In_ w_stream_socket p_socket,
+      _In_ std::chrono::steady_clock::duration p_timeout, _In_ w_socket_options p_socket_options,
+      _In_ std::shared_ptr<w_timing_wheel> p_wheel,
+      _In_ w_session_on_data_callback p_on_data_callback,
+      _In_ w_session_on_error_callback p_on_error_callback) noexcept;
 };
 }  // namespace wolf::system::socket
 #endif // WOLF_SYSTEM_SOCKET
\ No newline at end of file
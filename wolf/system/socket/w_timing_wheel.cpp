@@ -0,0 +1,206 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_timing_wheel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+using w_timing_wheel = wolf::system::socket::w_timing_wheel;
+using w_timing_wheel_entry = wolf::system::socket::w_timing_wheel_entry;
+using w_timing_wheel_stats = wolf::system::socket::w_timing_wheel_stats;
+using steady_clock = std::chrono::steady_clock;
+using steady_timer = boost::asio::steady_timer;
+using time_point = std::chrono::steady_clock::time_point;
+
+// the number of ticks which an idle timeout is split into
+constexpr auto TIMING_WHEEL_TICKS_PER_TIMEOUT = 32;
+
+w_timing_wheel::w_timing_wheel(_In_ steady_clock::duration p_tick, _In_ size_t p_slots)
+    : _resolution(std::max(p_tick, steady_clock::duration(std::chrono::milliseconds(1)))),
+      _start(steady_clock::now()),
+      _slots(std::bit_ceil(std::max(p_slots, size_t(2))), nullptr) {}
+
+w_timing_wheel::~w_timing_wheel() noexcept = default;
+
+std::shared_ptr<w_timing_wheel>
+w_timing_wheel::make_for_timeout(_In_ steady_clock::duration p_timeout) {
+  const auto _tick = std::clamp(p_timeout / TIMING_WHEEL_TICKS_PER_TIMEOUT,
+                                steady_clock::duration(std::chrono::milliseconds(1)),
+                                steady_clock::duration(std::chrono::seconds(1)));
+  return std::make_shared<w_timing_wheel>(_tick);
+}
+
+uint64_t w_timing_wheel::_get_tick(_In_ time_point p_time) const noexcept {
+  if (p_time <= this->_start) {
+    return 0;
+  }
+  // round up, so an entry never expires before its deadline
+  const auto _elapsed = p_time - this->_start;
+  const auto _ticks = uint64_t(_elapsed / this->_resolution);
+  return _elapsed % this->_resolution == steady_clock::duration::zero() ? _ticks : _ticks + 1;
+}
+
+void w_timing_wheel::_link(_Inout_ w_timing_wheel_entry &p_entry) noexcept {
+  const auto _tick = std::max(_get_tick(p_entry.get_deadline()), this->_current + 1);
+  const auto _slot = size_t(_tick & (this->_slots.size() - 1));
+
+  auto *_head = this->_slots[_slot];
+  p_entry._prev = nullptr;
+  p_entry._next = _head;
+  if (_head != nullptr) {
+    _head->_prev = &p_entry;
+  }
+  this->_slots[_slot] = &p_entry;
+  p_entry._slot = _slot;
+  p_entry._linked = true;
+}
+
+void w_timing_wheel::_unlink(_Inout_ w_timing_wheel_entry &p_entry) noexcept {
+  if (!p_entry._linked) {
+    return;
+  }
+  if (p_entry._prev != nullptr) {
+    p_entry._prev->_next = p_entry._next;
+  } else {
+    this->_slots[p_entry._slot] = p_entry._next;
+  }
+  if (p_entry._next != nullptr) {
+    p_entry._next->_prev = p_entry._prev;
+  }
+  p_entry._prev = nullptr;
+  p_entry._next = nullptr;
+  p_entry._linked = false;
+}
+
+void w_timing_wheel::_add(_Inout_ w_timing_wheel_entry &p_entry) noexcept {
+  std::scoped_lock _lock(this->_lock);
+  p_entry._expired = false;
+  if (!p_entry._linked) {
+    _link(p_entry);
+  }
+}
+
+void w_timing_wheel::_remove(_Inout_ w_timing_wheel_entry &p_entry) noexcept {
+  std::scoped_lock _lock(this->_lock);
+  _unlink(p_entry);
+  --this->_stats.entries;
+}
+
+void w_timing_wheel::_tick(_In_ time_point p_now) noexcept {
+  std::scoped_lock _lock(this->_lock);
+
+  const auto _slots = uint64_t(this->_slots.size());
+  const auto _target = uint64_t((p_now - this->_start) / this->_resolution);
+  // a late tick visits every slot once at most
+  if (_target > this->_current + _slots) {
+    this->_current = _target - _slots;
+  }
+
+  while (this->_current < _target) {
+    ++this->_current;
+    const auto _slot = size_t(this->_current & (_slots - 1));
+
+    // detach the slot, so the entries which are linked to it again wait for the next turn
+    auto *_entry = this->_slots[_slot];
+    this->_slots[_slot] = nullptr;
+
+    while (_entry != nullptr) {
+      auto *_next = _entry->_next;
+      _entry->_prev = nullptr;
+      _entry->_next = nullptr;
+      _entry->_linked = false;
+      ++this->_stats.visits;
+
+      if (_get_tick(_entry->get_deadline()) <= this->_current) {
+        // wake the session on its own executor
+        _entry->_expired = true;
+        ++this->_stats.expirations;
+        boost::asio::post(_entry->_timer->get_executor(),
+                          [_timer = _entry->_timer]() { _timer->cancel(); });
+      } else {
+        // the deadline was refreshed, so the entry moves to the slot of its new deadline
+        _link(*_entry);
+      }
+      _entry = _next;
+    }
+  }
+}
+
+static boost::asio::awaitable<void> s_run(_In_ std::weak_ptr<w_timing_wheel> p_wheel,
+                                          _In_ steady_clock::duration p_tick,
+                                          _In_ std::function<void(time_point)> p_on_tick) {
+  steady_timer _timer(co_await boost::asio::this_coro::executor);
+  auto _next = steady_clock::now();
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (;;) {
+    // a late tick does not make a burst of ticks
+    _next = std::max(_next + p_tick, steady_clock::now());
+    _timer.expires_at(_next);
+
+    boost::system::error_code _error;
+    co_await _timer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, _error));
+    if (_error || p_wheel.expired()) {
+      co_return;
+    }
+    p_on_tick(steady_clock::now());
+  }
+}
+
+void w_timing_wheel::run(_In_ boost::asio::any_io_executor p_executor) {
+  auto _weak = weak_from_this();
+  boost::asio::co_spawn(
+      p_executor,
+      s_run(_weak, this->_resolution,
+            [_weak](_In_ time_point p_now) {
+              if (const auto _wheel = _weak.lock()) {
+                _wheel->_tick(p_now);
+              }
+            }),
+      boost::asio::detached);
+}
+
+boost::asio::awaitable<std::errc>
+w_timing_wheel::async_wait(_Inout_ w_timing_wheel_entry &p_entry) {
+  p_entry._timer =
+      std::make_shared<steady_timer>(co_await boost::asio::this_coro::executor, time_point::max());
+  {
+    std::scoped_lock _lock(this->_lock);
+    ++this->_stats.entries;
+  }
+  DEFER { _remove(p_entry); });
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (;;) {
+    if (p_entry.get_deadline() <= steady_clock::now()) {
+      co_return std::errc::timed_out;
+    }
+    _add(p_entry);
+
+    // the timer never expires, it is canceled by the wheel or by the caller
+    boost::system::error_code _error;
+    co_await p_entry._timer->async_wait(
+        boost::asio::redirect_error(boost::asio::use_awaitable, _error));
+
+    auto _expired = false;
+    {
+      std::scoped_lock _lock(this->_lock);
+      std::swap(_expired, p_entry._expired);
+    }
+    if (!_expired) {
+      co_return std::errc::operation_canceled;
+    }
+  }
+}
+
+w_timing_wheel_stats w_timing_wheel::get_stats() const noexcept {
+  std::scoped_lock _lock(this->_lock);
+  return this->_stats;
+}
+
+#endif // WOLF_SYSTEM_SOCKET
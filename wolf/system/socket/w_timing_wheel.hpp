@@ -0,0 +1,154 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+#include <wolf/wolf.hpp>
+
+#include "DISABLE_ANALYSIS_BEGIN"
+#include <boost/asio.hpp>
+#include "DISABLE_ANALYSIS_END"
+
+namespace wolf::system::socket {
+
+class w_timing_wheel;
+
+/*
+ * the idle deadline of a session, which is watched by a timing wheel. refreshing the deadline
+ * is a store, the wheel moves the entry to its new slot only when the old slot is reached
+ */
+class w_timing_wheel_entry {
+public:
+  // default constructor
+  W_API w_timing_wheel_entry() noexcept = default;
+
+  // destructor
+  W_API virtual ~w_timing_wheel_entry() noexcept = default;
+
+  /*
+   * set the deadline, which may be called from any thread
+   * @param p_deadline, the time which the session expires at
+   */
+  void set_deadline(_In_ std::chrono::steady_clock::time_point p_deadline) noexcept {
+    this->_deadline.store(p_deadline.time_since_epoch().count(), std::memory_order_relaxed);
+  }
+
+  // get the deadline
+  std::chrono::steady_clock::time_point get_deadline() const noexcept {
+    return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(
+        this->_deadline.load(std::memory_order_relaxed)));
+  }
+
+private:
+  friend class w_timing_wheel;
+
+  // copy constructor
+  w_timing_wheel_entry(const w_timing_wheel_entry &) = delete;
+  // copy operator
+  w_timing_wheel_entry &operator=(const w_timing_wheel_entry &) = delete;
+  // move constructor, the wheel links to the entry
+  w_timing_wheel_entry(w_timing_wheel_entry &&) = delete;
+  // move operator
+  w_timing_wheel_entry &operator=(w_timing_wheel_entry &&) = delete;
+
+  std::atomic<std::chrono::steady_clock::rep> _deadline =
+      std::chrono::steady_clock::time_point::max().time_since_epoch().count();
+
+  // the state below is guarded by the lock of wheel
+  std::shared_ptr<boost::asio::steady_timer> _timer = nullptr;
+  w_timing_wheel_entry *_prev = nullptr;
+  w_timing_wheel_entry *_next = nullptr;
+  size_t _slot = 0;
+  bool _linked = false;
+  bool _expired = false;
+};
+
+struct w_timing_wheel_stats {
+  // the number of entries which are watched
+  size_t entries = 0;
+  // the number of entries which were visited by the ticks
+  size_t visits = 0;
+  // the number of entries which expired
+  size_t expirations = 0;
+};
+
+/*
+ * a hashed timing wheel which watches the idle deadlines of many sessions with one timer.
+ * adding, refreshing and removing an entry is O(1), a tick only visits the entries of its slot
+ * and each entry is visited about once per timeout or once per turn of wheel. a session waits
+ * on its own timer which is never re-armed, the wheel wakes it once its deadline passed, so
+ * expirations are late by one tick at most
+ */
+class w_timing_wheel : public std::enable_shared_from_this<w_timing_wheel> {
+public:
+  /*
+   * constructor
+   * @param p_tick, the resolution of wheel
+   * @param p_slots, the number of slots, which is rounded up to a power of two
+   */
+  W_API explicit w_timing_wheel(
+      _In_ std::chrono::steady_clock::duration p_tick = std::chrono::milliseconds(100),
+      _In_ size_t p_slots = 512);
+
+  // destructor
+  W_API virtual ~w_timing_wheel() noexcept;
+
+  /*
+   * start ticking, the wheel ticks until it is destroyed or the context is stopped
+   * @param p_executor, the executor of ticks
+   */
+  W_API void run(_In_ boost::asio::any_io_executor p_executor);
+
+  /*
+   * watch an entry until its deadline passes or the wait is canceled. the deadline of entry
+   * should be set before and refreshed by the session
+   * @param p_entry, the entry which lives until the wait ends
+   * @returns timed_out once the deadline passed, or operation_canceled
+   */
+  W_API boost::asio::awaitable<std::errc> async_wait(_Inout_ w_timing_wheel_entry &p_entry);
+
+  /*
+   * make a wheel whose resolution fits a timeout
+   * @param p_timeout, the idle timeout of sessions
+   * @returns the wheel
+   */
+  W_API static std::shared_ptr<w_timing_wheel>
+  make_for_timeout(_In_ std::chrono::steady_clock::duration p_timeout);
+
+  // get the statistics
+  W_API w_timing_wheel_stats get_stats() const noexcept;
+
+private:
+  // copy constructor
+  w_timing_wheel(const w_timing_wheel &) = delete;
+  // copy operator
+  w_timing_wheel &operator=(const w_timing_wheel &) = delete;
+
+  void _add(_Inout_ w_timing_wheel_entry &p_entry) noexcept;
+  void _remove(_Inout_ w_timing_wheel_entry &p_entry) noexcept;
+  void _link(_Inout_ w_timing_wheel_entry &p_entry) noexcept;
+  void _unlink(_Inout_ w_timing_wheel_entry &p_entry) noexcept;
+  void _tick(_In_ std::chrono::steady_clock::time_point p_now) noexcept;
+  uint64_t _get_tick(_In_ std::chrono::steady_clock::time_point p_time) const noexcept;
+
+  const std::chrono::steady_clock::duration _resolution;
+  const std::chrono::steady_clock::time_point _start;
+  mutable std::mutex _lock;
+  std::vector<w_timing_wheel_entry *> _slots;
+  // the last tick which was processed
+  uint64_t _current = 0;
+  w_timing_wheel_stats _stats = {};
+};
+} // namespace wolf::system::socket
+
+#endif // WOLF_SYSTEM_SOCKET
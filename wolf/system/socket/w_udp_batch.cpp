@@ -0,0 +1,313 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_udp_batch.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+
+// the offloads are missing from the headers of old C libraries
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
+using w_buffer = wolf::system::socket::w_buffer;
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+using w_udp_batch = wolf::system::socket::w_udp_batch;
+using w_udp_datagram = wolf::system::socket::w_udp_datagram;
+using w_udp_options = wolf::system::socket::w_udp_options;
+using udp = boost::asio::ip::udp;
+
+// the largest payload of an ipv4 datagram, which also limits a coalesced or segmented buffer
+constexpr auto UDP_MAX_PAYLOAD_SIZE = size_t(65507);
+// the number of segments which every kernel with GSO accepts in one buffer
+constexpr auto UDP_MAX_SEGMENTS = size_t(64);
+
+#ifdef __linux__
+// only the system calls of linux report their errors with errno
+static boost::system::system_error s_last_error() {
+  return boost::system::system_error(
+      boost::system::error_code(errno, boost::system::system_category()));
+}
+#endif
+
+boost::leaf::result<int> w_udp_batch::init(_Inout_ udp::socket &p_socket,
+                                           _In_ const w_udp_options &p_options) noexcept {
+  this->_options = p_options;
+  this->_options.batch_size = std::max(p_options.batch_size, size_t(1));
+  this->_gso = false;
+  this->_gro = false;
+
+  try {
+    p_socket.set_option(boost::asio::socket_base::reuse_address(p_options.reuse_address));
+#ifdef SO_REUSEPORT
+    if (p_options.reuse_port) {
+      using reuse_port_option =
+          boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+      p_socket.set_option(reuse_port_option(true));
+    }
+#endif
+    if (p_options.receive_buffer_size > 0) {
+      p_socket.set_option(
+          boost::asio::socket_base::receive_buffer_size(p_options.receive_buffer_size));
+    }
+    if (p_options.send_buffer_size > 0) {
+      p_socket.set_option(
+          boost::asio::socket_base::send_buffer_size(p_options.send_buffer_size));
+    }
+    // the batches are received and sent until the socket would block
+    p_socket.non_blocking(true);
+  } catch (const boost::system::system_error &p_ex) {
+    return W_FAILURE(std::errc::invalid_argument,
+                     "could not set the options of udp socket because " +
+                         std::string(p_ex.what()));
+  }
+
+#ifdef __linux__
+  const auto _fd = p_socket.native_handle();
+  if (p_options.gso) {
+    // the option is readable only if the kernel supports segmentation
+    int _size = 0;
+    socklen_t _length = sizeof(_size);
+    this->_gso = ::getsockopt(_fd, SOL_UDP, UDP_SEGMENT, &_size, &_length) == 0;
+  }
+  if (p_options.gro) {
+    const int _enable = 1;
+    this->_gro = ::setsockopt(_fd, SOL_UDP, UDP_GRO, &_enable, sizeof(_enable)) == 0;
+  }
+#endif
+
+  return 0;
+}
+
+boost::asio::awaitable<size_t>
+w_udp_batch::async_receive(_Inout_ udp::socket &p_socket,
+                           _Inout_ std::vector<w_udp_datagram> &p_datagrams) {
+#ifdef __linux__
+  const auto _batch = this->_options.batch_size;
+  // a coalesced buffer of GRO may be as large as a whole datagram of ipv4
+  const auto _slot = this->_gro ? UDP_MAX_PAYLOAD_SIZE : this->_options.max_datagram_size;
+  const auto _control_size = size_t(CMSG_SPACE(sizeof(int)));
+
+  this->_receive_headers.resize(_batch);
+  this->_receive_iovecs.resize(_batch);
+  this->_receive_addresses.resize(_batch);
+  this->_receive_controls.resize(_batch * _control_size);
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  for (;;) {
+    // the block of previous batch is kept while its datagrams are referenced
+    if (this->_block.use_count() != 1 || this->_block.size() < _batch * _slot) {
+      auto _block = w_buffer_pool::get_default().acquire(_batch * _slot);
+      if (!_block) {
+        throw boost::system::system_error(
+            make_error_code(boost::system::errc::not_enough_memory));
+      }
+      this->_block = std::move(_block.value());
+    }
+
+    for (size_t i = 0; i < _batch; ++i) {
+      this->_receive_iovecs[i] = {this->_block.data() + i * _slot, _slot};
+
+      auto &_header = this->_receive_headers[i];
+      _header = {};
+      _header.msg_hdr.msg_name = &this->_receive_addresses[i];
+      _header.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+      _header.msg_hdr.msg_iov = &this->_receive_iovecs[i];
+      _header.msg_hdr.msg_iovlen = 1;
+      if (this->_gro) {
+        _header.msg_hdr.msg_control = this->_receive_controls.data() + i * _control_size;
+        _header.msg_hdr.msg_controllen = _control_size;
+      }
+    }
+
+    const auto _count = ::recvmmsg(p_socket.native_handle(), this->_receive_headers.data(),
+                                   gsl::narrow_cast<unsigned int>(_batch), MSG_DONTWAIT,
+                                   nullptr);
+    if (_count < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        throw s_last_error();
+      }
+      co_await p_socket.async_wait(udp::socket::wait_read, boost::asio::use_awaitable);
+      continue;
+    }
+
+    size_t _received = 0;
+    for (size_t i = 0; i < gsl::narrow_cast<size_t>(_count); ++i) {
+      const auto &_header = this->_receive_headers[i].msg_hdr;
+      // a datagram which did not fit the slot is dropped
+      if ((_header.msg_flags & MSG_TRUNC) != 0) {
+        continue;
+      }
+
+      auto _endpoint = udp::endpoint();
+      const auto _address_size =
+          std::min(size_t(_header.msg_namelen), size_t(_endpoint.capacity()));
+      std::memcpy(_endpoint.data(), _header.msg_name, _address_size);
+      _endpoint.resize(_address_size);
+
+      // a coalesced buffer carries the size of its datagrams, only the last one may be shorter
+      const auto _size = size_t(this->_receive_headers[i].msg_len);
+      auto _segment = _size;
+      for (auto *_cmsg = CMSG_FIRSTHDR(&_header); _cmsg != nullptr;
+           _cmsg = CMSG_NXTHDR(const_cast<msghdr *>(&_header), _cmsg)) {
+        if (_cmsg->cmsg_level == SOL_UDP && _cmsg->cmsg_type == UDP_GRO) {
+          int _gro_size = 0;
+          std::memcpy(&_gro_size, CMSG_DATA(_cmsg), sizeof(_gro_size));
+          _segment = _gro_size > 0 ? size_t(_gro_size) : _size;
+        }
+      }
+
+      size_t _offset = 0;
+      do {
+        const auto _length = std::min(_segment, _size - _offset);
+        p_datagrams.push_back({_endpoint, this->_block.slice(i * _slot + _offset, _length)});
+        _offset += _length;
+        ++_received;
+      } while (_offset < _size);
+    }
+
+    if (_received != 0) {
+      co_return _received;
+    }
+  }
+#else
+  auto _buffer = w_buffer_pool::get_default().acquire(this->_options.max_datagram_size);
+  if (!_buffer) {
+    throw boost::system::system_error(make_error_code(boost::system::errc::not_enough_memory));
+  }
+
+  auto _endpoint = udp::endpoint();
+  const auto _size = co_await p_socket.async_receive_from(
+      boost::asio::mutable_buffer(_buffer.value().data(), _buffer.value().size()), _endpoint,
+      boost::asio::use_awaitable);
+  std::ignore = _buffer.value().resize(_size);
+  p_datagrams.push_back({_endpoint, std::move(_buffer.value())});
+
+  co_return 1;
+#endif
+}
+
+boost::asio::awaitable<size_t>
+w_udp_batch::async_send(_Inout_ udp::socket &p_socket,
+                        _In_ const std::vector<w_udp_datagram> &p_datagrams) {
+  const auto _datagrams = p_datagrams.size();
+  if (_datagrams == 0) {
+    co_return 0;
+  }
+
+#ifdef __linux__
+  const auto _control_size = size_t(CMSG_SPACE(sizeof(uint16_t)));
+
+  this->_send_headers.clear();
+  this->_send_iovecs.resize(_datagrams);
+  this->_send_controls.assign(_datagrams * _control_size, std::byte(0));
+
+  for (size_t i = 0; i < _datagrams;) {
+    const auto &_first = p_datagrams[i];
+    const auto _segment = _first.buffer.size();
+
+    // the following datagrams of the same destination become segments of one buffer
+    auto _end = i + 1;
+    if (this->_gso && _segment != 0) {
+      auto _total = _segment;
+      while (_end < _datagrams && _end - i < UDP_MAX_SEGMENTS &&
+             p_datagrams[_end].endpoint == _first.endpoint) {
+        const auto _size = p_datagrams[_end].buffer.size();
+        if (_size == 0 || _size > _segment || _total + _size > UDP_MAX_PAYLOAD_SIZE) {
+          break;
+        }
+        _total += _size;
+        ++_end;
+        if (_size < _segment) {
+          break;
+        }
+      }
+    }
+
+    for (auto j = i; j < _end; ++j) {
+      this->_send_iovecs[j] = {p_datagrams[j].buffer.data(), p_datagrams[j].buffer.size()};
+    }
+
+    mmsghdr _header = {};
+    if (_first.endpoint != udp::endpoint()) {
+      _header.msg_hdr.msg_name = const_cast<sockaddr *>(_first.endpoint.data());
+      _header.msg_hdr.msg_namelen = gsl::narrow_cast<socklen_t>(_first.endpoint.size());
+    }
+    _header.msg_hdr.msg_iov = &this->_send_iovecs[i];
+    _header.msg_hdr.msg_iovlen = _end - i;
+
+    if (_end - i > 1) {
+      _header.msg_hdr.msg_control =
+          this->_send_controls.data() + this->_send_headers.size() * _control_size;
+      _header.msg_hdr.msg_controllen = _control_size;
+
+      auto *_cmsg = CMSG_FIRSTHDR(&_header.msg_hdr);
+      _cmsg->cmsg_level = SOL_UDP;
+      _cmsg->cmsg_type = UDP_SEGMENT;
+      _cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      const auto _segment_size = gsl::narrow_cast<uint16_t>(_segment);
+      std::memcpy(CMSG_DATA(_cmsg), &_segment_size, sizeof(_segment_size));
+    }
+    this->_send_headers.push_back(_header);
+    i = _end;
+  }
+
+  size_t _offset = 0;
+  size_t _sent = 0;
+#ifdef __clang__
+#pragma unroll
+#endif
+  while (_offset < this->_send_headers.size()) {
+    const auto _count = ::sendmmsg(
+        p_socket.native_handle(), this->_send_headers.data() + _offset,
+        gsl::narrow_cast<unsigned int>(this->_send_headers.size() - _offset), MSG_DONTWAIT);
+    if (_count < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        co_await p_socket.async_wait(udp::socket::wait_write, boost::asio::use_awaitable);
+        continue;
+      }
+      if (errno == EIO && this->_gso) {
+        // the device can not offload the checksums of segments, so the rest of this batch is
+        // dropped like a lost datagram and the next batches are not segmented
+        this->_gso = false;
+        break;
+      }
+      throw s_last_error();
+    }
+
+    for (auto i = _offset; i < _offset + size_t(_count); ++i) {
+      _sent += this->_send_headers[i].msg_hdr.msg_iovlen;
+    }
+    _offset += size_t(_count);
+  }
+
+  co_return _sent;
+#else
+  for (const auto &_datagram : p_datagrams) {
+    if (_datagram.endpoint == udp::endpoint()) {
+      co_await p_socket.async_send(_datagram.buffer.get_const_buffer(),
+                                   boost::asio::use_awaitable);
+    } else {
+      co_await p_socket.async_send_to(_datagram.buffer.get_const_buffer(), _datagram.endpoint,
+                                      boost::asio::use_awaitable);
+    }
+  }
+  co_return _datagrams;
+#endif
+}
+
+#endif // WOLF_SYSTEM_SOCKET
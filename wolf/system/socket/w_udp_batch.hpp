@@ -0,0 +1,135 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_buffer.hpp"
+#include <functional>
+#include <vector>
+#include <wolf/wolf.hpp>
+
+#include "DISABLE_ANALYSIS_BEGIN"
+#include <boost/asio.hpp>
+#include "DISABLE_ANALYSIS_END"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
+namespace wolf::system::socket {
+
+struct w_udp_options {
+  bool reuse_address = true;
+  // let several sockets bind the same endpoint, so the kernel balances datagrams between them
+  bool reuse_port = false;
+  // the size of the receive and send buffers of kernel, zero keeps the default of system
+  int receive_buffer_size = 0;
+  int send_buffer_size = 0;
+  // the number of datagrams which are received or sent by one system call on linux
+  size_t batch_size = 32;
+  // the largest datagram which is received, a larger one is dropped
+  size_t max_datagram_size = 2048;
+  // let the kernel split a large send into equal datagrams (UDP_SEGMENT), linux 4.18+
+  bool gso = true;
+  // let the kernel coalesce the received datagrams of a flow (UDP_GRO), linux 5.0+
+  bool gro = false;
+};
+
+struct w_udp_datagram {
+  // the source of a received datagram or the destination of a sent one, an empty endpoint
+  // sends to the connected peer
+  boost::asio::ip::udp::endpoint endpoint = {};
+  w_buffer buffer = {};
+};
+
+typedef std::function<boost::system::errc::errc_t(
+    _In_ const boost::asio::ip::udp::endpoint &p_endpoint, _Inout_ w_buffer &p_mut_data)>
+    w_udp_on_data_callback;
+
+typedef std::function<void(_In_ const boost::system::system_error &p_error)>
+    w_udp_on_error_callback;
+
+/*
+ * receives and sends datagrams in batches. on linux a batch costs one recvmmsg or sendmmsg,
+ * equal datagrams of a destination are sent as one segmented buffer when GSO is supported
+ * and coalesced datagrams are split when GRO is enabled. other platforms fall back to one
+ * system call per datagram
+ */
+class w_udp_batch {
+public:
+  // default constructor
+  W_API w_udp_batch() noexcept = default;
+
+  // move constructor.
+  W_API w_udp_batch(w_udp_batch &&p_other) noexcept = default;
+  // move assignment operator.
+  W_API w_udp_batch &operator=(w_udp_batch &&p_other) noexcept = default;
+
+  // destructor
+  W_API virtual ~w_udp_batch() noexcept = default;
+
+  /*
+   * set the options to an open socket and probe the offloads of kernel
+   * @param p_socket, the socket
+   * @param p_options, the udp options
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> init(_Inout_ boost::asio::ip::udp::socket &p_socket,
+                                      _In_ const w_udp_options &p_options) noexcept;
+
+  /*
+   * wait for datagrams and receive a batch of them, the datagrams are views of one pooled
+   * block without copying
+   * @param p_socket, the socket
+   * @param p_datagrams, the received datagrams which are appended
+   * @returns the number of received datagrams
+   */
+  W_API boost::asio::awaitable<size_t>
+  async_receive(_Inout_ boost::asio::ip::udp::socket &p_socket,
+                _Inout_ std::vector<w_udp_datagram> &p_datagrams);
+
+  /*
+   * send datagrams with as few system calls as possible
+   * @param p_socket, the socket
+   * @param p_datagrams, the datagrams
+   * @returns the number of sent datagrams
+   */
+  W_API boost::asio::awaitable<size_t>
+  async_send(_Inout_ boost::asio::ip::udp::socket &p_socket,
+             _In_ const std::vector<w_udp_datagram> &p_datagrams);
+
+  // get whether the kernel segments the sent buffers
+  bool get_gso() const noexcept { return this->_gso; }
+
+  // get whether the kernel coalesces the received datagrams
+  bool get_gro() const noexcept { return this->_gro; }
+
+private:
+  // copy constructor
+  w_udp_batch(const w_udp_batch &) = delete;
+  // copy operator
+  w_udp_batch &operator=(const w_udp_batch &) = delete;
+
+  w_udp_options _options = {};
+  bool _gso = false;
+  bool _gro = false;
+  // the block which the datagrams of a batch are received into
+  w_buffer _block = {};
+#ifdef __linux__
+  // the storage of system calls, receives and sends may run at the same time
+  std::vector<mmsghdr> _receive_headers;
+  std::vector<iovec> _receive_iovecs;
+  std::vector<sockaddr_storage> _receive_addresses;
+  std::vector<std::byte> _receive_controls;
+  std::vector<mmsghdr> _send_headers;
+  std::vector<iovec> _send_iovecs;
+  std::vector<std::byte> _send_controls;
+#endif
+};
+} // namespace wolf::system::socket
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -0,0 +1,86 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_udp_client.hpp"
+#include <iterator>
+
+using w_buffer = wolf::system::socket::w_buffer;
+using w_udp_client = wolf::system::socket::w_udp_client;
+using w_udp_datagram = wolf::system::socket::w_udp_datagram;
+using w_udp_options = wolf::system::socket::w_udp_options;
+using udp = boost::asio::ip::udp;
+
+w_udp_client::w_udp_client(boost::asio::io_context &p_io_context) noexcept
+    : _socket(std::make_unique<udp::socket>(p_io_context)) {}
+
+w_udp_client::~w_udp_client() noexcept {
+  try {
+    if (this->_socket != nullptr && this->_socket->is_open()) {
+      this->_socket->close();
+    }
+  } catch (...) {
+  }
+}
+
+boost::leaf::result<int> w_udp_client::connect(_In_ const udp::endpoint &p_endpoint,
+                                               _In_ const w_udp_options &p_options) noexcept {
+  const gsl::not_null<udp::socket *> _socket_nn(this->_socket.get());
+
+  try {
+    _socket_nn->open(p_endpoint.protocol());
+    BOOST_LEAF_CHECK(this->_batch.init(*_socket_nn, p_options));
+    _socket_nn->connect(p_endpoint);
+  } catch (const boost::system::system_error &p_ex) {
+    return W_FAILURE(std::errc::connection_refused,
+                     "could not connect the udp socket because " + std::string(p_ex.what()));
+  }
+
+  this->_received.clear();
+  this->_next = 0;
+  return 0;
+}
+
+boost::asio::awaitable<size_t> w_udp_client::async_write(_In_ const w_buffer &p_buffer) {
+  const gsl::not_null<udp::socket *> _socket_nn(this->_socket.get());
+  return _socket_nn->async_send(p_buffer.get_const_buffer(), boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<size_t>
+w_udp_client::async_write(_In_ const std::vector<w_udp_datagram> &p_datagrams) {
+  const gsl::not_null<udp::socket *> _socket_nn(this->_socket.get());
+  co_return co_await this->_batch.async_send(*_socket_nn, p_datagrams);
+}
+
+boost::asio::awaitable<size_t> w_udp_client::async_read(_Inout_ w_buffer &p_mut_buffer) {
+  const gsl::not_null<udp::socket *> _socket_nn(this->_socket.get());
+
+  if (this->_next == this->_received.size()) {
+    this->_received.clear();
+    this->_next = 0;
+    co_await this->_batch.async_receive(*_socket_nn, this->_received);
+  }
+
+  p_mut_buffer = std::move(this->_received[this->_next++].buffer);
+  co_return p_mut_buffer.size();
+}
+
+boost::asio::awaitable<size_t>
+w_udp_client::async_read(_Inout_ std::vector<w_udp_datagram> &p_datagrams) {
+  const gsl::not_null<udp::socket *> _socket_nn(this->_socket.get());
+
+  // the datagrams which are left from a previous read come first
+  if (this->_next != this->_received.size()) {
+    const auto _count = this->_received.size() - this->_next;
+    std::move(this->_received.begin() + gsl::narrow_cast<std::ptrdiff_t>(this->_next),
+              this->_received.end(), std::back_inserter(p_datagrams));
+    this->_received.clear();
+    this->_next = 0;
+    co_return _count;
+  }
+  co_return co_await this->_batch.async_receive(*_socket_nn, p_datagrams);
+}
+
+bool w_udp_client::get_is_open() const {
+  return this->_socket != nullptr && this->_socket->is_open();
+}
+
+#endif // WOLF_SYSTEM_SOCKET
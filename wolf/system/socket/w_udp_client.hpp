@@ -0,0 +1,94 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_udp_batch.hpp"
+#include <wolf/wolf.hpp>
+
+namespace wolf::system::socket {
+class w_udp_client {
+public:
+  // default constructor
+  W_API explicit w_udp_client(boost::asio::io_context &p_io_context) noexcept;
+
+  // move constructor.
+  W_API w_udp_client(w_udp_client &&p_other) = default;
+  // move assignment operator.
+  W_API w_udp_client &operator=(w_udp_client &&p_other) = default;
+
+  // destructor
+  W_API virtual ~w_udp_client() noexcept;
+
+  /*
+   * open a socket and connect it to the endpoint, so the datagrams without an endpoint are
+   * sent to it and only its datagrams are received
+   * @param p_endpoint, the endpoint of the server
+   * @param p_options, the udp options
+   * @returns zero on success
+   */
+  W_API boost::leaf::result<int> connect(_In_ const boost::asio::ip::udp::endpoint &p_endpoint,
+                                         _In_ const w_udp_options &p_options) noexcept;
+
+  /*
+   * send a datagram to the connected endpoint
+   * @param p_buffer, the datagram
+   * @returns number of the sent bytes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_write(_In_ const w_buffer &p_buffer);
+
+  /*
+   * send datagrams in batches, equal datagrams of an endpoint are segmented by the kernel
+   * @param p_datagrams, the datagrams, an empty endpoint means the connected endpoint
+   * @returns number of the sent datagrams
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_write(_In_ const std::vector<w_udp_datagram> &p_datagrams);
+
+  /*
+   * read a datagram, the datagrams which arrived with one batch are returned without reading
+   * the socket again
+   * @param p_mut_buffer, the destination which will be a view of the received bytes
+   * @returns the size of datagram
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_read(_Inout_ w_buffer &p_mut_buffer);
+
+  /*
+   * read a batch of datagrams
+   * @param p_datagrams, the received datagrams which are appended
+   * @returns number of the received datagrams
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_read(_Inout_ std::vector<w_udp_datagram> &p_datagrams);
+
+  /*
+   * get whether socket is open
+   * @returns true if socket was open
+   */
+  W_API
+  bool get_is_open() const;
+
+  // get the batching of the socket
+  const w_udp_batch &get_batch() const noexcept { return this->_batch; }
+
+private:
+  // copy constructor
+  w_udp_client(const w_udp_client &) = delete;
+  // copy operator
+  w_udp_client &operator=(const w_udp_client &) = delete;
+
+  std::unique_ptr<boost::asio::ip::udp::socket> _socket;
+  w_udp_batch _batch = {};
+  // the received datagrams which were not read yet
+  std::vector<w_udp_datagram> _received;
+  size_t _next = 0;
+};
+} // namespace wolf::system::socket
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -0,0 +1,77 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_udp_server.hpp"
+
+using w_udp_batch = wolf::system::socket::w_udp_batch;
+using w_udp_datagram = wolf::system::socket::w_udp_datagram;
+using w_udp_on_data_callback = wolf::system::socket::w_udp_on_data_callback;
+using w_udp_on_error_callback = wolf::system::socket::w_udp_on_error_callback;
+using w_udp_options = wolf::system::socket::w_udp_options;
+using w_udp_server = wolf::system::socket::w_udp_server;
+using udp = boost::asio::ip::udp;
+
+static boost::asio::awaitable<void>
+s_serve(_In_ const boost::asio::io_context &p_io_context, _In_ udp::socket p_socket,
+        _In_ w_udp_batch p_batch, _In_ w_udp_on_data_callback p_on_data_callback,
+        _In_ w_udp_on_error_callback p_on_error_callback) noexcept {
+  std::vector<w_udp_datagram> _datagrams;
+  std::vector<w_udp_datagram> _replies;
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  while (!p_io_context.stopped()) {
+    try {
+      co_await p_batch.async_receive(p_socket, _datagrams);
+
+      for (auto &_datagram : _datagrams) {
+        const auto _res = p_on_data_callback(_datagram.endpoint, _datagram.buffer);
+        if (_res == boost::system::errc::success && !_datagram.buffer.empty()) {
+          _replies.push_back(std::move(_datagram));
+        }
+      }
+      _datagrams.clear();
+
+      co_await p_batch.async_send(p_socket, _replies);
+      _replies.clear();
+    } catch (const boost::system::system_error &p_ex) {
+      _datagrams.clear();
+      _replies.clear();
+      if (p_ex.code() == boost::asio::error::operation_aborted) {
+        break;
+      }
+      // a datagram which could not be delivered does not stop the server
+      p_on_error_callback(p_ex);
+    } catch (...) {
+      p_on_error_callback(boost::system::system_error(
+          make_error_code(boost::system::errc::not_enough_memory)));
+      break;
+    }
+  }
+}
+
+boost::leaf::result<int>
+w_udp_server::run(_In_ boost::asio::io_context &p_io_context, _In_ udp::endpoint &&p_endpoint,
+                  _In_ w_udp_options &&p_options, _In_ w_udp_on_data_callback p_on_data_callback,
+                  _In_ w_udp_on_error_callback p_on_error_callback) noexcept {
+  try {
+    // bind before returning, so the datagrams which are sent right after are not lost
+    udp::socket _socket(p_io_context);
+    _socket.open(p_endpoint.protocol());
+
+    w_udp_batch _batch = {};
+    BOOST_LEAF_CHECK(_batch.init(_socket, p_options));
+    _socket.bind(p_endpoint);
+
+    boost::asio::co_spawn(p_io_context,
+                          s_serve(p_io_context, std::move(_socket), std::move(_batch),
+                                  std::move(p_on_data_callback), std::move(p_on_error_callback)),
+                          boost::asio::detached);
+    return 0;
+  } catch (_In_ const std::exception &p_ex) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     "udp server caught an exception : " + std::string(p_ex.what()));
+  }
+}
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -0,0 +1,34 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_udp_batch.hpp"
+#include <wolf/wolf.hpp>
+
+namespace wolf::system::socket {
+class w_udp_server {
+ public:
+  /*
+   * receive the datagrams of an endpoint in batches, each datagram is passed to the data
+   * callback and a non-empty buffer is sent back to its source once the callback succeeds.
+   * the replies of a batch are sent together
+   * @param p_io_context, the boost io context
+   * @param p_endpoint, the endpoint of the server
+   * @param p_options, the udp options
+   * @param p_on_data_callback, on data callback for each datagram
+   * @param p_on_error_callback, on error callback of the socket
+   * @returns zero once the socket was bound
+   */
+  W_API static boost::leaf::result<int>
+  run(_In_ boost::asio::io_context &p_io_context, _In_ boost::asio::ip::udp::endpoint &&p_endpoint,
+      _In_ w_udp_options &&p_options, _In_ w_udp_on_data_callback p_on_data_callback,
+      _In_ w_udp_on_error_callback p_on_error_callback) noexcept;
+};
+}  // namespace wolf::system::socket
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -0,0 +1,167 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_uds_client.hpp"
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#include "w_fd_passing.hpp"
+#include <tuple>
+
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+using w_framing_options = wolf::system::socket::w_framing_options;
+using w_stream_socket = wolf::system::socket::w_stream_socket;
+using w_uds_client = wolf::system::socket::w_uds_client;
+using local = boost::asio::local::stream_protocol;
+
+// the smallest buffer which is acquired for a receive, when the socket reports nothing pending
+constexpr auto UDS_MIN_RECEIVE_SIZE = size_t(256);
+
+w_uds_client::w_uds_client(boost::asio::io_context &p_io_context) noexcept
+    : _socket(std::make_unique<w_stream_socket>(p_io_context)) {}
+
+w_uds_client::w_uds_client(boost::asio::io_context &p_io_context,
+                           _In_ const w_framing_options &p_framing) noexcept
+    : _socket(std::make_unique<w_stream_socket>(p_io_context)), _decoder(p_framing),
+      _encoder(p_framing) {}
+
+w_uds_client::~w_uds_client() noexcept {
+  try {
+    if (this->_socket != nullptr && this->_socket->is_open()) {
+      this->_socket->close();
+    }
+  } catch (...) {
+  }
+}
+
+boost::asio::awaitable<void>
+w_uds_client::async_connect(_In_ const local::endpoint &p_endpoint) {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+
+  // the generic socket lets the sessions of tcp and uds share their code
+  const auto _endpoint = boost::asio::generic::stream_protocol::endpoint(p_endpoint);
+  _socket_nn->open(_endpoint.protocol());
+  co_await _socket_nn->async_connect(_endpoint, boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<size_t> w_uds_client::async_write(_In_ const w_buffer &p_buffer) {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+
+  return boost::asio::async_write(*_socket_nn, p_buffer.get_const_buffer(),
+                                  boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<size_t>
+w_uds_client::async_write(_In_ const w_buffer_sequence &p_buffers) {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+
+  return boost::asio::async_write(*_socket_nn, p_buffers, boost::asio::use_awaitable);
+}
+
+// acquire a buffer of the default pool, which is sized by the pending bytes of socket
+static wolf::system::socket::w_buffer s_acquire_receive_buffer(_In_ w_stream_socket &p_socket) {
+  const auto _available = std::max(p_socket.available(), UDS_MIN_RECEIVE_SIZE);
+  auto _buffer_res = w_buffer_pool::get_default().acquire(_available);
+  if (!_buffer_res) {
+    throw boost::system::system_error(
+        make_error_code(boost::system::errc::not_enough_memory));
+  }
+  return std::move(_buffer_res.value());
+}
+
+boost::asio::awaitable<size_t> w_uds_client::async_read(_Inout_ w_buffer &p_mut_buffer) {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+
+  co_await _socket_nn->async_wait(w_stream_socket::wait_read, boost::asio::use_awaitable);
+
+  // the descriptors which were passed with the bytes are closed by the kernel
+  auto _buffer = s_acquire_receive_buffer(*_socket_nn);
+  const auto _bytes = co_await _socket_nn->async_receive(
+      boost::asio::mutable_buffer(_buffer.data(), _buffer.capacity()),
+      boost::asio::use_awaitable);
+  std::ignore = _buffer.resize(_bytes);
+
+  p_mut_buffer = std::move(_buffer);
+  co_return _bytes;
+}
+
+#ifndef WIN32
+boost::asio::awaitable<size_t> w_uds_client::async_write(_In_ const w_buffer &p_buffer,
+                                                         _In_ gsl::span<const int> p_fds) {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+
+  return wolf::system::socket::async_send_with_fds(*_socket_nn, p_buffer.get_const_buffer(),
+                                                   p_fds);
+}
+
+boost::asio::awaitable<size_t> w_uds_client::async_read(_Inout_ w_buffer &p_mut_buffer,
+                                                        _Inout_ std::vector<int> &p_mut_fds) {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+
+  co_await _socket_nn->async_wait(w_stream_socket::wait_read, boost::asio::use_awaitable);
+
+  auto _buffer = s_acquire_receive_buffer(*_socket_nn);
+  const auto _bytes = co_await wolf::system::socket::async_receive_with_fds(
+      *_socket_nn, boost::asio::mutable_buffer(_buffer.data(), _buffer.capacity()), p_mut_fds);
+  std::ignore = _buffer.resize(_bytes);
+
+  p_mut_buffer = std::move(_buffer);
+  co_return _bytes;
+}
+#endif
+
+boost::leaf::result<int> w_uds_client::queue_message(_In_ w_buffer p_message) noexcept {
+  return this->_encoder.push(std::move(p_message));
+}
+
+boost::asio::awaitable<size_t> w_uds_client::async_flush() {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+
+  if (this->_encoder.empty()) {
+    co_return 0;
+  }
+  // clear the queue even if the write fails, the stream is broken anyway
+  DEFER { this->_encoder.clear(); });
+  co_return co_await boost::asio::async_write(*_socket_nn, this->_encoder.get_buffers(),
+                                              boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<size_t> w_uds_client::async_write_message(_In_ w_buffer p_message) {
+  if (!queue_message(std::move(p_message))) {
+    throw boost::system::system_error(make_error_code(boost::system::errc::message_size));
+  }
+  co_return co_await async_flush();
+}
+
+boost::asio::awaitable<size_t>
+w_uds_client::async_read_message(_Inout_ w_buffer &p_mut_message) {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+
+  for (;;) {
+    auto _message = this->_decoder.next();
+    if (!_message) {
+      throw boost::system::system_error(make_error_code(boost::system::errc::message_size));
+    }
+    if (_message.value().has_value()) {
+      p_mut_message = std::move(_message.value().value());
+      co_return p_mut_message.size();
+    }
+
+    auto _room = this->_decoder.prepare();
+    if (!_room) {
+      throw boost::system::system_error(
+          make_error_code(boost::system::errc::not_enough_memory));
+    }
+    const auto _bytes =
+        co_await _socket_nn->async_receive(_room.value(), boost::asio::use_awaitable);
+    this->_decoder.commit(_bytes);
+  }
+}
+
+bool w_uds_client::get_is_open() const {
+  const gsl::not_null<w_stream_socket *> _socket_nn(this->_socket.get());
+  return _socket_nn->is_open();
+}
+
+#endif // BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#endif // WOLF_SYSTEM_SOCKET
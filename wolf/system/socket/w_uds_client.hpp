@@ -0,0 +1,151 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_socket_options.hpp"
+#include <vector>
+#include <wolf/wolf.hpp>
+
+#include "DISABLE_ANALYSIS_BEGIN"
+#include <boost/asio.hpp>
+#include "DISABLE_ANALYSIS_END"
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+namespace wolf::system::socket {
+
+// a client of unix domain stream sockets, which talks to w_uds_server like w_tcp_client
+class w_uds_client {
+public:
+  // default constructor
+  W_API explicit w_uds_client(boost::asio::io_context &p_io_context) noexcept;
+
+  // constructor with the framing options of messages
+  W_API w_uds_client(boost::asio::io_context &p_io_context,
+                     _In_ const w_framing_options &p_framing) noexcept;
+
+  // move constructor.
+  W_API w_uds_client(w_uds_client &&p_other) = default;
+  // move assignment operator.
+  W_API w_uds_client &operator=(w_uds_client &&p_other) = default;
+
+  // destructor
+  W_API virtual ~w_uds_client() noexcept;
+
+  /*
+   * open a socket and connect to the path asynchronously
+   * @param p_endpoint, the path of the server
+   * @returns a coroutine
+   */
+  W_API
+  boost::asio::awaitable<void>
+  async_connect(_In_ const boost::asio::local::stream_protocol::endpoint &p_endpoint);
+
+  /*
+   * write buffer data into the socket
+   * @param p_buffer, the source buffer which should be written
+   * @returns number of the written bytes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_write(_In_ const w_buffer &p_buffer);
+
+  /*
+   * gather a sequence of buffers and write them into the socket with a single call
+   * @param p_buffers, the source buffers which should be written
+   * @returns number of the written bytes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_write(_In_ const w_buffer_sequence &p_buffers);
+
+  /*
+   * read from the socket into a buffer of the default pool, which is sized by the
+   * pending bytes of socket, so a message is never truncated to a fixed size
+   * @param p_mut_buffer, the destination buffer which will be replaced by the read bytes
+   * @returns number of read bytes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_read(_Inout_ w_buffer &p_mut_buffer);
+
+#ifndef WIN32
+  /*
+   * write buffer data and pass file descriptors with it by SCM_RIGHTS, the descriptors stay
+   * open on this side
+   * @param p_buffer, the source buffer which should be written, which must not be empty
+   * @param p_fds, the file descriptors, up to 64 of them
+   * @returns number of the written bytes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_write(_In_ const w_buffer &p_buffer,
+                                             _In_ gsl::span<const int> p_fds);
+
+  /*
+   * read from the socket like async_read and take the file descriptors which were passed with
+   * the read bytes
+   * @param p_mut_buffer, the destination buffer which will be replaced by the read bytes
+   * @param p_mut_fds, the received descriptors are appended and owned by the caller
+   * @returns number of read bytes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_read(_Inout_ w_buffer &p_mut_buffer,
+                                            _Inout_ std::vector<int> &p_mut_fds);
+#endif
+
+  /*
+   * queue a length-prefixed message, the queued messages are sent by the next flush
+   * @param p_message, the message which is not copied
+   * @returns zero on success
+   */
+  W_API
+  boost::leaf::result<int> queue_message(_In_ w_buffer p_message) noexcept;
+
+  /*
+   * write all queued messages with a single gathered write
+   * @returns number of the written bytes, including the prefixes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_flush();
+
+  /*
+   * write a length-prefixed message together with the queued messages
+   * @param p_message, the message which is not copied
+   * @returns number of the written bytes, including the prefixes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_write_message(_In_ w_buffer p_message);
+
+  /*
+   * read the next length-prefixed message, the messages which arrived with one read are
+   * returned without reading the socket again
+   * @param p_mut_message, the destination which will be a view of the received bytes
+   * @returns the size of message
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_read_message(_Inout_ w_buffer &p_mut_message);
+
+  /*
+   * get whether socket is open
+   * @returns true if socket was open
+   */
+  W_API
+  bool get_is_open() const;
+
+private:
+  // copy constructor
+  w_uds_client(const w_uds_client &) = delete;
+  // copy operator
+  w_uds_client &operator=(const w_uds_client &) = delete;
+
+  std::unique_ptr<w_stream_socket> _socket;
+  w_frame_decoder _decoder;
+  w_frame_encoder _encoder;
+};
+} // namespace wolf::system::socket
+
+#endif // BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -0,0 +1,95 @@
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_uds_server.hpp"
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#include <filesystem>
+
+using w_uds_server = wolf::system::socket::w_uds_server;
+using w_tcp_server = wolf::system::socket::w_tcp_server;
+using w_timing_wheel = wolf::system::socket::w_timing_wheel;
+using w_session_on_data_callback = wolf::system::socket::w_session_on_data_callback;
+using w_session_on_error_callback = wolf::system::socket::w_session_on_error_callback;
+using w_socket_options = wolf::system::socket::w_socket_options;
+using w_stream_socket = wolf::system::socket::w_stream_socket;
+using steady_clock = std::chrono::steady_clock;
+using local = boost::asio::local::stream_protocol;
+
+static boost::asio::awaitable<void>
+s_listen(_In_ const boost::asio::io_context &p_io_context, _In_ local::acceptor p_acceptor,
+         _In_ steady_clock::duration p_timeout, _In_ w_socket_options p_socket_options,
+         _In_ w_session_on_data_callback p_on_data_callback,
+         _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+  auto _executor = co_await boost::asio::this_coro::executor;
+
+  // one timing wheel watches the idle timeouts of all sessions
+  const auto _wheel = w_timing_wheel::make_for_timeout(p_timeout);
+  _wheel->run(_executor);
+
+#ifdef __clang__
+#pragma unroll
+#endif
+  while (!p_io_context.stopped()) {
+    auto _socket = co_await p_acceptor.async_accept(boost::asio::use_awaitable);
+
+    // spawn a coroutinue for handling session
+    co_spawn(_executor,
+             w_tcp_server::async_run_session(p_io_context, w_stream_socket(std::move(_socket)),
+                                             p_timeout, p_socket_options, _wheel,
+                                             p_on_data_callback, p_on_error_callback),
+             boost::asio::detached);
+  }
+}
+
+// remove the socket file which was left by a server that is not running anymore
+static boost::leaf::result<int> s_remove_stale_path(_In_ boost::asio::io_context &p_io_context,
+                                                    _In_ const local::endpoint &p_endpoint) {
+  const auto _path = p_endpoint.path();
+  std::error_code _error;
+  if (_path.empty() || _path.front() == '\0' ||
+      !std::filesystem::is_socket(std::filesystem::path(_path), _error)) {
+    return 0;
+  }
+
+  boost::system::error_code _connect_error;
+  local::socket _probe(p_io_context);
+  std::ignore = _probe.connect(p_endpoint, _connect_error);
+  if (!_connect_error) {
+    return W_FAILURE(std::errc::address_in_use, "a uds server is running on " + _path);
+  }
+  if (_connect_error == boost::asio::error::connection_refused) {
+    std::filesystem::remove(std::filesystem::path(_path), _error);
+  }
+  return 0;
+}
+
+boost::leaf::result<int> w_uds_server::run(
+    _In_ boost::asio::io_context &p_io_context, _In_ local::endpoint &&p_endpoint,
+    _In_ std::chrono::steady_clock::duration &&p_timeout, _In_ w_socket_options &&p_socket_options,
+    _In_ w_session_on_data_callback p_on_data_callback,
+    _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+  try {
+    BOOST_LEAF_CHECK(s_remove_stale_path(p_io_context, p_endpoint));
+
+    // bind here, so the errors of path are returned to the caller
+    local::acceptor _acceptor(p_io_context);
+    _acceptor.open(p_endpoint.protocol());
+    _acceptor.bind(p_endpoint);
+    _acceptor.listen(p_socket_options.max_connections);
+
+    boost::asio::co_spawn(p_io_context,
+                          s_listen(p_io_context, std::move(_acceptor), p_timeout,
+                                   std::move(p_socket_options), std::move(p_on_data_callback),
+                                   std::move(p_on_error_callback)),
+                          boost::asio::detached);
+    return 0;
+  } catch (_In_ const std::exception &p_ex) {
+    return W_FAILURE(std::errc::operation_canceled,
+                     "uds server caught an exception : " + std::string(p_ex.what()));
+  }
+}
+
+#endif // BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#endif // WOLF_SYSTEM_SOCKET
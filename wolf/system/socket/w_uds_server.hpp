@@ -0,0 +1,48 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#pragma once
+
+#ifdef WOLF_SYSTEM_SOCKET
+
+#include "w_tcp_server.hpp"
+#include <wolf/wolf.hpp>
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+namespace wolf::system::socket {
+
+/*
+ * a server of unix domain stream sockets, whose sessions are the sessions of w_tcp_server, so
+ * the data callback, framing, send queues, registry and idle timeouts work the same way. the
+ * options of tcp like no_delay and keep_alive are ignored. set on_fds of socket options to
+ * receive the file descriptors which are passed by clients
+ */
+class w_uds_server {
+public:
+  /*
+   * bind the path and run the server, a stale socket file of the path is removed, while the path
+   * of a running server fails with address_in_use. a path which starts with '\0' is in the
+   * abstract namespace of linux and has no file
+   * @param p_io_context, the boost io context
+   * @param p_endpoint, the path of the server
+   * @param p_timeout, the idle timeout of sessions
+   * @param p_socket_options, the socket options
+   * @param p_on_data_callback, on data callback for session
+   * @param p_on_error_callback, on error callback for session
+   * @returns zero on success
+   */
+  W_API static boost::leaf::result<int>
+  run(_In_ boost::asio::io_context &p_io_context,
+      _In_ boost::asio::local::stream_protocol::endpoint &&p_endpoint,
+      _In_ std::chrono::steady_clock::duration &&p_timeout,
+      _In_ w_socket_options &&p_socket_options, _In_ w_session_on_data_callback p_on_data_callback,
+      _In_ w_session_on_error_callback p_on_error_callback) noexcept;
+};
+} // namespace wolf::system::socket
+
+#endif // BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#endif // WOLF_SYSTEM_SOCKET
@@ -1,7 +1,9 @@
 #if defined(WOLF_SYSTEM_HTTP_WS) && defined(WOLF_SYSTEM_SOCKET)
 
 #include "w_ws_client.hpp"
+#include <cstring>
 
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
 using w_ws_client = wolf::system::socket::w_ws_client;
 using tcp = boost::asio::ip::tcp;
 
@@ -67,6 +69,10 @@ boost::asio::awaitable<void> w_ws_client::async_connect(
                 std::string(BOOST_BEAST_VERSION_STRING) + " wolf-ws-client");
       }));
 
+  if (p_socket_options.ws_deflate.has_value()) {
+    p_socket_options.ws_deflate->set_to_stream(*this->_ws);
+  }
+
   // perform the websocket handshake
   co_await this->_ws->async_handshake(p_endpoint.address().to_string(), "/");
 }
@@ -78,25 +84,39 @@ w_ws_client::async_write(_In_ const w_buffer &p_buffer, _In_ bool p_is_binary) {
   } else {
     this->_ws->text(true);
   }
-  co_await this->_ws->async_write(
-      boost::asio::const_buffer(p_buffer.buf.data(), p_buffer.used_bytes));
+  co_return co_await this->_ws->async_write(p_buffer.get_const_buffer());
 }
 
 boost::asio::awaitable<size_t>
 w_ws_client::async_read(_Inout_ w_buffer &p_mut_buffer) {
-  boost::beast::flat_buffer _buffer = {};
-  co_await this->_ws->async_read(_buffer);
-
-  // an extra copy just for having a stable ABI
-  const auto _size = std::min(_buffer.cdata().size(), p_mut_buffer.buf.size());
-  std::memcpy(p_mut_buffer.buf.data(),
-              static_cast<char const *>(_buffer.cdata().data()), _size);
+  const auto _size = co_await this->_ws->async_read(this->_read_buffer);
+  DEFER { this->_read_buffer.consume(_size); });
+
+  // the caller owns the message, so it is copied into a pooled buffer which fits it
+  auto _buffer_res = w_buffer_pool::get_default().acquire(_size);
+  if (!_buffer_res) {
+    throw boost::system::system_error(
+        make_error_code(boost::system::errc::not_enough_memory));
+  }
+  p_mut_buffer = std::move(_buffer_res.value());
+  std::memcpy(p_mut_buffer.data(), this->_read_buffer.cdata().data(), _size);
   co_return _size;
 }
 
 boost::asio::awaitable<size_t>
 w_ws_client::async_read(_Inout_ boost::beast::flat_buffer &p_mut_buffer) {
-  co_await this->_ws->async_read(p_mut_buffer);
+  co_return co_await this->_ws->async_read(p_mut_buffer);
+}
+
+boost::asio::awaitable<size_t>
+w_ws_client::async_read(_In_ const w_ws_on_message_callback &p_on_message) {
+  const auto _size = co_await this->_ws->async_read(this->_read_buffer);
+  DEFER { this->_read_buffer.consume(_size); });
+
+  p_on_message(gsl::span<const std::byte>(
+                   static_cast<const std::byte *>(this->_read_buffer.cdata().data()), _size),
+               this->_ws->got_binary());
+  co_return _size;
 }
 
 boost::asio::awaitable<void> w_ws_client::async_close(
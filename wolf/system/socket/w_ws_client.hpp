@@ -61,8 +61,8 @@ public:
                                              _In_ bool p_is_binary);
 
   /*
-   * read from the websocket into the buffer
-   * @param p_mut_buffer, the destination buffer which will contain bytes
+   * read a whole message of any size from the websocket into a buffer of the default pool
+   * @param p_mut_buffer, the destination buffer which will be replaced by the message
    * @returns a coroutine with number of read bytes
    */
   W_API
@@ -77,6 +77,15 @@ public:
   boost::asio::awaitable<size_t>
   async_read(_Inout_ boost::beast::flat_buffer &p_mut_buffer);
 
+  /*
+   * read a whole message and pass a view of it to the callback without copying,
+   * the message is consumed when the callback returns
+   * @param p_on_message, the callback which gets the message
+   * @returns a coroutine with number of read bytes
+   */
+  W_API
+  boost::asio::awaitable<size_t> async_read(_In_ const w_ws_on_message_callback &p_on_message);
+
   /*
    * close the websocket asynchronously
    * @param p_close_reason, the close reason
@@ -100,6 +109,8 @@ private:
 
   std::unique_ptr<w_ws_stream> _ws;
   std::unique_ptr<boost::asio::ip::tcp::resolver> _resolver;
+  // the storage of incoming messages, which is reused by every read
+  boost::beast::flat_buffer _read_buffer;
 };
 } // namespace wolf::system::socket
 
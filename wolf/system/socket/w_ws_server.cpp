@@ -1,71 +1,184 @@
 #if defined(WOLF_SYSTEM_HTTP_WS) && defined(WOLF_SYSTEM_SOCKET)
 
 #include "w_ws_server.hpp"
+#include <cstring>
 
+using w_buffer = wolf::system::socket::w_buffer;
+using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+using w_send_queue = wolf::system::socket::w_send_queue;
+using w_send_queue_message = wolf::system::socket::w_send_queue_message;
+using w_send_queue_options = wolf::system::socket::w_send_queue_options;
+using w_send_queue_status = wolf::system::socket::w_send_queue_status;
+using w_session_id = wolf::system::socket::w_session_id;
+using w_session_registry = wolf::system::socket::w_session_registry;
 using w_ws_server = wolf::system::socket::w_ws_server;
 using w_session_ws_on_data_callback = wolf::system::socket::w_session_ws_on_data_callback;
+using w_session_ws_on_message_callback =
+    wolf::system::socket::w_session_ws_on_message_callback;
 using w_session_on_error_callback = wolf::system::socket::w_session_on_error_callback;
 using w_socket_options = wolf::system::socket::w_socket_options;
 using io_context = boost::asio::io_context;
 using w_ws_stream = wolf::system::socket::w_ws_stream;
 using tcp = boost::asio::ip::tcp;
+using namespace boost::asio::experimental::awaitable_operators;
 
 static boost::asio::awaitable<void>
-s_session(_In_ const boost::asio::io_context &p_io_context,
-          _In_ w_ws_stream &&p_ws,
-          _In_ const std::string p_conn_id,
-          _In_ w_session_ws_on_data_callback p_on_data_callback,
-          _In_ w_session_on_error_callback p_on_error_callback) {
-
-  // accept the websocket handshake
-  co_await p_ws.async_accept();
-
-  w_buffer _mut_buffer = {};
-  // incoming message
+on_read_session(_In_ const boost::asio::io_context &p_io_context, _Inout_ w_ws_stream &p_ws,
+                _In_ const std::string &p_conn_id, _In_ std::shared_ptr<w_send_queue> p_queue,
+                _In_ w_session_ws_on_message_callback p_on_message_callback,
+                _In_ w_session_on_error_callback p_on_error_callback) {
+  // incoming message, its storage is reused by every read
   boost::beast::flat_buffer _buffer;
+  w_buffer _reply = {};
 
   while (!p_io_context.stopped()) {
     try {
-      // This buffer will hold the incoming message
-      
-      // Read a message
-      _mut_buffer.used_bytes = co_await p_ws.async_read(_buffer);
-
-      // an extra copy just for having stable ABI
-      const auto _size = std::min(_mut_buffer.buf.size(), _mut_buffer.used_bytes);
-      std::memcpy(_mut_buffer.buf.data(),
-                  static_cast<char const *>(_buffer.cdata().data()), _size);
+      // read a whole message of any size
+      const auto _size = co_await p_ws.async_read(_buffer);
 
-      // call callback
+      // the callback gets a view of the message, which is consumed once it returns
       auto _is_binary = p_ws.got_binary();
-      const auto _code = p_on_data_callback(p_conn_id, _mut_buffer, _is_binary);
+      const auto _message = gsl::span<const std::byte>(
+          static_cast<const std::byte *>(_buffer.cdata().data()), _size);
+      const auto _code = p_on_message_callback(p_conn_id, _message, _is_binary, _reply);
+      _buffer.consume(_size);
       if (_code != boost::beast::websocket::close_code::none) {
         break;
       }
 
-      // Echo the message back
-      if (_is_binary) {
-        p_ws.binary(true);
-      } else {
-        p_ws.text(true);
+      if (!_reply.empty() && p_queue != nullptr) {
+        // the writer sends it, reading stops while a slowed down queue is full
+        const auto _status = co_await p_queue->async_push(std::move(_reply), _is_binary);
+        if (_status == w_send_queue_status::CLOSED) {
+          break;
+        }
+      } else if (!_reply.empty()) {
+        if (_is_binary) {
+          p_ws.binary(true);
+        } else {
+          p_ws.text(true);
+        }
+        co_await p_ws.async_write(_reply.get_const_buffer());
       }
-      co_await p_ws.async_write(
-          boost::asio::buffer(_mut_buffer.buf, _mut_buffer.used_bytes));
+      // give the block back to the pool
+      _reply = {};
+    } catch (const boost::system::system_error &p_exc) {
+      if (p_exc.code() != boost::beast::websocket::error::closed) {
+        p_on_error_callback(p_conn_id, p_exc);
+      }
+      break;
+    }
+  }
+}
+
+static boost::asio::awaitable<void>
+on_write_session(_Inout_ w_ws_stream &p_ws, _In_ const std::string &p_conn_id,
+                 _Inout_ w_send_queue &p_queue,
+                 _In_ w_session_on_error_callback p_on_error_callback) {
+  std::vector<w_send_queue_message> _messages;
 
+  for (;;) {
+    try {
+      if (co_await p_queue.async_pop(_messages) == 0) {
+        if (p_queue.is_overflowed()) {
+          const auto _error = boost::system::system_error(
+              make_error_code(boost::system::errc::no_buffer_space));
+          p_on_error_callback(p_conn_id, _error);
+          co_await p_ws.async_close(boost::beast::websocket::close_code::try_again_later);
+        }
+        break;
+      }
+
+      // each queued message is a websocket message of its own
+      for (auto &_message : _messages) {
+        if (_message.is_binary) {
+          p_ws.binary(true);
+        } else {
+          p_ws.text(true);
+        }
+        const auto _size = _message.buffer.size();
+        co_await p_ws.async_write(_message.buffer.get_const_buffer());
+        // give the block back to the pool
+        _message.buffer = {};
+        p_queue.consume(_size);
+      }
+      _messages.clear();
     } catch (const boost::system::system_error &p_exc) {
       if (p_exc.code() != boost::beast::websocket::error::closed) {
         p_on_error_callback(p_conn_id, p_exc);
       }
+      break;
     }
   }
 }
 
 static boost::asio::awaitable<void>
-s_listen(_In_ const boost::asio::io_context &p_io_context,
-         _In_ const tcp::endpoint &p_endpoint,
-         _In_ const boost::beast::websocket::stream_base::timeout &p_timeout,
-         _In_ w_socket_options &p_socket_options,
-         _In_ w_session_ws_on_data_callback p_on_data_callback,
+s_session(_In_ const boost::asio::io_context &p_io_context, _In_ w_ws_stream p_ws,
+          _In_ const w_session_id p_id,
+          _In_ std::optional<w_send_queue_options> p_send_queue,
+          _In_ std::shared_ptr<w_session_registry> p_registry,
+          _In_ w_session_ws_on_message_callback p_on_message_callback,
+          _In_ w_session_on_error_callback p_on_error_callback) {
+  const auto _conn_id = std::to_string(p_id);
+  try {
+    // accept the websocket handshake
+    co_await p_ws.async_accept();
+  } catch (const boost::system::system_error &p_exc) {
+    p_on_error_callback(_conn_id, p_exc);
+    co_return;
+  }
+
+  // the registered sessions need a queue for the broadcast messages
+  if (!p_send_queue.has_value() && p_registry != nullptr) {
+    p_send_queue = w_send_queue_options{};
+  }
+
+  if (!p_send_queue.has_value()) {
+    co_await on_read_session(p_io_context, p_ws, _conn_id, nullptr,
+                             std::move(p_on_message_callback), p_on_error_callback);
+    co_return;
+  }
+
+  std::shared_ptr<w_send_queue> _queue = nullptr;
+  try {
+    _queue = std::make_shared<w_send_queue>(p_send_queue.value());
+    if (p_send_queue->on_open) {
+      p_send_queue->on_open(_conn_id, _queue);
+    }
+  } catch (...) {
+    // on_open may have kept the queue, so its producers see the session as closed
+    if (_queue != nullptr) {
+      _queue->close();
+    }
+    const auto _error = boost::system::system_error(
+        make_error_code(boost::system::errc::not_enough_memory));
+    p_on_error_callback(_conn_id, _error);
+    co_return;
+  }
+  if (p_registry != nullptr && p_registry->add(p_id, _queue).has_error()) {
+    _queue->close();
+    const auto _error = boost::system::system_error(
+        make_error_code(boost::system::errc::not_enough_memory));
+    p_on_error_callback(_conn_id, _error);
+    co_return;
+  }
+
+  // the session ends once its reader or its writer ends
+  co_await (on_read_session(p_io_context, p_ws, _conn_id, _queue,
+                            std::move(p_on_message_callback), p_on_error_callback) ||
+            on_write_session(p_ws, _conn_id, *_queue, p_on_error_callback));
+  // the producers which keep the queue see the session as closed
+  _queue->close();
+  if (p_registry != nullptr) {
+    p_registry->remove(p_id);
+  }
+}
+
+static boost::asio::awaitable<void>
+s_listen(_In_ const boost::asio::io_context &p_io_context, _In_ tcp::endpoint p_endpoint,
+         _In_ boost::beast::websocket::stream_base::timeout p_timeout,
+         _In_ w_socket_options p_socket_options,
+         _In_ w_session_ws_on_message_callback p_on_message_callback,
          _In_ w_session_on_error_callback p_on_error_callback) {
   // create acceptor from this coroutine
   auto _executor = co_await boost::asio::this_coro::executor;
@@ -92,17 +205,22 @@ s_listen(_In_ const boost::asio::io_context &p_io_context,
     auto _ws = w_ws_stream(co_await _acceptor.async_accept());
     // set timeout settings for the websocket
     _ws.set_option(p_timeout);
+    if (p_socket_options.ws_deflate.has_value()) {
+      p_socket_options.ws_deflate->set_to_stream(_ws);
+    }
     // set a decorator to change the Server of the handshake
     _ws.set_option(boost::beast::websocket::stream_base::decorator(
         [](boost::beast::websocket::response_type &res) {
           res.set(boost::beast::http::field::server,
                   std::string(BOOST_BEAST_VERSION_STRING) + "wolf-ws-server");
         }));
-    const auto _conn_id = wolf::system::socket::make_connection_id();
+    const auto _id = wolf::system::socket::make_session_id();
 
     boost::asio::co_spawn(_acceptor.get_executor(),
-                          s_session(p_io_context, std::move(_ws), _conn_id,
-                                    p_on_data_callback, p_on_error_callback));
+                          s_session(p_io_context, std::move(_ws), _id,
+                                    p_socket_options.send_queue, p_socket_options.registry,
+                                    p_on_message_callback, p_on_error_callback),
+                          boost::asio::detached);
   }
 }
 
@@ -113,11 +231,42 @@ boost::leaf::result<int> w_ws_server::run(
     _In_ w_socket_options &&p_socket_options,
     _In_ w_session_ws_on_data_callback p_on_data_callback,
     _In_ w_session_on_error_callback p_on_error_callback) noexcept {
+  // the data callback owns a copy of each message, which is echoed back after the callback
+  auto _on_message = [p_on_data_callback, p_on_error_callback](
+                         _In_ const std::string &p_conn_id,
+                         _In_ gsl::span<const std::byte> p_message, _Inout_ bool &p_is_binary,
+                         _Inout_ w_buffer &p_mut_reply) {
+    auto _buffer = w_buffer_pool::get_default().acquire(p_message.size());
+    if (!_buffer) {
+      const auto _error = boost::system::system_error(
+          make_error_code(boost::system::errc::not_enough_memory));
+      p_on_error_callback(p_conn_id, _error);
+      return boost::beast::websocket::close_code::internal_error;
+    }
+    p_mut_reply = std::move(_buffer.value());
+    if (!p_message.empty()) {
+      std::memcpy(p_mut_reply.data(), p_message.data(), p_message.size());
+    }
+    return p_on_data_callback(p_conn_id, p_mut_reply, p_is_binary);
+  };
+
+  return run(p_io_context, std::move(p_endpoint), p_timeout, std::move(p_socket_options),
+             w_session_ws_on_message_callback(std::move(_on_message)),
+             std::move(p_on_error_callback));
+}
+
+boost::leaf::result<int> w_ws_server::run(
+    _In_ boost::asio::io_context &p_io_context,
+    _In_ const boost::asio::ip::tcp::endpoint &&p_endpoint,
+    _In_ const boost::beast::websocket::stream_base::timeout &p_timeout,
+    _In_ w_socket_options &&p_socket_options,
+    _In_ w_session_ws_on_message_callback p_on_message_callback,
+    _In_ w_session_on_error_callback p_on_error_callback) noexcept {
   try {
     // server with coroutines
     boost::asio::co_spawn(p_io_context,
                           s_listen(p_io_context, p_endpoint, p_timeout,
-                                   p_socket_options, std::move(p_on_data_callback),
+                                   p_socket_options, std::move(p_on_message_callback),
                                    std::move(p_on_error_callback)),
                           boost::asio::detached);
     return 0;
@@ -25,6 +25,25 @@ public:
       _In_ w_socket_options &&p_socket_options,
       _In_ w_session_ws_on_data_callback p_on_data_callback,
       _In_ w_session_on_error_callback p_on_error_callback) noexcept;
+
+  /*
+   * run the server with a callback which gets each whole message without copying it,
+   * the message is consumed when the callback returns
+   * @param p_io_context, the boost io context
+   * @param p_endpoint, the endpoint of the server
+   * @param p_timeout, the timeout for connection
+   * @param p_socket_options, the socket options
+   * @param p_on_message_callback, on message callback for session
+   * @param p_on_error_callback, on error callback for session
+   * @returns zero on success
+   */
+  W_API static boost::leaf::result<int>
+  run(_In_ boost::asio::io_context &p_io_context,
+      _In_ const boost::asio::ip::tcp::endpoint &&p_endpoint,
+      _In_ const boost::beast::websocket::stream_base::timeout &p_timeout,
+      _In_ w_socket_options &&p_socket_options,
+      _In_ w_session_ws_on_message_callback p_on_message_callback,
+      _In_ w_session_on_error_callback p_on_error_callback) noexcept;
 };
 } // namespace wolf::system::socket
 
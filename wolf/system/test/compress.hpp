@@ -9,8 +9,13 @@
 #include <system/w_leak_detector.hpp>
 #include <wolf/wolf.hpp>
 
+#include <fstream>
+
+#include <system/compression/w_compressor.hpp>
+#include <system/compression/w_entropy.hpp>
 #include <system/compression/w_lz4.hpp>
 #include <system/compression/w_lzma.hpp>
+#include <system/compression/w_zlib.hpp>
 
 #ifdef WOLF_SYSTEM_LZ4
 
@@ -54,6 +59,449 @@ BOOST_AUTO_TEST_CASE(compress_lz4_test) {
   std::cout << "leaving test case 'compress_lz4_test'" << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(compress_lz4_frame_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lz4_frame_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_lz4_frame_compressor = wolf::system::compression::w_lz4_frame_compressor;
+        using w_lz4_frame_decompressor = wolf::system::compression::w_lz4_frame_decompressor;
+
+        constexpr auto _mock_compression_data =
+            "HELLO WOLF\r\nHELLO WOLF!*&%!HELLO WOLF!07*&%!\r\nThe quick "
+            "brown fox jumps over the lazy dog!";
+
+        // generate a stream which is larger than a single block
+        std::vector<std::byte> _src;
+        for (size_t i = 0; i < 2048; ++i) {
+          const auto _bytes = std::span(reinterpret_cast<const std::byte *>(_mock_compression_data),
+                                        strlen(_mock_compression_data));
+          _src.insert(_src.end(), _bytes.begin(), _bytes.end());
+        }
+
+        // compress chunk by chunk into a caller-owned buffer
+        auto _compressor = w_lz4_frame_compressor();
+        BOOST_LEAF_CHECK(_compressor.init());
+
+        constexpr auto _chunk_size = size_t(4096);
+        std::vector<std::byte> _frame(_src.size() + 1024);
+        std::vector<std::byte> _chunk_dst(_compressor.get_compress_bound(_chunk_size));
+
+        BOOST_LEAF_AUTO(_header_size, _compressor.begin(_frame));
+        auto _frame_size = _header_size;
+
+        for (size_t _offset = 0; _offset < _src.size(); _offset += _chunk_size) {
+          const auto _len = std::min(_chunk_size, _src.size() - _offset);
+          BOOST_LEAF_AUTO(_written, _compressor.update(std::span(_src).subspan(_offset, _len),
+                                                       _chunk_dst));
+          std::copy_n(_chunk_dst.begin(), _written, _frame.begin() + _frame_size);
+          _frame_size += _written;
+        }
+        BOOST_LEAF_AUTO(_end_size, _compressor.end(_chunk_dst));
+        std::copy_n(_chunk_dst.begin(), _end_size, _frame.begin() + _frame_size);
+        _frame_size += _end_size;
+
+        BOOST_REQUIRE(_frame_size < _src.size());
+
+        // decompress chunk by chunk
+        auto _decompressor = w_lz4_frame_decompressor();
+        BOOST_LEAF_CHECK(_decompressor.init());
+
+        std::vector<std::byte> _dst(_src.size());
+        size_t _src_pos = 0;
+        size_t _dst_pos = 0;
+        for (;;) {
+          const auto _len = std::min(size_t(512), _frame_size - _src_pos);
+          BOOST_LEAF_AUTO(_progress,
+                          _decompressor.update(std::span(_frame).subspan(_src_pos, _len),
+                                               std::span(_dst).subspan(_dst_pos)));
+          _src_pos += _progress.src_consumed;
+          _dst_pos += _progress.dst_written;
+          if (_progress.src_size_hint == 0 || _src_pos == _frame_size) {
+            break;
+          }
+        }
+
+        BOOST_REQUIRE(_dst_pos == _src.size());
+        BOOST_REQUIRE(_dst == _src);
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lz4_frame_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lz4_frame_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lz4_frame_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_lz4_sized_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lz4_sized_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using lz4 = wolf::system::compression::w_lz4;
+        using steady_clock = std::chrono::steady_clock;
+
+        // a highly compressible payload, which forces several retries on lz4::decompress
+        std::vector<std::byte> _src(8 * 1024 * 1024);
+        for (size_t i = 0; i < _src.size(); ++i) {
+          _src[i] = std::byte((i / 4096) & 0x0F);
+        }
+
+        BOOST_LEAF_AUTO(_compressed, lz4::compress_default(_src));
+        BOOST_LEAF_AUTO(_sized, lz4::compress_sized(_src));
+
+        BOOST_LEAF_AUTO(_size, lz4::get_decompressed_size(_sized));
+        BOOST_REQUIRE(_size == _src.size());
+
+        constexpr auto _iterations = 10;
+        constexpr auto _max_retry = 32;
+
+        auto _start = steady_clock::now();
+        for (auto i = 0; i < _iterations; ++i) {
+          BOOST_LEAF_AUTO(_decompressed, lz4::decompress(_compressed, _max_retry));
+          BOOST_REQUIRE(_decompressed.size() == _src.size());
+        }
+        const auto _retry_time = steady_clock::now() - _start;
+
+        _start = steady_clock::now();
+        for (auto i = 0; i < _iterations; ++i) {
+          BOOST_LEAF_AUTO(_decompressed, lz4::decompress_sized(_sized));
+          BOOST_REQUIRE(_decompressed == _src);
+        }
+        const auto _sized_time = steady_clock::now() - _start;
+
+        std::vector<std::byte> _dst(_size);
+        _start = steady_clock::now();
+        for (auto i = 0; i < _iterations; ++i) {
+          BOOST_LEAF_AUTO(_bytes, lz4::decompress_into(_sized, _dst));
+          BOOST_REQUIRE(_bytes == _src.size());
+        }
+        const auto _into_time = steady_clock::now() - _start;
+        BOOST_REQUIRE(_dst == _src);
+
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+        std::cout << "lz4 decompress of " << _src.size() << " bytes (ratio "
+                  << _src.size() / _compressed.size() << "x) over " << _iterations
+                  << " iterations, retry: " << duration_cast<microseconds>(_retry_time).count()
+                  << "us, sized: " << duration_cast<microseconds>(_sized_time).count()
+                  << "us, into: " << duration_cast<microseconds>(_into_time).count() << "us"
+                  << std::endl;
+
+        // the destination must be large enough
+        std::vector<std::byte> _small_dst(_size - 1);
+        BOOST_REQUIRE(!lz4::decompress_into(_sized, _small_dst));
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lz4_sized_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lz4_sized_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lz4_sized_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_lz4_blocks_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lz4_blocks_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_lz4_blocks = wolf::system::compression::w_lz4_blocks;
+        using w_lz4_blocks_options = wolf::system::compression::w_lz4_blocks_options;
+        using w_lz4_blocks_reader = wolf::system::compression::w_lz4_blocks_reader;
+        using steady_clock = std::chrono::steady_clock;
+
+        std::vector<std::byte> _src(16 * 1024 * 1024 + 123);
+        for (size_t i = 0; i < _src.size(); ++i) {
+          _src[i] = std::byte((i * 31 + i / 1024) & 0x3F);
+        }
+
+        w_lz4_blocks_options _opts = {};
+        _opts.block_size = 256 * 1024;
+        _opts.threads = 1;
+
+        auto _start = steady_clock::now();
+        BOOST_LEAF_AUTO(_single, w_lz4_blocks::compress(_src, _opts));
+        const auto _single_time = steady_clock::now() - _start;
+
+        _opts.threads = 0;
+        _start = steady_clock::now();
+        BOOST_LEAF_AUTO(_parallel, w_lz4_blocks::compress(_src, _opts));
+        const auto _parallel_time = steady_clock::now() - _start;
+
+        // blocks are independent, so the output does not depend on number of threads
+        BOOST_REQUIRE(_single == _parallel);
+
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+        std::cout << "lz4 blocks compress of " << _src.size()
+                  << " bytes, single thread: " << duration_cast<microseconds>(_single_time).count()
+                  << "us, all threads: " << duration_cast<microseconds>(_parallel_time).count()
+                  << "us" << std::endl;
+
+        BOOST_LEAF_AUTO(_decompressed, w_lz4_blocks::decompress(_parallel));
+        BOOST_REQUIRE(_decompressed == _src);
+
+        // random access across block boundaries
+        auto _reader = w_lz4_blocks_reader();
+        BOOST_LEAF_CHECK(_reader.init(_parallel));
+        BOOST_REQUIRE(_reader.get_size() == _src.size());
+
+        std::vector<std::byte> _range(300 * 1024);
+        for (const auto _offset : {size_t(0), size_t(1), _opts.block_size - 7, 5 * _opts.block_size,
+                                   _src.size() - 100}) {
+          BOOST_LEAF_AUTO(_bytes, _reader.read(_offset, _range));
+          const auto _expected = std::min(_range.size(), _src.size() - _offset);
+          BOOST_REQUIRE(_bytes == _expected);
+          BOOST_REQUIRE(std::equal(_range.begin(), _range.begin() + _bytes,
+                                   _src.begin() + _offset));
+        }
+
+        // a footer whose forged size wraps the count of blocks to zero is rejected, the footer
+        // is the size, the block size, the count and the magic
+        std::vector<std::byte> _forged(_parallel.end() - 20, _parallel.end());
+        std::fill_n(_forged.begin(), sizeof(uint64_t), std::byte(0xFF));
+        std::fill_n(_forged.begin() + 12, sizeof(uint32_t), std::byte(0));
+        BOOST_REQUIRE(w_lz4_blocks::decompress(_forged).has_error());
+        auto _forged_reader = w_lz4_blocks_reader();
+        BOOST_REQUIRE(_forged_reader.init(_forged).has_error());
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lz4_blocks_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lz4_blocks_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lz4_blocks_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_lz4_dict_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lz4_dict_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using lz4 = wolf::system::compression::w_lz4;
+        using w_lz4_dict = wolf::system::compression::w_lz4_dict;
+
+        // small control messages, similar to what sockets send
+        std::vector<std::string> _messages;
+        for (auto i = 0; i < 400; ++i) {
+          _messages.push_back(wolf::format(
+              R"({{"type":"player_state","id":{},"position":{{"x":{},"y":{}}},"health":{}}})", i,
+              i * 3, i % 17, 100 - i % 100));
+        }
+
+        // train with the first half and measure on the second half
+        std::vector<gsl::span<const std::byte>> _samples;
+        for (size_t i = 0; i < _messages.size() / 2; ++i) {
+          _samples.push_back(std::as_bytes(std::span(_messages[i])));
+        }
+        BOOST_LEAF_AUTO(_trained, w_lz4_dict::train(_samples, 16 * 1024));
+        BOOST_REQUIRE(!_trained.empty());
+
+        auto _dict = w_lz4_dict();
+        BOOST_LEAF_CHECK(_dict.init(_trained));
+
+        size_t _plain_size = 0;
+        size_t _dict_size = 0;
+        std::vector<std::byte> _compressed(W_MAX_BUFFER_SIZE * 2);
+        std::vector<std::byte> _decompressed(W_MAX_BUFFER_SIZE);
+        for (size_t i = _messages.size() / 2; i < _messages.size(); ++i) {
+          const auto _msg = std::as_bytes(std::span(_messages[i]));
+
+          BOOST_LEAF_AUTO(_plain, lz4::compress_default(_msg));
+          _plain_size += _plain.size();
+
+          BOOST_LEAF_AUTO(_bytes, _dict.compress(_msg, _compressed));
+          _dict_size += _bytes;
+
+          BOOST_LEAF_AUTO(_decompressed_bytes,
+                          _dict.decompress(std::span(_compressed).first(_bytes), _decompressed));
+          BOOST_REQUIRE(_decompressed_bytes == _msg.size());
+          BOOST_REQUIRE(std::equal(_msg.begin(), _msg.end(), _decompressed.begin()));
+        }
+
+        std::cout << "lz4 compressed messages without dictionary: " << _plain_size
+                  << " bytes, with a dictionary of " << _trained.size()
+                  << " bytes: " << _dict_size << " bytes" << std::endl;
+        BOOST_REQUIRE(_dict_size < _plain_size);
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lz4_dict_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lz4_dict_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lz4_dict_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_lz4_encoder_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lz4_encoder_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using lz4 = wolf::system::compression::w_lz4;
+        using w_lz4_encoder = wolf::system::compression::w_lz4_encoder;
+        using w_lz4_mode = wolf::system::compression::w_lz4_mode;
+        using steady_clock = std::chrono::steady_clock;
+
+        constexpr auto _mock_compression_data =
+            "HELLO WOLF\r\nHELLO WOLF!*&%!HELLO WOLF!07*&%!\r\nThe quick "
+            "brown fox jumps over the lazy dog!";
+
+        // many medium-sized blobs
+        std::vector<std::byte> _src;
+        for (size_t i = 0; _src.size() < 16 * 1024; ++i) {
+          const auto _line = wolf::format("{} {}\n", _mock_compression_data, i);
+          const auto _bytes = std::as_bytes(std::span(_line));
+          _src.insert(_src.end(), _bytes.begin(), _bytes.end());
+        }
+
+        constexpr auto _iterations = 2000;
+
+        auto _start = steady_clock::now();
+        size_t _static_size = 0;
+        for (auto i = 0; i < _iterations; ++i) {
+          BOOST_LEAF_AUTO(_compressed, lz4::compress_fast(_src, 1));
+          _static_size = _compressed.size();
+        }
+        const auto _static_time = steady_clock::now() - _start;
+
+        auto _encoder = w_lz4_encoder();
+        BOOST_LEAF_CHECK(_encoder.init(w_lz4_mode::FAST, 1));
+
+        std::vector<std::byte> _dst(lz4::get_compress_bound(gsl::narrow_cast<int>(_src.size())));
+        _start = steady_clock::now();
+        size_t _encoder_size = 0;
+        for (auto i = 0; i < _iterations; ++i) {
+          BOOST_LEAF_ASSIGN(_encoder_size, _encoder.compress(_src, _dst));
+        }
+        const auto _encoder_time = steady_clock::now() - _start;
+        BOOST_REQUIRE(_encoder_size == _static_size);
+
+        // the high compression mode is decoded by the same decoder
+        auto _encoder_hc = w_lz4_encoder();
+        BOOST_LEAF_CHECK(_encoder_hc.init(w_lz4_mode::HC, 9));
+
+        _start = steady_clock::now();
+        BOOST_LEAF_AUTO(_compressed_hc, _encoder_hc.compress(_src));
+        const auto _hc_time = steady_clock::now() - _start;
+
+        BOOST_LEAF_AUTO(_static_hc, lz4::compress_hc(_src, 9));
+        BOOST_REQUIRE(_static_hc == _compressed_hc);
+        BOOST_REQUIRE(_compressed_hc.size() <= _encoder_size);
+
+        constexpr auto _max_retry = 10;
+        BOOST_LEAF_AUTO(_decompressed, lz4::decompress(_compressed_hc, _max_retry));
+        BOOST_REQUIRE(_decompressed == _src);
+
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+        std::cout << "lz4 " << _iterations << " x " << _src.size()
+                  << " bytes, static: " << duration_cast<microseconds>(_static_time).count()
+                  << "us, encoder: " << duration_cast<microseconds>(_encoder_time).count()
+                  << "us, fast size: " << _encoder_size << " bytes, hc size: "
+                  << _compressed_hc.size() << " bytes in "
+                  << duration_cast<microseconds>(_hc_time).count() << "us" << std::endl;
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lz4_encoder_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lz4_encoder_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lz4_encoder_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_lz4_stored_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lz4_stored_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using lz4 = wolf::system::compression::w_lz4;
+        using w_lz4_blocks = wolf::system::compression::w_lz4_blocks;
+        using w_lz4_blocks_options = wolf::system::compression::w_lz4_blocks_options;
+        using w_lz4_blocks_reader = wolf::system::compression::w_lz4_blocks_reader;
+
+        // already encoded data, such as video packets, followed by plain text
+        std::vector<std::byte> _src(1024 * 1024);
+        uint64_t _seed = 0x9E3779B97F4A7C15;
+        for (size_t i = 0; i < _src.size() / 2; ++i) {
+          _seed ^= _seed << 13;
+          _seed ^= _seed >> 7;
+          _seed ^= _seed << 17;
+          _src[i] = std::byte(_seed & 0xFF);
+        }
+        for (size_t i = _src.size() / 2; i < _src.size(); ++i) {
+          _src[i] = std::byte('a' + (i / 16) % 26);
+        }
+        const auto _noise = gsl::span<const std::byte>(_src).first(_src.size() / 2);
+
+        // an incompressible sized block never grows beyond its header
+        BOOST_LEAF_AUTO(_sized, lz4::compress_sized(_noise));
+        BOOST_REQUIRE(_sized.size() == _noise.size() + sizeof(uint32_t));
+        BOOST_LEAF_AUTO(_size, lz4::get_decompressed_size(_sized));
+        BOOST_REQUIRE(_size == _noise.size());
+        BOOST_LEAF_AUTO(_sized_decompressed, lz4::decompress_sized(_sized));
+        BOOST_REQUIRE(std::equal(_noise.begin(), _noise.end(), _sized_decompressed.begin()));
+
+        // the noisy blocks are stored and the text blocks are compressed
+        w_lz4_blocks_options _opts = {};
+        _opts.block_size = 64 * 1024;
+        BOOST_LEAF_AUTO(_blocks, w_lz4_blocks::compress(_src, _opts));
+        BOOST_REQUIRE(_blocks.size() < _src.size() / 2 + _src.size() / 16);
+        BOOST_LEAF_AUTO(_blocks_decompressed, w_lz4_blocks::decompress(_blocks));
+        BOOST_REQUIRE(_blocks_decompressed == _src);
+
+        auto _reader = w_lz4_blocks_reader();
+        BOOST_LEAF_CHECK(_reader.init(_blocks));
+        std::vector<std::byte> _range(100 * 1024);
+        for (const auto _offset : {size_t(7), _src.size() / 2 - 1000, _src.size() - 5000}) {
+          BOOST_LEAF_AUTO(_bytes, _reader.read(_offset, _range));
+          BOOST_REQUIRE(std::equal(_range.begin(), _range.begin() + _bytes,
+                                   _src.begin() + _offset));
+        }
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lz4_stored_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lz4_stored_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lz4_stored_test'" << std::endl;
+}
+
 #endif // WOLF_SYSTEM_LZ4
 
 #ifdef WOLF_SYSTEM_LZMA
@@ -94,6 +542,958 @@ BOOST_AUTO_TEST_CASE(compress_lzma_test) {
   std::cout << "leaving test case 'compress_lzma_test'" << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(compress_lzma2_mt_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lzma2_mt_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using lzma = wolf::system::compression::w_lzma;
+        using w_lzma2_options = wolf::system::compression::w_lzma2_options;
+        using steady_clock = std::chrono::steady_clock;
+
+        std::vector<std::byte> _src(16 * 1024 * 1024);
+        for (size_t i = 0; i < _src.size(); ++i) {
+          _src[i] = std::byte((i * 31 + i / 1024) & 0x3F);
+        }
+
+        w_lzma2_options _opts = {};
+        _opts.level = 5;
+        _opts.block_size = 2 * 1024 * 1024;
+        _opts.block_threads = 1;
+
+        auto _start = steady_clock::now();
+        BOOST_LEAF_AUTO(_single, lzma::compress_lzma2(_src, _opts));
+        const auto _single_time = steady_clock::now() - _start;
+
+        _opts.block_threads = 0;
+        _start = steady_clock::now();
+        BOOST_LEAF_AUTO(_parallel, lzma::compress_lzma2(_src, _opts));
+        const auto _parallel_time = steady_clock::now() - _start;
+
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        std::cout << "lzma2 compress of " << _src.size()
+                  << " bytes, single thread: " << duration_cast<milliseconds>(_single_time).count()
+                  << "ms (" << _single.size() << " bytes), all threads: "
+                  << duration_cast<milliseconds>(_parallel_time).count() << "ms ("
+                  << _parallel.size() << " bytes)" << std::endl;
+
+        // both of them are plain lzma2 streams
+        BOOST_LEAF_AUTO(_decompressed_single, lzma::decompress_lzma2(_single));
+        BOOST_REQUIRE(_decompressed_single == _src);
+
+        BOOST_LEAF_AUTO(_decompressed_parallel, lzma::decompress_lzma2(_parallel));
+        BOOST_REQUIRE(_decompressed_parallel == _src);
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lzma2_mt_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lzma2_mt_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lzma2_mt_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_lzma_stream_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lzma_stream_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using lzma = wolf::system::compression::w_lzma;
+
+        std::vector<std::byte> _src(8 * 1024 * 1024);
+        for (size_t i = 0; i < _src.size(); ++i) {
+          _src[i] = std::byte((i * 7 + i / 4096) & 0x7F);
+        }
+
+        BOOST_LEAF_AUTO(_lzma1, lzma::compress_lzma1(_src, 5));
+        BOOST_LEAF_AUTO(_lzma2, lzma::compress_lzma2(_src, 5));
+
+        // feed the compressed stream in small pieces and check every chunk of output
+        constexpr auto _chunk_size = 64 * 1024;
+        const auto _stream = [&](const std::vector<std::byte> &p_compressed, auto p_decompress)
+            -> boost::leaf::result<void> {
+          size_t _read_pos = 0;
+          size_t _write_pos = 0;
+          size_t _max_chunk = 0;
+
+          const auto _source =
+              [&](gsl::span<std::byte> p_buffer) -> boost::leaf::result<size_t> {
+            const auto _len = std::min(p_buffer.size(), p_compressed.size() - _read_pos);
+            std::copy_n(p_compressed.begin() + _read_pos, _len, p_buffer.begin());
+            _read_pos += _len;
+            return _len;
+          };
+          const auto _sink = [&](gsl::span<const std::byte> p_chunk) -> boost::leaf::result<int> {
+            BOOST_REQUIRE(std::equal(p_chunk.begin(), p_chunk.end(), _src.begin() + _write_pos));
+            _write_pos += p_chunk.size();
+            _max_chunk = std::max(_max_chunk, p_chunk.size());
+            return 0;
+          };
+
+          BOOST_LEAF_AUTO(_size, p_decompress(_source, _sink, _chunk_size));
+          BOOST_REQUIRE(_size == _src.size());
+          BOOST_REQUIRE(_write_pos == _src.size());
+          BOOST_REQUIRE(_max_chunk <= _chunk_size);
+          return {};
+        };
+
+        BOOST_LEAF_CHECK(_stream(_lzma1, [](auto &&...p_args) {
+          return lzma::decompress_lzma1(p_args...);
+        }));
+        BOOST_LEAF_CHECK(_stream(_lzma2, [](auto &&...p_args) {
+          return lzma::decompress_lzma2(p_args...);
+        }));
+
+        // a truncated stream must fail instead of returning a partial output
+        auto _truncated = _lzma2;
+        _truncated.resize(_truncated.size() / 2);
+        const auto _ret = _stream(_truncated, [](auto &&...p_args) {
+          return lzma::decompress_lzma2(p_args...);
+        });
+        BOOST_REQUIRE(!_ret);
+
+        // file to file
+        const auto _tmp = std::filesystem::temp_directory_path();
+        const auto _src_path = _tmp / "wolf_lzma_stream_test.lzma2";
+        const auto _dst_path = _tmp / "wolf_lzma_stream_test.bin";
+        {
+          std::ofstream _file(_src_path, std::ios::binary);
+          _file.write(reinterpret_cast<const char *>(_lzma2.data()),
+                      gsl::narrow_cast<std::streamsize>(_lzma2.size()));
+        }
+        BOOST_LEAF_AUTO(_file_size, lzma::decompress_lzma2_file(_src_path, _dst_path));
+        BOOST_REQUIRE(_file_size == _src.size());
+        BOOST_REQUIRE(std::filesystem::file_size(_dst_path) == _src.size());
+
+        std::filesystem::remove(_src_path);
+        std::filesystem::remove(_dst_path);
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lzma_stream_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lzma_stream_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lzma_stream_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_lzma_encoder_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lzma_encoder_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using lzma = wolf::system::compression::w_lzma;
+        using w_lzma_encoder = wolf::system::compression::w_lzma_encoder;
+        using w_lzma_decoder = wolf::system::compression::w_lzma_decoder;
+        using w_lzma2_options = wolf::system::compression::w_lzma2_options;
+        using steady_clock = std::chrono::steady_clock;
+
+        constexpr auto _mock_compression_data =
+            "HELLO WOLF\r\nHELLO WOLF!*&%!HELLO WOLF!07*&%!\r\nThe quick "
+            "brown fox jumps over the lazy dog!";
+
+        // many medium-sized blobs
+        std::vector<std::byte> _src;
+        for (size_t i = 0; _src.size() < 64 * 1024; ++i) {
+          const auto _line = wolf::format("{} {}\n", _mock_compression_data, i);
+          const auto _bytes = std::as_bytes(std::span(_line));
+          _src.insert(_src.end(), _bytes.begin(), _bytes.end());
+        }
+
+        constexpr auto _iterations = 50;
+        constexpr auto _level = 5U;
+
+        auto _start = steady_clock::now();
+        for (auto i = 0; i < _iterations; ++i) {
+          BOOST_LEAF_AUTO(_compressed, lzma::compress_lzma2(_src, _level));
+          BOOST_LEAF_AUTO(_decompressed, lzma::decompress_lzma2(_compressed));
+          BOOST_REQUIRE(_decompressed.size() == _src.size());
+        }
+        const auto _static_time = steady_clock::now() - _start;
+
+        w_lzma2_options _opts = {};
+        _opts.level = _level;
+        _opts.block_threads = 1;
+
+        auto _encoder = w_lzma_encoder();
+        BOOST_LEAF_CHECK(_encoder.init(_opts));
+        auto _decoder = w_lzma_decoder();
+        BOOST_LEAF_CHECK(_decoder.init());
+
+        // both buffers are reused, so only the first iteration allocates
+        std::vector<std::byte> _compressed(w_lzma_encoder::get_compress_bound(_src.size()));
+        std::vector<std::byte> _decompressed(_src.size());
+
+        _start = steady_clock::now();
+        size_t _compressed_size = 0;
+        for (auto i = 0; i < _iterations; ++i) {
+          BOOST_LEAF_ASSIGN(_compressed_size, _encoder.compress(_src, _compressed));
+          const auto _compressed_span =
+              gsl::span<const std::byte>(_compressed.data(), _compressed_size);
+          BOOST_LEAF_AUTO(_decompressed_size,
+                          _decoder.decompress(_compressed_span, _decompressed));
+          BOOST_REQUIRE(_decompressed_size == _src.size());
+        }
+        const auto _reused_time = steady_clock::now() - _start;
+        BOOST_REQUIRE(_decompressed == _src);
+
+        // the stream of encoder is a plain lzma2 stream
+        _compressed.resize(_compressed_size);
+        BOOST_LEAF_AUTO(_static_decompressed, lzma::decompress_lzma2(_compressed));
+        BOOST_REQUIRE(_static_decompressed == _src);
+
+        // a small destination must fail
+        std::vector<std::byte> _small(_src.size() / 2);
+        const auto _ret = _decoder.decompress(_compressed, _small);
+        BOOST_REQUIRE(!_ret);
+
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+        std::cout << "lzma2 " << _iterations << " x " << _src.size()
+                  << " bytes round trip, static: "
+                  << duration_cast<microseconds>(_static_time).count()
+                  << "us, reused encoder/decoder: "
+                  << duration_cast<microseconds>(_reused_time).count() << "us, size: "
+                  << _compressed_size << " bytes" << std::endl;
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lzma_encoder_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lzma_encoder_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lzma_encoder_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_lzma_stored_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_lzma_stored_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using lzma = wolf::system::compression::w_lzma;
+        using w_lzma_decoder = wolf::system::compression::w_lzma_decoder;
+        using w_lzma_encoder = wolf::system::compression::w_lzma_encoder;
+
+        // already encoded data, such as video packets
+        std::vector<std::byte> _noise(512 * 1024);
+        uint64_t _seed = 0x9E3779B97F4A7C15;
+        for (auto &_byte : _noise) {
+          _seed ^= _seed << 13;
+          _seed ^= _seed >> 7;
+          _seed ^= _seed << 17;
+          _byte = std::byte(_seed & 0xFF);
+        }
+
+        // the stored streams only add their headers
+        BOOST_LEAF_AUTO(_lzma1, lzma::compress_lzma1(_noise, 5));
+        BOOST_REQUIRE(_lzma1.size() == _noise.size() + 13);
+        BOOST_LEAF_AUTO(_lzma1_decompressed, lzma::decompress_lzma1(_lzma1));
+        BOOST_REQUIRE(_lzma1_decompressed == _noise);
+
+        BOOST_LEAF_AUTO(_lzma2, lzma::compress_lzma2(_noise, 5));
+        BOOST_REQUIRE(_lzma2.size() == _noise.size() + 9);
+        BOOST_LEAF_AUTO(_lzma2_decompressed, lzma::decompress_lzma2(_lzma2));
+        BOOST_REQUIRE(_lzma2_decompressed == _noise);
+
+        auto _encoder = w_lzma_encoder();
+        BOOST_LEAF_CHECK(_encoder.init());
+        BOOST_LEAF_AUTO(_encoded, _encoder.compress(_noise));
+        BOOST_REQUIRE(_encoded == _lzma2);
+
+        auto _decoder = w_lzma_decoder();
+        BOOST_LEAF_CHECK(_decoder.init());
+        BOOST_LEAF_AUTO(_decoded, _decoder.decompress(_encoded));
+        BOOST_REQUIRE(_decoded == _noise);
+
+        // the streaming decoders pass the stored payload through
+        for (const auto *_compressed : {&_lzma1, &_lzma2}) {
+          size_t _read_pos = 0;
+          std::vector<std::byte> _streamed;
+          const auto _source =
+              [&](gsl::span<std::byte> p_buffer) -> boost::leaf::result<size_t> {
+            const auto _len = std::min(p_buffer.size(), _compressed->size() - _read_pos);
+            std::copy_n(_compressed->begin() + _read_pos, _len, p_buffer.begin());
+            _read_pos += _len;
+            return _len;
+          };
+          const auto _sink = [&](gsl::span<const std::byte> p_chunk) -> boost::leaf::result<int> {
+            _streamed.insert(_streamed.end(), p_chunk.begin(), p_chunk.end());
+            return 0;
+          };
+
+          BOOST_LEAF_AUTO(_total, _compressed == &_lzma1
+                                      ? lzma::decompress_lzma1(_source, _sink, 64 * 1024)
+                                      : lzma::decompress_lzma2(_source, _sink, 64 * 1024));
+          BOOST_REQUIRE(_total == _noise.size());
+          BOOST_REQUIRE(_streamed == _noise);
+        }
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_lzma_stored_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_lzma_stored_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_lzma_stored_test'" << std::endl;
+}
+
+#endif // WOLF_SYSTEM_LZMA
+
+#ifdef WOLF_SYSTEM_ZLIB
+
+BOOST_AUTO_TEST_CASE(compress_zlib_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_zlib_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_zlib = wolf::system::compression::w_zlib;
+        using w_zlib_deflater = wolf::system::compression::w_zlib_deflater;
+        using w_zlib_format = wolf::system::compression::w_zlib_format;
+        using w_zlib_inflater = wolf::system::compression::w_zlib_inflater;
+
+        constexpr auto _mock_compression_data =
+            "HELLO WOLF\r\nHELLO WOLF!*&%!HELLO WOLF!07*&%!\r\nThe quick "
+            "brown fox jumps over the lazy dog!";
+
+        std::vector<std::byte> _src;
+        for (size_t i = 0; _src.size() < 256 * 1024; ++i) {
+          const auto _line = wolf::format("{} {}\n", _mock_compression_data, i);
+          const auto _bytes = std::as_bytes(std::span(_line));
+          _src.insert(_src.end(), _bytes.begin(), _bytes.end());
+        }
+
+        for (const auto _format : {w_zlib_format::RAW, w_zlib_format::ZLIB, w_zlib_format::GZIP}) {
+          // one-shot
+          BOOST_LEAF_AUTO(_compressed, w_zlib::compress(_src, _format, 6));
+          BOOST_REQUIRE(_compressed.size() < _src.size());
+          BOOST_LEAF_AUTO(_decompressed, w_zlib::decompress(_compressed, _format));
+          BOOST_REQUIRE(_decompressed == _src);
+
+          // streaming with a small output buffer and a flush per chunk,
+          // the same way a chunked http response is sent
+          auto _deflater = w_zlib_deflater();
+          BOOST_LEAF_CHECK(_deflater.init(_format, 6));
+
+          constexpr auto _chunk_size = size_t(16 * 1024);
+          std::vector<std::byte> _buffer(1024);
+          std::vector<std::byte> _stream;
+          for (size_t _pos = 0; _pos < _src.size(); _pos += _chunk_size) {
+            auto _chunk = gsl::span<const std::byte>(_src).subspan(
+                _pos, std::min(_chunk_size, _src.size() - _pos));
+            for (;;) {
+              BOOST_LEAF_AUTO(_progress, _deflater.update(_chunk, _buffer, true));
+              _stream.insert(_stream.end(), _buffer.begin(),
+                             _buffer.begin() + _progress.dst_written);
+              _chunk = _chunk.subspan(_progress.src_consumed);
+              if (_chunk.empty() && _progress.dst_written < _buffer.size()) {
+                break;
+              }
+            }
+          }
+          for (;;) {
+            BOOST_LEAF_AUTO(_progress, _deflater.end(_buffer));
+            _stream.insert(_stream.end(), _buffer.begin(),
+                           _buffer.begin() + _progress.dst_written);
+            if (_progress.finished) {
+              break;
+            }
+          }
+
+          // the inflater is reused for both streams
+          auto _inflater = w_zlib_inflater();
+          BOOST_LEAF_CHECK(_inflater.init(_format));
+
+          BOOST_LEAF_AUTO(_stream_decompressed, _inflater.decompress(_stream));
+          BOOST_REQUIRE(_stream_decompressed == _src);
+
+          std::vector<std::byte> _dst(_src.size());
+          BOOST_LEAF_AUTO(_size, _inflater.decompress(_compressed, _dst));
+          BOOST_REQUIRE(_size == _src.size());
+          BOOST_REQUIRE(_dst == _src);
+
+          // a truncated stream must fail
+          auto _truncated = _compressed;
+          _truncated.resize(_truncated.size() / 2);
+          const auto _ret = _inflater.decompress(_truncated);
+          BOOST_REQUIRE(!_ret);
+        }
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg = wolf::format("compress_zlib_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_zlib_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_zlib_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_zlib_throughput_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_zlib_throughput_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_zlib_deflater = wolf::system::compression::w_zlib_deflater;
+        using w_zlib_format = wolf::system::compression::w_zlib_format;
+        using w_zlib_inflater = wolf::system::compression::w_zlib_inflater;
+        using steady_clock = std::chrono::steady_clock;
+
+        constexpr auto _mock_compression_data =
+            "HELLO WOLF\r\nHELLO WOLF!*&%!HELLO WOLF!07*&%!\r\nThe quick "
+            "brown fox jumps over the lazy dog!";
+
+        std::vector<std::byte> _src;
+        for (size_t i = 0; _src.size() < 4 * 1024 * 1024; ++i) {
+          const auto _line = wolf::format("{} {}\n", _mock_compression_data, i * 7919);
+          const auto _bytes = std::as_bytes(std::span(_line));
+          _src.insert(_src.end(), _bytes.begin(), _bytes.end());
+        }
+
+        using std::chrono::duration;
+        const auto _print = [&](const std::string_view p_name, const size_t p_size,
+                                const steady_clock::duration p_compress_time,
+                                const steady_clock::duration p_decompress_time) {
+          constexpr auto _mb = 1024.0 * 1024.0;
+          const auto _src_mb = gsl::narrow_cast<double>(_src.size()) / _mb;
+          std::cout << p_name << ": ratio "
+                    << gsl::narrow_cast<double>(_src.size()) / gsl::narrow_cast<double>(p_size)
+                    << ", compress " << _src_mb / duration<double>(p_compress_time).count()
+                    << " MB/s, decompress "
+                    << _src_mb / duration<double>(p_decompress_time).count() << " MB/s"
+                    << std::endl;
+        };
+
+        auto _inflater = w_zlib_inflater();
+        BOOST_LEAF_CHECK(_inflater.init(w_zlib_format::GZIP));
+        std::vector<std::byte> _decompressed(_src.size());
+
+        for (const auto _level : {1, 6, 9}) {
+          auto _deflater = w_zlib_deflater();
+          BOOST_LEAF_CHECK(_deflater.init(w_zlib_format::GZIP, _level));
+          std::vector<std::byte> _compressed(_deflater.get_compress_bound(_src.size()));
+
+          auto _start = steady_clock::now();
+          BOOST_LEAF_AUTO(_size, _deflater.compress(_src, _compressed));
+          const auto _compress_time = steady_clock::now() - _start;
+
+          _start = steady_clock::now();
+          BOOST_LEAF_CHECK(_inflater.decompress(
+              gsl::span<const std::byte>(_compressed.data(), _size), _decompressed));
+          const auto _decompress_time = steady_clock::now() - _start;
+          BOOST_REQUIRE(_decompressed == _src);
+
+          _print(wolf::format("gzip level {}", _level), _size, _compress_time, _decompress_time);
+        }
+
+#ifdef WOLF_SYSTEM_LZ4
+        {
+          using lz4 = wolf::system::compression::w_lz4;
+          auto _start = steady_clock::now();
+          BOOST_LEAF_AUTO(_compressed, lz4::compress_sized(_src));
+          const auto _compress_time = steady_clock::now() - _start;
+
+          _start = steady_clock::now();
+          BOOST_LEAF_CHECK(lz4::decompress_into(_compressed, _decompressed));
+          const auto _decompress_time = steady_clock::now() - _start;
+          BOOST_REQUIRE(_decompressed == _src);
+
+          _print("lz4", _compressed.size(), _compress_time, _decompress_time);
+        }
+#endif // WOLF_SYSTEM_LZ4
+
+#ifdef WOLF_SYSTEM_LZMA
+        {
+          using lzma = wolf::system::compression::w_lzma;
+          auto _start = steady_clock::now();
+          BOOST_LEAF_AUTO(_compressed, lzma::compress_lzma2(_src, 5));
+          const auto _compress_time = steady_clock::now() - _start;
+
+          _start = steady_clock::now();
+          BOOST_LEAF_AUTO(_lzma_decompressed, lzma::decompress_lzma2(_compressed));
+          const auto _decompress_time = steady_clock::now() - _start;
+          BOOST_REQUIRE(_lzma_decompressed == _src);
+
+          _print("lzma2 level 5", _compressed.size(), _compress_time, _decompress_time);
+        }
 #endif // WOLF_SYSTEM_LZMA
 
-#endif // WOLF_TESTS
\ No newline at end of file
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_zlib_throughput_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_zlib_throughput_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_zlib_throughput_test'" << std::endl;
+}
+
+#endif // WOLF_SYSTEM_ZLIB
+
+#if defined(WOLF_SYSTEM_LZ4) || defined(WOLF_SYSTEM_LZMA) || defined(WOLF_SYSTEM_ZLIB)
+
+BOOST_AUTO_TEST_CASE(compress_compressor_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_compressor_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_compressor = wolf::system::compression::w_compressor;
+        using w_compressor_codec = wolf::system::compression::w_compressor_codec;
+        using w_compressor_policy = wolf::system::compression::w_compressor_policy;
+
+        constexpr auto _mock_compression_data =
+            "HELLO WOLF\r\nHELLO WOLF!*&%!HELLO WOLF!07*&%!\r\nThe quick "
+            "brown fox jumps over the lazy dog!";
+
+        std::vector<std::byte> _src;
+        for (size_t i = 0; _src.size() < 512 * 1024; ++i) {
+          const auto _line = wolf::format("{} {}\n", _mock_compression_data, i);
+          const auto _bytes = std::as_bytes(std::span(_line));
+          _src.insert(_src.end(), _bytes.begin(), _bytes.end());
+        }
+
+        // every stream is decompressed without telling the codec
+        auto _candidates = w_compressor::get_default_candidates();
+        _candidates.push_back({w_compressor_codec::STORED, 0});
+        for (const auto &_options : _candidates) {
+          BOOST_LEAF_AUTO(_compressed, w_compressor::compress(_src, _options));
+          BOOST_LEAF_AUTO(_header, w_compressor::get_header(_compressed));
+          BOOST_REQUIRE(std::get<0>(_header).codec == _options.codec);
+          BOOST_REQUIRE(std::get<1>(_header) == _src.size());
+
+          BOOST_LEAF_AUTO(_decompressed, w_compressor::decompress(_compressed));
+          BOOST_REQUIRE(_decompressed == _src);
+        }
+
+        // the encoders of each thread are reused across calls and changes of options
+        for (const auto &_options : _candidates) {
+          BOOST_LEAF_AUTO(_first, w_compressor::compress(_src, _options));
+          BOOST_LEAF_AUTO(_second, w_compressor::compress(_src, _options));
+          BOOST_REQUIRE(_first == _second);
+        }
+
+        // the levels of a codec which are probed in turn keep their own encoders, and the
+        // released encoders of a thread are created again by its next call
+        std::vector<std::vector<std::byte>> _streams;
+        for (const auto &_options : _candidates) {
+          BOOST_LEAF_AUTO(_compressed, w_compressor::compress(_src, _options));
+          _streams.push_back(std::move(_compressed));
+        }
+        w_compressor::release_thread_cache();
+        w_compressor::release_thread_cache();
+        for (size_t i = 0; i < _candidates.size(); ++i) {
+          BOOST_LEAF_AUTO(_compressed, w_compressor::compress(_src, _candidates[i]));
+          BOOST_REQUIRE(_compressed == _streams[i]);
+        }
+
+        // an empty source and a foreign stream
+        BOOST_LEAF_AUTO(_empty, w_compressor::compress({}, _candidates.front()));
+        BOOST_LEAF_AUTO(_empty_decompressed, w_compressor::decompress(_empty));
+        BOOST_REQUIRE(_empty_decompressed.empty());
+        const auto _ret = w_compressor::decompress(gsl::span(_src).first(64));
+        BOOST_REQUIRE(!_ret);
+
+        // a forged size in the header fails instead of throwing from the allocation
+        BOOST_LEAF_AUTO(_forged, w_compressor::compress(_src, _candidates.front()));
+        std::fill_n(_forged.begin() + 8, sizeof(uint64_t), std::byte(0xFF));
+        BOOST_REQUIRE(!w_compressor::decompress(_forged));
+
+        // the fastest codec is chosen when only a ratio is requested
+        w_compressor_policy _policy = {};
+        _policy.min_ratio = 2.0;
+        BOOST_LEAF_AUTO(_fast, w_compressor::select(_src, _policy));
+        BOOST_REQUIRE(_fast.ratio >= 2.0);
+
+        // the best ratio is chosen when every codec is fast enough
+        _policy.min_ratio = 0.0;
+        _policy.min_compress_mbps = 0.001;
+        BOOST_LEAF_AUTO(_small, w_compressor::select(_src, _policy));
+        BOOST_REQUIRE(_small.ratio >= _fast.ratio);
+
+        // incompressible data is stored
+        std::vector<std::byte> _noise(64 * 1024);
+        uint64_t _seed = 0x9E3779B97F4A7C15;
+        for (auto &_byte : _noise) {
+          _seed ^= _seed << 13;
+          _seed ^= _seed >> 7;
+          _seed ^= _seed << 17;
+          _byte = std::byte(_seed & 0xFF);
+        }
+        BOOST_LEAF_AUTO(_stored, w_compressor::select(_noise, _policy));
+        BOOST_REQUIRE(_stored.options.codec == w_compressor_codec::STORED);
+
+        BOOST_LEAF_AUTO(_policy_compressed, w_compressor::compress(_src, _policy));
+        BOOST_LEAF_AUTO(_policy_decompressed, w_compressor::decompress(_policy_compressed));
+        BOOST_REQUIRE(_policy_decompressed == _src);
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_compressor_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_compressor_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_compressor_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_compressor_content_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_compressor_content_benchmark_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_compressor = wolf::system::compression::w_compressor;
+        using w_compressor_policy = wolf::system::compression::w_compressor_policy;
+
+        const auto _content_path = std::filesystem::current_path().append("../../content");
+        if (!std::filesystem::exists(_content_path)) {
+          std::cout << "could not find the content folder, skipping" << std::endl;
+          return {};
+        }
+
+        // a throughput target which rules out the slow codecs
+        w_compressor_policy _policy = {};
+        _policy.min_compress_mbps = 50.0;
+
+        for (const auto &_entry : std::filesystem::recursive_directory_iterator(_content_path)) {
+          if (!_entry.is_regular_file()) {
+            continue;
+          }
+
+          std::ifstream _file(_entry.path(), std::ios::binary);
+          std::vector<std::byte> _data(gsl::narrow_cast<size_t>(_entry.file_size()));
+          _file.read(reinterpret_cast<char *>(_data.data()),
+                     gsl::narrow_cast<std::streamsize>(_data.size()));
+
+          std::cout << _entry.path().filename().string() << " (" << _data.size() << " bytes)"
+                    << std::endl;
+
+          BOOST_LEAF_AUTO(_stats, w_compressor::measure(_data));
+          for (const auto &_stat : _stats) {
+            std::cout << "  codec " << static_cast<int>(_stat.options.codec) << " level "
+                      << _stat.options.level << ": ratio " << _stat.ratio << ", compress "
+                      << _stat.compress_mbps << " MB/s, decompress " << _stat.decompress_mbps
+                      << " MB/s" << std::endl;
+          }
+
+          BOOST_LEAF_AUTO(_chosen, w_compressor::select(_data, _policy));
+          std::cout << "  chosen for " << _policy.min_compress_mbps << " MB/s: codec "
+                    << static_cast<int>(_chosen.options.codec) << " level "
+                    << _chosen.options.level << std::endl;
+
+          BOOST_LEAF_AUTO(_compressed, w_compressor::compress(_data, _chosen.options));
+          BOOST_LEAF_AUTO(_decompressed, w_compressor::decompress(_compressed));
+          BOOST_REQUIRE(_decompressed == _data);
+        }
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg = wolf::format(
+            "compress_compressor_content_benchmark_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_compressor_content_benchmark_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_compressor_content_benchmark_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_container_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_container_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_checksum = wolf::system::compression::w_checksum;
+        using w_checksum_type = wolf::system::compression::w_checksum_type;
+        using w_compressor = wolf::system::compression::w_compressor;
+        using w_compressor_container_options =
+            wolf::system::compression::w_compressor_container_options;
+
+        // the check values of both checksums
+        const auto _check = std::string_view("123456789");
+        const auto _check_bytes = gsl::span(reinterpret_cast<const std::byte *>(_check.data()),
+                                            _check.size());
+        BOOST_REQUIRE(w_checksum::crc32c(_check_bytes) == 0xE3069283);
+        BOOST_REQUIRE(w_checksum::crc32c(_check_bytes.subspan(4),
+                                         w_checksum::crc32c(_check_bytes.first(4))) ==
+                      0xE3069283);
+        BOOST_REQUIRE(w_checksum::xxh64({}) == 0xEF46DB3751D8E999);
+        const auto _abc = std::string_view("abc");
+        BOOST_REQUIRE(w_checksum::xxh64(gsl::span(reinterpret_cast<const std::byte *>(_abc.data()),
+                                                  _abc.size())) == 0x44BC2CF5AD770999);
+
+        std::vector<std::byte> _src(3 * 1024 * 1024 + 123);
+        for (size_t i = 0; i < _src.size(); ++i) {
+          _src[i] = gsl::narrow_cast<std::byte>((i / 64) % 251);
+        }
+
+        for (const auto _checksum :
+             {w_checksum_type::NONE, w_checksum_type::CRC32C, w_checksum_type::XXH64}) {
+          for (const auto &_candidate : w_compressor::get_default_candidates()) {
+            w_compressor_container_options _options = {};
+            _options.options = _candidate;
+            _options.block_size = 256 * 1024;
+            _options.checksum = _checksum;
+
+            BOOST_LEAF_AUTO(_compressed, w_compressor::compress_container(_src, _options));
+            BOOST_LEAF_AUTO(_blocks, w_compressor::verify_container(_compressed));
+            BOOST_REQUIRE(_blocks == 13);
+
+            BOOST_LEAF_AUTO(_decompressed, w_compressor::decompress_container(_compressed));
+            BOOST_REQUIRE(_decompressed == _src);
+
+            if (_checksum == w_checksum_type::NONE) {
+              continue;
+            }
+
+            // flip a byte of the last block, it must be detected before decoding
+            auto _corrupted = _compressed;
+            _corrupted[_corrupted.size() - 2] ^= std::byte(0x20);
+            BOOST_REQUIRE(!w_compressor::verify_container(_corrupted));
+            BOOST_REQUIRE(!w_compressor::decompress_container(_corrupted));
+
+            // the header is always protected
+            _corrupted = _compressed;
+            _corrupted[10] ^= std::byte(0x01);
+            BOOST_REQUIRE(!w_compressor::verify_container(_corrupted));
+          }
+        }
+
+        // an empty source has no block
+        BOOST_LEAF_AUTO(_empty, w_compressor::compress_container({}, {}));
+        BOOST_LEAF_AUTO(_empty_blocks, w_compressor::verify_container(_empty));
+        BOOST_REQUIRE(_empty_blocks == 0);
+
+        // a forged size under a valid crc of header fails instead of throwing
+        auto _forged = _empty;
+        std::fill_n(_forged.begin() + 8, sizeof(uint64_t), std::byte(0xFF));
+        const auto _crc = w_checksum::crc32c(gsl::span(_forged).first(24));
+        for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+          _forged[24 + i] = std::byte((_crc >> (i * 8)) & 0xFF);
+        }
+        BOOST_REQUIRE(!w_compressor::verify_container(_forged));
+        BOOST_REQUIRE(!w_compressor::decompress_container(_forged));
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_container_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_container_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_container_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_container_checksum_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_container_checksum_benchmark_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using steady_clock = std::chrono::steady_clock;
+        using w_checksum = wolf::system::compression::w_checksum;
+        using w_checksum_type = wolf::system::compression::w_checksum_type;
+        using w_compressor = wolf::system::compression::w_compressor;
+        using w_compressor_container_options =
+            wolf::system::compression::w_compressor_container_options;
+
+        constexpr auto _mb = 1024.0 * 1024.0;
+        constexpr auto _repeat = 8;
+
+        std::vector<std::byte> _src(16 * 1024 * 1024);
+        for (size_t i = 0; i < _src.size(); ++i) {
+          _src[i] = gsl::narrow_cast<std::byte>((i * 31 + i / 4096) % 253);
+        }
+
+        std::cout << "hardware crc32c: " << std::boolalpha << w_checksum::has_hardware_crc32c()
+                  << std::endl;
+
+        for (const auto _checksum : {w_checksum_type::CRC32C, w_checksum_type::XXH64}) {
+          uint32_t _value = 0;
+          const auto _start = steady_clock::now();
+          for (auto i = 0; i < _repeat; ++i) {
+            _value += w_checksum::calculate(_src, _checksum);
+          }
+          const auto _seconds = std::chrono::duration<double>(steady_clock::now() - _start);
+          std::cout << "checksum " << static_cast<int>(_checksum) << ": "
+                    << _repeat * gsl::narrow_cast<double>(_src.size()) / _mb / _seconds.count()
+                    << " MB/s (" << _value << ")" << std::endl;
+        }
+
+        // the overhead of verification on the fastest codec
+        const auto _candidates = w_compressor::get_default_candidates();
+        BOOST_REQUIRE(!_candidates.empty());
+
+        std::vector<std::byte> _dst(_src.size());
+        for (const auto _checksum :
+             {w_checksum_type::NONE, w_checksum_type::CRC32C, w_checksum_type::XXH64}) {
+          w_compressor_container_options _options = {};
+          _options.options = _candidates.front();
+          _options.checksum = _checksum;
+
+          BOOST_LEAF_AUTO(_compressed, w_compressor::compress_container(_src, _options));
+
+          const auto _start = steady_clock::now();
+          for (auto i = 0; i < _repeat; ++i) {
+            BOOST_LEAF_CHECK(w_compressor::decompress_container(_compressed, _dst));
+          }
+          const auto _seconds = std::chrono::duration<double>(steady_clock::now() - _start);
+          std::cout << "decompress codec " << static_cast<int>(_options.options.codec)
+                    << " with checksum " << static_cast<int>(_checksum) << ": "
+                    << _repeat * gsl::narrow_cast<double>(_src.size()) / _mb / _seconds.count()
+                    << " MB/s" << std::endl;
+          BOOST_REQUIRE(_dst == _src);
+        }
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg = wolf::format(
+            "compress_container_checksum_benchmark_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_container_checksum_benchmark_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_container_checksum_benchmark_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(compress_entropy_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'compress_entropy_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using steady_clock = std::chrono::steady_clock;
+        using w_compressor = wolf::system::compression::w_compressor;
+        using w_compressor_container_options =
+            wolf::system::compression::w_compressor_container_options;
+        using w_entropy = wolf::system::compression::w_entropy;
+
+        std::vector<std::byte> _noise(4 * 1024 * 1024);
+        uint64_t _seed = 0x9E3779B97F4A7C15;
+        for (auto &_byte : _noise) {
+          _seed ^= _seed << 13;
+          _seed ^= _seed >> 7;
+          _seed ^= _seed << 17;
+          _byte = std::byte(_seed & 0xFF);
+        }
+
+        std::vector<std::byte> _text;
+        for (size_t i = 0; _text.size() < _noise.size(); ++i) {
+          const auto _line = wolf::format("{{\"id\": {}, \"cmd\": \"move\", \"x\": {}}}\n", i,
+                                          i * 7 % 1000);
+          const auto _bytes = std::as_bytes(std::span(_line));
+          _text.insert(_text.end(), _bytes.begin(), _bytes.end());
+        }
+
+        // every byte value is equally likely, but the sequence repeats
+        std::vector<std::byte> _ramp(_noise.size());
+        for (size_t i = 0; i < _ramp.size(); ++i) {
+          _ramp[i] = std::byte(i & 0xFF);
+        }
+
+        const auto _noise_estimate = w_entropy::estimate(_noise);
+        const auto _text_estimate = w_entropy::estimate(_text);
+        const auto _ramp_estimate = w_entropy::estimate(_ramp);
+        std::cout << "noise: " << _noise_estimate.bits_per_byte << " bits, "
+                  << _noise_estimate.match_ratio << " matches, text: "
+                  << _text_estimate.bits_per_byte << " bits, " << _text_estimate.match_ratio
+                  << " matches, ramp: " << _ramp_estimate.bits_per_byte << " bits, "
+                  << _ramp_estimate.match_ratio << " matches" << std::endl;
+
+        BOOST_REQUIRE(!w_entropy::is_compressible(_noise));
+        BOOST_REQUIRE(w_entropy::is_compressible(_text));
+        BOOST_REQUIRE(w_entropy::is_compressible(_ramp));
+        BOOST_REQUIRE(w_entropy::is_compressible(std::vector<std::byte>(4096)));
+        BOOST_REQUIRE(w_entropy::is_compressible(gsl::span(_noise).first(16)));
+
+        // the estimate only reads a sample, so it does not depend on the size of source
+        constexpr auto _iterations = 1000;
+        auto _start = steady_clock::now();
+        for (auto i = 0; i < _iterations; ++i) {
+          BOOST_REQUIRE(!w_entropy::is_compressible(_noise));
+        }
+        const auto _estimate_time = std::chrono::duration<double>(steady_clock::now() - _start);
+        std::cout << "estimate of " << _noise.size() << " bytes: "
+                  << _estimate_time.count() * 1e6 / _iterations << "us" << std::endl;
+
+        // a mixed stream, the noisy blocks skip the codec
+        std::vector<std::byte> _mixed = _noise;
+        _mixed.insert(_mixed.end(), _text.begin(), _text.end());
+
+        const auto _candidates = w_compressor::get_default_candidates();
+        BOOST_REQUIRE(!_candidates.empty());
+        for (const auto _skip : {false, true}) {
+          w_compressor_container_options _options = {};
+          _options.options = _candidates.back();
+          _options.block_size = 256 * 1024;
+          _options.skip_incompressible = _skip;
+
+          _start = steady_clock::now();
+          BOOST_LEAF_AUTO(_compressed, w_compressor::compress_container(_mixed, _options));
+          const auto _time = std::chrono::duration<double>(steady_clock::now() - _start);
+
+          BOOST_LEAF_AUTO(_decompressed, w_compressor::decompress_container(_compressed));
+          BOOST_REQUIRE(_decompressed == _mixed);
+          // a stored block costs only its block header
+          BOOST_REQUIRE(_compressed.size() < _noise.size() + _text.size() / 2);
+
+          std::cout << "container of codec " << static_cast<int>(_options.options.codec)
+                    << " level " << _options.options.level << ", skip incompressible " << _skip
+                    << ": " << _compressed.size() << " bytes in " << _time.count() * 1000.0
+                    << "ms" << std::endl;
+        }
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg =
+            wolf::format("compress_entropy_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("compress_entropy_test got an error!"); });
+
+  std::cout << "leaving test case 'compress_entropy_test'" << std::endl;
+}
+
+#endif // WOLF_SYSTEM_LZ4 || WOLF_SYSTEM_LZMA || WOLF_SYSTEM_ZLIB
+
+#endif // WOLF_TESTS
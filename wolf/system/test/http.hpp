@@ -0,0 +1,279 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#if defined(WOLF_TEST) && defined(WOLF_SYSTEM_SOCKET) && defined(WOLF_SYSTEM_HTTP_WS)
+
+#include <boost/test/included/unit_test.hpp>
+#include <system/w_leak_detector.hpp>
+#include <wolf/wolf.hpp>
+
+#include <system/socket/w_http_server.hpp>
+
+#ifdef WOLF_STREAM_HTTP
+#include <filesystem>
+#include <fstream>
+#include <stream/http/w_http_server.hpp>
+#endif
+
+BOOST_AUTO_TEST_CASE(http_server_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'http_server_test'" << std::endl;
+
+  using tcp = boost::asio::ip::tcp;
+  using w_http_options = wolf::system::socket::w_http_options;
+  using w_http_request = wolf::system::socket::w_http_request;
+  using w_http_response = wolf::system::socket::w_http_response;
+  using w_http_routes = wolf::system::socket::w_http_routes;
+  using w_http_server = wolf::system::socket::w_http_server;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  namespace http = boost::beast::http;
+  using namespace std::chrono_literals;
+
+  constexpr auto _port = uint16_t(8097);
+
+  auto _routes = w_http_routes{};
+  BOOST_REQUIRE(!_routes
+                     .add(http::verb::get, "/hello",
+                          [](const std::string &p_conn_id, const w_http_request &p_request,
+                             w_http_response &p_response) { p_response.body() = "hello"; })
+                     .has_error());
+  BOOST_REQUIRE(!_routes
+                     .add(http::verb::post, "/echo",
+                          [](const std::string &p_conn_id, const w_http_request &p_request,
+                             w_http_response &p_response) {
+                            p_response.body() = p_request.body();
+                          })
+                     .has_error());
+  BOOST_REQUIRE(!_routes
+                     .add(http::verb::get, "/static/*",
+                          [](const std::string &p_conn_id, const w_http_request &p_request,
+                             w_http_response &p_response) {
+                            p_response.body() = std::string(p_request.target());
+                          })
+                     .has_error());
+  BOOST_REQUIRE(_routes
+                    .add(http::verb::get, "/hello",
+                         [](const std::string &p_conn_id, const w_http_request &p_request,
+                            w_http_response &p_response) {})
+                    .has_error());
+
+  auto _http_options = w_http_options{};
+  _http_options.body_limit = 1024;
+
+  auto _io = boost::asio::io_context();
+  const auto _res = w_http_server::run(
+      _io, tcp::endpoint(tcp::v4(), _port), 10s, w_socket_options{},
+      std::move(_http_options), std::move(_routes),
+      [](const std::string &p_conn_id, const boost::system::system_error &p_error) {
+        std::cout << "http server got an error: " << p_error.what() << std::endl;
+      });
+  BOOST_REQUIRE(_res.has_error() == false);
+  auto _server = std::jthread([&]() { _io.run(); });
+  // wait for the acceptor
+  std::this_thread::sleep_for(200ms);
+
+  tcp::socket _socket(_io);
+  _socket.connect(tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), _port));
+
+  // three pipelined requests in one write are answered in order on the same connection
+  const auto _pipelined = std::string("GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                                      "POST /echo HTTP/1.1\r\nHost: localhost\r\n"
+                                      "Content-Length: 4\r\n\r\nwolf"
+                                      "GET /static/a.txt?v=1 HTTP/1.1\r\nHost: localhost\r\n\r\n");
+  boost::asio::write(_socket, boost::asio::buffer(_pipelined));
+
+  boost::beast::flat_buffer _buffer;
+  const auto _read = [&]() {
+    http::response<http::string_body> _response;
+    http::read(_socket, _buffer, _response);
+    return _response;
+  };
+
+  auto _response = _read();
+  BOOST_REQUIRE(_response.result() == http::status::ok);
+  BOOST_REQUIRE(_response.body() == "hello");
+  BOOST_REQUIRE(_response.keep_alive());
+  BOOST_REQUIRE(_read().body() == "wolf");
+  BOOST_REQUIRE(_read().body() == "/static/a.txt?v=1");
+
+  boost::asio::write(_socket,
+                     boost::asio::buffer(std::string_view(
+                         "GET /missing HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                         "DELETE /hello HTTP/1.1\r\nHost: localhost\r\n\r\n")));
+  BOOST_REQUIRE(_read().result() == http::status::not_found);
+  BOOST_REQUIRE(_read().result() == http::status::method_not_allowed);
+
+  // a body over the limit is refused and the connection is closed
+  boost::asio::write(_socket, boost::asio::buffer(std::string_view(
+                                  "POST /echo HTTP/1.1\r\nHost: localhost\r\n"
+                                  "Content-Length: 4096\r\n\r\n")));
+  _response = _read();
+  BOOST_REQUIRE(_response.result() == http::status::payload_too_large);
+  BOOST_REQUIRE(!_response.keep_alive());
+
+  boost::system::error_code _error;
+  http::response<http::string_body> _closed;
+  http::read(_socket, _buffer, _closed, _error);
+  BOOST_REQUIRE(_error == http::error::end_of_stream);
+
+  _io.stop();
+
+  std::cout << "leaving test case 'http_server_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(http_server_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'http_server_benchmark_test'" << std::endl;
+
+  using tcp = boost::asio::ip::tcp;
+  using w_http_options = wolf::system::socket::w_http_options;
+  using w_http_request = wolf::system::socket::w_http_request;
+  using w_http_response = wolf::system::socket::w_http_response;
+  using w_http_routes = wolf::system::socket::w_http_routes;
+  using w_http_server = wolf::system::socket::w_http_server;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  namespace http = boost::beast::http;
+  using namespace std::chrono_literals;
+
+  constexpr auto _port = uint16_t(8098);
+  constexpr auto _connections = size_t(8);
+  constexpr auto _duration = 2s;
+  const auto _body = std::string(128, 'w');
+  const auto _cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+  // like wrk, each connection keeps sending requests and waits for their responses
+  const auto _load = [&](_In_ const uint16_t p_port, _In_ const std::string_view p_target,
+                         _In_ const size_t p_depth) {
+    std::atomic<size_t> _requests = 0;
+    std::mutex _latencies_mutex;
+    std::vector<double> _latencies;
+    const auto _deadline = std::chrono::steady_clock::now() + _duration;
+    {
+      std::vector<std::jthread> _threads;
+      for (size_t i = 0; i < _connections; ++i) {
+        _threads.emplace_back([&]() {
+          try {
+            boost::asio::io_context _io;
+            tcp::socket _socket(_io);
+            _socket.connect(tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), p_port));
+            _socket.set_option(tcp::no_delay(true));
+
+            std::string _batch;
+            for (size_t j = 0; j < p_depth; ++j) {
+              _batch += wolf::format("GET {} HTTP/1.1\r\nHost: localhost\r\n\r\n", p_target);
+            }
+
+            boost::beast::flat_buffer _buffer;
+            std::vector<double> _thread_latencies;
+            while (std::chrono::steady_clock::now() < _deadline) {
+              const auto _start = std::chrono::steady_clock::now();
+              boost::asio::write(_socket, boost::asio::buffer(_batch));
+              for (size_t j = 0; j < p_depth; ++j) {
+                http::response<http::string_body> _response;
+                http::read(_socket, _buffer, _response);
+              }
+              _thread_latencies.push_back(
+                  std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                            _start)
+                      .count());
+              _requests += p_depth;
+            }
+
+            const auto _lock = std::scoped_lock(_latencies_mutex);
+            _latencies.insert(_latencies.end(), _thread_latencies.begin(),
+                              _thread_latencies.end());
+          } catch (const std::exception &p_ex) {
+            std::cout << "benchmark client got an error: " << p_ex.what() << std::endl;
+          }
+        });
+      }
+    }
+
+    std::sort(_latencies.begin(), _latencies.end());
+    const auto _percentile = [&](_In_ const double p_percent) {
+      return _latencies.empty()
+                 ? 0.0
+                 : _latencies[gsl::narrow_cast<size_t>(p_percent *
+                                                       gsl::narrow_cast<double>(
+                                                           _latencies.size() - 1))];
+    };
+    const auto _seconds = std::chrono::duration<double>(_duration).count();
+    return std::make_tuple(gsl::narrow_cast<double>(_requests.load()) / _seconds,
+                           _percentile(0.5), _percentile(0.99));
+  };
+
+  // the http server of socket with one reactor per core
+  {
+    auto _routes = w_http_routes{};
+    BOOST_REQUIRE(!_routes
+                       .add(http::verb::get, "/hello.txt",
+                            [&](const std::string &p_conn_id, const w_http_request &p_request,
+                                w_http_response &p_response) {
+                              p_response.set(http::field::content_type, "text/plain");
+                              p_response.body() = _body;
+                            })
+                       .has_error());
+
+    std::stop_source _stop = {};
+    auto _server_failed = false;
+    auto _server = std::jthread([&]() {
+      const auto _res = w_http_server::run(
+          {_cores, true}, _stop.get_token(), tcp::endpoint(tcp::v4(), _port), 10s,
+          w_socket_options{}, w_http_options{}, std::move(_routes),
+          [](const std::string &p_conn_id, const boost::system::system_error &p_error) {});
+      // checked on the main thread after join
+      _server_failed = _res.has_error();
+    });
+    // wait for the acceptors
+    std::this_thread::sleep_for(500ms);
+
+    for (const auto _depth : {size_t(1), size_t(16)}) {
+      const auto [_rps, _p50, _p99] = _load(_port, "/hello.txt", _depth);
+      std::cout << wolf::format("socket http server with {} reactors, {} connections, "
+                                "pipeline {}: {:.0f} requests/sec, latency p50 {:.0f} us, "
+                                "p99 {:.0f} us",
+                                _cores, _connections, _depth, _rps, _p50, _p99)
+                << std::endl;
+      BOOST_REQUIRE(_rps != 0);
+    }
+
+    _stop.request_stop();
+    _server.join();
+    BOOST_REQUIRE(!_server_failed);
+  }
+
+#ifdef WOLF_STREAM_HTTP
+  // the http server of stream, which serves the same body from a file
+  {
+    const auto _root = std::filesystem::temp_directory_path() / "wolf_http_benchmark";
+    std::filesystem::create_directories(_root);
+    std::ofstream(_root / "hello.txt", std::ios::binary) << _body;
+
+    {
+      const auto _server = wolf::stream::http::w_http_server(
+          {"document_root", _root.string(), "listening_ports", std::to_string(_port + 1),
+           "enable_keep_alive", "yes", "num_threads", std::to_string(_cores * 2)},
+          nullptr);
+
+      for (const auto _depth : {size_t(1), size_t(16)}) {
+        const auto [_rps, _p50, _p99] =
+            _load(gsl::narrow_cast<uint16_t>(_port + 1), "/hello.txt", _depth);
+        std::cout << wolf::format("stream http server with {} threads, {} connections, "
+                                  "pipeline {}: {:.0f} requests/sec, latency p50 {:.0f} us, "
+                                  "p99 {:.0f} us",
+                                  _cores * 2, _connections, _depth, _rps, _p50, _p99)
+                  << std::endl;
+      }
+    }
+    std::filesystem::remove_all(_root);
+  }
+#endif
+
+  std::cout << "leaving test case 'http_server_benchmark_test'" << std::endl;
+}
+
+#endif // defined(WOLF_TEST) && defined(WOLF_SYSTEM_SOCKET) && defined(WOLF_SYSTEM_HTTP_WS)
@@ -0,0 +1,15 @@
+#!/bin/sh
+# build the tests with the epoll and io_uring backends and run the socket benchmarks of both,
+# tcp.hpp and udp.hpp must be included by tests.cpp
+set -e
+SOURCE_DIR=$(cd "$(dirname "$0")/../../.." && pwd)
+BENCHMARKS=tcp_server_reactors_benchmark_test,udp_batch_benchmark_test
+
+for BACKEND in epoll io_uring; do
+    if [ "$BACKEND" = "io_uring" ]; then IO_URING=ON; else IO_URING=OFF; fi
+    BUILD_DIR="$SOURCE_DIR/build/benchmark-$BACKEND"
+    cmake -S "$SOURCE_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release -DWOLF_TEST=ON \
+        -DWOLF_SYSTEM_SOCKET=ON -DWOLF_SYSTEM_SOCKET_IO_URING=$IO_URING
+    cmake --build "$BUILD_DIR" --target wolf_tests
+    "$(find "$BUILD_DIR" -type f -name wolf_tests | head -n 1)" --run_test=$BENCHMARKS
+done
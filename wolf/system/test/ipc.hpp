@@ -0,0 +1,344 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#if defined(WOLF_TEST) && defined(WOLF_SYSTEM_IPC)
+
+#include <boost/test/included/unit_test.hpp>
+#include <system/w_leak_detector.hpp>
+#include <wolf.hpp>
+
+#include <system/ipc/w_shm_channel.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <sys/wait.h>
+#include <unistd.h>
+
+BOOST_AUTO_TEST_CASE(ipc_shm_channel_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'ipc_shm_channel_test'" << std::endl;
+
+  using w_shm_channel = wolf::system::ipc::w_shm_channel;
+  using w_shm_channel_options = wolf::system::ipc::w_shm_channel_options;
+  using w_shm_channel_reader = wolf::system::ipc::w_shm_channel_reader;
+  using namespace std::chrono_literals;
+
+  auto _options = w_shm_channel_options{};
+  _options.capacity = 3000;
+  _options.max_readers = 2;
+  _options.spin = 16;
+
+  auto _created = w_shm_channel::create("wolf_ipc_test", _options);
+  BOOST_REQUIRE(!_created.has_error());
+  auto _channel = std::move(_created.value());
+  BOOST_REQUIRE(_channel.get_capacity() == 4096);
+  BOOST_REQUIRE(_channel.get_max_record_size() == 2040);
+  BOOST_REQUIRE(_channel.reserve(2041, 0s).has_error());
+
+  // the size of a record is 32 bits, so the ring is at most 4 GiB
+  auto _huge = _options;
+  _huge.capacity = (size_t(1) << 32) + 1;
+  BOOST_REQUIRE(w_shm_channel::create("wolf_ipc_huge", _huge).has_error());
+
+  // without readers nothing waits
+  const auto _record = std::vector<std::byte>(1000, std::byte{'w'});
+  for (size_t i = 0; i < 10; ++i) {
+    auto _written = _channel.write(_record, 0s);
+    BOOST_REQUIRE(!_written.has_error() && _written.value());
+  }
+
+  // a second mapping of the descriptor, like a consumer process does
+  auto _opened = w_shm_channel::open(_channel.get_fd());
+  BOOST_REQUIRE(!_opened.has_error());
+  auto _mapping = std::move(_opened.value());
+
+  auto _first = w_shm_channel_reader(_channel);
+  auto _second = w_shm_channel_reader(_mapping);
+  auto _third = w_shm_channel_reader(_mapping);
+  BOOST_REQUIRE(!_first.attach().has_error());
+  BOOST_REQUIRE(!_second.attach().has_error());
+  BOOST_REQUIRE(_third.attach().has_error());
+  BOOST_REQUIRE(_channel.get_reader_count() == 2);
+
+  auto _empty = _first.read(1ms);
+  BOOST_REQUIRE(!_empty.has_error() && !_empty.value().has_value());
+
+  // records of every size wrap around the ring many times, each reader gets all of them
+  for (size_t i = 0; i < 1000; ++i) {
+    const auto _size = (i * 37) % 1500;
+    auto _room = _channel.reserve(_size, 1s);
+    BOOST_REQUIRE(!_room.has_error() && _room.value().has_value());
+    std::memset(_room.value()->data(), gsl::narrow_cast<int>(i & 0xff), _size);
+    BOOST_REQUIRE(!_channel.commit().has_error());
+
+    for (auto *_reader : {&_first, &_second}) {
+      auto _read = _reader->read(1s);
+      BOOST_REQUIRE(!_read.has_error() && _read.value().has_value());
+      const auto _view = _read.value().value();
+      BOOST_REQUIRE(_view.size() == _size);
+      BOOST_REQUIRE(std::all_of(_view.begin(), _view.end(), [&](std::byte p_byte) {
+        return p_byte == std::byte(i & 0xff);
+      }));
+      _reader->consume();
+    }
+  }
+
+  // the producer waits for the slowest reader, and goes on when it detached
+  _second.detach();
+  _first.consume();
+  size_t _count = 0;
+  for (;;) {
+    auto _written = _channel.write(_record, 10ms);
+    BOOST_REQUIRE(!_written.has_error());
+    if (!_written.value()) {
+      break;
+    }
+    ++_count;
+  }
+  BOOST_REQUIRE(_count >= 3 && _count <= 4);
+  for (size_t i = 0; i < _count; ++i) {
+    auto _read = _first.read(0s);
+    BOOST_REQUIRE(!_read.has_error() && _read.value().has_value());
+  }
+  _first.detach();
+  BOOST_REQUIRE(_channel.get_reader_count() == 0);
+  BOOST_REQUIRE(_channel.write(_record, 0s).value());
+
+  // the reader of a dead process is evicted by the waiting producer
+  const auto _pid = ::fork();
+  BOOST_REQUIRE(_pid != -1);
+  if (_pid == 0) {
+    auto _orphan = w_shm_channel_reader(_mapping);
+    ::_exit(_orphan.attach().has_error() ? 1 : 0);
+  }
+  int _status = 0;
+  BOOST_REQUIRE(::waitpid(_pid, &_status, 0) == _pid && WEXITSTATUS(_status) == 0);
+  BOOST_REQUIRE(_channel.get_reader_count() == 1);
+  for (size_t i = 0; i < 10; ++i) {
+    BOOST_REQUIRE(_channel.write(_record, 1s).value());
+  }
+  BOOST_REQUIRE(_channel.get_reader_count() == 0);
+
+  // a reader which lives on after the process which attached it died is evicted too, and
+  // finds out on its next read
+  std::array<int, 2> _go = {-1, -1};
+  std::array<int, 2> _report = {-1, -1};
+  BOOST_REQUIRE(::pipe(_go.data()) == 0 && ::pipe(_report.data()) == 0);
+  const auto _parent = ::fork();
+  BOOST_REQUIRE(_parent != -1);
+  if (_parent == 0) {
+    auto _survivor = w_shm_channel_reader(_mapping);
+    if (_survivor.attach().has_error() || ::fork() != 0) {
+      ::_exit(0);
+    }
+    char _byte = 0;
+    std::ignore = ::read(_go[0], &_byte, 1);
+    auto _read = _survivor.read(0s);
+    _byte = _read.has_error() ? 'e' : 'r';
+    ::_exit(::write(_report[1], &_byte, 1) == 1 ? 0 : 1);
+  }
+  BOOST_REQUIRE(::waitpid(_parent, &_status, 0) == _parent);
+  BOOST_REQUIRE(_channel.get_reader_count() == 1);
+  for (size_t i = 0; i < 10; ++i) {
+    BOOST_REQUIRE(_channel.write(_record, 1s).value());
+  }
+  BOOST_REQUIRE(_channel.get_reader_count() == 0);
+  char _result = 0;
+  BOOST_REQUIRE(::write(_go[1], "g", 1) == 1 && ::read(_report[0], &_result, 1) == 1);
+  BOOST_REQUIRE(_result == 'e');
+  for (const auto _fd : {_go[0], _go[1], _report[0], _report[1]}) {
+    ::close(_fd);
+  }
+
+  // a live pid which another process reused is not the reader, which is told apart by the
+  // start time of its process. the first slot follows the header of 256 bytes, and its start
+  // time follows the position, the state and the pid
+  auto _reused = w_shm_channel_reader(_mapping);
+  BOOST_REQUIRE(!_reused.attach().has_error());
+  const auto _start_time = uint64_t(1);
+  BOOST_REQUIRE(::pwrite(_channel.get_fd(), &_start_time, sizeof(_start_time), 256 + 16) ==
+                ssize_t(sizeof(_start_time)));
+  for (size_t i = 0; i < 10; ++i) {
+    BOOST_REQUIRE(_channel.write(_record, 1s).value());
+  }
+  BOOST_REQUIRE(_channel.get_reader_count() == 0);
+  BOOST_REQUIRE(_reused.read(0s).has_error());
+
+  // a named segment
+  const auto _name = "/wolf_ipc_test_" + std::to_string(::getpid());
+  auto _named = w_shm_channel::create(_name, _options, true);
+  BOOST_REQUIRE(!_named.has_error());
+  BOOST_REQUIRE(w_shm_channel::create(_name, _options, true).has_error());
+  auto _named_mapping = w_shm_channel::open(std::string_view(_name));
+  BOOST_REQUIRE(!_named_mapping.has_error());
+  BOOST_REQUIRE(_named_mapping.value().get_capacity() == 4096);
+  BOOST_REQUIRE(!w_shm_channel::unlink(_name).has_error());
+  BOOST_REQUIRE(w_shm_channel::open(std::string_view(_name)).has_error());
+
+  // a forged number of readers, whose slots would overflow into the ring, is rejected. it
+  // follows the magic, the version, the spin and the capacity in the header
+  auto _forged = w_shm_channel::create("wolf_ipc_forged", _options);
+  BOOST_REQUIRE(!_forged.has_error());
+  BOOST_REQUIRE(!w_shm_channel::open(_forged.value().get_fd()).has_error());
+  const auto _max_readers = std::numeric_limits<uint64_t>::max() / 64 + 2;
+  BOOST_REQUIRE(::pwrite(_forged.value().get_fd(), &_max_readers, sizeof(_max_readers), 24) ==
+                ssize_t(sizeof(_max_readers)));
+  BOOST_REQUIRE(w_shm_channel::open(_forged.value().get_fd()).has_error());
+
+  auto _many = _options;
+  _many.max_readers = std::numeric_limits<size_t>::max() / 64 + 2;
+  BOOST_REQUIRE(w_shm_channel::create("wolf_ipc_many", _many).has_error());
+
+  std::cout << "leaving test case 'ipc_shm_channel_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(ipc_shm_channel_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'ipc_shm_channel_benchmark_test'" << std::endl;
+
+  using w_shm_channel = wolf::system::ipc::w_shm_channel;
+  using w_shm_channel_options = wolf::system::ipc::w_shm_channel_options;
+  using w_shm_channel_reader = wolf::system::ipc::w_shm_channel_reader;
+  using namespace std::chrono_literals;
+
+  constexpr auto _readers = size_t(2);
+  constexpr auto _frame_size = size_t(1024 * 1024);
+  constexpr auto _frames = size_t(2048);
+  constexpr auto _pings = size_t(2000);
+
+  const auto _now_ns = []() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  };
+
+  /*
+   * fork the consumer processes, which map the inherited descriptor. each one reports when it
+   * was attached, and sends the p50 and p99 of its wakeup latency in us when it is done
+   */
+  const auto _run = [&](w_shm_channel &p_channel, size_t p_count, auto &&p_produce) {
+    std::array<int, 2> _ready = {-1, -1};
+    std::array<int, 2> _results = {-1, -1};
+    BOOST_REQUIRE(::pipe(_ready.data()) == 0 && ::pipe(_results.data()) == 0);
+
+    std::vector<pid_t> _pids;
+    for (size_t i = 0; i < _readers; ++i) {
+      const auto _pid = ::fork();
+      BOOST_REQUIRE(_pid != -1);
+      if (_pid != 0) {
+        _pids.push_back(_pid);
+        continue;
+      }
+
+      auto _mapping = w_shm_channel::open(p_channel.get_fd());
+      if (_mapping.has_error()) {
+        ::_exit(1);
+      }
+      auto _reader = w_shm_channel_reader(_mapping.value());
+      if (_reader.attach().has_error() || ::write(_ready[1], "r", 1) != 1) {
+        ::_exit(1);
+      }
+      std::vector<double> _latencies;
+      _latencies.reserve(p_count);
+      for (size_t j = 0; j < p_count; ++j) {
+        auto _read = _reader.read(10s);
+        if (_read.has_error() || !_read.value().has_value()) {
+          ::_exit(1);
+        }
+        int64_t _sent = 0;
+        std::memcpy(&_sent, _read.value()->data(), sizeof(_sent));
+        _latencies.push_back(gsl::narrow_cast<double>(_now_ns() - _sent) / 1000.0);
+      }
+      _reader.detach();
+      std::sort(_latencies.begin(), _latencies.end());
+      const auto _result = std::array<double, 2>{_latencies[_latencies.size() / 2],
+                                                 _latencies[_latencies.size() * 99 / 100]};
+      const auto _size = sizeof(_result);
+      ::_exit(::write(_results[1], _result.data(), _size) == ssize_t(_size) ? 0 : 1);
+    }
+
+    for (size_t i = 0; i < _readers; ++i) {
+      char _byte = 0;
+      BOOST_REQUIRE(::read(_ready[0], &_byte, 1) == 1);
+    }
+    p_produce();
+
+    auto _worst = std::array<double, 2>{0, 0};
+    for (const auto _pid : _pids) {
+      auto _result = std::array<double, 2>{0, 0};
+      const auto _size = sizeof(_result);
+      BOOST_REQUIRE(::read(_results[0], _result.data(), _size) == ssize_t(_size));
+      _worst = {std::max(_worst[0], _result[0]), std::max(_worst[1], _result[1])};
+      int _status = 0;
+      BOOST_REQUIRE(::waitpid(_pid, &_status, 0) == _pid && WEXITSTATUS(_status) == 0);
+    }
+    for (const auto _fd : {_ready[0], _ready[1], _results[0], _results[1]}) {
+      ::close(_fd);
+    }
+    return _worst;
+  };
+
+  // the throughput of frames which the producer fills in place
+  auto _options = w_shm_channel_options{};
+  auto _channel = w_shm_channel::create("wolf_ipc_bench", _options);
+  BOOST_REQUIRE(!_channel.has_error());
+  const auto _frame = std::vector<std::byte>(_frame_size, std::byte{'w'});
+  double _seconds = 0;
+  std::ignore = _run(_channel.value(), _frames, [&]() {
+    const auto _start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < _frames; ++i) {
+      auto _room = _channel.value().reserve(_frame_size, 10s);
+      BOOST_REQUIRE(!_room.has_error() && _room.value().has_value());
+      std::memcpy(_room.value()->data(), _frame.data(), _frame_size);
+      const auto _sent = _now_ns();
+      std::memcpy(_room.value()->data(), &_sent, sizeof(_sent));
+      BOOST_REQUIRE(!_channel.value().commit().has_error());
+    }
+    // the last records are released when the readers are done
+    while (_channel.value().get_reader_count() != 0) {
+      std::this_thread::sleep_for(1ms);
+    }
+    _seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+  });
+  const auto _gib = gsl::narrow_cast<double>(_frame_size * _frames) / (1024.0 * 1024.0 * 1024.0);
+
+  // the wakeup latency of idle readers, which poll first or sleep on the futex right away
+  const auto _ping = [&](uint32_t p_spin) {
+    auto _ping_options = w_shm_channel_options{};
+    _ping_options.capacity = 1024 * 1024;
+    _ping_options.spin = p_spin;
+    auto _ping_channel = w_shm_channel::create("wolf_ipc_ping", _ping_options);
+    BOOST_REQUIRE(!_ping_channel.has_error());
+    return _run(_ping_channel.value(), _pings, [&]() {
+      for (size_t i = 0; i < _pings; ++i) {
+        std::this_thread::sleep_for(100us);
+        const auto _sent = _now_ns();
+        auto _written = _ping_channel.value().write(
+            gsl::span<const std::byte>(reinterpret_cast<const std::byte *>(&_sent), sizeof(_sent)),
+            10s);
+        BOOST_REQUIRE(!_written.has_error() && _written.value());
+      }
+    });
+  };
+  const auto _spin = _ping(_options.spin);
+  const auto _futex = _ping(0);
+
+  std::cout << wolf::format("shm channel: {} readers of 1 MiB frames {:.2f} GiB/s", _readers,
+                            _gib / _seconds)
+            << std::endl;
+  std::cout << wolf::format("shm channel: wakeup latency with polling p50 {:.1f} us, "
+                            "p99 {:.1f} us, with the futex only p50 {:.1f} us, p99 {:.1f} us",
+                            _spin[0], _spin[1], _futex[0], _futex[1])
+            << std::endl;
+  BOOST_REQUIRE(_seconds != 0);
+
+  std::cout << "leaving test case 'ipc_shm_channel_benchmark_test'" << std::endl;
+}
+
+#endif // defined(WOLF_TEST) && defined(WOLF_SYSTEM_IPC)
@@ -9,10 +9,529 @@
 #include <system/w_leak_detector.hpp>
 #include <wolf.hpp>
 
+#include <system/socket/w_buffer.hpp>
+#include <system/socket/w_framing.hpp>
+#include <system/socket/w_send_queue.hpp>
+#include <system/socket/w_session_registry.hpp>
 #include <system/socket/w_tcp_client.hpp>
 #include <system/socket/w_tcp_server.hpp>
+#include <system/socket/w_timing_wheel.hpp>
 #include <system/w_timer.hpp>
 
+BOOST_AUTO_TEST_CASE(buffer_pool_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'buffer_pool_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_buffer = wolf::system::socket::w_buffer;
+        using w_buffer_pool = wolf::system::socket::w_buffer_pool;
+        using w_buffer_sequence = wolf::system::socket::w_buffer_sequence;
+
+        w_buffer_pool _pool = {};
+        BOOST_LEAF_CHECK(_pool.init({64, 256}, 4));
+
+        {
+          // the smallest size class which fits the request is chosen
+          BOOST_LEAF_AUTO(_buffer, _pool.acquire(100));
+          BOOST_REQUIRE(_buffer.size() == 100);
+          BOOST_REQUIRE(_buffer.capacity() == 256);
+          std::memset(_buffer.data(), 'a', _buffer.size());
+
+          // copies and slices share the block
+          const auto _copy = _buffer;
+          const auto _slice = _buffer.slice(90, 50);
+          BOOST_REQUIRE(_buffer.use_count() == 3);
+          BOOST_REQUIRE(_copy.data() == _buffer.data());
+          BOOST_REQUIRE(_slice.size() == 10);
+          BOOST_REQUIRE(_slice.to_string() == std::string(10, 'a'));
+
+          BOOST_REQUIRE(_buffer.resize(256));
+          BOOST_REQUIRE(!_buffer.resize(257));
+        }
+
+        // the block went back to the pool and is reused
+        auto _stats = _pool.get_stats();
+        BOOST_REQUIRE(_stats.cached_blocks == 1);
+        BOOST_REQUIRE(_stats.cached_bytes == 256);
+        {
+          BOOST_LEAF_AUTO(_buffer, _pool.acquire(200));
+          BOOST_REQUIRE(_pool.get_stats().hits == 1);
+
+          // a request above the largest class is not cached
+          BOOST_LEAF_AUTO(_large, _pool.acquire(64 * 1024));
+          BOOST_REQUIRE(_large.capacity() == 64 * 1024);
+        }
+        _stats = _pool.get_stats();
+        BOOST_REQUIRE(_stats.cached_blocks == 1);
+        BOOST_REQUIRE(_stats.misses == 2);
+
+        // a gathered sequence is a const buffer sequence of asio
+        w_buffer_sequence _sequence = {};
+        _sequence.push_back(w_buffer("hello "));
+        _sequence.push_back(w_buffer("wolf"));
+        BOOST_REQUIRE(_sequence.count() == 2);
+        BOOST_REQUIRE(boost::asio::buffer_size(_sequence) == 10);
+
+        _sequence.consume(3);
+        BOOST_REQUIRE(_sequence.size() == 7);
+        BOOST_LEAF_AUTO(_flat, _sequence.flatten());
+        BOOST_REQUIRE(_flat.to_string() == "lo wolf");
+
+        _sequence.consume(4);
+        BOOST_REQUIRE(_sequence.count() == 1);
+        BOOST_REQUIRE(boost::asio::buffer_size(_sequence) == 3);
+
+        _pool.trim();
+        BOOST_REQUIRE(_pool.get_stats().cached_blocks == 0);
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg = wolf::format("buffer_pool_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("buffer_pool_test got an error!"); });
+
+  std::cout << "leaving test case 'buffer_pool_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(tcp_framing_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'tcp_framing_test'" << std::endl;
+
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        using w_buffer = wolf::system::socket::w_buffer;
+        using w_frame_decoder = wolf::system::socket::w_frame_decoder;
+        using w_frame_encoder = wolf::system::socket::w_frame_encoder;
+        using w_framing_options = wolf::system::socket::w_framing_options;
+
+        const auto _options = w_framing_options{1024 * 1024, 16};
+        const std::vector<std::string> _messages = {"hello", "", std::string(3000, 'w'), "wolf"};
+
+        // all messages are queued as one buffer sequence
+        w_frame_encoder _encoder(_options);
+        for (const auto &_message : _messages) {
+          BOOST_LEAF_CHECK(_encoder.push(w_buffer(_message)));
+        }
+        BOOST_REQUIRE(_encoder.count() == _messages.size());
+
+        size_t _total = 0;
+        for (const auto &_message : _messages) {
+          _total += wolf::system::socket::W_FRAME_HEADER_SIZE + _message.size();
+        }
+        BOOST_REQUIRE(_encoder.get_buffers().size() == _total);
+        BOOST_LEAF_AUTO(_stream, _encoder.get_buffers().flatten());
+        _encoder.clear();
+        BOOST_REQUIRE(_encoder.empty());
+
+        // feed the stream in uneven reads, the messages come out whole
+        w_frame_decoder _decoder(_options);
+        std::vector<w_buffer> _parsed;
+        size_t _offset = 0;
+        size_t _read_size = 1;
+        while (_offset < _stream.size()) {
+          BOOST_LEAF_AUTO(_room, _decoder.prepare());
+          const auto _size = std::min({_read_size, _room.size(), _stream.size() - _offset});
+          std::memcpy(_room.data(), _stream.data() + _offset, _size);
+          _decoder.commit(_size);
+          _offset += _size;
+          _read_size = _read_size * 3 + 1;
+
+          for (;;) {
+            BOOST_LEAF_AUTO(_message, _decoder.next());
+            if (!_message.has_value()) {
+              break;
+            }
+            _parsed.push_back(std::move(_message.value()));
+          }
+        }
+        BOOST_REQUIRE(_decoder.get_pending_size() == 0);
+        BOOST_REQUIRE(_parsed.size() == _messages.size());
+        for (size_t i = 0; i < _messages.size(); ++i) {
+          BOOST_REQUIRE(_parsed[i].to_string() == _messages[i]);
+        }
+
+        // a prefix above the limit is a protocol error
+        w_frame_decoder _small_decoder(w_framing_options{16, 16});
+        BOOST_LEAF_AUTO(_room, _small_decoder.prepare(_stream.size()));
+        std::memcpy(_room.data(), _stream.data(), _stream.size());
+        _small_decoder.commit(_stream.size());
+        BOOST_LEAF_AUTO(_first, _small_decoder.next());
+        BOOST_REQUIRE(_first.has_value());
+        BOOST_LEAF_AUTO(_second, _small_decoder.next());
+        BOOST_REQUIRE(_second.has_value());
+        BOOST_REQUIRE(!_small_decoder.next());
+
+        return {};
+      },
+      [](const w_trace &p_trace) {
+        const auto _msg = wolf::format("tcp_framing_test got an error : {}", p_trace.to_string());
+        BOOST_ERROR(_msg);
+      },
+      [] { BOOST_ERROR("tcp_framing_test got an error!"); });
+
+  std::cout << "leaving test case 'tcp_framing_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(tcp_send_queue_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'tcp_send_queue_test'" << std::endl;
+
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_send_queue = wolf::system::socket::w_send_queue;
+  using w_send_queue_message = wolf::system::socket::w_send_queue_message;
+  using w_send_queue_options = wolf::system::socket::w_send_queue_options;
+  using w_send_queue_policy = wolf::system::socket::w_send_queue_policy;
+  using w_send_queue_status = wolf::system::socket::w_send_queue_status;
+
+  const auto _message = w_buffer(std::string(300, 'w'));
+  auto _options = w_send_queue_options{};
+  _options.high_watermark = 1000;
+  _options.low_watermark = 200;
+
+  // a slowed down producer waits until the writer drains the queue to the low watermark
+  {
+    auto _io = boost::asio::io_context();
+    auto _queue = w_send_queue(_options);
+    for (auto i = 0; i < 3; ++i) {
+      BOOST_REQUIRE(_queue.push(_message) == w_send_queue_status::QUEUED);
+    }
+    BOOST_REQUIRE(_queue.push(_message) == w_send_queue_status::FULL);
+    BOOST_REQUIRE(_queue.get_stats().full);
+
+    std::vector<std::string> _events;
+    boost::asio::co_spawn(
+        _io,
+        [&]() -> boost::asio::awaitable<void> {
+          const auto _status = co_await _queue.async_push(_message);
+          BOOST_REQUIRE(_status == w_send_queue_status::QUEUED);
+          _events.push_back("pushed");
+        },
+        boost::asio::detached);
+    boost::asio::co_spawn(
+        _io,
+        [&]() -> boost::asio::awaitable<void> {
+          std::vector<w_send_queue_message> _messages;
+          BOOST_REQUIRE(co_await _queue.async_pop(_messages) == 3);
+          _events.push_back("popped");
+          _queue.consume(600);
+          // still above the low watermark
+          BOOST_REQUIRE(_queue.get_stats().full);
+          _queue.consume(300);
+          BOOST_REQUIRE(co_await _queue.async_pop(_messages) == 1);
+          _events.push_back("popped");
+          _queue.close();
+          BOOST_REQUIRE(co_await _queue.async_pop(_messages) == 0);
+        },
+        boost::asio::detached);
+    _io.run();
+
+    BOOST_REQUIRE(_events == std::vector<std::string>({"popped", "pushed", "popped"}));
+    BOOST_REQUIRE(_queue.push(_message) == w_send_queue_status::CLOSED);
+  }
+
+  // fan-out is never blocked by a slow consumer, its queue drops what exceeds the watermark
+  {
+    _options.policy = w_send_queue_policy::DROP;
+    auto _fast = w_send_queue(_options);
+    auto _slow = w_send_queue(_options);
+    for (auto i = 0; i < 100; ++i) {
+      BOOST_REQUIRE(_fast.push(_message) == w_send_queue_status::QUEUED);
+      _fast.consume(_message.size());
+      std::ignore = _slow.push(_message);
+    }
+    BOOST_REQUIRE(_fast.get_stats().dropped_messages == 0);
+    BOOST_REQUIRE(_slow.get_stats().bytes <= _options.high_watermark);
+    BOOST_REQUIRE(_slow.get_stats().messages == 3);
+    BOOST_REQUIRE(_slow.get_stats().dropped_messages == 97);
+    // the queued messages share one block
+    BOOST_REQUIRE(_message.use_count() == 1 + 100 + 3);
+  }
+
+  // a consumer which must not miss any message is disconnected
+  {
+    _options.policy = w_send_queue_policy::DISCONNECT;
+    auto _io = boost::asio::io_context();
+    auto _queue = w_send_queue(_options);
+    for (auto i = 0; i < 3; ++i) {
+      BOOST_REQUIRE(_queue.push(_message) == w_send_queue_status::QUEUED);
+    }
+    BOOST_REQUIRE(_queue.push(_message) == w_send_queue_status::CLOSED);
+    BOOST_REQUIRE(_queue.is_overflowed());
+
+    boost::asio::co_spawn(
+        _io,
+        [&]() -> boost::asio::awaitable<void> {
+          std::vector<w_send_queue_message> _messages;
+          BOOST_REQUIRE(co_await _queue.async_pop(_messages) == 0);
+          BOOST_REQUIRE(co_await _queue.async_wait_writable() == false);
+        },
+        boost::asio::detached);
+    _io.run();
+  }
+
+  std::cout << "leaving test case 'tcp_send_queue_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(tcp_send_queue_server_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'tcp_send_queue_server_test'" << std::endl;
+
+  using tcp = boost::asio::ip::tcp;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_framing_options = wolf::system::socket::w_framing_options;
+  using w_send_queue = wolf::system::socket::w_send_queue;
+  using w_send_queue_options = wolf::system::socket::w_send_queue_options;
+  using w_send_queue_policy = wolf::system::socket::w_send_queue_policy;
+  using w_send_queue_status = wolf::system::socket::w_send_queue_status;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  using w_tcp_server = wolf::system::socket::w_tcp_server;
+  using namespace std::chrono_literals;
+
+  constexpr auto _high_watermark = size_t(256 * 1024);
+  constexpr auto _message_size = size_t(16 * 1024);
+  // far more than the socket buffers of loopback hold
+  constexpr auto _count = size_t(4096);
+
+  // the bytes of a session, which are prefixed by the little-endian size of host when framed
+  const auto _to_wire = [](_In_ const std::string &p_message, _In_ const bool p_framed) {
+    auto _wire = std::string();
+    if (p_framed) {
+      const auto _size = gsl::narrow_cast<uint32_t>(p_message.size());
+      _wire.append(reinterpret_cast<const char *>(&_size), sizeof(_size));
+    }
+    return _wire + p_message;
+  };
+
+  const auto _wait_for = [](_In_ const std::function<bool()> &p_condition) {
+    const auto _deadline = std::chrono::steady_clock::now() + 5s;
+    while (!p_condition() && std::chrono::steady_clock::now() < _deadline) {
+      std::this_thread::sleep_for(10ms);
+    }
+    return p_condition();
+  };
+
+  /*
+   * the sessions of server echo through their send queues and hand them to the test, which
+   * pushes into the queue of a client that shrinks its window and stalls reading
+   */
+  const auto _test = [&](_In_ const uint16_t p_port, _In_ const w_send_queue_policy p_policy,
+                         _In_ const bool p_framed) {
+    auto _io = boost::asio::io_context();
+    std::mutex _mutex;
+    std::shared_ptr<w_send_queue> _queue = nullptr;
+    std::vector<boost::system::error_code> _errors;
+
+    auto _queue_options = w_send_queue_options{};
+    _queue_options.high_watermark = _high_watermark;
+    _queue_options.low_watermark = _high_watermark / 4;
+    _queue_options.policy = p_policy;
+    _queue_options.on_open = [&](const std::string &p_conn_id,
+                                 std::shared_ptr<w_send_queue> p_queue) {
+      const auto _lock = std::scoped_lock(_mutex);
+      _queue = std::move(p_queue);
+    };
+
+    auto _socket_options = w_socket_options{};
+    if (p_framed) {
+      _socket_options.framing = w_framing_options{};
+    }
+    _socket_options.send_queue = std::move(_queue_options);
+
+    BOOST_REQUIRE(!w_tcp_server::run(
+                       _io, tcp::endpoint(tcp::v4(), p_port), 10s, std::move(_socket_options),
+                       [](const std::string &p_conn_id, w_buffer &p_mut_data) {
+                         return boost::system::errc::success;
+                       },
+                       [&](const std::string &p_conn_id,
+                           const boost::system::system_error &p_error) {
+                         const auto _lock = std::scoped_lock(_mutex);
+                         _errors.push_back(p_error.code());
+                       })
+                       .has_error());
+    auto _work = boost::asio::make_work_guard(_io);
+    auto _server = std::jthread([&]() { _io.run(); });
+    // wait for the acceptor
+    std::this_thread::sleep_for(200ms);
+
+    boost::asio::io_context _client_io;
+    tcp::socket _client(_client_io);
+    _client.open(tcp::v4());
+    // the window is only shrunk before connecting
+    _client.set_option(boost::asio::socket_base::receive_buffer_size(4096));
+    _client.connect(tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), p_port));
+
+    // the reply goes out through the queue
+    const auto _hello = _to_wire("hello", p_framed);
+    boost::asio::write(_client, boost::asio::buffer(_hello));
+    auto _reply = std::string(_hello.size(), '\0');
+    boost::asio::read(_client, boost::asio::buffer(_reply));
+    BOOST_REQUIRE(_reply == _hello);
+
+    const auto _session_queue = [&]() {
+      const auto _lock = std::scoped_lock(_mutex);
+      return _queue;
+    }();
+    BOOST_REQUIRE(_session_queue != nullptr);
+    const auto _has_error = [&](_In_ const boost::system::errc::errc_t p_error) {
+      const auto _lock = std::scoped_lock(_mutex);
+      return std::find(_errors.begin(), _errors.end(), make_error_code(p_error)) !=
+             _errors.end();
+    };
+
+    // the queue never exceeds its watermark while the client does not read
+    std::string _queued;
+    size_t _dropped = 0;
+    auto _status = w_send_queue_status::QUEUED;
+    for (size_t i = 0; i < _count && _status != w_send_queue_status::CLOSED; ++i) {
+      const auto _message = std::string(_message_size, gsl::narrow_cast<char>('a' + i % 26));
+      _status = _session_queue->push(w_buffer(_message));
+      BOOST_REQUIRE(_session_queue->get_stats().bytes <= _high_watermark);
+      if (_status == w_send_queue_status::QUEUED) {
+        _queued += _to_wire(_message, p_framed);
+      } else if (_status == w_send_queue_status::DROPPED) {
+        ++_dropped;
+      }
+      if (i == 0) {
+        // the writer takes the first message, so it is in flight before the queue fills up
+        BOOST_REQUIRE(_wait_for([&]() { return _session_queue->get_stats().messages == 0; }));
+      }
+    }
+
+    if (p_policy == w_send_queue_policy::DROP) {
+      // the session stays open and gets every queued message in order, with its frame
+      BOOST_REQUIRE(_status != w_send_queue_status::CLOSED);
+      BOOST_REQUIRE(_dropped != 0);
+      BOOST_REQUIRE(_session_queue->get_stats().dropped_messages == _dropped);
+      BOOST_REQUIRE(!_session_queue->get_stats().closed);
+
+      auto _received = std::string(_queued.size(), '\0');
+      boost::asio::read(_client, boost::asio::buffer(_received));
+      BOOST_REQUIRE(_received == _queued);
+
+      // the session ends with its client and closes its queue
+      _client.close();
+      BOOST_REQUIRE(_wait_for([&]() { return _session_queue->get_stats().closed; }));
+      BOOST_REQUIRE(!_session_queue->is_overflowed());
+      BOOST_REQUIRE(!_has_error(boost::system::errc::no_buffer_space));
+    } else {
+      // the overflow closes the queue and ends the session
+      BOOST_REQUIRE(_status == w_send_queue_status::CLOSED);
+      BOOST_REQUIRE(_dropped == 0);
+      BOOST_REQUIRE(_session_queue->is_overflowed());
+      BOOST_REQUIRE(_wait_for([&]() { return _has_error(boost::system::errc::no_buffer_space); }));
+
+      // the client gets what was written before the overflow, then the end of stream
+      std::string _received;
+      std::array<char, 64 * 1024> _chunk = {};
+      boost::system::error_code _error;
+      while (!_error) {
+        const auto _bytes = _client.read_some(boost::asio::buffer(_chunk), _error);
+        _received.append(_chunk.data(), _bytes);
+      }
+      BOOST_REQUIRE(_error == boost::asio::error::eof ||
+                    _error == boost::asio::error::connection_reset);
+      BOOST_REQUIRE(!_received.empty());
+      BOOST_REQUIRE(_queued.starts_with(_received));
+    }
+    BOOST_REQUIRE(_session_queue->push(w_buffer("wolf")) == w_send_queue_status::CLOSED);
+
+    _io.stop();
+  };
+
+  _test(8084, w_send_queue_policy::DROP, true);
+  _test(8085, w_send_queue_policy::DISCONNECT, false);
+
+  std::cout << "leaving test case 'tcp_send_queue_server_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(tcp_session_registry_server_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'tcp_session_registry_server_test'" << std::endl;
+
+  using tcp = boost::asio::ip::tcp;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_session_registry = wolf::system::socket::w_session_registry;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  using w_tcp_server = wolf::system::socket::w_tcp_server;
+  using namespace std::chrono_literals;
+
+  constexpr auto _port = uint16_t(8086);
+  constexpr auto _clients = size_t(3);
+
+  const auto _wait_for = [](_In_ const std::function<bool()> &p_condition) {
+    const auto _deadline = std::chrono::steady_clock::now() + 5s;
+    while (!p_condition() && std::chrono::steady_clock::now() < _deadline) {
+      std::this_thread::sleep_for(10ms);
+    }
+    return p_condition();
+  };
+
+  // the sessions get a send queue with default options and register it
+  auto _registry = std::make_shared<w_session_registry>(4);
+  auto _socket_options = w_socket_options{};
+  _socket_options.registry = _registry;
+
+  auto _io = boost::asio::io_context();
+  BOOST_REQUIRE(!w_tcp_server::run(
+                     _io, tcp::endpoint(tcp::v4(), _port), 10s, std::move(_socket_options),
+                     [](const std::string &p_conn_id, w_buffer &p_mut_data) {
+                       return boost::system::errc::success;
+                     },
+                     [](const std::string &p_conn_id,
+                        const boost::system::system_error &p_error) {})
+                     .has_error());
+  auto _work = boost::asio::make_work_guard(_io);
+  auto _server = std::jthread([&]() { _io.run(); });
+  // wait for the acceptor
+  std::this_thread::sleep_for(200ms);
+
+  // each client gets its echo, so its session was registered
+  boost::asio::io_context _client_io;
+  std::vector<tcp::socket> _sockets;
+  for (size_t i = 0; i < _clients; ++i) {
+    auto &_socket = _sockets.emplace_back(_client_io);
+    _socket.connect(tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), _port));
+    boost::asio::write(_socket, boost::asio::buffer(std::string_view("hello")));
+    auto _reply = std::string(5, '\0');
+    boost::asio::read(_socket, boost::asio::buffer(_reply));
+    BOOST_REQUIRE(_reply == "hello");
+  }
+  BOOST_REQUIRE(_registry->size() == _clients);
+
+  const auto _broadcast = [&](_In_ const std::string_view p_payload, _In_ const size_t p_first) {
+    auto _message = w_session_registry::make_message(
+        gsl::span(reinterpret_cast<const std::byte *>(p_payload.data()), p_payload.size()));
+    BOOST_REQUIRE(_message.has_error() == false);
+    const auto _stats = _registry->broadcast(_message.value());
+    BOOST_REQUIRE(_stats.queued == _clients - p_first);
+
+    // every connected client receives the message
+    for (size_t i = p_first; i < _clients; ++i) {
+      auto _received = std::string(p_payload.size(), '\0');
+      boost::asio::read(_sockets[i], boost::asio::buffer(_received));
+      BOOST_REQUIRE(_received == p_payload);
+    }
+  };
+  _broadcast("wolf", 0);
+
+  // a disconnected session is removed and the broadcast skips it
+  _sockets.front().close();
+  BOOST_REQUIRE(_wait_for([&]() { return _registry->size() == _clients - 1; }));
+  _broadcast("engine", 1);
+
+  _io.stop();
+
+  std::cout << "leaving test case 'tcp_session_registry_server_test'" << std::endl;
+}
+
 BOOST_AUTO_TEST_CASE(tcp_server_timeout_test) {
   const wolf::system::w_leak_detector _detector = {};
 
@@ -21,6 +540,7 @@ BOOST_AUTO_TEST_CASE(tcp_server_timeout_test) {
   boost::leaf::try_handle_all(
       [&]() -> boost::leaf::result<void> {
         using tcp = boost::asio::ip::tcp;
+        using w_buffer = wolf::system::socket::w_buffer;
         using w_tcp_server = wolf::system::socket::w_tcp_server;
         using w_socket_options = wolf::system::socket::w_socket_options;
 
@@ -41,7 +561,7 @@ BOOST_AUTO_TEST_CASE(tcp_server_timeout_test) {
                 _io, std::move(_endpoint), std::move(timeout), std::move(_opts),
                 [](const std::string &p_conn_id, w_buffer &p_mut_data) -> auto{
                   std::cout << "tcp server just got: /'" << p_mut_data.to_string() << "/'"
-                            << " and " << p_mut_data.used_bytes
+                            << " and " << p_mut_data.size()
                             << " bytes from connection id: " << p_conn_id << std::endl;
                   return boost::system::errc::connection_aborted;
                 },
@@ -113,12 +633,116 @@ BOOST_AUTO_TEST_CASE(tcp_client_timeout_test) {
   std::cout << "leaving test case 'tcp_client_timeout_test'" << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(tcp_idle_timeout_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'tcp_idle_timeout_benchmark_test'" << std::endl;
+
+  using steady_clock = std::chrono::steady_clock;
+  using w_timing_wheel = wolf::system::socket::w_timing_wheel;
+  using w_timing_wheel_entry = wolf::system::socket::w_timing_wheel_entry;
+  using namespace std::chrono_literals;
+
+  constexpr auto _sessions = size_t(100000);
+  constexpr auto _timeout = 200ms;
+  // the sessions are busy for a while, then all of them go idle
+  constexpr auto _busy = 2s;
+  // the first deadline leaves time for spawning the sessions
+  constexpr auto _startup = 1s;
+  constexpr auto _traffic_interval = 10ms;
+
+  // a timer per session, as the sessions were watched before the wheel
+  size_t _timer_wakeups = 0;
+  const auto _watchdog =
+      [&](const steady_clock::time_point &p_deadline) -> boost::asio::awaitable<std::errc> {
+    boost::asio::steady_timer _timer(co_await boost::asio::this_coro::executor);
+    while (p_deadline > steady_clock::now()) {
+      _timer.expires_at(p_deadline);
+      co_await _timer.async_wait(boost::asio::use_awaitable);
+      ++_timer_wakeups;
+    }
+    co_return std::errc::timed_out;
+  };
+
+  for (const auto _use_wheel : {false, true}) {
+    auto _io = boost::asio::io_context();
+    const auto _first_deadline = steady_clock::now() + _startup + _timeout;
+
+    std::vector<steady_clock::time_point> _deadlines(_sessions, _first_deadline);
+    std::vector<w_timing_wheel_entry> _entries(_sessions);
+    for (auto &_entry : _entries) {
+      _entry.set_deadline(_first_deadline);
+    }
+
+    auto _wheel = w_timing_wheel::make_for_timeout(_timeout);
+    if (_use_wheel) {
+      _wheel->run(_io.get_executor());
+    }
+
+    size_t _timed_out = 0;
+    steady_clock::time_point _last_timeout = {};
+    for (size_t i = 0; i < _sessions; ++i) {
+      boost::asio::co_spawn(
+          _io, _use_wheel ? _wheel->async_wait(_entries[i]) : _watchdog(_deadlines[i]),
+          [&](std::exception_ptr, std::errc p_res) {
+            BOOST_REQUIRE(p_res == std::errc::timed_out);
+            _last_timeout = steady_clock::now();
+            if (++_timed_out == _sessions) {
+              _io.stop();
+            }
+          });
+    }
+
+    // every session reads a message now and then
+    steady_clock::time_point _idle = {};
+    boost::asio::co_spawn(
+        _io,
+        [&]() -> boost::asio::awaitable<void> {
+          boost::asio::steady_timer _timer(co_await boost::asio::this_coro::executor);
+          const auto _start = steady_clock::now();
+          while (steady_clock::now() - _start < _busy) {
+            const auto _deadline = steady_clock::now() + _timeout;
+            for (size_t i = 0; i < _sessions; ++i) {
+              if (_use_wheel) {
+                _entries[i].set_deadline(_deadline);
+              } else {
+                _deadlines[i] = _deadline;
+              }
+            }
+            _timer.expires_after(_traffic_interval);
+            co_await _timer.async_wait(boost::asio::use_awaitable);
+          }
+          _idle = steady_clock::now();
+        },
+        boost::asio::detached);
+
+    const auto _cpu = std::clock();
+    _io.run();
+    const auto _cpu_ms = 1000.0 * gsl::narrow_cast<double>(std::clock() - _cpu) / CLOCKS_PER_SEC;
+
+    const auto _late = std::chrono::duration_cast<std::chrono::milliseconds>(
+        _last_timeout - _idle - _timeout);
+    std::cout << wolf::format("{} idle sessions with {}: {:.0f} ms of cpu, {} {}, the last one "
+                              "timed out {} ms late",
+                              _sessions, _use_wheel ? "a timing wheel" : "a timer per session",
+                              _cpu_ms, _use_wheel ? _wheel->get_stats().visits : _timer_wakeups,
+                              _use_wheel ? "visits of wheel" : "wakeups of timers",
+                              _late.count())
+              << std::endl;
+    BOOST_REQUIRE(_timed_out == _sessions);
+    BOOST_REQUIRE(!_use_wheel || _wheel->get_stats().entries == 0);
+  }
+
+  std::cout << "leaving test case 'tcp_idle_timeout_benchmark_test'" << std::endl;
+}
+
 BOOST_AUTO_TEST_CASE(tcp_read_write_test) {
   const wolf::system::w_leak_detector _detector = {};
 
   std::cout << "entering test case 'tcp_read_write_test'" << std::endl;
 
   using tcp = boost::asio::ip::tcp;
+  using w_buffer = wolf::system::socket::w_buffer;
   using w_tcp_client = wolf::system::socket::w_tcp_client;
   using w_tcp_server = wolf::system::socket::w_tcp_server;
   using w_socket_options = wolf::system::socket::w_socket_options;
@@ -170,13 +794,46 @@ BOOST_AUTO_TEST_CASE(tcp_read_write_test) {
                            _client.async_read(_recv_buffer));
           // expect the connection
           BOOST_REQUIRE(_res.index() == 1);
-          _recv_buffer.used_bytes = std::get<1>(_res);
+          BOOST_REQUIRE(std::get<1>(_res) == _recv_buffer.size());
 
-          BOOST_REQUIRE(_recv_buffer.used_bytes == 10);             // hello-back
+          BOOST_REQUIRE(_recv_buffer.size() == 10);                 // hello-back
           BOOST_REQUIRE(_recv_buffer.to_string() == "hello-back");  // hello-back
         }
 
-        _send_buffer.from_string("exit");
+        // a message larger than the old fixed buffer of 1 KiB goes through untouched. the
+        // server may get it in several reads and appends "-back" to each of them, so the
+        // payload has no '-' and the suffixes are stripped before the whole echo is compared
+        auto _large = std::string(64 * 1024, ' ');
+        for (size_t i = 0; i < _large.size(); ++i) {
+          _large[i] = gsl::narrow_cast<char>('a' + i % 26);
+        }
+        BOOST_REQUIRE(_send_buffer.from_string(_large));
+        auto _large_res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                                    _client.async_write(_send_buffer));
+        BOOST_REQUIRE(_large_res.index() == 1);
+        BOOST_REQUIRE(std::get<1>(_large_res) == _large.size());
+
+        const auto _strip = [](_In_ std::string p_echo) {
+          for (auto _pos = p_echo.find("-back"); _pos != std::string::npos;
+               _pos = p_echo.find("-back", _pos)) {
+            p_echo.erase(_pos, 5);
+          }
+          return p_echo;
+        };
+
+        std::string _echo;
+        std::string _payload;
+        while (_payload.size() < _large.size() || !_echo.ends_with("-back")) {
+          _large_res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                                 _client.async_read(_recv_buffer));
+          BOOST_REQUIRE(_large_res.index() == 1);
+          BOOST_REQUIRE(std::get<1>(_large_res) != 0);
+          _echo += _recv_buffer.to_string();
+          _payload = _strip(_echo);
+        }
+        BOOST_REQUIRE(_payload == _large);
+
+        BOOST_REQUIRE(_send_buffer.from_string("exit"));
         auto _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
                               _client.async_write(_send_buffer));
         // expect the connection
@@ -194,21 +851,61 @@ BOOST_AUTO_TEST_CASE(tcp_read_write_test) {
   w_tcp_server::run(
       _io, std::move(_endpoint), _timeout, std::move(_opts),
       [](_In_ const std::string &p_conn_id, _Inout_ w_buffer &p_mut_data) -> auto{
-        // close on overflow
-        if (p_mut_data.used_bytes > 1025) {
+        auto _reply = p_mut_data.to_string();
+
+        std::cout << "tcp server just got " << _reply.size()
+                  << " bytes from connection id: " << p_conn_id << std::endl;
+
+        if (_reply == "exit") {
           return boost::system::errc::connection_aborted;
         }
+        _reply += "-back";
+        std::ignore = p_mut_data.from_string(_reply);
+        return boost::system::errc::success;
+      },
+      [&](const std::string &p_conn_id, const boost::system::system_error &p_error) {
+        std::cout << "error happened for connection: " << p_conn_id << " because of "
+                  << p_error.what() << " error code: " << p_error.code() << std::endl;
+        _io.stop();
+      });
 
-        auto _reply = std::string(p_mut_data.buf.data(), p_mut_data.used_bytes);
+  _io.run();
+
+  std::cout << "leaving test case 'tcp_read_write_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(tcp_framed_read_write_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'tcp_framed_read_write_test'" << std::endl;
 
-        std::cout << "tcp server just got: \"" << _reply << "\" from connection id: " << p_conn_id
-                  << std::endl;
+  using tcp = boost::asio::ip::tcp;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_framing_options = wolf::system::socket::w_framing_options;
+  using w_tcp_client = wolf::system::socket::w_tcp_client;
+  using w_tcp_server = wolf::system::socket::w_tcp_server;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  using w_timer = wolf::system::w_timer;
+  using namespace std::chrono_literals;
 
+  constexpr auto _count = size_t(100);
+
+  auto _io = boost::asio::io_context();
+  w_socket_options _opts = {};
+  _opts.framing = w_framing_options{};
+  tcp::endpoint _endpoint = {tcp::v4(), 8081};
+  const auto _timeout = 10s;
+
+  // the server listens before the client connects
+  w_tcp_server::run(
+      _io, std::move(_endpoint), _timeout, std::move(_opts),
+      [](_In_ const std::string &p_conn_id, _Inout_ w_buffer &p_mut_data) -> auto{
+        auto _reply = p_mut_data.to_string();
         if (_reply == "exit") {
           return boost::system::errc::connection_aborted;
         }
         _reply += "-back";
-        p_mut_data.from_string(_reply);
+        std::ignore = p_mut_data.from_string(_reply);
         return boost::system::errc::success;
       },
       [&](const std::string &p_conn_id, const boost::system::system_error &p_error) {
@@ -217,9 +914,147 @@ BOOST_AUTO_TEST_CASE(tcp_read_write_test) {
         _io.stop();
       });
 
+  boost::asio::co_spawn(
+      _io,
+      [&]() -> boost::asio::awaitable<void> {
+        auto _client = w_tcp_client(_io, w_framing_options{});
+        auto _timer = w_timer(_io);
+        _timer.expires_after(_timeout);
+
+        const auto _endpoint = tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 8081);
+        auto _conn_res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                                   _client.async_connect(_endpoint, w_socket_options{}));
+        BOOST_REQUIRE(_conn_res.index() == 1);
+
+        // many small messages go out with a single write
+        for (size_t i = 0; i < _count; ++i) {
+          BOOST_REQUIRE(_client.queue_message(w_buffer(std::to_string(i))));
+        }
+        BOOST_REQUIRE(_client.queue_message(w_buffer(std::string(256 * 1024, 'w'))));
+        auto _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                              _client.async_flush());
+        BOOST_REQUIRE(_res.index() == 1);
+
+        // each one comes back as a whole message
+        w_buffer _message = {};
+        for (size_t i = 0; i < _count; ++i) {
+          _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                           _client.async_read_message(_message));
+          BOOST_REQUIRE(_res.index() == 1);
+          BOOST_REQUIRE(_message.to_string() == std::to_string(i) + "-back");
+        }
+        _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                         _client.async_read_message(_message));
+        BOOST_REQUIRE(_res.index() == 1);
+        BOOST_REQUIRE(_message.size() == 256 * 1024 + 5);
+
+        _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                         _client.async_write_message(w_buffer("exit")));
+        BOOST_REQUIRE(_res.index() == 1);
+
+        _io.stop();
+        co_return;
+      },
+      boost::asio::detached);
+
   _io.run();
 
-  std::cout << "leaving test case 'tcp_read_write_test'" << std::endl;
+  std::cout << "leaving test case 'tcp_framed_read_write_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(tcp_server_reactors_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'tcp_server_reactors_benchmark_test'" << std::endl;
+
+  using tcp = boost::asio::ip::tcp;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_tcp_server = wolf::system::socket::w_tcp_server;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  using namespace std::chrono_literals;
+
+  constexpr auto _port = uint16_t(8090);
+  constexpr auto _clients = size_t(8);
+  constexpr auto _duration = 2s;
+  constexpr auto _chunk_size = size_t(64 * 1024);
+
+  // the same load is used for each number of reactors
+  const auto _load = [&](_In_ const bool p_reconnect) -> std::pair<size_t, size_t> {
+    std::atomic<size_t> _connections = 0;
+    std::atomic<size_t> _bytes = 0;
+    const auto _deadline = std::chrono::steady_clock::now() + _duration;
+    {
+      std::vector<std::jthread> _threads;
+      for (size_t i = 0; i < _clients; ++i) {
+        _threads.emplace_back([&]() {
+          try {
+            boost::asio::io_context _io;
+            const auto _endpoint = tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), _port);
+            const auto _size = p_reconnect ? size_t(64) : _chunk_size;
+            std::vector<char> _send(_size, 'w');
+            std::vector<char> _recv(_size);
+
+            tcp::socket _socket(_io);
+            while (std::chrono::steady_clock::now() < _deadline) {
+              if (!_socket.is_open()) {
+                _socket.connect(_endpoint);
+                _socket.set_option(tcp::no_delay(true));
+                ++_connections;
+              }
+              boost::asio::write(_socket, boost::asio::buffer(_send));
+              boost::asio::read(_socket, boost::asio::buffer(_recv));
+              _bytes += _size;
+              if (p_reconnect) {
+                _socket.close();
+              }
+            }
+          } catch (const std::exception &p_ex) {
+            std::cout << "benchmark client got an error: " << p_ex.what() << std::endl;
+          }
+        });
+      }
+    }
+    return {_connections.load(), _bytes.load()};
+  };
+
+  const auto _cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  for (size_t _reactors = 1; _reactors <= _cores && _reactors <= 8; _reactors *= 2) {
+    std::stop_source _stop = {};
+    auto _server_failed = false;
+    auto _server = std::jthread([&]() {
+      const auto _res = w_tcp_server::run(
+          {_reactors, true}, _stop.get_token(), tcp::endpoint(tcp::v4(), _port), 10s,
+          w_socket_options{},
+          [](_In_ const std::string &p_conn_id, _Inout_ w_buffer &p_mut_data) -> auto{
+            // echo back
+            return boost::system::errc::success;
+          },
+          [](_In_ const std::string &p_conn_id, _In_ const boost::system::system_error &p_error) {
+          });
+      // the assertions of boost test are not thread-safe, so the result is checked after join
+      _server_failed = _res.has_error();
+    });
+    // wait for the acceptors
+    std::this_thread::sleep_for(500ms);
+
+    const auto _connections = _load(true).first;
+    const auto _bytes = _load(false).second;
+    _stop.request_stop();
+    _server.join();
+    BOOST_REQUIRE(!_server_failed);
+
+    const auto _seconds = std::chrono::duration<double>(_duration).count();
+    std::cout << wolf::format("tcp server on {} with {} reactors: {:.0f} connections/sec, "
+                              "echo {:.1f} MiB/s",
+                              wolf::system::socket::get_io_backend(), _reactors,
+                              gsl::narrow_cast<double>(_connections) / _seconds,
+                              gsl::narrow_cast<double>(_bytes) / (1024.0 * 1024.0) / _seconds)
+              << std::endl;
+    BOOST_REQUIRE(_connections != 0);
+    BOOST_REQUIRE(_bytes != 0);
+  }
+
+  std::cout << "leaving test case 'tcp_server_reactors_benchmark_test'" << std::endl;
 }
 
 #endif  // defined(WOLF_TEST) && defined(WOLF_SYSTEM_SOCKET)
\ No newline at end of file
@@ -0,0 +1,172 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#if defined(WOLF_TEST) && defined(WOLF_SYSTEM_SOCKET)
+
+#include <boost/test/included/unit_test.hpp>
+#include <system/w_leak_detector.hpp>
+#include <wolf.hpp>
+
+#include <system/socket/w_socket_options.hpp>
+#include <system/socket/w_udp_client.hpp>
+#include <system/socket/w_udp_server.hpp>
+
+BOOST_AUTO_TEST_CASE(udp_read_write_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'udp_read_write_test'" << std::endl;
+
+  using udp = boost::asio::ip::udp;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_udp_client = wolf::system::socket::w_udp_client;
+  using w_udp_datagram = wolf::system::socket::w_udp_datagram;
+  using w_udp_options = wolf::system::socket::w_udp_options;
+  using w_udp_server = wolf::system::socket::w_udp_server;
+
+  auto _io = boost::asio::io_context();
+  auto _options = w_udp_options{};
+  _options.receive_buffer_size = 4 * 1024 * 1024;
+
+  const auto _res = w_udp_server::run(
+      _io, udp::endpoint(udp::v4(), 8095), w_udp_options(_options),
+      [](_In_ const udp::endpoint &p_endpoint, _Inout_ w_buffer &p_mut_data) -> auto{
+        // echo back
+        return boost::system::errc::success;
+      },
+      [&](_In_ const boost::system::system_error &p_error) {
+        std::cout << "udp server got an error: " << p_error.what() << std::endl;
+      });
+  BOOST_REQUIRE(_res.has_error() == false);
+
+  boost::asio::co_spawn(
+      _io,
+      [&]() -> boost::asio::awaitable<void> {
+        auto _client = w_udp_client(_io);
+        const auto _endpoint = udp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 8095);
+        // the replies may be coalesced by the kernel and split by the client
+        auto _client_options = _options;
+        _client_options.gro = true;
+        BOOST_REQUIRE(_client.connect(_endpoint, _client_options).has_error() == false);
+        std::cout << "udp gso: " << _client.get_batch().get_gso()
+                  << ", gro: " << _client.get_batch().get_gro() << std::endl;
+
+        const auto _hello = w_buffer(std::string_view("hello"));
+        BOOST_REQUIRE(co_await _client.async_write(_hello) == 5);
+
+        w_buffer _reply = {};
+        BOOST_REQUIRE(co_await _client.async_read(_reply) == 5);
+        BOOST_REQUIRE(_reply.to_string() == "hello");
+
+        // equal datagrams are sent by one system call and come back one by one
+        std::vector<w_udp_datagram> _datagrams;
+        for (auto i = 0; i < 40; ++i) {
+          const auto _size = i == 39 ? size_t(100) : size_t(1200);
+          const auto _byte = gsl::narrow_cast<char>('a' + i % 26);
+          _datagrams.push_back({{}, w_buffer(std::string(_size, _byte))});
+        }
+        BOOST_REQUIRE(co_await _client.async_write(_datagrams) == _datagrams.size());
+
+        std::vector<w_udp_datagram> _replies;
+        while (_replies.size() < _datagrams.size()) {
+          co_await _client.async_read(_replies);
+        }
+        BOOST_REQUIRE(_replies.size() == _datagrams.size());
+        for (size_t i = 0; i < _datagrams.size(); ++i) {
+          BOOST_REQUIRE(_replies[i].buffer.to_string() == _datagrams[i].buffer.to_string());
+        }
+
+        _io.stop();
+      },
+      boost::asio::detached);
+
+  _io.run();
+
+  std::cout << "leaving test case 'udp_read_write_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(udp_batch_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'udp_batch_benchmark_test'" << std::endl;
+
+  using udp = boost::asio::ip::udp;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_udp_client = wolf::system::socket::w_udp_client;
+  using w_udp_datagram = wolf::system::socket::w_udp_datagram;
+  using w_udp_options = wolf::system::socket::w_udp_options;
+  using w_udp_server = wolf::system::socket::w_udp_server;
+  using namespace std::chrono_literals;
+
+  constexpr auto _port = 8096;
+  constexpr auto _duration = 1s;
+  constexpr auto _datagram_size = size_t(64);
+
+  const auto _payload = w_buffer(std::string(_datagram_size, 'w'));
+
+  // one datagram per system call, batched system calls, and batches which are segmented
+  for (const auto &[_batch_size, _gso] :
+       std::vector<std::pair<size_t, bool>>{{1, false}, {32, false}, {32, true}}) {
+    auto _options = w_udp_options{};
+    _options.batch_size = _batch_size;
+    _options.gso = _gso;
+    _options.receive_buffer_size = 8 * 1024 * 1024;
+    _options.send_buffer_size = 8 * 1024 * 1024;
+
+    std::atomic<size_t> _received = 0;
+    auto _server_io = boost::asio::io_context();
+    const auto _res = w_udp_server::run(
+        _server_io, udp::endpoint(udp::v4(), _port), w_udp_options(_options),
+        [&](_In_ const udp::endpoint &p_endpoint, _Inout_ w_buffer &p_mut_data) -> auto{
+          _received.fetch_add(1, std::memory_order_relaxed);
+          // no reply
+          return boost::system::errc::operation_canceled;
+        },
+        [](_In_ const boost::system::system_error &p_error) {});
+    BOOST_REQUIRE(_res.has_error() == false);
+    auto _server = std::jthread([&]() { _server_io.run(); });
+
+    size_t _sent = 0;
+    auto _client_io = boost::asio::io_context();
+    boost::asio::co_spawn(
+        _client_io,
+        [&]() -> boost::asio::awaitable<void> {
+          auto _client = w_udp_client(_client_io);
+          const auto _endpoint = udp::endpoint(boost::asio::ip::make_address("127.0.0.1"), _port);
+          BOOST_REQUIRE(_client.connect(_endpoint, _options).has_error() == false);
+
+          const std::vector<w_udp_datagram> _batch(_batch_size, w_udp_datagram{{}, _payload});
+          const auto _deadline = std::chrono::steady_clock::now() + _duration;
+          while (std::chrono::steady_clock::now() < _deadline) {
+            if (_batch_size == 1) {
+              co_await _client.async_write(_payload);
+              ++_sent;
+            } else {
+              _sent += co_await _client.async_write(_batch);
+            }
+          }
+        },
+        boost::asio::detached);
+    _client_io.run();
+
+    // let the server drain its socket
+    std::this_thread::sleep_for(200ms);
+    _server_io.stop();
+    _server.join();
+
+    const auto _seconds = std::chrono::duration<double>(_duration).count();
+    std::cout << wolf::format("udp on {} with {} bytes, batch {}, gso {}: sent {:.0f} pps, "
+                              "received {:.0f} pps",
+                              wolf::system::socket::get_io_backend(), _datagram_size,
+                              _batch_size, _gso,
+                              gsl::narrow_cast<double>(_sent) / _seconds,
+                              gsl::narrow_cast<double>(_received.load()) / _seconds)
+              << std::endl;
+    BOOST_REQUIRE(_received.load() != 0);
+  }
+
+  std::cout << "leaving test case 'udp_batch_benchmark_test'" << std::endl;
+}
+
+#endif // defined(WOLF_TEST) && defined(WOLF_SYSTEM_SOCKET)
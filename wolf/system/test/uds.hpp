@@ -0,0 +1,265 @@
+/*
+    Project: Wolf Engine. Copyright © 2014-2023 Pooya Eimandar
+    https://github.com/WolfEngine/WolfEngine
+*/
+
+#if defined(WOLF_TEST) && defined(WOLF_SYSTEM_SOCKET) && !defined(WIN32)
+
+#include <boost/test/included/unit_test.hpp>
+#include <system/w_leak_detector.hpp>
+#include <wolf.hpp>
+
+#include <system/socket/w_tcp_server.hpp>
+#include <system/socket/w_uds_client.hpp>
+#include <system/socket/w_uds_server.hpp>
+
+#include <filesystem>
+#include <unistd.h>
+
+#include <boost/asio/experimental/awaitable_operators.hpp>
+
+BOOST_AUTO_TEST_CASE(uds_read_write_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'uds_read_write_test'" << std::endl;
+
+  using local = boost::asio::local::stream_protocol;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_framing_options = wolf::system::socket::w_framing_options;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  using w_uds_client = wolf::system::socket::w_uds_client;
+  using w_uds_server = wolf::system::socket::w_uds_server;
+  using namespace boost::asio::experimental::awaitable_operators;
+  using namespace std::chrono_literals;
+
+  const auto _path = (std::filesystem::temp_directory_path() / "wolf_uds_test.sock").string();
+  const auto _framed_path =
+      (std::filesystem::temp_directory_path() / "wolf_uds_framed_test.sock").string();
+  const auto _timeout = 10s;
+
+  // a socket file which was left by a dead server
+  std::filesystem::remove(_path);
+  {
+    boost::asio::io_context _io;
+    local::acceptor _stale(_io, local::endpoint(_path));
+  }
+  BOOST_REQUIRE(std::filesystem::exists(_path));
+
+  auto _io = boost::asio::io_context();
+  const auto _on_error = [&](const std::string &p_conn_id,
+                             const boost::system::system_error &p_error) {
+    // the probe of the second run closes its connection
+    if (p_error.code() == boost::asio::error::eof) {
+      return;
+    }
+    std::cout << "error happened for connection: " << p_conn_id << " because of "
+              << p_error.what() << std::endl;
+    _io.stop();
+  };
+  const auto _on_data = [](const std::string &p_conn_id, w_buffer &p_mut_data) {
+    auto _reply = p_mut_data.to_string();
+    if (_reply == "exit") {
+      return boost::system::errc::connection_aborted;
+    }
+    _reply += "-back";
+    std::ignore = p_mut_data.from_string(_reply);
+    return boost::system::errc::success;
+  };
+
+  // the server reads the pipes which the client passes to it
+  std::string _from_fds;
+  auto _opts = w_socket_options{};
+  _opts.on_fds = [&](const std::string &p_conn_id, std::vector<int> &&p_fds) {
+    for (const auto _fd : p_fds) {
+      std::array<char, 16> _data = {};
+      const auto _size = ::read(_fd, _data.data(), _data.size());
+      if (_size > 0) {
+        _from_fds.append(_data.data(), gsl::narrow_cast<size_t>(_size));
+      }
+      ::close(_fd);
+    }
+  };
+  BOOST_REQUIRE(!w_uds_server::run(_io, local::endpoint(_path), _timeout, std::move(_opts),
+                                   _on_data, _on_error)
+                     .has_error());
+
+  // the path of a running server is not taken
+  BOOST_REQUIRE(w_uds_server::run(_io, local::endpoint(_path), _timeout, w_socket_options{},
+                                  _on_data, _on_error)
+                    .has_error());
+
+  auto _framed_opts = w_socket_options{};
+  _framed_opts.framing = w_framing_options{};
+  BOOST_REQUIRE(!w_uds_server::run(_io, local::endpoint(_framed_path), _timeout,
+                                   std::move(_framed_opts), _on_data, _on_error)
+                     .has_error());
+
+  auto _done = false;
+  boost::asio::co_spawn(
+      _io,
+      [&]() -> boost::asio::awaitable<void> {
+        auto _timer = boost::asio::steady_timer(_io);
+        _timer.expires_after(_timeout);
+
+        auto _client = w_uds_client(_io);
+        auto _conn_res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                                   _client.async_connect(local::endpoint(_path)));
+        BOOST_REQUIRE(_conn_res.index() == 1);
+
+        w_buffer _recv_buffer = {};
+        for (size_t i = 0; i < 5; i++) {
+          auto _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                                _client.async_write(w_buffer("hello")));
+          BOOST_REQUIRE(_res.index() == 1);
+          _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                           _client.async_read(_recv_buffer));
+          BOOST_REQUIRE(_res.index() == 1);
+          BOOST_REQUIRE(_recv_buffer.to_string() == "hello-back");
+        }
+
+        // pass the read end of a pipe, the server reads what was written to it
+        std::array<int, 2> _pipe = {-1, -1};
+        BOOST_REQUIRE(::pipe(_pipe.data()) == 0);
+        BOOST_REQUIRE(::write(_pipe[1], "wolf", 4) == 4);
+        ::close(_pipe[1]);
+        const auto _fds = std::array<int, 1>{_pipe[0]};
+        auto _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                              _client.async_write(w_buffer("fd"), _fds));
+        BOOST_REQUIRE(_res.index() == 1);
+        ::close(_pipe[0]);
+        _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                         _client.async_read(_recv_buffer));
+        BOOST_REQUIRE(_res.index() == 1);
+        BOOST_REQUIRE(_recv_buffer.to_string() == "fd-back");
+        BOOST_REQUIRE(_from_fds == "wolf");
+
+        // the framing of tcp sessions works on uds
+        auto _framed_client = w_uds_client(_io, w_framing_options{});
+        _conn_res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                              _framed_client.async_connect(local::endpoint(_framed_path)));
+        BOOST_REQUIRE(_conn_res.index() == 1);
+        for (size_t i = 0; i < 100; ++i) {
+          BOOST_REQUIRE(_framed_client.queue_message(w_buffer(std::to_string(i))));
+        }
+        _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                         _framed_client.async_flush());
+        BOOST_REQUIRE(_res.index() == 1);
+        for (size_t i = 0; i < 100; ++i) {
+          _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                           _framed_client.async_read_message(_recv_buffer));
+          BOOST_REQUIRE(_res.index() == 1);
+          BOOST_REQUIRE(_recv_buffer.to_string() == std::to_string(i) + "-back");
+        }
+
+        _done = true;
+        _io.stop();
+        co_return;
+      },
+      boost::asio::detached);
+
+  _io.run();
+  BOOST_REQUIRE(_done);
+
+  std::filesystem::remove(_path);
+  std::filesystem::remove(_framed_path);
+
+  std::cout << "leaving test case 'uds_read_write_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(uds_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'uds_benchmark_test'" << std::endl;
+
+  using local = boost::asio::local::stream_protocol;
+  using tcp = boost::asio::ip::tcp;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  using w_tcp_server = wolf::system::socket::w_tcp_server;
+  using w_uds_server = wolf::system::socket::w_uds_server;
+  using namespace std::chrono_literals;
+
+  constexpr auto _port = uint16_t(8099);
+  constexpr auto _round_trips = size_t(20000);
+  constexpr auto _chunk_size = size_t(64 * 1024);
+  constexpr auto _total_size = size_t(256 * 1024 * 1024);
+  const auto _path = (std::filesystem::temp_directory_path() / "wolf_uds_bench.sock").string();
+
+  // both servers echo on one io context
+  auto _io = boost::asio::io_context();
+  const auto _on_data = [](const std::string &p_conn_id, w_buffer &p_mut_data) {
+    return boost::system::errc::success;
+  };
+  const auto _on_error = [](const std::string &p_conn_id,
+                            const boost::system::system_error &p_error) {};
+  BOOST_REQUIRE(!w_uds_server::run(_io, local::endpoint(_path), 10s, w_socket_options{},
+                                   _on_data, _on_error)
+                     .has_error());
+  BOOST_REQUIRE(!w_tcp_server::run(_io, tcp::endpoint(tcp::v4(), _port), 10s,
+                                   w_socket_options{}, _on_data, _on_error)
+                     .has_error());
+  auto _work = boost::asio::make_work_guard(_io);
+  auto _server = std::jthread([&]() { _io.run(); });
+  // wait for the acceptors
+  std::this_thread::sleep_for(200ms);
+
+  // a blocking client measures the round trips of small messages and the echo of large chunks
+  const auto _measure = [&](auto &p_socket) {
+    std::array<char, 64> _small = {};
+    std::vector<double> _latencies;
+    _latencies.reserve(_round_trips);
+    for (size_t i = 0; i < _round_trips; ++i) {
+      const auto _start = std::chrono::steady_clock::now();
+      boost::asio::write(p_socket, boost::asio::buffer(_small));
+      boost::asio::read(p_socket, boost::asio::buffer(_small));
+      _latencies.push_back(
+          std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - _start)
+              .count());
+    }
+    std::sort(_latencies.begin(), _latencies.end());
+
+    std::vector<char> _chunk(_chunk_size, 'w');
+    const auto _start = std::chrono::steady_clock::now();
+    for (size_t _sent = 0; _sent < _total_size; _sent += _chunk.size()) {
+      boost::asio::write(p_socket, boost::asio::buffer(_chunk));
+      boost::asio::read(p_socket, boost::asio::buffer(_chunk));
+    }
+    const auto _seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+
+    return std::make_tuple(_latencies[_latencies.size() / 2],
+                           _latencies[_latencies.size() * 99 / 100],
+                           gsl::narrow_cast<double>(_total_size) / (1024.0 * 1024.0) / _seconds);
+  };
+
+  boost::asio::io_context _client_io;
+  local::socket _uds(_client_io);
+  _uds.connect(local::endpoint(_path));
+  const auto [_uds_p50, _uds_p99, _uds_mib] = _measure(_uds);
+
+  tcp::socket _tcp(_client_io);
+  _tcp.connect(tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), _port));
+  _tcp.set_option(tcp::no_delay(true));
+  const auto [_tcp_p50, _tcp_p99, _tcp_mib] = _measure(_tcp);
+
+  std::cout << wolf::format("uds: round trip of 64 bytes p50 {:.1f} us, p99 {:.1f} us, "
+                            "echo of 64 KiB chunks {:.0f} MiB/s",
+                            _uds_p50, _uds_p99, _uds_mib)
+            << std::endl;
+  std::cout << wolf::format("loopback tcp: round trip of 64 bytes p50 {:.1f} us, "
+                            "p99 {:.1f} us, echo of 64 KiB chunks {:.0f} MiB/s",
+                            _tcp_p50, _tcp_p99, _tcp_mib)
+            << std::endl;
+  BOOST_REQUIRE(_uds_mib != 0 && _tcp_mib != 0);
+
+  _uds.close();
+  _tcp.close();
+  _work.reset();
+  _io.stop();
+  _server.join();
+  std::filesystem::remove(_path);
+
+  std::cout << "leaving test case 'uds_benchmark_test'" << std::endl;
+}
+
+#endif // defined(WOLF_TEST) && defined(WOLF_SYSTEM_SOCKET) && !defined(WIN32)
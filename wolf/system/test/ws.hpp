@@ -9,18 +9,24 @@
 #include <system/w_leak_detector.hpp>
 #include <wolf/wolf.hpp>
 
+#include <system/socket/w_session_registry.hpp>
 #include <system/socket/w_ws_client.hpp>
 #include <system/socket/w_ws_server.hpp>
 #include <system/w_timer.hpp>
 
 #include <system/socket/w_ws_client_emc.hpp>
 
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <ctime>
+#include <random>
+
 BOOST_AUTO_TEST_CASE(ws_server_timeout_test) {
   const wolf::system::w_leak_detector _detector = {};
 
   std::cout << "entering leaving test case 'ws_server_timeout_test'" << std::endl;
 
   using tcp = boost::asio::ip::tcp;
+  using w_buffer = wolf::system::socket::w_buffer;
   using w_ws_server = wolf::system::socket::w_ws_server;
   using w_socket_options = wolf::system::socket::w_socket_options;
   using namespace std::chrono_literals;
@@ -47,7 +53,7 @@ BOOST_AUTO_TEST_CASE(ws_server_timeout_test) {
       [](const std::string &p_conn_id, _Inout_ w_buffer &p_buffer,
          _Inout_ bool &p_is_binary) -> auto{
         std::cout << "websocket server just got: /'" << p_buffer.to_string() << "/' and "
-                  << p_buffer.used_bytes << " bytes from connection id: " << p_conn_id << std::endl;
+                  << p_buffer.size() << " bytes from connection id: " << p_conn_id << std::endl;
         return boost::beast::websocket::close_code::normal;
       },
       [](const std::string &p_conn_id, const boost::system::system_error &p_error) {
@@ -99,6 +105,293 @@ BOOST_AUTO_TEST_CASE(ws_client_timeout_test) {
   std::cout << "leaving test case 'ws_client_timeout_test'" << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(ws_message_view_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'ws_message_view_test'" << std::endl;
+
+  using tcp = boost::asio::ip::tcp;
+  using w_buffer = wolf::system::socket::w_buffer;
+  using w_ws_client = wolf::system::socket::w_ws_client;
+  using w_ws_server = wolf::system::socket::w_ws_server;
+  using w_socket_options = wolf::system::socket::w_socket_options;
+  using w_timer = wolf::system::w_timer;
+  using namespace std::chrono_literals;
+
+  // far above the old limit of 1 KiB
+  constexpr auto _message_size = size_t(4 * 1024 * 1024);
+
+  auto _io = boost::asio::io_context();
+  tcp::endpoint _endpoint = {tcp::v4(), 8883};
+  const auto _timeout = boost::beast::websocket::stream_base::timeout{// handshake_timeout
+                                                                      5s,
+                                                                      // idle_timeout
+                                                                      5s,
+                                                                      // keep_alive_pings
+                                                                      false};
+
+  // reply with the number of received bytes and their sum, without copying the message
+  w_ws_server::run(
+      _io, std::move(_endpoint), _timeout, w_socket_options{},
+      [](_In_ const std::string &p_conn_id, _In_ gsl::span<const std::byte> p_message,
+         _Inout_ bool &p_is_binary, _Inout_ w_buffer &p_mut_reply) -> auto{
+        size_t _sum = 0;
+        for (const auto _byte : p_message) {
+          _sum += std::to_integer<size_t>(_byte);
+        }
+        p_is_binary = false;
+        std::ignore = p_mut_reply.from_string(wolf::format("{}:{}", p_message.size(), _sum));
+        return boost::beast::websocket::close_code::none;
+      },
+      [&](_In_ const std::string &p_conn_id, _In_ const boost::system::system_error &p_error) {
+        std::cout << "error happened for connection: " << p_conn_id << " because of "
+                  << p_error.what() << " error code: " << p_error.code() << std::endl;
+      });
+
+  boost::asio::co_spawn(
+      _io,
+      [&]() -> boost::asio::awaitable<void> {
+        auto _client = w_ws_client(_io);
+        auto _timer = w_timer(_io);
+        _timer.expires_after(10s);
+
+        const auto _endpoint = tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 8883);
+        auto _conn_res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                                   _client.async_connect(_endpoint, w_socket_options{}));
+        BOOST_REQUIRE(_conn_res.index() == 1);
+
+        auto _message = w_buffer(std::string(_message_size, char(1)));
+        auto _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                              _client.async_write(_message, true));
+        BOOST_REQUIRE(_res.index() == 1);
+
+        std::string _reply;
+        _res = co_await (_timer.async_wait(boost::asio::use_awaitable) ||
+                         _client.async_read([&](_In_ gsl::span<const std::byte> p_message,
+                                                _In_ bool p_is_binary) {
+                           BOOST_REQUIRE(p_is_binary == false);
+                           _reply.assign(reinterpret_cast<const char *>(p_message.data()),
+                                         p_message.size());
+                         }));
+        BOOST_REQUIRE(_res.index() == 1);
+        BOOST_REQUIRE(_reply == wolf::format("{}:{}", _message_size, _message_size));
+
+        co_await _client.async_close(boost::beast::websocket::close_code::normal);
+        _io.stop();
+        co_return;
+      },
+      boost::asio::detached);
+
+  _io.run();
+
+  std::cout << "leaving test case 'ws_message_view_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(ws_deflate_benchmark_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'ws_deflate_benchmark_test'" << std::endl;
+
+  using w_ws_deflate_options = wolf::system::socket::w_ws_deflate_options;
+  using w_test_ws = boost::beast::websocket::stream<boost::beast::test::stream>;
+
+  // representative payloads: game states as json, short chat lines and compressed assets
+  auto _rand_engine = std::mt19937(7);
+  auto _rand_gen = std::uniform_int_distribution<int>(0, 9999);
+
+  std::vector<std::pair<std::string, std::vector<std::string>>> _payloads(3);
+  _payloads[0].first = "json states";
+  _payloads[1].first = "chat lines";
+  _payloads[2].first = "binary assets";
+  for (auto i = 0; i < 1000; ++i) {
+    _payloads[0].second.push_back(wolf::format(
+        R"({{"type":"player_state","seq":{},"player":{{"id":{},"name":"player_{}",)"
+        R"("position":{{"x":{},"y":{},"z":{}}},"health":{},"armor":{}}},)"
+        R"("inventory":["sword","shield","potion_{}","arrow"],"flags":{{"alive":true,)"
+        R"("visible":true,"crouching":false}}}})",
+        i, _rand_gen(_rand_engine), _rand_gen(_rand_engine), _rand_gen(_rand_engine),
+        _rand_gen(_rand_engine), _rand_gen(_rand_engine), _rand_gen(_rand_engine) % 100,
+        _rand_gen(_rand_engine) % 100, _rand_gen(_rand_engine) % 10));
+    _payloads[1].second.push_back(
+        wolf::format("player_{}: gg, meet me at {}", _rand_gen(_rand_engine), i));
+  }
+  for (auto i = 0; i < 100; ++i) {
+    auto _asset = std::string(16 * 1024, '\0');
+    for (auto &_byte : _asset) {
+      _byte = gsl::narrow_cast<char>(_rand_gen(_rand_engine) & 0xFF);
+    }
+    _payloads[2].second.push_back(std::move(_asset));
+  }
+
+  std::vector<std::pair<std::string, std::optional<w_ws_deflate_options>>> _configs;
+  _configs.emplace_back("no deflate", std::nullopt);
+  for (const auto _level : {1, 6, 9}) {
+    auto _deflate = w_ws_deflate_options{};
+    _deflate.compression_level = _level;
+    _configs.emplace_back(wolf::format("deflate level {}", _level), _deflate);
+  }
+  auto _no_takeover = w_ws_deflate_options{};
+  _no_takeover.server_no_context_takeover = true;
+  _no_takeover.client_no_context_takeover = true;
+  _configs.emplace_back("deflate level 6 without context takeover", _no_takeover);
+
+  for (const auto &[_payload_name, _messages] : _payloads) {
+    size_t _raw_bytes = 0;
+    for (const auto &_message : _messages) {
+      _raw_bytes += _message.size();
+    }
+
+    size_t _plain_wire_bytes = 0;
+    for (const auto &[_config_name, _deflate] : _configs) {
+      auto _io = boost::asio::io_context();
+
+      // an in-memory pair of streams, so only the cost of websocket is measured and the bytes
+      // of frames are counted by the server
+      auto _client_stream = boost::beast::test::stream(_io);
+      auto _server_stream = boost::beast::test::stream(_io);
+      _client_stream.connect(_server_stream);
+
+      auto _client = w_test_ws(std::move(_client_stream));
+      auto _server = w_test_ws(std::move(_server_stream));
+      if (_deflate.has_value()) {
+        _deflate->set_to_stream(_client);
+        _deflate->set_to_stream(_server);
+      }
+
+      size_t _handshake_bytes = 0;
+      size_t _received = 0;
+      boost::asio::co_spawn(
+          _io,
+          [&]() -> boost::asio::awaitable<void> {
+            co_await _server.async_accept(boost::asio::use_awaitable);
+            _handshake_bytes = _server.next_layer().nread_bytes();
+            auto _buffer = boost::beast::flat_buffer();
+            for (size_t i = 0; i < _messages.size(); ++i) {
+              _received += co_await _server.async_read(_buffer, boost::asio::use_awaitable);
+              _buffer.consume(_buffer.size());
+            }
+          },
+          boost::asio::detached);
+      boost::asio::co_spawn(
+          _io,
+          [&]() -> boost::asio::awaitable<void> {
+            co_await _client.async_handshake("localhost", "/", boost::asio::use_awaitable);
+            _client.binary(true);
+            for (const auto &_message : _messages) {
+              co_await _client.async_write(boost::asio::buffer(_message),
+                                           boost::asio::use_awaitable);
+            }
+          },
+          boost::asio::detached);
+
+      const auto _cpu_start = std::clock();
+      _io.run();
+      const auto _cpu_ms = 1000.0 * gsl::narrow_cast<double>(std::clock() - _cpu_start) /
+                           gsl::narrow_cast<double>(CLOCKS_PER_SEC);
+
+      BOOST_REQUIRE(_received == _raw_bytes);
+
+      const auto _wire_bytes = _server.next_layer().nread_bytes() - _handshake_bytes;
+      if (_deflate.has_value() == false) {
+        _plain_wire_bytes = _wire_bytes;
+      }
+      const auto _saved = gsl::narrow_cast<double>(_plain_wire_bytes) -
+                          gsl::narrow_cast<double>(_wire_bytes);
+
+      std::cout << wolf::format("{} with {}: {} bytes on the wire of {} bytes, saved {:.1f}%, "
+                                "cpu {:.2f} ms",
+                                _payload_name, _config_name, _wire_bytes, _raw_bytes,
+                                100.0 * _saved / gsl::narrow_cast<double>(_plain_wire_bytes),
+                                _cpu_ms)
+                << std::endl;
+
+      // repeated json must shrink, random bytes can not
+      if (_deflate.has_value() && _payload_name == "json states") {
+        BOOST_REQUIRE(_wire_bytes < _plain_wire_bytes);
+      }
+    }
+  }
+
+  std::cout << "leaving test case 'ws_deflate_benchmark_test'" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(ws_session_registry_test) {
+  const wolf::system::w_leak_detector _detector = {};
+
+  std::cout << "entering test case 'ws_session_registry_test'" << std::endl;
+
+  using w_send_queue = wolf::system::socket::w_send_queue;
+  using w_send_queue_options = wolf::system::socket::w_send_queue_options;
+  using w_session_id = wolf::system::socket::w_session_id;
+  using w_session_registry = wolf::system::socket::w_session_registry;
+
+  constexpr auto _sessions = size_t(1000);
+
+  auto _registry = w_session_registry(6);
+  std::vector<w_session_id> _ids;
+  std::vector<std::shared_ptr<w_send_queue>> _queues;
+  for (size_t i = 0; i < _sessions; ++i) {
+    _ids.push_back(wolf::system::socket::make_session_id());
+    _queues.push_back(std::make_shared<w_send_queue>(w_send_queue_options{}));
+    BOOST_REQUIRE(_registry.add(_ids.back(), _queues.back()).has_error() == false);
+  }
+  BOOST_REQUIRE(_registry.add(_ids.front(), _queues.front()).has_error());
+  BOOST_REQUIRE(_registry.size() == _sessions);
+  BOOST_REQUIRE(_registry.find(_ids[7]) == _queues[7]);
+  BOOST_REQUIRE(_registry.find(0) == nullptr);
+
+  // the connection ids which are given to the callbacks map back to the sessions
+  BOOST_REQUIRE(w_session_registry::get_id(std::to_string(_ids[3])) == _ids[3]);
+  BOOST_REQUIRE(w_session_registry::get_id("12_ab") == 0);
+
+  // all sessions share the block of one message
+  const auto _payload = std::string(4096, 'w');
+  auto _message = w_session_registry::make_message(
+      gsl::span(reinterpret_cast<const std::byte *>(_payload.data()), _payload.size()));
+  BOOST_REQUIRE(_message.has_error() == false);
+
+  const auto _broadcast = _registry.broadcast(_message.value(), false);
+  BOOST_REQUIRE(_broadcast.queued == _sessions);
+  BOOST_REQUIRE(_message.value().use_count() == 1 + _sessions);
+
+  const auto _multicast =
+      _registry.multicast(gsl::span(_ids.data(), 10), _message.value());
+  BOOST_REQUIRE(_multicast.queued == 10);
+  BOOST_REQUIRE(_message.value().use_count() == 1 + _sessions + 10);
+
+  BOOST_REQUIRE(_queues[0]->get_stats().messages == 2);
+  BOOST_REQUIRE(_queues[10]->get_stats().messages == 1);
+
+  // the closed sessions are removed by the next broadcast
+  for (size_t i = 0; i < 5; ++i) {
+    _queues[i]->close();
+  }
+  const auto _after_close = _registry.broadcast(_message.value());
+  BOOST_REQUIRE(_after_close.closed == 5);
+  BOOST_REQUIRE(_after_close.queued == _sessions - 5);
+  BOOST_REQUIRE(_registry.size() == _sessions - 5);
+
+  _registry.remove(_ids[5]);
+  BOOST_REQUIRE(_registry.find(_ids[5]) == nullptr);
+  BOOST_REQUIRE(_registry.size() == _sessions - 6);
+
+  // the sessions move with the registry, and the moved registry is empty
+  auto _moved = std::move(_registry);
+  BOOST_REQUIRE(_moved.size() == _sessions - 6);
+  BOOST_REQUIRE(_moved.find(_ids[7]) == _queues[7]);
+  BOOST_REQUIRE(_registry.size() == 0);
+  BOOST_REQUIRE(_registry.find(_ids[7]) == nullptr);
+  BOOST_REQUIRE(_registry.add(_ids[5], _queues[5]).has_error());
+  BOOST_REQUIRE(_registry.broadcast(_message.value()).queued == 0);
+  _registry.remove(_ids[7]);
+
+  _registry = std::move(_moved);
+  BOOST_REQUIRE(_registry.size() == _sessions - 6);
+  BOOST_REQUIRE(_moved.size() == 0);
+
+  std::cout << "leaving test case 'ws_session_registry_test'" << std::endl;
+}
+
 // BOOST_AUTO_TEST_CASE(ws_read_write) {
 //   const wolf::system::w_leak_detector _detector = {};
 //
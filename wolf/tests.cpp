@@ -26,12 +26,16 @@ BOOST_AUTO_TEST_CASE(wolf_test) {
 //#include <wolf/system/test/coroutine.hpp>
 //#include <wolf/system/test/gamepad.hpp>
 //#include <wolf/system/test/gametime.hpp>
+//#include <wolf/system/test/http.hpp>
+//#include <wolf/system/test/ipc.hpp>
 //#include <wolf/system/test/log.hpp>
 ////#include <wolf/system/test/postgresql.hpp>
 //#include <wolf/system/test/process.hpp>
 //#include <wolf/system/test/signal_slot.hpp>
 //#include <wolf/system/test/tcp.hpp>
 //#include <wolf/system/test/trace.hpp>
+//#include <wolf/system/test/udp.hpp>
+//#include <wolf/system/test/uds.hpp>
 //#include <wolf/system/test/ws.hpp>
 //#include <wolf/system/test/lua.hpp>
 //#include <wolf/system/test/python.hpp>
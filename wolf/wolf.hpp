@@ -46,33 +46,6 @@ constexpr auto W_MAX_BUFFER_SIZE = 1024;
 
 #define DEFER auto _ = std::shared_ptr<void>(nullptr, [&](...)
 
-struct w_buffer {
-  w_buffer() noexcept = default;
-
-  explicit w_buffer(const std::string_view p_str) { from_string(p_str); }
-
-  w_buffer(std::array<char, W_MAX_BUFFER_SIZE> &&p_array, const size_t p_used_bytes) noexcept {
-    this->buf = std::move(p_array);
-    this->used_bytes = p_used_bytes;
-  }
-
-  void from_string(const std::string_view p_str) {
-    const auto _size = p_str.size();
-    this->used_bytes = _size > 1024 ? 1024 : _size;
-    std::copy(p_str.cbegin(), p_str.cbegin() + this->used_bytes, buf.begin());
-  }
-
-  std::string to_string() {
-    if (this->buf.size() && this->used_bytes) {
-      return std::string(this->buf.data(), this->used_bytes);
-    }
-    return std::string();
-  }
-
-  std::array<char, W_MAX_BUFFER_SIZE> buf = {0};
-  size_t used_bytes = 0;
-};
-
 // #ifdef __clang__
 // #define W_ALIGNMENT_16 __attribute__((packed)) __attribute__((aligned(16)))
 // #define W_ALIGNMENT_32 __attribute__((packed)) __attribute__((aligned(32)))